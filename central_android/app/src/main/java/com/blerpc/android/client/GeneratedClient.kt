@@ -71,4 +71,17 @@ abstract class GeneratedClient {
         val respData = streamSend("counter_upload", raw, "counter_upload")
         return blerpc.Blerpc.CounterUploadResponse.parseFrom(respData)
     }
+
+    open suspend fun flashDump(
+        address: Int = 0,
+        length: Int = 0,
+    ): List<blerpc.Blerpc.FlashDumpResponse> {
+        val req =
+            blerpc.Blerpc.FlashDumpRequest.newBuilder()
+                .setAddress(address)
+                .setLength(length)
+                .build()
+        val responses = streamReceive("flash_dump", req.toByteArray())
+        return responses.map { blerpc.Blerpc.FlashDumpResponse.parseFrom(it) }
+    }
 }
@@ -49,4 +49,15 @@ mixin GeneratedClientMixin {
     final respData = await streamSend('counter_upload', raw, 'counter_upload');
     return CounterUploadResponse.fromBuffer(respData);
   }
+
+  Future<List<FlashDumpResponse>> flashDump({int address = 0, int length = 0}) async {
+    final req = FlashDumpRequest()
+      ..address = address
+      ..length = length;
+    final responses = await streamReceive(
+        'flash_dump', Uint8List.fromList(req.writeToBuffer()));
+    return responses
+        .map((data) => FlashDumpResponse.fromBuffer(data))
+        .toList();
+  }
 }
@@ -618,6 +618,155 @@ class CounterUploadResponse extends $pb.GeneratedMessage {
   void clearReceivedCount() => $_clearField(1);
 }
 
+/// FlashDump (P->C stream) — peripheral streams `length` bytes of flash from
+/// `address` as fixed-size chunks, each with its absolute offset and the
+/// CRC-32 (IEEE) of its data. After a disconnect, request again from the
+/// first offset not yet received to resume.
+class FlashDumpRequest extends $pb.GeneratedMessage {
+  factory FlashDumpRequest({
+    $core.int? address,
+    $core.int? length,
+  }) {
+    final result = create();
+    if (address != null) result.address = address;
+    if (length != null) result.length = length;
+    return result;
+  }
+
+  FlashDumpRequest._();
+
+  factory FlashDumpRequest.fromBuffer($core.List<$core.int> data,
+          [$pb.ExtensionRegistry registry = $pb.ExtensionRegistry.EMPTY]) =>
+      create()..mergeFromBuffer(data, registry);
+  factory FlashDumpRequest.fromJson($core.String json,
+          [$pb.ExtensionRegistry registry = $pb.ExtensionRegistry.EMPTY]) =>
+      create()..mergeFromJson(json, registry);
+
+  static final $pb.BuilderInfo _i = $pb.BuilderInfo(
+      _omitMessageNames ? '' : 'FlashDumpRequest',
+      package: const $pb.PackageName(_omitMessageNames ? '' : 'blerpc'),
+      createEmptyInstance: create)
+    ..aI(1, _omitFieldNames ? '' : 'address', fieldType: $pb.PbFieldType.OU3)
+    ..aI(2, _omitFieldNames ? '' : 'length', fieldType: $pb.PbFieldType.OU3)
+    ..hasRequiredFields = false;
+
+  @$core.Deprecated('See https://github.com/google/protobuf.dart/issues/998.')
+  FlashDumpRequest clone() => deepCopy();
+  @$core.Deprecated('See https://github.com/google/protobuf.dart/issues/998.')
+  FlashDumpRequest copyWith(void Function(FlashDumpRequest) updates) =>
+      super.copyWith((message) => updates(message as FlashDumpRequest))
+          as FlashDumpRequest;
+
+  @$core.override
+  $pb.BuilderInfo get info_ => _i;
+
+  @$core.pragma('dart2js:noInline')
+  static FlashDumpRequest create() => FlashDumpRequest._();
+  @$core.override
+  FlashDumpRequest createEmptyInstance() => create();
+  @$core.pragma('dart2js:noInline')
+  static FlashDumpRequest getDefault() => _defaultInstance ??=
+      $pb.GeneratedMessage.$_defaultFor<FlashDumpRequest>(create);
+  static FlashDumpRequest? _defaultInstance;
+
+  @$pb.TagNumber(1)
+  $core.int get address => $_getIZ(0);
+  @$pb.TagNumber(1)
+  set address($core.int value) => $_setUnsignedInt32(0, value);
+  @$pb.TagNumber(1)
+  $core.bool hasAddress() => $_has(0);
+  @$pb.TagNumber(1)
+  void clearAddress() => $_clearField(1);
+
+  @$pb.TagNumber(2)
+  $core.int get length => $_getIZ(1);
+  @$pb.TagNumber(2)
+  set length($core.int value) => $_setUnsignedInt32(1, value);
+  @$pb.TagNumber(2)
+  $core.bool hasLength() => $_has(1);
+  @$pb.TagNumber(2)
+  void clearLength() => $_clearField(2);
+}
+
+class FlashDumpResponse extends $pb.GeneratedMessage {
+  factory FlashDumpResponse({
+    $core.int? offset,
+    $core.List<$core.int>? data,
+    $core.int? crc32,
+  }) {
+    final result = create();
+    if (offset != null) result.offset = offset;
+    if (data != null) result.data = data;
+    if (crc32 != null) result.crc32 = crc32;
+    return result;
+  }
+
+  FlashDumpResponse._();
+
+  factory FlashDumpResponse.fromBuffer($core.List<$core.int> data,
+          [$pb.ExtensionRegistry registry = $pb.ExtensionRegistry.EMPTY]) =>
+      create()..mergeFromBuffer(data, registry);
+  factory FlashDumpResponse.fromJson($core.String json,
+          [$pb.ExtensionRegistry registry = $pb.ExtensionRegistry.EMPTY]) =>
+      create()..mergeFromJson(json, registry);
+
+  static final $pb.BuilderInfo _i = $pb.BuilderInfo(
+      _omitMessageNames ? '' : 'FlashDumpResponse',
+      package: const $pb.PackageName(_omitMessageNames ? '' : 'blerpc'),
+      createEmptyInstance: create)
+    ..aI(1, _omitFieldNames ? '' : 'offset', fieldType: $pb.PbFieldType.OU3)
+    ..a<$core.List<$core.int>>(
+        2, _omitFieldNames ? '' : 'data', $pb.PbFieldType.OY)
+    ..aI(3, _omitFieldNames ? '' : 'crc32', fieldType: $pb.PbFieldType.OU3)
+    ..hasRequiredFields = false;
+
+  @$core.Deprecated('See https://github.com/google/protobuf.dart/issues/998.')
+  FlashDumpResponse clone() => deepCopy();
+  @$core.Deprecated('See https://github.com/google/protobuf.dart/issues/998.')
+  FlashDumpResponse copyWith(void Function(FlashDumpResponse) updates) =>
+      super.copyWith((message) => updates(message as FlashDumpResponse))
+          as FlashDumpResponse;
+
+  @$core.override
+  $pb.BuilderInfo get info_ => _i;
+
+  @$core.pragma('dart2js:noInline')
+  static FlashDumpResponse create() => FlashDumpResponse._();
+  @$core.override
+  FlashDumpResponse createEmptyInstance() => create();
+  @$core.pragma('dart2js:noInline')
+  static FlashDumpResponse getDefault() => _defaultInstance ??=
+      $pb.GeneratedMessage.$_defaultFor<FlashDumpResponse>(create);
+  static FlashDumpResponse? _defaultInstance;
+
+  @$pb.TagNumber(1)
+  $core.int get offset => $_getIZ(0);
+  @$pb.TagNumber(1)
+  set offset($core.int value) => $_setUnsignedInt32(0, value);
+  @$pb.TagNumber(1)
+  $core.bool hasOffset() => $_has(0);
+  @$pb.TagNumber(1)
+  void clearOffset() => $_clearField(1);
+
+  @$pb.TagNumber(2)
+  $core.List<$core.int> get data => $_getN(1);
+  @$pb.TagNumber(2)
+  set data($core.List<$core.int> value) => $_setBytes(1, value);
+  @$pb.TagNumber(2)
+  $core.bool hasData() => $_has(1);
+  @$pb.TagNumber(2)
+  void clearData() => $_clearField(2);
+
+  @$pb.TagNumber(3)
+  $core.int get crc32 => $_getIZ(2);
+  @$pb.TagNumber(3)
+  set crc32($core.int value) => $_setUnsignedInt32(2, value);
+  @$pb.TagNumber(3)
+  $core.bool hasCrc32() => $_has(2);
+  @$pb.TagNumber(3)
+  void clearCrc32() => $_clearField(3);
+}
+
 const $core.bool _omitFieldNames =
     $core.bool.fromEnvironment('protobuf.omit_field_names');
 const $core.bool _omitMessageNames =
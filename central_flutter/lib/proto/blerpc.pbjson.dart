@@ -144,3 +144,32 @@ const CounterUploadResponse$json = {
 final $typed_data.Uint8List counterUploadResponseDescriptor = $convert.base64Decode(
     'ChVDb3VudGVyVXBsb2FkUmVzcG9uc2USJQoOcmVjZWl2ZWRfY291bnQYASABKA1SDXJlY2Vpdm'
     'VkQ291bnQ=');
+
+@$core.Deprecated('Use flashDumpRequestDescriptor instead')
+const FlashDumpRequest$json = {
+  '1': 'FlashDumpRequest',
+  '2': [
+    {'1': 'address', '3': 1, '4': 1, '5': 13, '10': 'address'},
+    {'1': 'length', '3': 2, '4': 1, '5': 13, '10': 'length'},
+  ],
+};
+
+/// Descriptor for `FlashDumpRequest`. Decode as a `google.protobuf.DescriptorProto`.
+final $typed_data.Uint8List flashDumpRequestDescriptor = $convert.base64Decode(
+    'ChBGbGFzaER1bXBSZXF1ZXN0EhgKB2FkZHJlc3MYASABKA1SB2FkZHJlc3MSFgoGbGVuZ3RoGA'
+    'IgASgNUgZsZW5ndGg=');
+
+@$core.Deprecated('Use flashDumpResponseDescriptor instead')
+const FlashDumpResponse$json = {
+  '1': 'FlashDumpResponse',
+  '2': [
+    {'1': 'offset', '3': 1, '4': 1, '5': 13, '10': 'offset'},
+    {'1': 'data', '3': 2, '4': 1, '5': 12, '10': 'data'},
+    {'1': 'crc32', '3': 3, '4': 1, '5': 13, '10': 'crc32'},
+  ],
+};
+
+/// Descriptor for `FlashDumpResponse`. Decode as a `google.protobuf.DescriptorProto`.
+final $typed_data.Uint8List flashDumpResponseDescriptor = $convert.base64Decode(
+    'ChFGbGFzaER1bXBSZXNwb25zZRIWCgZvZmZzZXQYASABKA1SBm9mZnNldBISCgRkYXRhGAIgAS'
+    'gMUgRkYXRhEhQKBWNyYzMyGAMgASgNUgVjcmMzMg==');
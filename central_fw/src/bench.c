@@ -0,0 +1,358 @@
+#include "bench.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/gap.h>
+#include <zephyr/logging/log.h>
+#include <pb_decode.h>
+#include <pb_encode.h>
+#include <string.h>
+
+#include "blerpc_rpc.h"
+#include "generated_client.h"
+
+LOG_MODULE_REGISTER(bench, LOG_LEVEL_INF);
+
+/* Timed calls per point, after one untimed warm-up call */
+#define BENCH_CALLS CONFIG_BLERPC_BENCH_ITERATIONS
+
+/* Payload size of the link and depth sweeps besides the largest one */
+#define BENCH_SMALL_PAYLOAD 16
+
+/* Gives the log backend time to drain before the next line */
+#define BENCH_EMIT_GAP K_MSEC(20)
+
+enum bench_op {
+    BENCH_OP_READ,  /* flash_read of size bytes */
+    BENCH_OP_WRITE, /* data_write of size bytes */
+};
+
+static const char *const bench_op_names[] = {"read", "write"};
+
+struct bench_sample {
+    uint32_t start; /* cycles at submit */
+    uint32_t end;   /* cycles at completion */
+    int status;
+};
+
+struct bench_point {
+    enum bench_op op;
+    uint32_t size;
+    size_t depth;
+};
+
+struct bench_result {
+    uint32_t ok;
+    uint32_t failed;
+    uint32_t p50_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+    uint32_t bytes_per_s;
+};
+
+/* Calls run one point at a time, so one set of state serves the suite */
+static struct bench_sample samples[BENCH_CALLS];
+static uint32_t latencies[BENCH_CALLS];
+static uint8_t req_buf[CONFIG_BLERPC_PROTOCOL_ASSEMBLER_BUF_SIZE];
+static struct k_sem slots;
+static atomic_t remaining;
+static K_SEM_DEFINE(done_sem, 0, 1);
+
+static uint32_t points;
+static uint32_t failed_points;
+
+/* ── Calls ───────────────────────────────────────────────────────────── */
+
+/* Checks each response as it sits in the receive buffer */
+static int bench_check(const uint8_t *data, size_t len, void *ctx)
+{
+    const struct bench_point *pt = ctx;
+
+    if (pt->op == BENCH_OP_READ) {
+        return len >= pt->size ? 0 : -1;
+    }
+    blerpc_DataWriteResponse resp = blerpc_DataWriteResponse_init_zero;
+    pb_istream_t istream = pb_istream_from_buffer(data, len);
+    if (!pb_decode(&istream, blerpc_DataWriteResponse_fields, &resp)) {
+        return -1;
+    }
+    return resp.length == pt->size ? 0 : -1;
+}
+
+static void bench_done(int status, size_t resp_len, void *user_data)
+{
+    struct bench_sample *s = user_data;
+
+    ARG_UNUSED(resp_len);
+    s->end = k_cycle_get_32();
+    s->status = status;
+    k_sem_give(&slots);
+    if (atomic_dec(&remaining) == 1) {
+        k_sem_give(&done_sem);
+    }
+}
+
+static int bench_encode(const struct bench_point *pt, size_t *len)
+{
+    pb_ostream_t ostream = pb_ostream_from_buffer(req_buf, sizeof(req_buf));
+
+    if (pt->op == BENCH_OP_READ) {
+        blerpc_FlashReadRequest req = blerpc_FlashReadRequest_init_zero;
+        req.address = 0;
+        req.length = pt->size;
+        if (!pb_encode(&ostream, blerpc_FlashReadRequest_fields, &req)) {
+            return -1;
+        }
+    } else {
+        /* The same incrementing pattern as the data_write test, written
+         * straight into req_buf rather than staged */
+        if (!pb_encode_tag(&ostream, PB_WT_STRING, blerpc_DataWriteRequest_data_tag) ||
+            !pb_encode_varint(&ostream, pt->size)) {
+            return -1;
+        }
+        uint8_t chunk[64];
+        for (uint32_t off = 0; off < pt->size; off += sizeof(chunk)) {
+            size_t n = MIN(sizeof(chunk), pt->size - off);
+            for (size_t i = 0; i < n; i++) {
+                chunk[i] = (uint8_t)((off + i) & 0xFF);
+            }
+            if (!pb_write(&ostream, chunk, n)) {
+                return -1;
+            }
+        }
+    }
+    *len = ostream.bytes_written;
+    return 0;
+}
+
+/* Nearest-rank percentile of the sorted latencies */
+static uint32_t percentile(const uint32_t *sorted, size_t n, unsigned int pct)
+{
+    size_t rank = (n * pct + 99) / 100;
+    return sorted[MAX(rank, 1) - 1];
+}
+
+static void bench_measure(ble_central_conn_t *conn, const struct bench_point *pt,
+                          struct bench_result *r)
+{
+    size_t req_len;
+
+    memset(r, 0, sizeof(*r));
+    if (bench_encode(pt, &req_len) != 0) {
+        r->failed = BENCH_CALLS;
+        return;
+    }
+
+    const char *name = pt->op == BENCH_OP_READ ? "flash_read" : "data_write";
+    uint8_t id = pt->op == BENCH_OP_READ ? BLERPC_CMD_ID_FLASH_READ : BLERPC_CMD_ID_DATA_WRITE;
+
+    /* Settles the link after a parameter change */
+    if (blerpc_rpc_call_loan(conn, id, name, req_buf, req_len, bench_check, (void *)pt) != 0) {
+        LOG_WRN("Bench %s %u: warm-up call failed", name, pt->size);
+    }
+
+    /* slots caps the calls in flight at the point's depth */
+    k_sem_init(&slots, pt->depth, pt->depth);
+    atomic_set(&remaining, ARRAY_SIZE(samples));
+    k_sem_reset(&done_sem);
+
+    for (size_t i = 0; i < ARRAY_SIZE(samples); i++) {
+        struct bench_sample *s = &samples[i];
+
+        s->status = -EAGAIN;
+        if (k_sem_take(&slots, K_SECONDS(30)) != 0) {
+            LOG_ERR("Bench %s %u: no call completed", name, pt->size);
+            blerpc_rpc_flush(conn, K_SECONDS(15));
+            r->failed = BENCH_CALLS;
+            return;
+        }
+        s->start = k_cycle_get_32();
+        int rc = blerpc_rpc_call_loan_async(conn, id, name, req_buf, req_len, bench_check,
+                                            (void *)pt, bench_done, s, K_SECONDS(10));
+        if (rc != 0) {
+            s->status = rc;
+            s->end = s->start;
+            k_sem_give(&slots);
+            if (atomic_dec(&remaining) == 1) {
+                k_sem_give(&done_sem);
+            }
+        }
+    }
+    if (k_sem_take(&done_sem, K_SECONDS(60)) != 0) {
+        LOG_ERR("Bench %s %u: completion timeout", name, pt->size);
+        blerpc_rpc_flush(conn, K_SECONDS(15));
+    }
+
+    uint32_t first = samples[0].start;
+    uint32_t last = first;
+    for (size_t i = 0; i < ARRAY_SIZE(samples); i++) {
+        const struct bench_sample *s = &samples[i];
+        if (s->status != 0) {
+            r->failed++;
+            continue;
+        }
+        latencies[r->ok++] = k_cyc_to_us_floor32(s->end - s->start);
+        if ((int32_t)(s->end - last) > 0) {
+            last = s->end;
+        }
+    }
+    if (r->ok == 0) {
+        return;
+    }
+
+    /* Insertion sort: at most CONFIG_BLERPC_BENCH_ITERATIONS samples */
+    for (size_t i = 1; i < r->ok; i++) {
+        uint32_t v = latencies[i];
+        size_t j = i;
+        for (; j > 0 && latencies[j - 1] > v; j--) {
+            latencies[j] = latencies[j - 1];
+        }
+        latencies[j] = v;
+    }
+    r->p50_us = percentile(latencies, r->ok, 50);
+    r->p99_us = percentile(latencies, r->ok, 99);
+    r->max_us = latencies[r->ok - 1];
+
+    uint32_t elapsed_us = MAX(k_cyc_to_us_floor32(last - first), 1);
+    r->bytes_per_s = (uint32_t)((uint64_t)pt->size * r->ok * USEC_PER_SEC / elapsed_us);
+}
+
+/* ── Sweeps ──────────────────────────────────────────────────────────── */
+
+static void bench_point(ble_central_conn_t *conn, const char *sweep, enum bench_op op,
+                        uint32_t size, size_t depth)
+{
+    const struct bench_point pt = {.op = op, .size = size, .depth = depth};
+    struct bench_result r;
+    struct ble_central_link_params params;
+
+    bench_measure(conn, &pt, &r);
+    ble_central_get_link_params(conn, &params);
+
+    points++;
+    if (r.failed) {
+        failed_points++;
+    }
+    LOG_INF("BENCH {\"sweep\":\"%s\",\"op\":\"%s\",\"size\":%u,\"mtu\":%u,\"phy\":%u,"
+            "\"interval\":%u,\"depth\":%u,\"enc\":%d,\"bulk\":%d,\"n\":%u,\"fail\":%u,"
+            "\"p50_us\":%u,\"p99_us\":%u,\"max_us\":%u,\"bytes_per_s\":%u}",
+            sweep, bench_op_names[op], size, ble_central_get_mtu(conn), params.tx_phy,
+            params.interval, (unsigned int)depth, ble_central_is_encrypted(conn) ? 1 : 0,
+            ble_central_bulk_max_payload(conn) > 0 ? 1 : 0, r.ok, r.failed, r.p50_us, r.p99_us,
+            r.max_us, r.bytes_per_s);
+    k_sleep(BENCH_EMIT_GAP);
+}
+
+/* Both operations at a small and the largest payload */
+static void bench_pair(ble_central_conn_t *conn, const char *sweep, uint32_t max_payload,
+                       size_t depth)
+{
+    for (int op = BENCH_OP_READ; op <= BENCH_OP_WRITE; op++) {
+        bench_point(conn, sweep, op, BENCH_SMALL_PAYLOAD, depth);
+        bench_point(conn, sweep, op, max_payload, depth);
+    }
+}
+
+static void sweep_size(ble_central_conn_t *conn, uint32_t max_payload)
+{
+    for (int op = BENCH_OP_READ; op <= BENCH_OP_WRITE; op++) {
+        for (uint32_t size = 1; size < max_payload; size *= 4) {
+            bench_point(conn, "size", op, size, 1);
+        }
+        bench_point(conn, "size", op, max_payload, 1);
+    }
+}
+
+static void sweep_mtu(ble_central_conn_t *conn, uint32_t max_payload)
+{
+    /* The last entry lifts the cap back to the negotiated MTU */
+    static const uint16_t mtus[] = {23, 65, 131, 0};
+
+    for (size_t i = 0; i < ARRAY_SIZE(mtus); i++) {
+        ble_central_set_mtu_limit(conn, mtus[i]);
+        bench_pair(conn, "mtu", max_payload, 1);
+    }
+}
+
+static void sweep_phy(ble_central_conn_t *conn, uint32_t max_payload, uint8_t restore)
+{
+    static const uint8_t phys[] = {
+        BT_GAP_LE_PHY_1M,
+        BT_GAP_LE_PHY_2M,
+#ifdef CONFIG_BT_CTLR_PHY_CODED
+        BT_GAP_LE_PHY_CODED,
+#endif
+    };
+
+    for (size_t i = 0; i < ARRAY_SIZE(phys); i++) {
+        int err = ble_central_set_phy(conn, phys[i]);
+        if (err) {
+            LOG_WRN("PHY %u unavailable (err %d), skipping", phys[i], err);
+            continue;
+        }
+        bench_pair(conn, "phy", max_payload, 1);
+    }
+    ble_central_set_phy(conn, restore);
+}
+
+/* Wait for the peripheral to accept a requested interval */
+static void interval_apply(ble_central_conn_t *conn, uint16_t interval)
+{
+    struct ble_central_link_params params;
+
+    if (ble_central_set_conn_interval(conn, interval) != 0) {
+        return;
+    }
+    for (int i = 0; i < 60; i++) {
+        ble_central_get_link_params(conn, &params);
+        if (params.interval == interval) {
+            return;
+        }
+        k_sleep(K_MSEC(50));
+    }
+    LOG_WRN("Interval %u not applied, measuring at %u", interval, params.interval);
+}
+
+static void sweep_interval(ble_central_conn_t *conn, uint32_t max_payload, uint16_t restore)
+{
+    /* 7.5 ms to 120 ms */
+    static const uint16_t intervals[] = {6, 12, 24, 48, 96};
+
+    for (size_t i = 0; i < ARRAY_SIZE(intervals); i++) {
+        interval_apply(conn, intervals[i]);
+        bench_pair(conn, "interval", max_payload, 1);
+    }
+    interval_apply(conn, restore);
+}
+
+static void sweep_depth(ble_central_conn_t *conn, uint32_t max_payload)
+{
+    for (size_t depth = 1; depth < CONFIG_BLERPC_RPC_WINDOW_SIZE; depth *= 2) {
+        bench_pair(conn, "depth", max_payload, depth);
+    }
+    bench_pair(conn, "depth", max_payload, CONFIG_BLERPC_RPC_WINDOW_SIZE);
+}
+
+int bench_run(ble_central_conn_t *conn, uint32_t max_payload)
+{
+    struct ble_central_link_params initial;
+
+    ble_central_get_link_params(conn, &initial);
+    points = 0;
+    failed_points = 0;
+
+    LOG_INF("BENCH {\"suite\":\"begin\",\"calls\":%u,\"window\":%u,\"max_payload\":%u,"
+            "\"enc\":%d}",
+            BENCH_CALLS, CONFIG_BLERPC_RPC_WINDOW_SIZE, max_payload,
+            ble_central_is_encrypted(conn) ? 1 : 0);
+    k_sleep(BENCH_EMIT_GAP);
+
+    sweep_size(conn, max_payload);
+    sweep_mtu(conn, max_payload);
+    sweep_phy(conn, max_payload, initial.tx_phy);
+    sweep_interval(conn, max_payload, initial.interval);
+    sweep_depth(conn, max_payload);
+
+    LOG_INF("BENCH {\"suite\":\"end\",\"points\":%u,\"failed_points\":%u}", points,
+            failed_points);
+    return failed_points == 0 ? 0 : -1;
+}
@@ -0,0 +1,29 @@
+#ifndef BLERPC_BENCH_H
+#define BLERPC_BENCH_H
+
+#include <stdint.h>
+
+#include "ble_central.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Run the benchmark suite (CONFIG_BLERPC_BENCH) against one peripheral.
+ *
+ * Sweeps payload size up to max_payload, the central's container MTU, PHY,
+ * connection interval and pipelining depth one at a time around the link's
+ * current settings, timing flash_read and data_write calls. Each point is
+ * logged as one line, "BENCH " followed by a JSON object, for
+ * central_py/bench.py to collect over RTT. The link is restored afterwards.
+ *
+ * @return 0 if every call succeeded, -1 otherwise
+ */
+int bench_run(ble_central_conn_t *conn, uint32_t max_payload);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLERPC_BENCH_H */
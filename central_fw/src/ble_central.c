@@ -6,15 +6,38 @@
 #include <mbedtls/platform_util.h>
 #include <psa/crypto.h>
 #include <string.h>
+#include "stream_crypto.h"
+#endif
+
+#ifdef CONFIG_BLERPC_RESUMPTION
+#include "session_resume.h"
+/* Key exchange and resumption replies share the response buffer */
+#define KX_MSG_MAX_SIZE MAX(BLERPC_STEP2_SIZE, SESSION_RESUME_MAX_MSG_SIZE)
+#else
+#define KX_MSG_MAX_SIZE BLERPC_STEP2_SIZE
 #endif
 
 #include <zephyr/kernel.h>
 #include <zephyr/bluetooth/bluetooth.h>
 #include <zephyr/bluetooth/conn.h>
 #include <zephyr/bluetooth/gatt.h>
+#include <zephyr/bluetooth/hci.h>
 #include <zephyr/bluetooth/uuid.h>
 #include <zephyr/logging/log.h>
 
+#ifdef CONFIG_BLERPC_CENTRAL_L2CAP
+#include <zephyr/bluetooth/l2cap.h>
+#include <zephyr/sys/atomic.h>
+#endif
+
+#if defined(CONFIG_BLERPC_CENTRAL_STATS) && defined(CONFIG_STATS)
+#include <zephyr/stats/stats.h>
+#endif
+
+#ifdef CONFIG_BLERPC_CENTRAL_FAST_CONNECT
+#include "gatt_cache.h"
+#endif
+
 LOG_MODULE_REGISTER(ble_central, LOG_LEVEL_INF);
 
 /* Timeout for BLE operations (scan, discovery, etc.) */
@@ -24,38 +47,171 @@ LOG_MODULE_REGISTER(ble_central, LOG_LEVEL_INF);
 static struct bt_uuid_128 blerpc_svc_uuid = BT_UUID_INIT_128(BLERPC_SERVICE_UUID);
 static struct bt_uuid_128 blerpc_char_uuid = BT_UUID_INIT_128(BLERPC_CHAR_UUID);
 
-/* Connection state */
-static struct bt_conn *current_conn;
-static uint16_t char_value_handle;
-static struct bt_gatt_subscribe_params subscribe_params;
+/* Per-peripheral state, one pool entry per link */
+struct blerpc_conn {
+    struct bt_conn *conn;
+    bool ready; /* discovery and subscription complete */
+    uint16_t char_value_handle;
+    struct bt_gatt_subscribe_params subscribe_params;
+    struct bt_gatt_discover_params discover_params;
+    struct bt_gatt_exchange_params mtu_exchange_params;
+    uint16_t svc_start_handle;
+    uint16_t svc_end_handle;
+    struct k_sem discover_sem;
+    struct k_sem mtu_sem;
+    struct k_sem subscribe_sem;
+    uint8_t subscribe_err; /* ATT error of the CCC write */
+
+    /* Link tuning */
+    int8_t rssi; /* of the advertisement we connected from */
+    struct ble_central_link_params params;
+    struct k_sem phy_sem;
+    uint16_t mtu_limit; /* 0 if none, see ble_central_set_mtu_limit() */
+
+    /* Container assembler for incoming notifications */
+    struct container_assembler assembler;
+
+    /* Capabilities */
+    uint16_t max_request_payload_size;
+    uint16_t max_response_payload_size;
+    uint16_t capability_flags;
+    uint16_t schema_hash;
+    uint16_t inflate_limit; /* largest request data the peripheral expands */
+    struct k_sem caps_sem;
+
+    /* Pending ble_central_request_stats() reply, NULL when none */
+    uint8_t *stats_buf;
+    size_t stats_size;
+    size_t stats_len;
+    struct k_sem stats_sem;
+
+#ifdef CONFIG_BLERPC_CENTRAL_FAST_CONNECT
+    /* Handles and capabilities came from the cache, not this connection */
+    bool cache_hit;
+    /* Written back to the cache by cache_work when capabilities arrive, or
+     * forgotten if they show the peripheral runs another schema */
+    bt_addr_le_t cache_addr;
+    struct gatt_cache_record cache_rec;
+    bool cache_stale;
+    struct k_work cache_work;
+#endif
+
+#ifdef CONFIG_BLERPC_CENTRAL_L2CAP
+    /* Bulk channel */
+    uint16_t bulk_psm; /* from capabilities, 0 if none */
+    struct bt_l2cap_le_chan bulk_chan;
+    struct k_sem bulk_sem; /* channel connected or closed, or SDU sent */
+    bool bulk_connected;
+    /* GATT writes handed to the stack and not yet sent */
+    atomic_t writes_pending;
+    struct k_sem writes_idle;
+#endif
+
+#ifdef CONFIG_BLERPC_ENCRYPTION
+    /* Encryption state */
+    struct blerpc_crypto_session crypto_session;
+    bool encryption_active;
+    struct k_sem kx_sem;
+    uint8_t kx_response_buf[KX_MSG_MAX_SIZE + CONTAINER_CONTROL_HEADER_SIZE];
+    size_t kx_response_len;
+#endif
+};
+
+static struct blerpc_conn links[CONFIG_BT_MAX_CONN];
+
+/* ── Counters ────────────────────────────────────────────────────────── */
+
+#ifdef CONFIG_BLERPC_CENTRAL_STATS
+#ifdef CONFIG_STATS
+#define CENTRAL_STATS_SECT_ENTRY(name) STATS_SECT_ENTRY32(name)
+STATS_SECT_START(central_stats)
+BLE_CENTRAL_STATS_COUNTERS(CENTRAL_STATS_SECT_ENTRY)
+STATS_SECT_END;
+static STATS_SECT_DECL(central_stats) central_stats;
 
-/* Container assembler for incoming notifications */
-static struct container_assembler assembler;
+#define CENTRAL_STATS_NAME(name) STATS_NAME(central_stats, name)
+STATS_NAME_START(central_stats)
+BLE_CENTRAL_STATS_COUNTERS(CENTRAL_STATS_NAME)
+STATS_NAME_END(central_stats);
+#else
+/* Written from the BT RX thread and callers' threads without locking */
+static struct ble_central_stats central_stats;
+#endif
+#define CENTRAL_STATS_ADD(name, n) ((void)(central_stats.name += (uint32_t)(n)))
+#else
+#define CENTRAL_STATS_ADD(name, n) ((void)0)
+#endif
+#define CENTRAL_STATS_INC(name) CENTRAL_STATS_ADD(name, 1)
 
 /* Callbacks */
 static ble_central_response_cb_t response_cb;
 static ble_central_error_cb_t error_cb;
 static ble_central_stream_end_cb_t stream_end_cb;
 
-/* Capabilities */
-static uint16_t max_request_payload_size;
-static uint16_t max_response_payload_size;
-static uint16_t capability_flags;
-static K_SEM_DEFINE(caps_sem, 0, 1);
+/* Connects are serialized: one scan + create + discovery at a time */
+static K_MUTEX_DEFINE(connect_mutex);
+static struct blerpc_conn *connecting;
+static K_SEM_DEFINE(connect_sem, 0, 1);
+#ifdef CONFIG_BLERPC_CENTRAL_FAST_CONNECT
+/* connecting waits for an accept-list connection, whose bt_conn the
+ * connected callback hands over */
+static bool connecting_auto;
+#endif
 
+/* Every link gets the same fixed interval, so the controller can lay
+ * their connection events out back to back within it instead of letting
+ * anchor points drift into each other. */
+static const struct bt_conn_le_create_param link_create_param = BT_CONN_LE_CREATE_PARAM_INIT(
+    BT_CONN_LE_OPT_NONE, BT_GAP_SCAN_FAST_INTERVAL, BT_GAP_SCAN_FAST_WINDOW);
+static const struct bt_le_conn_param link_conn_param = BT_LE_CONN_PARAM_INIT(
+    CONFIG_BLERPC_CENTRAL_CONN_INTERVAL, CONFIG_BLERPC_CENTRAL_CONN_INTERVAL, 0, 100);
+
+static struct blerpc_conn *link_get(struct bt_conn *conn)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(links); i++) {
+        if (links[i].conn == conn) {
+            return &links[i];
+        }
+    }
+    return NULL;
+}
+
+static struct blerpc_conn *link_alloc(void)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(links); i++) {
+        if (links[i].conn == NULL) {
+            return &links[i];
+        }
+    }
+    return NULL;
+}
+
+/* Drop everything learned about the peer; called once the link is gone */
+static void link_reset(struct blerpc_conn *link)
+{
+    link->ready = false;
+    link->char_value_handle = 0;
+    link->svc_start_handle = 0;
+    link->svc_end_handle = 0;
+    link->max_request_payload_size = 0;
+    link->max_response_payload_size = 0;
+    link->capability_flags = 0;
+    link->schema_hash = 0;
+    link->inflate_limit = 0;
+    link->mtu_limit = 0;
+    container_assembler_init(&link->assembler);
+#ifdef CONFIG_BLERPC_CENTRAL_L2CAP
+    link->bulk_psm = 0;
+    atomic_set(&link->writes_pending, 0);
+#endif
 #ifdef CONFIG_BLERPC_ENCRYPTION
-/* Encryption state */
-static struct blerpc_crypto_session crypto_session;
-static bool encryption_active;
-static K_SEM_DEFINE(kx_sem, 0, 1);
-static uint8_t kx_response_buf[BLERPC_STEP2_SIZE + CONTAINER_CONTROL_HEADER_SIZE];
-static size_t kx_response_len;
+    link->encryption_active = false;
+    mbedtls_platform_zeroize(&link->crypto_session, sizeof(link->crypto_session));
 #endif
-
-/* Synchronization semaphores */
-static K_SEM_DEFINE(connect_sem, 0, 1);
-static K_SEM_DEFINE(discover_sem, 0, 1);
-static K_SEM_DEFINE(mtu_sem, 0, 1);
+#ifdef CONFIG_BLERPC_CENTRAL_FAST_CONNECT
+    link->cache_hit = false;
+#endif
+}
 
 /* ── Scan callbacks ──────────────────────────────────────────────────── */
 
@@ -97,6 +253,17 @@ static void device_found(const bt_addr_le_t *addr, int8_t rssi, uint8_t type,
         return;
     }
 
+    /* Skip peripherals that already have a link, and stray reports that
+     * arrive after a connection was created */
+    if (!connecting || connecting->conn) {
+        return;
+    }
+    struct bt_conn *existing = bt_conn_lookup_addr_le(BT_ID_DEFAULT, addr);
+    if (existing) {
+        bt_conn_unref(existing);
+        return;
+    }
+
     char addr_str[BT_ADDR_LE_STR_LEN];
     bt_addr_le_to_str(addr, addr_str, sizeof(addr_str));
     LOG_INF("Found blerpc device: %s (RSSI %d)", addr_str, rssi);
@@ -107,143 +274,144 @@ static void device_found(const bt_addr_le_t *addr, int8_t rssi, uint8_t type,
         return;
     }
 
-    struct bt_conn_le_create_param create_param = BT_CONN_LE_CREATE_PARAM_INIT(
-        BT_CONN_LE_OPT_NONE, BT_GAP_SCAN_FAST_INTERVAL, BT_GAP_SCAN_FAST_WINDOW);
-
-    struct bt_le_conn_param conn_param = BT_LE_CONN_PARAM_INIT(12, 24, 0, 100);
-
-    err = bt_conn_le_create(addr, &create_param, &conn_param, &current_conn);
+    connecting->rssi = rssi;
+    err = bt_conn_le_create(addr, &link_create_param, &link_conn_param, &connecting->conn);
     if (err) {
         LOG_ERR("Create connection failed (err %d)", err);
+        connecting->conn = NULL;
+        k_sem_give(&connect_sem);
     }
 }
 
 /* ── GATT discovery ──────────────────────────────────────────────────── */
 
-static struct bt_gatt_discover_params discover_params;
-static uint16_t svc_start_handle;
-static uint16_t svc_end_handle;
-
 static uint8_t discover_desc_cb(struct bt_conn *conn, const struct bt_gatt_attr *attr,
                                 struct bt_gatt_discover_params *params)
 {
+    struct blerpc_conn *link = CONTAINER_OF(params, struct blerpc_conn, discover_params);
+
     if (!attr) {
         LOG_INF("Descriptor discovery complete");
-        k_sem_give(&discover_sem);
+        k_sem_give(&link->discover_sem);
         return BT_GATT_ITER_STOP;
     }
 
     LOG_INF("Descriptor found: handle %u", attr->handle);
 
     /* Subscribe for notifications */
-    subscribe_params.notify = NULL; /* Set later */
-    subscribe_params.value_handle = char_value_handle;
-    subscribe_params.ccc_handle = attr->handle;
-    subscribe_params.value = BT_GATT_CCC_NOTIFY;
+    link->subscribe_params.notify = NULL; /* Set later */
+    link->subscribe_params.value_handle = link->char_value_handle;
+    link->subscribe_params.ccc_handle = attr->handle;
+    link->subscribe_params.value = BT_GATT_CCC_NOTIFY;
 
-    k_sem_give(&discover_sem);
+    k_sem_give(&link->discover_sem);
     return BT_GATT_ITER_STOP;
 }
 
 static uint8_t discover_char_cb(struct bt_conn *conn, const struct bt_gatt_attr *attr,
                                 struct bt_gatt_discover_params *params)
 {
+    struct blerpc_conn *link = CONTAINER_OF(params, struct blerpc_conn, discover_params);
+
     if (!attr) {
         LOG_ERR("Characteristic not found");
-        k_sem_give(&discover_sem);
+        k_sem_give(&link->discover_sem);
         return BT_GATT_ITER_STOP;
     }
 
     struct bt_gatt_chrc *chrc = (struct bt_gatt_chrc *)attr->user_data;
-    char_value_handle = chrc->value_handle;
-    LOG_INF("Characteristic found: value_handle %u", char_value_handle);
+    link->char_value_handle = chrc->value_handle;
+    LOG_INF("Characteristic found: value_handle %u", link->char_value_handle);
 
-    k_sem_give(&discover_sem);
+    k_sem_give(&link->discover_sem);
     return BT_GATT_ITER_STOP;
 }
 
 static uint8_t discover_svc_cb(struct bt_conn *conn, const struct bt_gatt_attr *attr,
                                struct bt_gatt_discover_params *params)
 {
+    struct blerpc_conn *link = CONTAINER_OF(params, struct blerpc_conn, discover_params);
+
     if (!attr) {
         LOG_ERR("Service not found");
-        k_sem_give(&discover_sem);
+        k_sem_give(&link->discover_sem);
         return BT_GATT_ITER_STOP;
     }
 
     struct bt_gatt_service_val *svc = (struct bt_gatt_service_val *)attr->user_data;
-    svc_start_handle = attr->handle;
-    svc_end_handle = svc->end_handle;
-    LOG_INF("Service found: handles %u-%u", svc_start_handle, svc_end_handle);
+    link->svc_start_handle = attr->handle;
+    link->svc_end_handle = svc->end_handle;
+    LOG_INF("Service found: handles %u-%u", link->svc_start_handle, link->svc_end_handle);
 
-    k_sem_give(&discover_sem);
+    k_sem_give(&link->discover_sem);
     return BT_GATT_ITER_STOP;
 }
 
-static int gatt_discover(void)
+static int gatt_discover(struct blerpc_conn *link)
 {
+    struct bt_gatt_discover_params *discover_params = &link->discover_params;
     int err;
 
     /* Phase 1: Discover primary service */
-    memset(&discover_params, 0, sizeof(discover_params));
-    discover_params.uuid = &blerpc_svc_uuid.uuid;
-    discover_params.func = discover_svc_cb;
-    discover_params.start_handle = BT_ATT_FIRST_ATTRIBUTE_HANDLE;
-    discover_params.end_handle = BT_ATT_LAST_ATTRIBUTE_HANDLE;
-    discover_params.type = BT_GATT_DISCOVER_PRIMARY;
-
-    err = bt_gatt_discover(current_conn, &discover_params);
+    memset(discover_params, 0, sizeof(*discover_params));
+    discover_params->uuid = &blerpc_svc_uuid.uuid;
+    discover_params->func = discover_svc_cb;
+    discover_params->start_handle = BT_ATT_FIRST_ATTRIBUTE_HANDLE;
+    discover_params->end_handle = BT_ATT_LAST_ATTRIBUTE_HANDLE;
+    discover_params->type = BT_GATT_DISCOVER_PRIMARY;
+
+    err = bt_gatt_discover(link->conn, discover_params);
     if (err) {
         LOG_ERR("Service discover failed (err %d)", err);
         return err;
     }
-    if (k_sem_take(&discover_sem, BLE_OP_TIMEOUT) != 0) {
+    if (k_sem_take(&link->discover_sem, BLE_OP_TIMEOUT) != 0) {
         LOG_ERR("Service discovery timed out");
         return -ETIMEDOUT;
     }
 
-    if (svc_start_handle == 0) {
+    if (link->svc_start_handle == 0) {
         LOG_ERR("Service not found");
         return -ENOENT;
     }
 
     /* Phase 2: Discover characteristic */
-    memset(&discover_params, 0, sizeof(discover_params));
-    discover_params.uuid = &blerpc_char_uuid.uuid;
-    discover_params.func = discover_char_cb;
-    discover_params.start_handle = svc_start_handle;
-    discover_params.end_handle = svc_end_handle;
-    discover_params.type = BT_GATT_DISCOVER_CHARACTERISTIC;
-
-    err = bt_gatt_discover(current_conn, &discover_params);
+    memset(discover_params, 0, sizeof(*discover_params));
+    discover_params->uuid = &blerpc_char_uuid.uuid;
+    discover_params->func = discover_char_cb;
+    discover_params->start_handle = link->svc_start_handle;
+    discover_params->end_handle = link->svc_end_handle;
+    discover_params->type = BT_GATT_DISCOVER_CHARACTERISTIC;
+
+    err = bt_gatt_discover(link->conn, discover_params);
     if (err) {
         LOG_ERR("Char discover failed (err %d)", err);
         return err;
     }
-    if (k_sem_take(&discover_sem, BLE_OP_TIMEOUT) != 0) {
+    if (k_sem_take(&link->discover_sem, BLE_OP_TIMEOUT) != 0) {
         LOG_ERR("Characteristic discovery timed out");
         return -ETIMEDOUT;
     }
 
-    if (char_value_handle == 0) {
+    if (link->char_value_handle == 0) {
         LOG_ERR("Characteristic not found");
         return -ENOENT;
     }
 
     /* Phase 3: Discover CCC descriptor */
-    memset(&discover_params, 0, sizeof(discover_params));
-    discover_params.uuid = BT_UUID_GATT_CCC;
-    discover_params.func = discover_desc_cb;
-    discover_params.start_handle = char_value_handle + 1;
-    discover_params.end_handle = svc_end_handle;
-    discover_params.type = BT_GATT_DISCOVER_DESCRIPTOR;
-
-    err = bt_gatt_discover(current_conn, &discover_params);
+    memset(discover_params, 0, sizeof(*discover_params));
+    discover_params->uuid = BT_UUID_GATT_CCC;
+    discover_params->func = discover_desc_cb;
+    discover_params->start_handle = link->char_value_handle + 1;
+    discover_params->end_handle = link->svc_end_handle;
+    discover_params->type = BT_GATT_DISCOVER_DESCRIPTOR;
+
+    err = bt_gatt_discover(link->conn, discover_params);
     if (err) {
         LOG_ERR("Descriptor discover failed (err %d)", err);
         return err;
     }
-    if (k_sem_take(&discover_sem, BLE_OP_TIMEOUT) != 0) {
+    if (k_sem_take(&link->discover_sem, BLE_OP_TIMEOUT) != 0) {
         LOG_ERR("Descriptor discovery timed out");
         return -ETIMEDOUT;
     }
@@ -251,11 +419,57 @@ static int gatt_discover(void)
     return 0;
 }
 
+/* ── GATT cache ──────────────────────────────────────────────────────── */
+
+#ifdef CONFIG_BLERPC_CENTRAL_FAST_CONNECT
+static void cache_work_handler(struct k_work *work)
+{
+    struct blerpc_conn *link = CONTAINER_OF(work, struct blerpc_conn, cache_work);
+
+    if (link->cache_stale) {
+        gatt_cache_forget(&link->cache_addr);
+        return;
+    }
+    gatt_cache_store(&link->cache_addr, &link->cache_rec);
+}
+
+/* Capabilities arrived on the BT RX thread: record them with the handles,
+ * leaving the settings write to the system work queue. A schema hash other
+ * than the cached one means new firmware, whose handles may have moved too,
+ * so the record is dropped and the next connect discovers them. */
+static void cache_update(struct blerpc_conn *link)
+{
+    struct gatt_cache_record *rec = &link->cache_rec;
+
+    link->cache_stale = link->cache_hit && rec->schema_hash != link->schema_hash;
+    if (link->cache_stale) {
+        LOG_WRN("Peripheral schema changed (0x%04x -> 0x%04x), dropping its cache record",
+                rec->schema_hash, link->schema_hash);
+    }
+    memset(rec, 0, sizeof(*rec));
+    rec->value_handle = link->char_value_handle;
+    rec->ccc_handle = link->subscribe_params.ccc_handle;
+    rec->max_request_payload_size = link->max_request_payload_size;
+    rec->max_response_payload_size = link->max_response_payload_size;
+    rec->capability_flags = link->capability_flags;
+    rec->schema_hash = link->schema_hash;
+    rec->inflate_limit = link->inflate_limit;
+#ifdef CONFIG_BLERPC_CENTRAL_L2CAP
+    rec->bulk_psm = link->bulk_psm;
+#endif
+    rec->rssi = link->rssi;
+    bt_addr_le_copy(&link->cache_addr, bt_conn_get_dst(link->conn));
+    k_work_submit(&link->cache_work);
+}
+#endif /* CONFIG_BLERPC_CENTRAL_FAST_CONNECT */
+
 /* ── Notification handler ────────────────────────────────────────────── */
 
 static uint8_t notify_handler(struct bt_conn *conn, struct bt_gatt_subscribe_params *params,
                               const void *data, uint16_t length)
 {
+    struct blerpc_conn *link = CONTAINER_OF(params, struct blerpc_conn, subscribe_params);
+
     if (!data) {
         LOG_INF("Notifications disabled");
         params->value_handle = 0;
@@ -263,6 +477,8 @@ static uint8_t notify_handler(struct bt_conn *conn, struct bt_gatt_subscribe_par
     }
 
     LOG_DBG("Notification: %u bytes", length);
+    CENTRAL_STATS_INC(notifications);
+    CENTRAL_STATS_ADD(bytes_in, length);
 
     struct container_header hdr;
     if (container_parse_header(data, length, &hdr) != 0) {
@@ -274,205 +490,829 @@ static uint8_t notify_handler(struct bt_conn *conn, struct bt_gatt_subscribe_par
     if (hdr.type == CONTAINER_TYPE_CONTROL) {
         if (hdr.control_cmd == CONTROL_CMD_STREAM_END_P2C) {
             if (stream_end_cb) {
-                stream_end_cb();
+                stream_end_cb(link);
             }
         } else if (hdr.control_cmd == CONTROL_CMD_CAPABILITIES && hdr.payload_len >= 4) {
-            max_request_payload_size = (uint16_t)(hdr.payload[0] | (hdr.payload[1] << 8));
-            max_response_payload_size = (uint16_t)(hdr.payload[2] | (hdr.payload[3] << 8));
-            capability_flags = 0;
+            link->max_request_payload_size = (uint16_t)(hdr.payload[0] | (hdr.payload[1] << 8));
+            link->max_response_payload_size = (uint16_t)(hdr.payload[2] | (hdr.payload[3] << 8));
+            link->capability_flags = 0;
             if (hdr.payload_len >= 6) {
-                capability_flags = (uint16_t)hdr.payload[4] | ((uint16_t)hdr.payload[5] << 8);
+                link->capability_flags =
+                    (uint16_t)hdr.payload[4] | ((uint16_t)hdr.payload[5] << 8);
+            }
+            if (hdr.payload_len >= 18) {
+                /* Link parameters as the peripheral sees them */
+                LOG_INF("Peripheral link: phy tx %u rx %u, len tx %u rx %u, interval %u",
+                        hdr.payload[6], hdr.payload[7],
+                        (uint16_t)(hdr.payload[8] | (hdr.payload[9] << 8)),
+                        (uint16_t)(hdr.payload[10] | (hdr.payload[11] << 8)),
+                        (uint16_t)(hdr.payload[12] | (hdr.payload[13] << 8)));
+            }
+#ifdef CONFIG_BLERPC_CENTRAL_L2CAP
+            if (hdr.payload_len >= 20) {
+                link->bulk_psm = (uint16_t)(hdr.payload[18] | (hdr.payload[19] << 8));
+            }
+#endif
+            link->schema_hash = 0;
+            if (hdr.payload_len >= 22) {
+                link->schema_hash = (uint16_t)(hdr.payload[20] | (hdr.payload[21] << 8));
+            }
+            link->inflate_limit = 0;
+            if (hdr.payload_len >= 24 && (link->capability_flags & CAPABILITY_FLAG_COMPRESSION)) {
+                link->inflate_limit = (uint16_t)(hdr.payload[22] | (hdr.payload[23] << 8));
+            }
+#ifdef CONFIG_BLERPC_CENTRAL_FAST_CONNECT
+            cache_update(link);
+#endif
+            k_sem_give(&link->caps_sem);
+        } else if (hdr.control_cmd == CONTROL_CMD_STATS && hdr.payload_len >= 1) {
+            if (link->stats_buf) {
+                link->stats_len = MIN(hdr.payload_len, link->stats_size);
+                memcpy(link->stats_buf, hdr.payload, link->stats_len);
+                link->stats_buf = NULL;
+                k_sem_give(&link->stats_sem);
             }
-            k_sem_give(&caps_sem);
         } else if (hdr.control_cmd == CONTROL_CMD_ERROR && hdr.payload_len >= 1) {
+            if (hdr.payload[0] == BLERPC_ERROR_BUSY) {
+                CENTRAL_STATS_INC(busy_errors);
+            }
             if (error_cb) {
-                error_cb(hdr.payload[0]);
+                error_cb(link, hdr.transaction_id, hdr.payload[0]);
             }
 #ifdef CONFIG_BLERPC_ENCRYPTION
-        } else if (hdr.control_cmd == CONTROL_CMD_KEY_EXCHANGE) {
+        } else if (hdr.control_cmd == CONTROL_CMD_KEY_EXCHANGE ||
+                   hdr.control_cmd == CONTROL_CMD_RESUME) {
             /* Store raw notification for key exchange processing */
-            if (length <= sizeof(kx_response_buf)) {
-                memcpy(kx_response_buf, data, length);
-                kx_response_len = length;
-                k_sem_give(&kx_sem);
+            if (length <= sizeof(link->kx_response_buf)) {
+                memcpy(link->kx_response_buf, data, length);
+                link->kx_response_len = length;
+                k_sem_give(&link->kx_sem);
             }
 #endif
         }
         return BT_GATT_ITER_CONTINUE;
     }
 
-    int rc = container_assembler_feed(&assembler, &hdr);
+    struct container_assembler *assembler = &link->assembler;
+    int rc = container_assembler_feed(assembler, &hdr);
     if (rc == 1) {
         /* Assembly complete */
 #ifdef CONFIG_BLERPC_ENCRYPTION
-        if (encryption_active) {
+        if (link->encryption_active) {
+            /* Notifications from every link are handled one at a time on the
+             * BT RX thread, so one plaintext buffer serves the whole pool */
             static uint8_t decrypted[CONFIG_BLERPC_PROTOCOL_ASSEMBLER_BUF_SIZE];
             size_t decrypted_len;
-            if (blerpc_crypto_session_decrypt(&crypto_session, decrypted, sizeof(decrypted),
-                                              &decrypted_len, assembler.buf,
-                                              assembler.total_length) != 0) {
+            if (blerpc_crypto_session_decrypt(&link->crypto_session, decrypted,
+                                              sizeof(decrypted), &decrypted_len, assembler->buf,
+                                              assembler->total_length) != 0) {
                 LOG_ERR("Response decryption failed");
-                container_assembler_init(&assembler);
+                CENTRAL_STATS_INC(decrypt_failures);
+                container_assembler_init(assembler);
                 return BT_GATT_ITER_CONTINUE;
             }
             if (response_cb) {
-                response_cb(decrypted, decrypted_len);
+                response_cb(link, hdr.transaction_id, decrypted, decrypted_len);
             }
         } else {
 #endif
             if (response_cb) {
-                response_cb(assembler.buf, assembler.total_length);
+                response_cb(link, hdr.transaction_id, assembler->buf, assembler->total_length);
             }
 #ifdef CONFIG_BLERPC_ENCRYPTION
         }
 #endif
-        container_assembler_init(&assembler);
+        container_assembler_init(assembler);
     } else if (rc < 0) {
         LOG_ERR("Assembler error");
-        container_assembler_init(&assembler);
+        CENTRAL_STATS_INC(assembler_resets);
+        container_assembler_init(assembler);
     }
 
     return BT_GATT_ITER_CONTINUE;
 }
 
+/* ── Subscription ────────────────────────────────────────────────────── */
+
+static void subscribe_cb(struct bt_conn *conn, uint8_t err,
+                         struct bt_gatt_subscribe_params *params)
+{
+    struct blerpc_conn *link = CONTAINER_OF(params, struct blerpc_conn, subscribe_params);
+
+    link->subscribe_err = err;
+    k_sem_give(&link->subscribe_sem);
+}
+
+/* Write the CCC and wait until the peripheral accepts it, so notifications
+ * are on before the first control request goes out */
+static int subscribe(struct blerpc_conn *link)
+{
+    k_sem_reset(&link->subscribe_sem);
+    link->subscribe_params.notify = notify_handler;
+    link->subscribe_params.subscribe = subscribe_cb;
+    link->subscribe_params.value = BT_GATT_CCC_NOTIFY;
+
+    int err = bt_gatt_subscribe(link->conn, &link->subscribe_params);
+    if (err) {
+        LOG_ERR("Subscribe failed (err %d)", err);
+        return err;
+    }
+    if (k_sem_take(&link->subscribe_sem, BLE_OP_TIMEOUT) != 0) {
+        LOG_ERR("Subscribe timed out");
+        return -ETIMEDOUT;
+    }
+    if (link->subscribe_err) {
+        LOG_ERR("Subscribe rejected (ATT err 0x%02x)", link->subscribe_err);
+        return -EIO;
+    }
+    return 0;
+}
+
+#ifdef CONFIG_BLERPC_CENTRAL_FAST_CONNECT
+/* Subscribe with the handles cached for the peer and take its cached
+ * capabilities. False if there are none, or the peripheral refuses the
+ * handles, in which case they are forgotten and discovery runs. */
+static bool cache_setup(struct blerpc_conn *link)
+{
+    const bt_addr_le_t *addr = bt_conn_get_dst(link->conn);
+    struct gatt_cache_record rec;
+
+    if (!gatt_cache_lookup(addr, &rec)) {
+        return false;
+    }
+    link->char_value_handle = rec.value_handle;
+    link->subscribe_params.value_handle = rec.value_handle;
+    link->subscribe_params.ccc_handle = rec.ccc_handle;
+    if (subscribe(link) != 0) {
+        LOG_WRN("Cached handles refused, rediscovering");
+        gatt_cache_forget(addr);
+        link->char_value_handle = 0;
+        return false;
+    }
+
+    link->max_request_payload_size = rec.max_request_payload_size;
+    link->max_response_payload_size = rec.max_response_payload_size;
+    link->capability_flags = rec.capability_flags;
+    /* No command IDs until the live reply confirms the schema: after a
+     * firmware update, cached IDs could name other handlers */
+    link->schema_hash = 0;
+    link->inflate_limit = rec.inflate_limit;
+#ifdef CONFIG_BLERPC_CENTRAL_L2CAP
+    link->bulk_psm = rec.bulk_psm;
+#endif
+    link->cache_rec = rec;
+    link->cache_hit = true;
+    LOG_INF("Using cached handles %u/%u and capabilities", rec.value_handle, rec.ccc_handle);
+    return true;
+}
+#endif
+
 /* ── Connection callbacks ────────────────────────────────────────────── */
 
+/* Link-layer defaults until the controller reports otherwise */
+static void link_params_init(struct blerpc_conn *link)
+{
+    struct bt_conn_info info;
+
+    link->params = (struct ble_central_link_params){
+        .tx_phy = BT_GAP_LE_PHY_1M,
+        .rx_phy = BT_GAP_LE_PHY_1M,
+        .tx_max_len = 27,
+        .rx_max_len = 27,
+    };
+    if (bt_conn_get_info(link->conn, &info) != 0) {
+        return;
+    }
+    link->params.interval = info.le.interval;
+    link->params.latency = info.le.latency;
+    link->params.timeout = info.le.timeout;
+#ifdef CONFIG_BT_USER_PHY_UPDATE
+    link->params.tx_phy = info.le.phy->tx_phy;
+    link->params.rx_phy = info.le.phy->rx_phy;
+#endif
+#ifdef CONFIG_BT_USER_DATA_LEN_UPDATE
+    link->params.tx_max_len = info.le.data_len->tx_max_len;
+    link->params.rx_max_len = info.le.data_len->rx_max_len;
+#endif
+}
+
 static void connected_cb(struct bt_conn *conn, uint8_t err)
 {
+    struct blerpc_conn *link = link_get(conn);
+#ifdef CONFIG_BLERPC_CENTRAL_FAST_CONNECT
+    if (!link && connecting && connecting_auto && !connecting->conn) {
+        link = connecting;
+        link->conn = bt_conn_ref(conn);
+    }
+#endif
+    if (!link) {
+        return;
+    }
+
     if (err) {
         LOG_ERR("Connection failed (err %u)", err);
-        if (current_conn) {
-            bt_conn_unref(current_conn);
-            current_conn = NULL;
-        }
+        bt_conn_unref(link->conn);
+        link->conn = NULL;
         k_sem_give(&connect_sem);
         return;
     }
 
-    LOG_INF("Connected");
+    LOG_INF("Connected (link %u)", (unsigned int)(link - links));
+    link_params_init(link);
     k_sem_give(&connect_sem);
 }
 
 static void disconnected_cb(struct bt_conn *conn, uint8_t reason)
 {
-    LOG_INF("Disconnected (reason %u)", reason);
-    if (current_conn) {
-        bt_conn_unref(current_conn);
-        current_conn = NULL;
+    struct blerpc_conn *link = link_get(conn);
+    if (!link) {
+        return;
     }
-#ifdef CONFIG_BLERPC_ENCRYPTION
-    encryption_active = false;
-    mbedtls_platform_zeroize(&crypto_session, sizeof(crypto_session));
+
+    LOG_INF("Disconnected (link %u, reason %u)", (unsigned int)(link - links), reason);
+    link_reset(link);
+    bt_conn_unref(link->conn);
+    link->conn = NULL;
+}
+
+static void le_param_updated_cb(struct bt_conn *conn, uint16_t interval, uint16_t latency,
+                                uint16_t timeout)
+{
+    struct blerpc_conn *link = link_get(conn);
+    if (!link) {
+        return;
+    }
+    link->params.interval = interval;
+    link->params.latency = latency;
+    link->params.timeout = timeout;
+    LOG_INF("Connection params: interval %u, latency %u, timeout %u", interval, latency,
+            timeout);
+}
+
+#ifdef CONFIG_BT_USER_PHY_UPDATE
+static void le_phy_updated_cb(struct bt_conn *conn, struct bt_conn_le_phy_info *param)
+{
+    struct blerpc_conn *link = link_get(conn);
+    if (!link) {
+        return;
+    }
+    link->params.tx_phy = param->tx_phy;
+    link->params.rx_phy = param->rx_phy;
+    LOG_INF("PHY updated: tx %u, rx %u", param->tx_phy, param->rx_phy);
+    k_sem_give(&link->phy_sem);
+}
 #endif
+
+#ifdef CONFIG_BT_USER_DATA_LEN_UPDATE
+static void le_data_len_updated_cb(struct bt_conn *conn, struct bt_conn_le_data_len_info *info)
+{
+    struct blerpc_conn *link = link_get(conn);
+    if (!link) {
+        return;
+    }
+    link->params.tx_max_len = info->tx_max_len;
+    link->params.rx_max_len = info->rx_max_len;
+    LOG_INF("Data length updated: tx %u, rx %u", info->tx_max_len, info->rx_max_len);
 }
+#endif
 
 BT_CONN_CB_DEFINE(conn_callbacks) = {
     .connected = connected_cb,
     .disconnected = disconnected_cb,
+    .le_param_updated = le_param_updated_cb,
+#ifdef CONFIG_BT_USER_PHY_UPDATE
+    .le_phy_updated = le_phy_updated_cb,
+#endif
+#ifdef CONFIG_BT_USER_DATA_LEN_UPDATE
+    .le_data_len_updated = le_data_len_updated_cb,
+#endif
 };
 
 /* ── MTU exchange ────────────────────────────────────────────────────── */
 
-static struct bt_gatt_exchange_params mtu_exchange_params;
-
 static void mtu_exchange_cb(struct bt_conn *conn, uint8_t err,
                             struct bt_gatt_exchange_params *params)
 {
+    struct blerpc_conn *link = CONTAINER_OF(params, struct blerpc_conn, mtu_exchange_params);
+
     if (err) {
         LOG_ERR("MTU exchange failed (err %u)", err);
     } else {
         LOG_INF("MTU exchanged: %u", bt_gatt_get_mtu(conn));
     }
-    k_sem_give(&mtu_sem);
+    k_sem_give(&link->mtu_sem);
 }
 
+/* ── Bulk channel ────────────────────────────────────────────────────── */
+
+#ifdef CONFIG_BLERPC_CENTRAL_L2CAP
+/* Bulk channel SDU: transaction_id(1) || payload, the payload being exactly
+ * what the GATT path carries in containers */
+#define BULK_SDU_HEADER_SIZE 1
+
+NET_BUF_POOL_FIXED_DEFINE(bulk_rx_pool, CONFIG_BT_MAX_CONN,
+                          BT_L2CAP_SDU_BUF_SIZE(CONFIG_BLERPC_CENTRAL_L2CAP_MTU), 8, NULL);
+/* Requests are sent one at a time (blerpc_rpc holds its send mutex) */
+NET_BUF_POOL_FIXED_DEFINE(bulk_tx_pool, 1, BT_L2CAP_SDU_BUF_SIZE(CONFIG_BLERPC_CENTRAL_L2CAP_MTU),
+                          CONFIG_BT_CONN_TX_USER_DATA_SIZE, NULL);
+
+static struct blerpc_conn *bulk_link(struct bt_l2cap_chan *chan)
+{
+    return CONTAINER_OF(BT_L2CAP_LE_CHAN(chan), struct blerpc_conn, bulk_chan);
+}
+
+static void bulk_connected(struct bt_l2cap_chan *chan)
+{
+    struct blerpc_conn *link = bulk_link(chan);
+    link->bulk_connected = true;
+    LOG_INF("Bulk channel open (link %u, tx mtu %u, rx mtu %u)",
+            (unsigned int)(link - links), link->bulk_chan.tx.mtu, link->bulk_chan.rx.mtu);
+    k_sem_give(&link->bulk_sem);
+}
+
+static void bulk_disconnected(struct bt_l2cap_chan *chan)
+{
+    struct blerpc_conn *link = bulk_link(chan);
+    link->bulk_connected = false;
+    LOG_INF("Bulk channel closed (link %u)", (unsigned int)(link - links));
+    k_sem_give(&link->bulk_sem);
+}
+
+static void bulk_sent(struct bt_l2cap_chan *chan)
+{
+    k_sem_give(&bulk_link(chan)->bulk_sem);
+}
+
+static struct net_buf *bulk_alloc_buf(struct bt_l2cap_chan *chan)
+{
+    (void)chan;
+    return net_buf_alloc(&bulk_rx_pool, K_NO_WAIT);
+}
+
+/* One SDU is one whole response: no reassembly needed */
+static int bulk_recv(struct bt_l2cap_chan *chan, struct net_buf *buf)
+{
+    struct blerpc_conn *link = bulk_link(chan);
+
+    if (buf->len <= BULK_SDU_HEADER_SIZE) {
+        return 0;
+    }
+    CENTRAL_STATS_INC(notifications);
+    CENTRAL_STATS_ADD(bytes_in, buf->len);
+    uint8_t transaction_id = net_buf_pull_u8(buf);
+
+#ifdef CONFIG_BLERPC_ENCRYPTION
+    if (link->encryption_active) {
+        /* Runs on the BT RX thread like notify_handler(), one SDU at a time */
+        static uint8_t decrypted[CONFIG_BLERPC_CENTRAL_L2CAP_MTU];
+        size_t decrypted_len;
+        if (blerpc_crypto_session_decrypt(&link->crypto_session, decrypted, sizeof(decrypted),
+                                          &decrypted_len, buf->data, buf->len) != 0) {
+            LOG_ERR("Response decryption failed");
+            CENTRAL_STATS_INC(decrypt_failures);
+            return 0;
+        }
+        if (response_cb) {
+            response_cb(link, transaction_id, decrypted, decrypted_len);
+        }
+        return 0;
+    }
+#endif
+    if (response_cb) {
+        response_cb(link, transaction_id, buf->data, buf->len);
+    }
+    return 0;
+}
+
+static const struct bt_l2cap_chan_ops bulk_ops = {
+    .connected = bulk_connected,
+    .disconnected = bulk_disconnected,
+    .sent = bulk_sent,
+    .alloc_buf = bulk_alloc_buf,
+    .recv = bulk_recv,
+};
+#endif /* CONFIG_BLERPC_CENTRAL_L2CAP */
+
 /* ── Public API ──────────────────────────────────────────────────────── */
 
 void ble_central_init(ble_central_response_cb_t resp_cb, ble_central_error_cb_t err_cb)
 {
     response_cb = resp_cb;
     error_cb = err_cb;
-    container_assembler_init(&assembler);
+    for (size_t i = 0; i < ARRAY_SIZE(links); i++) {
+        k_sem_init(&links[i].discover_sem, 0, 1);
+        k_sem_init(&links[i].mtu_sem, 0, 1);
+        k_sem_init(&links[i].subscribe_sem, 0, 1);
+        k_sem_init(&links[i].phy_sem, 0, 1);
+        k_sem_init(&links[i].caps_sem, 0, 1);
+        k_sem_init(&links[i].stats_sem, 0, 1);
+#ifdef CONFIG_BLERPC_CENTRAL_L2CAP
+        k_sem_init(&links[i].bulk_sem, 0, 1);
+        k_sem_init(&links[i].writes_idle, 0, 1);
+#endif
+#ifdef CONFIG_BLERPC_ENCRYPTION
+        k_sem_init(&links[i].kx_sem, 0, 1);
+#endif
+#ifdef CONFIG_BLERPC_CENTRAL_FAST_CONNECT
+        k_work_init(&links[i].cache_work, cache_work_handler);
+#endif
+        link_reset(&links[i]);
+    }
+#if defined(CONFIG_BLERPC_CENTRAL_STATS) && defined(CONFIG_STATS)
+    if (STATS_INIT_AND_REG(central_stats, STATS_SIZE_32, "ble_central") != 0) {
+        LOG_WRN("Stats group registration failed");
+    }
+#endif
+}
+
+/* Link tuning: fastest PHY the link can sustain, then the longest data
+ * length. The connection interval was already set at connect time.
+ * Returns true if a PHY update is pending, for link_tune_finish(). */
+static bool link_tune_start(struct blerpc_conn *link)
+{
+    bool phy_pending = false;
+    int err;
+
+#ifdef CONFIG_BT_USER_PHY_UPDATE
+    const struct bt_conn_le_phy_param *phy = BT_CONN_LE_PHY_PARAM_2M;
+    if (IS_ENABLED(CONFIG_BT_CTLR_PHY_CODED) &&
+        link->rssi < CONFIG_BLERPC_CENTRAL_CODED_PHY_RSSI) {
+        LOG_INF("Weak link (RSSI %d), requesting coded PHY", link->rssi);
+        phy = BT_CONN_LE_PHY_PARAM_CODED;
+    }
+    k_sem_reset(&link->phy_sem);
+    err = bt_conn_le_phy_update(link->conn, phy);
+    if (err) {
+        LOG_WRN("PHY update failed (err %d), continuing", err);
+    } else {
+        phy_pending = true;
+    }
+#endif
+
+    /* The maximum TX time also covers 251 octets on coded PHY */
+    err = bt_conn_le_data_len_update(link->conn, BT_LE_DATA_LEN_PARAM_MAX);
+    if (err) {
+        LOG_WRN("Data length update failed (err %d), continuing", err);
+    }
+    return phy_pending;
 }
 
-int ble_central_connect(void)
+static void link_tune_finish(struct blerpc_conn *link, bool phy_pending)
+{
+#ifdef CONFIG_BT_USER_PHY_UPDATE
+    if (phy_pending && k_sem_take(&link->phy_sem, K_SECONDS(2)) != 0) {
+        LOG_WRN("PHY update timed out, continuing");
+    }
+#else
+    ARG_UNUSED(link);
+    ARG_UNUSED(phy_pending);
+#endif
+}
+
+/* Bring a freshly connected link up to the point where RPCs can be sent.
+ * The MTU exchange and the PHY and data length updates are started first
+ * and waited for last: ATT runs the MTU exchange ahead of the discovery
+ * and CCC write queued behind it, while the link layer procedures run
+ * alongside all three. */
+static int link_setup(struct blerpc_conn *link)
 {
     int err;
 
+    k_sem_reset(&link->mtu_sem);
+    link->mtu_exchange_params.func = mtu_exchange_cb;
+    err = bt_gatt_exchange_mtu(link->conn, &link->mtu_exchange_params);
+    if (err) {
+        LOG_ERR("MTU exchange request failed (err %d)", err);
+    }
+    bool mtu_pending = err == 0;
+    bool phy_pending = link_tune_start(link);
+
+    bool subscribed = false;
+#ifdef CONFIG_BLERPC_CENTRAL_FAST_CONNECT
+    subscribed = cache_setup(link);
+#endif
+    if (!subscribed) {
+        k_sem_reset(&link->discover_sem);
+        err = gatt_discover(link);
+        if (err) {
+            return err;
+        }
+        err = subscribe(link);
+        if (err) {
+            return err;
+        }
+    }
+    LOG_INF("Subscribed to notifications");
+
+    if (mtu_pending) {
+        k_sem_take(&link->mtu_sem, K_SECONDS(5));
+    }
+    link_tune_finish(link, phy_pending);
+    return 0;
+}
+
+/* Scan for a new blerpc peripheral and connect to the first one found */
+static int scan_connect(struct blerpc_conn *link, k_timeout_t timeout)
+{
     LOG_INF("Scanning for blerpc peripheral...");
 
-    err = bt_le_scan_start(BT_LE_SCAN_ACTIVE, device_found);
+    k_sem_reset(&connect_sem);
+    int err = bt_le_scan_start(BT_LE_SCAN_ACTIVE, device_found);
     if (err) {
         LOG_ERR("Scan start failed (err %d)", err);
         return err;
     }
 
     /* Wait for connection */
-    if (k_sem_take(&connect_sem, BLE_OP_TIMEOUT) != 0) {
-        LOG_ERR("Connection timed out");
+    if (k_sem_take(&connect_sem, timeout) != 0) {
         bt_le_scan_stop();
+        if (!link->conn) {
+            LOG_INF("No new blerpc peripheral found");
+            return -ETIMEDOUT;
+        }
+        /* Created but never completed: give up on it */
+        LOG_ERR("Connection timed out");
+        bt_conn_disconnect(link->conn, BT_HCI_ERR_REMOTE_USER_TERM_CONN);
         return -ETIMEDOUT;
     }
 
-    if (!current_conn) {
+    if (!link->conn) {
         LOG_ERR("Connection failed");
         return -ENOTCONN;
     }
+    return 0;
+}
 
-    /* Request data length update */
-    struct bt_conn_le_data_len_param dl_param = {
-        .tx_max_len = 251,
-        .tx_max_time = 2120,
-    };
-    err = bt_conn_le_data_len_update(current_conn, &dl_param);
+#ifdef CONFIG_BLERPC_CENTRAL_FAST_CONNECT
+/* Connect to whichever cached peripheral without a link advertises first,
+ * letting the controller match addresses from the filter accept list
+ * instead of scanning and parsing advertisements here.
+ * @return 0 once connected, -ENOENT if no cached peripheral is left to
+ *         try, -ETIMEDOUT if none showed up in time
+ */
+static int fal_connect(struct blerpc_conn *link)
+{
+    bt_addr_le_t addrs[CONFIG_BLERPC_CENTRAL_FAST_CONNECT_CACHE_SIZE];
+    size_t n = gatt_cache_addrs(addrs, ARRAY_SIZE(addrs));
+    size_t listed = 0;
+
+    if (n == 0) {
+        return -ENOENT;
+    }
+    int err = bt_le_filter_accept_list_clear();
     if (err) {
-        LOG_WRN("Data length update failed (err %d), continuing", err);
+        LOG_WRN("Accept list clear failed (err %d)", err);
+        return err;
+    }
+    for (size_t i = 0; i < n; i++) {
+        struct bt_conn *existing = bt_conn_lookup_addr_le(BT_ID_DEFAULT, &addrs[i]);
+        if (existing) {
+            bt_conn_unref(existing);
+            continue;
+        }
+        if (bt_le_filter_accept_list_add(&addrs[i]) == 0) {
+            listed++;
+        }
+    }
+    if (listed == 0) {
+        return -ENOENT;
     }
 
-    /* Exchange MTU */
-    mtu_exchange_params.func = mtu_exchange_cb;
-    err = bt_gatt_exchange_mtu(current_conn, &mtu_exchange_params);
+    LOG_INF("Connecting to %zu cached peripheral(s)...", listed);
+    k_sem_reset(&connect_sem);
+    connecting_auto = true;
+    err = bt_conn_le_create_auto(&link_create_param, &link_conn_param);
     if (err) {
-        LOG_ERR("MTU exchange request failed (err %d)", err);
-    } else {
-        k_sem_take(&mtu_sem, K_SECONDS(5));
+        LOG_WRN("Accept list connect failed (err %d)", err);
+        connecting_auto = false;
+        return err;
     }
 
-    /* GATT discovery */
-    err = gatt_discover();
+    if (k_sem_take(&connect_sem, K_MSEC(CONFIG_BLERPC_CENTRAL_FAST_CONNECT_TIMEOUT_MS)) != 0) {
+        if (bt_conn_create_auto_stop() == 0) {
+            /* Its failure report, if one follows, finds no link */
+            connecting_auto = false;
+            LOG_INF("No cached peripheral in range");
+            return -ETIMEDOUT;
+        }
+        /* Too late to stop: the connection is completing */
+        k_sem_take(&connect_sem, BLE_OP_TIMEOUT);
+    }
+    connecting_auto = false;
+    if (!link->conn) {
+        return -ENOTCONN;
+    }
+
+    /* No advertisement was seen: tune the PHY by the last one */
+    struct gatt_cache_record rec;
+    if (gatt_cache_lookup(bt_conn_get_dst(link->conn), &rec)) {
+        link->rssi = rec.rssi;
+    }
+    return 0;
+}
+#endif
+
+int ble_central_connect(k_timeout_t timeout, ble_central_conn_t **out)
+{
+    int err;
+
+    k_mutex_lock(&connect_mutex, K_FOREVER);
+
+    struct blerpc_conn *link = link_alloc();
+    if (!link) {
+        k_mutex_unlock(&connect_mutex);
+        return -ENOMEM;
+    }
+
+    connecting = link;
+    link->rssi = 0;
+
+#ifdef CONFIG_BLERPC_CENTRAL_FAST_CONNECT
+    err = fal_connect(link);
+    if (err != 0 && !link->conn)
+#endif
+    {
+        err = scan_connect(link, timeout);
+        if (err) {
+            goto out;
+        }
+    }
+
+    err = link_setup(link);
     if (err) {
-        return err;
+        bt_conn_disconnect(link->conn, BT_HCI_ERR_REMOTE_USER_TERM_CONN);
+        goto out;
     }
 
-    /* Subscribe for notifications */
-    subscribe_params.notify = notify_handler;
-    err = bt_gatt_subscribe(current_conn, &subscribe_params);
+    link->ready = true;
+    *out = link;
+
+out:
+    connecting = NULL;
+    k_mutex_unlock(&connect_mutex);
+    return err;
+}
+
+size_t ble_central_conn_count(void)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < ARRAY_SIZE(links); i++) {
+        if (links[i].ready) {
+            n++;
+        }
+    }
+    return n;
+}
+
+ble_central_conn_t *ble_central_conn_get(size_t index)
+{
+    if (index >= ARRAY_SIZE(links) || !links[index].ready) {
+        return NULL;
+    }
+    return &links[index];
+}
+
+size_t ble_central_conn_index(const ble_central_conn_t *conn)
+{
+    return (size_t)(conn - links);
+}
+
+void ble_central_get_link_params(ble_central_conn_t *conn, struct ble_central_link_params *out)
+{
+    *out = conn->params;
+}
+
+int ble_central_set_link_profile(ble_central_conn_t *conn, enum ble_central_link_profile profile)
+{
+    if (!conn->conn) {
+        return -ENOTCONN;
+    }
+
+    struct bt_le_conn_param param;
+    switch (profile) {
+    case BLE_CENTRAL_PROFILE_THROUGHPUT:
+        param = (struct bt_le_conn_param)BT_LE_CONN_PARAM_INIT(
+            CONFIG_BLERPC_CENTRAL_CONN_INTERVAL, CONFIG_BLERPC_CENTRAL_CONN_INTERVAL, 0, 100);
+        break;
+    case BLE_CENTRAL_PROFILE_LOW_POWER: {
+        /* Supervision timeout (10 ms units) of about four skipped intervals'
+         * worth of time, never below the throughput profile's 1 s */
+        uint32_t timeout = (1 + CONFIG_BLERPC_CENTRAL_LOW_POWER_LATENCY) *
+                           CONFIG_BLERPC_CENTRAL_LOW_POWER_CONN_INTERVAL / 2;
+        param = (struct bt_le_conn_param)BT_LE_CONN_PARAM_INIT(
+            CONFIG_BLERPC_CENTRAL_LOW_POWER_CONN_INTERVAL,
+            CONFIG_BLERPC_CENTRAL_LOW_POWER_CONN_INTERVAL,
+            CONFIG_BLERPC_CENTRAL_LOW_POWER_LATENCY, CLAMP(timeout, 100, 3200));
+        break;
+    }
+    default:
+        return -EINVAL;
+    }
+
+    return bt_conn_le_param_update(conn->conn, &param);
+}
+
+int ble_central_set_conn_interval(ble_central_conn_t *conn, uint16_t interval)
+{
+    if (!conn->conn) {
+        return -ENOTCONN;
+    }
+
+    /* Eight intervals of 1.25 ms are interval in 10 ms units; never below
+     * the throughput profile's 1 s supervision timeout */
+    struct bt_le_conn_param param =
+        BT_LE_CONN_PARAM_INIT(interval, interval, 0, CLAMP(interval, 100, 3200));
+    return bt_conn_le_param_update(conn->conn, &param);
+}
+
+int ble_central_set_phy(ble_central_conn_t *conn, uint8_t phy)
+{
+#ifdef CONFIG_BT_USER_PHY_UPDATE
+    if (!conn->conn) {
+        return -ENOTCONN;
+    }
+
+    const struct bt_conn_le_phy_param param = BT_CONN_LE_PHY_PARAM_INIT(phy, phy);
+    k_sem_reset(&conn->phy_sem);
+    int err = bt_conn_le_phy_update(conn->conn, &param);
     if (err) {
-        LOG_ERR("Subscribe failed (err %d)", err);
         return err;
     }
-
-    LOG_INF("Subscribed to notifications");
+    if (k_sem_take(&conn->phy_sem, K_SECONDS(2)) != 0) {
+        return -ETIMEDOUT;
+    }
     return 0;
+#else
+    (void)conn;
+    (void)phy;
+    return -ENOTSUP;
+#endif
+}
+
+void ble_central_set_mtu_limit(ble_central_conn_t *conn, uint16_t mtu)
+{
+    conn->mtu_limit = mtu;
+}
+
+#ifdef CONFIG_BLERPC_CENTRAL_L2CAP
+static void write_sent(struct bt_conn *conn, void *user_data)
+{
+    struct blerpc_conn *link = user_data;
+
+    (void)conn;
+    if (atomic_dec(&link->writes_pending) <= 1) {
+        k_sem_give(&link->writes_idle);
+    }
 }
 
-int ble_central_write(const uint8_t *data, size_t len)
+/* Wait until every GATT write queued on link has been sent */
+static int writes_drain(struct blerpc_conn *link, k_timeout_t timeout)
 {
-    if (!current_conn) {
+    k_sem_reset(&link->writes_idle);
+    if (atomic_get(&link->writes_pending) <= 0) {
+        return 0;
+    }
+    return k_sem_take(&link->writes_idle, timeout) == 0 ? 0 : -EAGAIN;
+}
+#endif
+
+int ble_central_write(ble_central_conn_t *conn, const uint8_t *data, size_t len)
+{
+    if (!conn->conn) {
         return -ENOTCONN;
     }
 
-    return bt_gatt_write_without_response(current_conn, char_value_handle, data, len, false);
+#ifdef CONFIG_BLERPC_CENTRAL_L2CAP
+    /* Tracked so a bulk SDU cannot overtake writes still queued */
+    atomic_inc(&conn->writes_pending);
+    int err = bt_gatt_write_without_response_cb(conn->conn, conn->char_value_handle, data, len,
+                                                false, write_sent, conn);
+    if (err) {
+        write_sent(conn->conn, conn);
+    }
+#else
+    int err = bt_gatt_write_without_response(conn->conn, conn->char_value_handle, data, len, false);
+#endif
+    if (err) {
+        CENTRAL_STATS_INC(write_failures);
+    } else {
+        CENTRAL_STATS_INC(writes);
+        CENTRAL_STATS_ADD(bytes_out, len);
+    }
+    return err;
 }
 
-int ble_central_encrypt_payload(const uint8_t *plaintext, size_t plaintext_len, uint8_t *out,
-                                size_t out_size, size_t *out_len)
+int ble_central_encrypt_payload(ble_central_conn_t *conn, const uint8_t *plaintext,
+                                size_t plaintext_len, uint8_t *out, size_t out_size,
+                                size_t *out_len)
 {
 #ifdef CONFIG_BLERPC_ENCRYPTION
-    if (encryption_active) {
-        return blerpc_crypto_session_encrypt(&crypto_session, out, out_size, out_len, plaintext,
-                                             plaintext_len);
+    if (conn->encryption_active) {
+        return blerpc_crypto_session_encrypt(&conn->crypto_session, out, out_size, out_len,
+                                             plaintext, plaintext_len);
     }
+#else
+    (void)conn;
 #endif
     if (plaintext_len > out_size) {
         return -ENOMEM;
@@ -482,17 +1322,137 @@ int ble_central_encrypt_payload(const uint8_t *plaintext, size_t plaintext_len,
     return 0;
 }
 
-uint16_t ble_central_get_mtu(void)
+int ble_central_encrypt_begin(ble_central_conn_t *conn, struct stream_crypto_tx *tx,
+                              size_t plaintext_len, uint8_t *counter_out)
 {
-    if (current_conn) {
-        return bt_gatt_get_mtu(current_conn);
+#ifdef CONFIG_BLERPC_ENCRYPTION
+    if (!conn->encryption_active) {
+        return -ENOTSUP;
+    }
+    if (stream_crypto_tx_begin(tx, &conn->crypto_session, STREAM_CRYPTO_DIRECTION_C2P,
+                               plaintext_len, counter_out) != 0) {
+        return -EIO;
+    }
+    return 0;
+#else
+    (void)conn;
+    (void)tx;
+    (void)plaintext_len;
+    (void)counter_out;
+    return -ENOTSUP;
+#endif
+}
+
+int ble_central_bulk_open(ble_central_conn_t *conn)
+{
+#ifdef CONFIG_BLERPC_CENTRAL_L2CAP
+    if (!conn->conn) {
+        return -ENOTCONN;
+    }
+    if (!(conn->capability_flags & CAPABILITY_FLAG_L2CAP_SUPPORTED) || conn->bulk_psm == 0) {
+        return -ENOTSUP;
+    }
+    if (conn->bulk_connected) {
+        return 0;
+    }
+
+    memset(&conn->bulk_chan, 0, sizeof(conn->bulk_chan));
+    conn->bulk_chan.chan.ops = &bulk_ops;
+    conn->bulk_chan.rx.mtu = CONFIG_BLERPC_CENTRAL_L2CAP_MTU;
+
+    k_sem_reset(&conn->bulk_sem);
+    int err = bt_l2cap_chan_connect(conn->conn, &conn->bulk_chan.chan, conn->bulk_psm);
+    if (err) {
+        LOG_ERR("Bulk channel connect failed (err %d)", err);
+        return err;
+    }
+    if (k_sem_take(&conn->bulk_sem, BLE_OP_TIMEOUT) != 0) {
+        LOG_ERR("Bulk channel connect timed out");
+        bt_l2cap_chan_disconnect(&conn->bulk_chan.chan);
+        return -ETIMEDOUT;
+    }
+    return conn->bulk_connected ? 0 : -ECONNREFUSED;
+#else
+    (void)conn;
+    return -ENOTSUP;
+#endif
+}
+
+size_t ble_central_bulk_max_payload(ble_central_conn_t *conn)
+{
+#ifdef CONFIG_BLERPC_CENTRAL_L2CAP
+    if (conn->bulk_connected) {
+        return MIN(conn->bulk_chan.tx.mtu, CONFIG_BLERPC_CENTRAL_L2CAP_MTU) -
+               BULK_SDU_HEADER_SIZE;
+    }
+#else
+    (void)conn;
+#endif
+    return 0;
+}
+
+int ble_central_bulk_send(ble_central_conn_t *conn, uint8_t transaction_id,
+                          const uint8_t *payload, size_t len)
+{
+#ifdef CONFIG_BLERPC_CENTRAL_L2CAP
+    if (!conn->bulk_connected) {
+        return -ENOTCONN;
+    }
+    if (len > ble_central_bulk_max_payload(conn)) {
+        return -EMSGSIZE;
+    }
+
+    struct net_buf *buf = net_buf_alloc(&bulk_tx_pool, BLE_OP_TIMEOUT);
+    if (!buf) {
+        return -ENOMEM;
+    }
+    /* The stack interleaves ATT and bulk channel PDUs: let queued writes go
+     * first, or the peripheral could see encrypted payloads out of order */
+    if (writes_drain(conn, BLE_OP_TIMEOUT) != 0) {
+        LOG_ERR("GATT writes did not drain before bulk send");
+        net_buf_unref(buf);
+        return -EAGAIN;
+    }
+    net_buf_reserve(buf, BT_L2CAP_SDU_CHAN_SEND_RESERVE);
+    net_buf_add_u8(buf, transaction_id);
+    net_buf_add_mem(buf, payload, len);
+
+    k_sem_reset(&conn->bulk_sem);
+    int err = bt_l2cap_chan_send(&conn->bulk_chan.chan, buf);
+    if (err < 0) {
+        LOG_ERR("Bulk send failed (err %d)", err);
+        CENTRAL_STATS_INC(write_failures);
+        net_buf_unref(buf);
+        return err;
+    }
+    CENTRAL_STATS_INC(writes);
+    CENTRAL_STATS_ADD(bytes_out, BULK_SDU_HEADER_SIZE + len);
+    /* Likewise hold later writes back until the SDU is out */
+    if (k_sem_take(&conn->bulk_sem, BLE_OP_TIMEOUT) != 0) {
+        return -ETIMEDOUT;
+    }
+    return conn->bulk_connected ? 0 : -ENOTCONN;
+#else
+    (void)conn;
+    (void)transaction_id;
+    (void)payload;
+    (void)len;
+    return -ENOTSUP;
+#endif
+}
+
+uint16_t ble_central_get_mtu(ble_central_conn_t *conn)
+{
+    if (conn->conn) {
+        uint16_t mtu = bt_gatt_get_mtu(conn->conn);
+        return conn->mtu_limit ? MIN(mtu, conn->mtu_limit) : mtu;
     }
     return 23;
 }
 
-int ble_central_request_capabilities(void)
+int ble_central_request_capabilities(ble_central_conn_t *conn)
 {
-    uint8_t ctrl_buf[8];
+    uint8_t ctrl_buf[CONTAINER_CONTROL_HEADER_SIZE + 4];
     struct container_header ctrl = {
         .transaction_id = 0,
         .sequence_number = 0,
@@ -501,18 +1461,40 @@ int ble_central_request_capabilities(void)
         .payload_len = 0,
     };
     ctrl.payload = NULL;
+#ifdef CONFIG_BLERPC_COMPRESSION
+    /* Our flags(2) and the largest response data we expand(2), so the
+     * peripheral may compress responses */
+    uint8_t central_caps[4] = {
+        (uint8_t)(CAPABILITY_FLAG_COMPRESSION & 0xFF),
+        (uint8_t)(CAPABILITY_FLAG_COMPRESSION >> 8),
+        (uint8_t)(CONFIG_BLERPC_COMPRESSION_BUF_SIZE & 0xFF),
+        (uint8_t)(CONFIG_BLERPC_COMPRESSION_BUF_SIZE >> 8),
+    };
+    ctrl.payload = central_caps;
+    ctrl.payload_len = sizeof(central_caps);
+#endif
     int n = container_serialize(&ctrl, ctrl_buf, sizeof(ctrl_buf));
     if (n < 0) {
         return -EINVAL;
     }
 
-    int err = ble_central_write(ctrl_buf, (size_t)n);
+    k_sem_reset(&conn->caps_sem);
+    int err = ble_central_write(conn, ctrl_buf, (size_t)n);
     if (err) {
         return err;
     }
 
+#ifdef CONFIG_BLERPC_CENTRAL_FAST_CONNECT
+    /* The cached capabilities stand in until the reply refreshes them, with
+     * commands sent by name until it confirms the schema hash. The request
+     * goes out all the same: it carries our own flags */
+    if (conn->cache_hit) {
+        return 0;
+    }
+#endif
+
     /* Wait up to 1 second for response */
-    err = k_sem_take(&caps_sem, K_SECONDS(1));
+    err = k_sem_take(&conn->caps_sem, K_SECONDS(1));
     if (err) {
         return -ETIMEDOUT;
     }
@@ -520,32 +1502,91 @@ int ble_central_request_capabilities(void)
     return 0;
 }
 
-uint16_t ble_central_get_max_request_payload_size(void)
+int ble_central_request_stats(ble_central_conn_t *conn, uint8_t page, uint8_t *buf, size_t size,
+                              size_t *out_len)
+{
+    if (!(conn->capability_flags & CAPABILITY_FLAG_STATS)) {
+        return -ENOTSUP;
+    }
+
+    uint8_t ctrl_buf[CONTAINER_CONTROL_HEADER_SIZE + 1];
+    struct container_header ctrl = {
+        .transaction_id = 0,
+        .sequence_number = 0,
+        .type = CONTAINER_TYPE_CONTROL,
+        .control_cmd = CONTROL_CMD_STATS,
+        .payload_len = 1,
+        .payload = &page,
+    };
+    int n = container_serialize(&ctrl, ctrl_buf, sizeof(ctrl_buf));
+    if (n < 0) {
+        return -EINVAL;
+    }
+
+    k_sem_reset(&conn->stats_sem);
+    conn->stats_size = size;
+    conn->stats_len = 0;
+    conn->stats_buf = buf;
+    int err = ble_central_write(conn, ctrl_buf, (size_t)n);
+    if (err == 0 && k_sem_take(&conn->stats_sem, K_SECONDS(1)) != 0) {
+        err = -ETIMEDOUT;
+    }
+    /* A late reply must not land in the caller's buffer */
+    conn->stats_buf = NULL;
+    if (err) {
+        return err;
+    }
+    *out_len = conn->stats_len;
+    return 0;
+}
+
+void ble_central_get_stats(struct ble_central_stats *out)
+{
+#ifdef CONFIG_BLERPC_CENTRAL_STATS
+#define CENTRAL_STATS_COPY(name) out->name = central_stats.name;
+    BLE_CENTRAL_STATS_COUNTERS(CENTRAL_STATS_COPY)
+#undef CENTRAL_STATS_COPY
+#else
+    memset(out, 0, sizeof(*out));
+#endif
+}
+
+uint16_t ble_central_get_max_request_payload_size(ble_central_conn_t *conn)
+{
+    return conn->max_request_payload_size;
+}
+
+uint16_t ble_central_get_max_response_payload_size(ble_central_conn_t *conn)
 {
-    return max_request_payload_size;
+    return conn->max_response_payload_size;
 }
 
-uint16_t ble_central_get_max_response_payload_size(void)
+uint16_t ble_central_get_capability_flags(ble_central_conn_t *conn)
 {
-    return max_response_payload_size;
+    return conn->capability_flags;
 }
 
-uint16_t ble_central_get_capability_flags(void)
+uint16_t ble_central_get_schema_hash(ble_central_conn_t *conn)
 {
-    return capability_flags;
+    return conn->schema_hash;
+}
+
+uint16_t ble_central_get_inflate_limit(ble_central_conn_t *conn)
+{
+    return conn->inflate_limit;
 }
 
 #ifdef CONFIG_BLERPC_ENCRYPTION
 
-static int kx_send_cb(const uint8_t *payload, size_t len, void *ctx)
+static int kx_send_control(struct blerpc_conn *link, uint8_t control_cmd,
+                           const uint8_t *payload, size_t len)
 {
-    (void)ctx;
-    uint8_t ctrl_buf[BLERPC_STEP2_SIZE + CONTAINER_CONTROL_HEADER_SIZE];
+    uint8_t ctrl_buf[KX_MSG_MAX_SIZE + CONTAINER_CONTROL_HEADER_SIZE];
     struct container_header ctrl = {
         .transaction_id = 0,
         .sequence_number = 0,
         .type = CONTAINER_TYPE_CONTROL,
-        .control_cmd = CONTROL_CMD_KEY_EXCHANGE,
+        .control_cmd = control_cmd,
         .payload_len = len,
         .payload = payload,
     };
@@ -554,20 +1595,25 @@ static int kx_send_cb(const uint8_t *payload, size_t len, void *ctx)
         return -1;
     }
 
-    k_sem_reset(&kx_sem);
-    return ble_central_write(ctrl_buf, (size_t)n);
+    k_sem_reset(&link->kx_sem);
+    return ble_central_write(link, ctrl_buf, (size_t)n);
+}
+
+static int kx_send_cb(const uint8_t *payload, size_t len, void *ctx)
+{
+    return kx_send_control(ctx, CONTROL_CMD_KEY_EXCHANGE, payload, len);
 }
 
 static int kx_recv_cb(uint8_t *buf, size_t buf_size, size_t *out_len, void *ctx)
 {
-    (void)ctx;
-    int err = k_sem_take(&kx_sem, K_SECONDS(5));
+    struct blerpc_conn *link = ctx;
+    int err = k_sem_take(&link->kx_sem, K_SECONDS(5));
     if (err) {
         return -1;
     }
 
     struct container_header hdr;
-    if (container_parse_header(kx_response_buf, kx_response_len, &hdr) != 0) {
+    if (container_parse_header(link->kx_response_buf, link->kx_response_len, &hdr) != 0) {
         return -1;
     }
 
@@ -579,7 +1625,130 @@ static int kx_recv_cb(uint8_t *buf, size_t buf_size, size_t *out_len, void *ctx)
     return 0;
 }
 
-int ble_central_perform_key_exchange(void)
+#ifdef CONFIG_BLERPC_RESUMPTION
+
+/* Resumption tickets by peripheral address. Each is used once: taken out
+ * for a resumption attempt, and replaced by the one the peripheral returns. */
+struct resume_entry {
+    bt_addr_le_t addr;
+    int64_t last_used;
+    bool valid;
+    uint8_t secret[SESSION_RESUME_SECRET_SIZE];
+    uint8_t ticket[SESSION_RESUME_TICKET_SIZE];
+};
+
+static struct resume_entry resume_cache[CONFIG_BLERPC_RESUMPTION_CACHE_SIZE];
+static K_MUTEX_DEFINE(resume_lock);
+
+/* Move addr's ticket and secret out of the cache; false if it has none */
+static bool resume_take(const bt_addr_le_t *addr, uint8_t secret[SESSION_RESUME_SECRET_SIZE],
+                        uint8_t ticket[SESSION_RESUME_TICKET_SIZE])
+{
+    bool found = false;
+
+    k_mutex_lock(&resume_lock, K_FOREVER);
+    for (size_t i = 0; i < ARRAY_SIZE(resume_cache); i++) {
+        struct resume_entry *e = &resume_cache[i];
+        if (e->valid && bt_addr_le_cmp(&e->addr, addr) == 0) {
+            memcpy(secret, e->secret, SESSION_RESUME_SECRET_SIZE);
+            memcpy(ticket, e->ticket, SESSION_RESUME_TICKET_SIZE);
+            mbedtls_platform_zeroize(e, sizeof(*e));
+            found = true;
+            break;
+        }
+    }
+    k_mutex_unlock(&resume_lock);
+    return found;
+}
+
+static void resume_store(const bt_addr_le_t *addr, const uint8_t secret[SESSION_RESUME_SECRET_SIZE],
+                         const uint8_t ticket[SESSION_RESUME_TICKET_SIZE])
+{
+    k_mutex_lock(&resume_lock, K_FOREVER);
+    struct resume_entry *slot = &resume_cache[0];
+    for (size_t i = 0; i < ARRAY_SIZE(resume_cache); i++) {
+        struct resume_entry *e = &resume_cache[i];
+        if (!e->valid || bt_addr_le_cmp(&e->addr, addr) == 0) {
+            slot = e;
+            break;
+        }
+        if (e->last_used < slot->last_used) {
+            slot = e;
+        }
+    }
+    bt_addr_le_copy(&slot->addr, addr);
+    memcpy(slot->secret, secret, SESSION_RESUME_SECRET_SIZE);
+    memcpy(slot->ticket, ticket, SESSION_RESUME_TICKET_SIZE);
+    slot->last_used = k_uptime_get();
+    slot->valid = true;
+    k_mutex_unlock(&resume_lock);
+}
+
+/* Rekey from a cached ticket. Nonzero if there is none or the peripheral
+ * refuses it; the caller then runs a full key exchange. */
+static int resume_session(struct blerpc_conn *link)
+{
+    const bt_addr_le_t *addr = bt_conn_get_dst(link->conn);
+    uint8_t hello[SESSION_RESUME_HELLO_SIZE];
+    uint8_t secret[SESSION_RESUME_SECRET_SIZE];
+    uint8_t reply[SESSION_RESUME_ACCEPT_SIZE];
+    size_t reply_len;
+    struct session_resume_keys keys;
+    int rc = -EACCES;
+
+    if (!resume_take(addr, secret, hello + 1)) {
+        return -ENOENT;
+    }
+    hello[0] = SESSION_RESUME_OP_HELLO;
+    uint8_t *nonce_c = hello + 1 + SESSION_RESUME_TICKET_SIZE;
+
+    if (psa_generate_random(nonce_c, SESSION_RESUME_NONCE_SIZE) != PSA_SUCCESS ||
+        kx_send_control(link, CONTROL_CMD_RESUME, hello, sizeof(hello)) != 0 ||
+        kx_recv_cb(reply, sizeof(reply), &reply_len, link) != 0) {
+        rc = -EIO;
+    } else if (reply_len < SESSION_RESUME_ACCEPT_MIN_SIZE ||
+               reply[0] != SESSION_RESUME_OP_ACCEPT) {
+        LOG_INF("Peripheral refused resumption");
+    } else if (session_resume_derive(secret, nonce_c, reply + 1, &keys) != 0 ||
+               !session_resume_confirm_ok(&keys, reply + 1 + SESSION_RESUME_NONCE_SIZE)) {
+        LOG_WRN("Resumption confirm mismatch");
+    } else if (session_resume_start(&link->crypto_session, &keys, true) == 0) {
+        if (reply_len == SESSION_RESUME_ACCEPT_SIZE) {
+            resume_store(addr, keys.next_secret, reply + SESSION_RESUME_ACCEPT_MIN_SIZE);
+        }
+        rc = 0;
+    }
+    mbedtls_platform_zeroize(secret, sizeof(secret));
+    mbedtls_platform_zeroize(&keys, sizeof(keys));
+    return rc;
+}
+
+/* After a full key exchange, before any request: ask for the first ticket
+ * of a chain. Failure only costs the next connection its shortcut. */
+static void resume_fetch_ticket(struct blerpc_conn *link)
+{
+    uint8_t op = SESSION_RESUME_OP_TICKET_REQUEST;
+    uint8_t reply[SESSION_RESUME_TICKET_MSG_SIZE];
+    uint8_t plain[SESSION_RESUME_SECRET_SIZE + SESSION_RESUME_TICKET_SIZE];
+    size_t reply_len;
+    size_t plain_len;
+
+    if (kx_send_control(link, CONTROL_CMD_RESUME, &op, 1) != 0 ||
+        kx_recv_cb(reply, sizeof(reply), &reply_len, link) != 0 || reply_len < 1 ||
+        reply[0] != SESSION_RESUME_OP_TICKET ||
+        blerpc_crypto_session_decrypt(&link->crypto_session, plain, sizeof(plain), &plain_len,
+                                      reply + 1, reply_len - 1) != 0 ||
+        plain_len != sizeof(plain)) {
+        LOG_WRN("No resumption ticket from the peripheral");
+        mbedtls_platform_zeroize(plain, sizeof(plain));
+        return;
+    }
+    resume_store(bt_conn_get_dst(link->conn), plain, plain + SESSION_RESUME_SECRET_SIZE);
+    mbedtls_platform_zeroize(plain, sizeof(plain));
+}
+#endif /* CONFIG_BLERPC_RESUMPTION */
+
+int ble_central_perform_key_exchange(ble_central_conn_t *conn)
 {
     /* PSA Crypto must be initialized before any PSA operations */
     psa_status_t psa_rc = psa_crypto_init();
@@ -588,30 +1757,46 @@ int ble_central_perform_key_exchange(void)
         return -EIO;
     }
 
-    int rc =
-        blerpc_central_perform_key_exchange(kx_send_cb, kx_recv_cb, NULL, &crypto_session, NULL);
+#ifdef CONFIG_BLERPC_RESUMPTION
+    bool resumable = conn->capability_flags & CAPABILITY_FLAG_RESUMPTION;
+    if (resumable && resume_session(conn) == 0) {
+        conn->encryption_active = true;
+        LOG_INF("E2E encryption resumed (link %u)", (unsigned int)ble_central_conn_index(conn));
+        return 0;
+    }
+#endif
+
+    int rc = blerpc_central_perform_key_exchange(kx_send_cb, kx_recv_cb, conn,
+                                                 &conn->crypto_session, NULL);
     if (rc != 0) {
         LOG_ERR("Key exchange failed: %d", rc);
         return -EACCES;
     }
 
-    encryption_active = true;
-    LOG_INF("E2E encryption established");
+    conn->encryption_active = true;
+    LOG_INF("E2E encryption established (link %u)", (unsigned int)ble_central_conn_index(conn));
+#ifdef CONFIG_BLERPC_RESUMPTION
+    if (resumable) {
+        resume_fetch_ticket(conn);
+    }
+#endif
     return 0;
 }
 #else
-int ble_central_perform_key_exchange(void)
+int ble_central_perform_key_exchange(ble_central_conn_t *conn)
 {
+    (void)conn;
     LOG_ERR("Encryption support not compiled in (CONFIG_BLERPC_ENCRYPTION)");
     return -ENOTSUP;
 }
 #endif /* CONFIG_BLERPC_ENCRYPTION */
 
-bool ble_central_is_encrypted(void)
+bool ble_central_is_encrypted(ble_central_conn_t *conn)
 {
 #ifdef CONFIG_BLERPC_ENCRYPTION
-    return encryption_active;
+    return conn->encryption_active;
 #else
+    (void)conn;
     return false;
 #endif
 }
@@ -621,7 +1806,7 @@ void ble_central_set_stream_end_cb(ble_central_stream_end_cb_t cb)
     stream_end_cb = cb;
 }
 
-int ble_central_send_stream_end_c2p(void)
+int ble_central_send_stream_end_c2p(ble_central_conn_t *conn)
 {
     uint8_t ctrl_buf[8];
     struct container_header ctrl = {
@@ -636,5 +1821,24 @@ int ble_central_send_stream_end_c2p(void)
     if (n < 0) {
         return -EINVAL;
     }
-    return ble_central_write(ctrl_buf, (size_t)n);
+    return ble_central_write(conn, ctrl_buf, (size_t)n);
+}
+
+int ble_central_send_stream_credit(ble_central_conn_t *conn, uint16_t credits, uint8_t flags)
+{
+    uint8_t ctrl_buf[CONTAINER_CONTROL_HEADER_SIZE + 3];
+    uint8_t payload[3] = {(uint8_t)(credits & 0xFF), (uint8_t)(credits >> 8), flags};
+    struct container_header ctrl = {
+        .transaction_id = 0,
+        .sequence_number = 0,
+        .type = CONTAINER_TYPE_CONTROL,
+        .control_cmd = CONTROL_CMD_STREAM_CREDIT,
+        .payload_len = sizeof(payload),
+        .payload = payload,
+    };
+    int n = container_serialize(&ctrl, ctrl_buf, sizeof(ctrl_buf));
+    if (n < 0) {
+        return -EINVAL;
+    }
+    return ble_central_write(conn, ctrl_buf, (size_t)n);
 }
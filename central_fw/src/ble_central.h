@@ -4,6 +4,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
+#include <zephyr/kernel.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -15,20 +16,115 @@ extern "C" {
 /* blerpc Characteristic UUID: 12340002-0000-1000-8000-00805f9b34fb */
 #define BLERPC_CHAR_UUID BT_UUID_128_ENCODE(0x12340002, 0x0000, 0x1000, 0x8000, 0x00805f9b34fb)
 
+/* Capability flag: the peripheral accepts a bulk L2CAP channel */
+#ifndef CAPABILITY_FLAG_L2CAP_SUPPORTED
+#define CAPABILITY_FLAG_L2CAP_SUPPORTED 0x0002
+#endif
+
+/* Capability flag: the peripheral accepts 1-byte command IDs */
+#ifndef CAPABILITY_FLAG_COMMAND_IDS
+#define CAPABILITY_FLAG_COMMAND_IDS 0x0004
+#endif
+
+/* Capability flag: the peripheral accepts batch requests */
+#ifndef CAPABILITY_FLAG_BATCH
+#define CAPABILITY_FLAG_BATCH 0x0008
+#endif
+
+/* Capability flag: the peripheral paces P→C streams by granted credits */
+#ifndef CAPABILITY_FLAG_STREAM_CREDITS
+#define CAPABILITY_FLAG_STREAM_CREDITS 0x0010
+#endif
+
+/* Control command granting P→C stream credits: credits(2 LE) flags(1) */
+#ifndef CONTROL_CMD_STREAM_CREDIT
+#define CONTROL_CMD_STREAM_CREDIT 7
+#endif
+
+/* Stream credit flag: stream messages may arrive coalesced in batch frames */
+#ifndef STREAM_CREDIT_FLAG_COALESCE
+#define STREAM_CREDIT_FLAG_COALESCE 0x01
+#endif
+
+/* Capability flag: the peripheral accepts coalesced C→P stream frames */
+#ifndef CAPABILITY_FLAG_STREAM_COALESCE
+#define CAPABILITY_FLAG_STREAM_COALESCE 0x0020
+#endif
+
+/* Capability flag: the peripheral answers CONTROL_CMD_STATS */
+#ifndef CAPABILITY_FLAG_STATS
+#define CAPABILITY_FLAG_STATS 0x0040
+#endif
+
+/* Capability flag: request and response data may be compressed. The
+ * central sends it, with the largest response data it expands, in its
+ * CAPABILITIES request to get compressed responses. */
+#ifndef CAPABILITY_FLAG_COMPRESSION
+#define CAPABILITY_FLAG_COMPRESSION 0x0080
+#endif
+
+/* Capability flag: the peripheral issues session resumption tickets */
+#ifndef CAPABILITY_FLAG_RESUMPTION
+#define CAPABILITY_FLAG_RESUMPTION 0x0100
+#endif
+
+/* Control command for session resumption (session_resume.h) */
+#ifndef CONTROL_CMD_RESUME
+#define CONTROL_CMD_RESUME 9
+#endif
+
+/* Control command reading peripheral instrumentation: page(1), answered with
+ * the same command carrying the page (see ble_central_request_stats()) */
+#ifndef CONTROL_CMD_STATS
+#define CONTROL_CMD_STATS 8
+#endif
+
+/* Command byte 0 flag: a batch frame whose data is a sequence of command
+ * packets. A request batch naming a stream command carries
+ * [len(2 LE)][message] entries for that command instead. */
+#ifndef COMMAND_FLAG_BATCH
+#define COMMAND_FLAG_BATCH 0x20
+#endif
+
+/* Command byte 0 flag: the data field is compressed (blerpc_compress.h) */
+#ifndef COMMAND_FLAG_COMPRESSED
+#define COMMAND_FLAG_COMPRESSED 0x10
+#endif
+
+/* Command byte 0 flag: the name field holds a 1-byte command ID */
+#ifndef COMMAND_FLAG_ID
+#define COMMAND_FLAG_ID 0x40
+#endif
+
 /**
- * Callback for received RPC response data (assembled payload).
+ * Handle for one connected blerpc peripheral.
+ *
+ * Handles live in a pool of CONFIG_BT_MAX_CONN entries, each with its own
+ * assembler, capabilities and crypto session. A handle stays valid until the
+ * link disconnects; its slot may then be reused by a later connect.
  */
-typedef void (*ble_central_response_cb_t)(const uint8_t *data, size_t len);
+typedef struct blerpc_conn ble_central_conn_t;
+
+/**
+ * Callback for received RPC response data (assembled payload or bulk SDU).
+ * @param conn            Link the response arrived on
+ * @param transaction_id  Transaction ID of the response containers
+ */
+typedef void (*ble_central_response_cb_t)(ble_central_conn_t *conn, uint8_t transaction_id,
+                                          const uint8_t *data, size_t len);
 
 /**
  * Callback for received error control containers.
+ * @param conn            Link the error arrived on
+ * @param transaction_id  Transaction ID the peripheral reported the error for
  */
-typedef void (*ble_central_error_cb_t)(uint8_t error_code);
+typedef void (*ble_central_error_cb_t)(ble_central_conn_t *conn, uint8_t transaction_id,
+                                       uint8_t error_code);
 
 /**
  * Callback for STREAM_END_P2C control container.
  */
-typedef void (*ble_central_stream_end_cb_t)(void);
+typedef void (*ble_central_stream_end_cb_t)(ble_central_conn_t *conn);
 
 /**
  * Initialize the BLE central module.
@@ -38,7 +134,7 @@ typedef void (*ble_central_stream_end_cb_t)(void);
 void ble_central_init(ble_central_response_cb_t resp_cb, ble_central_error_cb_t err_cb);
 
 /**
- * Set callback for STREAM_END_P2C reception.
+ * Set callback for STREAM_END_P2C reception (shared by all links).
  */
 void ble_central_set_stream_end_cb(ble_central_stream_end_cb_t cb);
 
@@ -46,71 +142,261 @@ void ble_central_set_stream_end_cb(ble_central_stream_end_cb_t cb);
  * Send a STREAM_END_C2P control container to peripheral.
  * @return 0 on success, negative on error
  */
-int ble_central_send_stream_end_c2p(void);
+int ble_central_send_stream_end_c2p(ble_central_conn_t *conn);
 
 /**
- * Scan for and connect to a device advertising the blerpc service UUID.
- * Uses passive scan. Blocks until connected and GATT discovery + subscription complete.
+ * Grant the peripheral credits for that many more P→C stream messages.
+ * @param flags STREAM_CREDIT_FLAG_* bits
  * @return 0 on success, negative on error
  */
-int ble_central_connect(void);
+int ble_central_send_stream_credit(ble_central_conn_t *conn, uint16_t credits, uint8_t flags);
+
+/**
+ * Read one instrumentation page from a peripheral that advertises
+ * CAPABILITY_FLAG_STATS. Page 0 holds its link counters, a command ID page
+ * that command's calls, errors and per-phase latency histograms (u32 and u16
+ * fields, little-endian). buf receives the reply payload, page byte first,
+ * truncated to size. Blocks up to 1 second.
+ * @return 0 on success, -ENOTSUP, -ETIMEDOUT or a write error
+ */
+int ble_central_request_stats(ble_central_conn_t *conn, uint8_t page, uint8_t *buf, size_t size,
+                              size_t *out_len);
+
+/* Central counters summed over all links, in the order of struct
+ * ble_central_stats */
+#define BLE_CENTRAL_STATS_COUNTERS(X)                                                            \
+    X(writes)           /* containers and SDUs handed to the stack */                           \
+    X(write_failures)   /* writes the stack refused */                                          \
+    X(bytes_out)        /* bytes of the writes handed to the stack */                           \
+    X(notifications)    /* notifications and bulk SDUs received */                              \
+    X(bytes_in)         /* bytes of the notifications and SDUs received */                      \
+    X(busy_errors)      /* ERROR(BUSY) received */                                              \
+    X(assembler_resets) /* responses dropped part-way through reassembly */                     \
+    X(decrypt_failures) /* responses that failed decryption */
+
+struct ble_central_stats {
+#define BLE_CENTRAL_STATS_FIELD(name) uint32_t name;
+    BLE_CENTRAL_STATS_COUNTERS(BLE_CENTRAL_STATS_FIELD)
+#undef BLE_CENTRAL_STATS_FIELD
+};
+
+/**
+ * Snapshot the central counters. All zero unless CONFIG_BLERPC_CENTRAL_STATS
+ * is enabled; with CONFIG_STATS they are also registered as the Zephyr stats
+ * group "ble_central".
+ */
+void ble_central_get_stats(struct ble_central_stats *out);
+
+/**
+ * Scan for and connect to a device advertising the blerpc service UUID
+ * that is not already connected. Uses active scan. Blocks until connected,
+ * the link is tuned (2M or coded PHY, maximum data length) and GATT
+ * discovery + subscription complete. Call repeatedly to fill the pool;
+ * connects are serialized.
+ *
+ * With CONFIG_BLERPC_CENTRAL_FAST_CONNECT, peripherals connected before
+ * are tried first through the filter accept list, for up to
+ * CONFIG_BLERPC_CENTRAL_FAST_CONNECT_TIMEOUT_MS before the scan, and
+ * subscribed with their cached handles instead of discovery.
+ * @param timeout  How long to scan for a new peripheral
+ * @param out      Receives the new handle on success
+ * @return 0 on success, -ENOMEM if the pool is full, -ETIMEDOUT if no new
+ *         peripheral was found, other negative on error
+ */
+int ble_central_connect(k_timeout_t timeout, ble_central_conn_t **out);
+
+/**
+ * Number of links that completed ble_central_connect() and are still up.
+ */
+size_t ble_central_conn_count(void);
+
+/**
+ * Get the ready link in pool slot index.
+ * @return handle, or NULL if the slot is free or still connecting
+ */
+ble_central_conn_t *ble_central_conn_get(size_t index);
+
+/**
+ * Pool slot of a handle, in [0, CONFIG_BT_MAX_CONN).
+ */
+size_t ble_central_conn_index(const ble_central_conn_t *conn);
+
+/**
+ * Radio parameters of a link.
+ */
+struct ble_central_link_params {
+    uint8_t tx_phy;      /* BT_GAP_LE_PHY_* */
+    uint8_t rx_phy;      /* BT_GAP_LE_PHY_* */
+    uint16_t tx_max_len; /* link-layer payload octets */
+    uint16_t rx_max_len; /* link-layer payload octets */
+    uint16_t interval;   /* connection interval, 1.25 ms units */
+    uint16_t latency;    /* peripheral latency, connection events */
+    uint16_t timeout;    /* supervision timeout, 10 ms units */
+};
+
+/**
+ * Connection-interval profiles selectable at runtime.
+ */
+enum ble_central_link_profile {
+    /* CONFIG_BLERPC_CENTRAL_CONN_INTERVAL, no latency (the connect default) */
+    BLE_CENTRAL_PROFILE_THROUGHPUT,
+    /* CONFIG_BLERPC_CENTRAL_LOW_POWER_CONN_INTERVAL with peripheral latency */
+    BLE_CENTRAL_PROFILE_LOW_POWER,
+};
+
+/**
+ * Get the current radio parameters of a link, as last reported by the
+ * controller.
+ */
+void ble_central_get_link_params(ble_central_conn_t *conn, struct ble_central_link_params *out);
+
+/**
+ * Switch a link to another connection-interval profile.
+ * Returns once the update is requested; the new parameters show up in
+ * ble_central_get_link_params() when the peripheral accepts them.
+ * @return 0 on success, negative on error
+ */
+int ble_central_set_link_profile(ble_central_conn_t *conn, enum ble_central_link_profile profile);
+
+/**
+ * Request a fixed connection interval (1.25 ms units) with no peripheral
+ * latency, e.g. for a parameter sweep. Like ble_central_set_link_profile(),
+ * returns once the update is requested.
+ * @return 0 on success, negative on error
+ */
+int ble_central_set_conn_interval(ble_central_conn_t *conn, uint16_t interval);
+
+/**
+ * Switch both directions of a link to one PHY (BT_GAP_LE_PHY_1M, _2M or
+ * _CODED). Blocks until the controller reports the update, up to 2 seconds.
+ * @return 0 on success, -ENOTSUP without CONFIG_BT_USER_PHY_UPDATE,
+ *         -ETIMEDOUT, other negative on error
+ */
+int ble_central_set_phy(ble_central_conn_t *conn, uint8_t phy);
+
+/**
+ * Cap the MTU ble_central_get_mtu() reports, so requests are split into
+ * smaller containers than the negotiated ATT MTU allows. The peripheral
+ * still sizes its notifications by the negotiated MTU. 0 removes the cap.
+ */
+void ble_central_set_mtu_limit(ble_central_conn_t *conn, uint16_t mtu);
 
 /**
  * Send data to the peripheral (write without response).
  * @return 0 on success, negative on error
  */
-int ble_central_write(const uint8_t *data, size_t len);
+int ble_central_write(ble_central_conn_t *conn, const uint8_t *data, size_t len);
 
 /**
- * Get the current connection MTU.
+ * Get the connection MTU of a link.
  */
-uint16_t ble_central_get_mtu(void);
+uint16_t ble_central_get_mtu(ble_central_conn_t *conn);
 
 /**
  * Request capabilities from the peripheral.
- * Blocks until response received or timeout.
+ * Blocks until response received or timeout. On a link set up from the
+ * fast-connect cache, returns once the request is written: the cached
+ * capabilities apply until the reply updates them, except the schema hash,
+ * so commands are sent by name rather than ID until the reply arrives.
  * @return 0 on success, negative on error/timeout
  */
-int ble_central_request_capabilities(void);
+int ble_central_request_capabilities(ble_central_conn_t *conn);
 
 /**
  * Get peripheral's max request payload size (0 if unknown).
  */
-uint16_t ble_central_get_max_request_payload_size(void);
+uint16_t ble_central_get_max_request_payload_size(ble_central_conn_t *conn);
 
 /**
  * Get peripheral's max response payload size (0 if unknown).
  */
-uint16_t ble_central_get_max_response_payload_size(void);
+uint16_t ble_central_get_max_response_payload_size(ble_central_conn_t *conn);
 
 /**
  * Get peripheral's capability flags (0 if unknown).
  */
-uint16_t ble_central_get_capability_flags(void);
+uint16_t ble_central_get_capability_flags(ble_central_conn_t *conn);
+
+/**
+ * Get the schema hash of the peripheral's command IDs (0 if unknown). Only
+ * meaningful when CAPABILITY_FLAG_COMMAND_IDS is set.
+ */
+uint16_t ble_central_get_schema_hash(ble_central_conn_t *conn);
+
+/**
+ * Get the largest request data the peripheral decompresses (0 unless it
+ * advertises CAPABILITY_FLAG_COMPRESSION).
+ */
+uint16_t ble_central_get_inflate_limit(ble_central_conn_t *conn);
 
 /**
  * Perform the 4-step key exchange handshake with the peripheral.
  * Requires CONFIG_BLERPC_ENCRYPTION to be enabled.
  * Must be called after capabilities have been received and peripheral
  * advertises CAPABILITY_FLAG_ENCRYPTION_SUPPORTED.
+ * With CONFIG_BLERPC_RESUMPTION and a peripheral advertising
+ * CAPABILITY_FLAG_RESUMPTION, a ticket cached from an earlier connection to
+ * the same address rekeys in one round trip instead, and a full handshake
+ * fetches a ticket for the next connection.
  * Blocks until key exchange completes or fails.
  * @return 0 on success, negative on error
  */
-int ble_central_perform_key_exchange(void);
+int ble_central_perform_key_exchange(ble_central_conn_t *conn);
 
 /**
- * Check whether E2E encryption is currently active.
+ * Open the bulk L2CAP channel the peripheral advertised in its capabilities
+ * (CAPABILITY_FLAG_L2CAP_SUPPORTED). Requires CONFIG_BLERPC_CENTRAL_L2CAP.
+ * Once open, large requests and responses travel over it as single SDUs
+ * instead of container trains over GATT. Blocks until the channel is up.
+ * @return 0 on success, -ENOTSUP if the peripheral or this build has no bulk
+ *         channel, negative on error
+ */
+int ble_central_bulk_open(ble_central_conn_t *conn);
+
+/**
+ * Largest payload one bulk SDU can carry to the peripheral.
+ * @return 0 if the bulk channel is not open
+ */
+size_t ble_central_bulk_max_payload(ble_central_conn_t *conn);
+
+/**
+ * Send one request payload, as produced by ble_central_encrypt_payload(), as
+ * a single bulk SDU. Waits for earlier GATT writes to be sent first and
+ * returns once the SDU is sent, so payloads reach the peripheral in the
+ * order they were encrypted whichever path each takes.
+ * @return 0 on success, -EMSGSIZE if len exceeds
+ *         ble_central_bulk_max_payload(), other negative on error
+ */
+int ble_central_bulk_send(ble_central_conn_t *conn, uint8_t transaction_id,
+                          const uint8_t *payload, size_t len);
+
+/**
+ * Check whether E2E encryption is currently active on a link.
  * @return true if encryption is active
  */
-bool ble_central_is_encrypted(void);
+bool ble_central_is_encrypted(ble_central_conn_t *conn);
 
 /**
  * Encrypt a payload for sending to the peripheral.
  * If encryption is not active, copies plaintext to out unchanged.
  * @return 0 on success, negative on error
  */
-int ble_central_encrypt_payload(const uint8_t *plaintext, size_t plaintext_len, uint8_t *out,
-                                size_t out_size, size_t *out_len);
+int ble_central_encrypt_payload(ble_central_conn_t *conn, const uint8_t *plaintext,
+                                size_t plaintext_len, uint8_t *out, size_t out_size,
+                                size_t *out_len);
+
+/* Incremental encryption state, defined by stream_crypto.h */
+struct stream_crypto_tx;
+
+/**
+ * Start encrypting a payload of exactly plaintext_len bytes incrementally,
+ * producing the same wire format as ble_central_encrypt_payload(). Consumes
+ * the link's next TX counter; continue with stream_crypto_tx_update().
+ * @param counter_out Receives the 4-byte counter prefix to send first
+ * @return 0 on success, -ENOTSUP if encryption is not active, -EIO on failure
+ */
+int ble_central_encrypt_begin(ble_central_conn_t *conn, struct stream_crypto_tx *tx,
+                              size_t plaintext_len, uint8_t *counter_out);
 
 #ifdef __cplusplus
 }
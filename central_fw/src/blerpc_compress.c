@@ -0,0 +1 @@
+../../peripheral_fw/src/blerpc_compress.c
\ No newline at end of file
@@ -0,0 +1 @@
+../../peripheral_fw/src/blerpc_compress.h
\ No newline at end of file
@@ -0,0 +1,1617 @@
+#include "blerpc_rpc.h"
+#include "ble_central.h"
+#include "generated_client.h"
+#include <blerpc_protocol/container.h>
+#include <blerpc_protocol/command.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <string.h>
+
+#ifdef CONFIG_BLERPC_ENCRYPTION
+#include <blerpc_protocol/crypto.h>
+#include <psa/crypto.h>
+#include "stream_crypto.h"
+#endif
+
+#ifdef CONFIG_BLERPC_COMPRESSION
+#include "blerpc_compress.h"
+#endif
+
+LOG_MODULE_REGISTER(blerpc_rpc, LOG_LEVEL_INF);
+
+#define RPC_TIMEOUT K_MSEC(CONFIG_BLERPC_RPC_TIMEOUT_MS)
+
+/* Shared send buffers (guarded by send_mutex) */
+static uint8_t shared_cmd_buf[CONFIG_BLERPC_PROTOCOL_ASSEMBLER_BUF_SIZE];
+static uint8_t encrypt_buf[CONFIG_BLERPC_PROTOCOL_ASSEMBLER_BUF_SIZE + 20];
+static K_MUTEX_DEFINE(send_mutex);
+
+/* ── Pipelined call window ───────────────────────────────────────────── */
+
+enum rpc_slot_state {
+    RPC_SLOT_FREE,
+    RPC_SLOT_RESERVED, /* window permit held, request not yet sent */
+    RPC_SLOT_PENDING,  /* request sent, waiting for response */
+};
+
+struct rpc_slot {
+    struct k_work_delayable timeout_work;
+    struct k_work deliver_work;
+    enum rpc_slot_state state;
+    k_timepoint_t deadline; /* when the pending request times out */
+    uint8_t transaction_id;
+    uint8_t cmd_id; /* sent as a 1-byte ID, or 0 if sent by name */
+    const char *cmd_name;
+    uint8_t name_len;
+    uint8_t *resp_data;
+    size_t resp_size;
+    blerpc_rpc_resp_cb_t on_resp; /* loans the response instead of copying it */
+    void *resp_ctx;
+    blerpc_rpc_encode_t encode; /* writes the request while it is sent, or NULL */
+    void *encode_ctx;
+    struct blerpc_batch_call *batch; /* batch calls, or NULL for a single call */
+    size_t batch_count;
+    blerpc_rpc_done_cb_t done;
+    void *user_data;
+    struct rpc_link *link;
+    ble_central_conn_t *conn;
+    /* Handed over by the RX thread: a copy of the response, or an error */
+    uint8_t *rx_data;
+    size_t rx_len;
+    int rx_status;
+};
+
+/* Each peripheral link has its own window and transaction ID space */
+struct rpc_link {
+    struct rpc_slot slots[CONFIG_BLERPC_RPC_WINDOW_SIZE];
+    struct k_sem window_sem;
+    uint8_t transaction_counter;
+};
+
+static struct rpc_link rpc_links[CONFIG_BT_MAX_CONN];
+static struct k_spinlock slots_lock;
+
+/* Responses are decoded and calls completed here, not on the Bluetooth RX
+ * thread, which only copies each response into resp_heap */
+static struct k_work_q rpc_work_q;
+static K_THREAD_STACK_DEFINE(rpc_work_stack, CONFIG_BLERPC_RPC_WORK_STACK_SIZE);
+static K_HEAP_DEFINE(resp_heap, CONFIG_BLERPC_RPC_RESPONSE_HEAP_SIZE);
+
+/* ── Exclusive (stream) mode ─────────────────────────────────────────── */
+
+/* Stream responses carry peripheral-chosen transaction IDs, so streams hold
+ * their link's whole window and receive every unmatched response on it.
+ * Responses are handled on the RX thread straight from the assembler buffer:
+ * P2C messages go to stream_on_resp, the C2P final response is copied into
+ * stream_resp_data. One stream runs at a time across all links. */
+static blerpc_on_stream_resp_t stream_on_resp;
+static void *stream_ctx;
+static uint8_t *stream_resp_data;
+static size_t stream_resp_size;
+static size_t stream_resp_len;
+static int stream_status;
+static uint32_t stream_received; /* P2C messages handed to stream_on_resp */
+static int rpc_error_code;
+static bool stream_active;
+static ble_central_conn_t *stream_conn;
+static K_SEM_DEFINE(response_sem, 0, 10);
+static K_MUTEX_DEFINE(stream_mutex);
+
+static struct rpc_link *rpc_link_get(ble_central_conn_t *conn)
+{
+    return &rpc_links[ble_central_conn_index(conn)];
+}
+
+static uint8_t next_transaction_id(ble_central_conn_t *conn)
+{
+    return rpc_link_get(conn)->transaction_counter++;
+}
+
+/* The ID to name a command by on this link, or 0 to send its name: IDs are
+ * only meaningful to a peripheral generated from the same schema. */
+static uint8_t wire_cmd_id(ble_central_conn_t *conn, uint8_t cmd_id)
+{
+    if (!IS_ENABLED(CONFIG_BLERPC_RPC_COMMAND_IDS) ||
+        !(ble_central_get_capability_flags(conn) & CAPABILITY_FLAG_COMMAND_IDS) ||
+        ble_central_get_schema_hash(conn) != BLERPC_SCHEMA_HASH) {
+        return 0;
+    }
+    return cmd_id;
+}
+
+/* Send container callback for container_split_and_send */
+static int send_container(const uint8_t *data, size_t len, void *ctx)
+{
+    return ble_central_write(ctx, data, len);
+}
+
+/* Encrypt and send the command already serialized in shared_cmd_buf.
+ * Caller must hold send_mutex. */
+static int send_cmd_buf(ble_central_conn_t *conn, uint8_t tid, size_t cmd_len)
+{
+    uint16_t max_req = ble_central_get_max_request_payload_size(conn);
+    if (max_req > 0 && cmd_len > max_req) {
+        LOG_ERR("Request too large: %zu > %u", cmd_len, max_req);
+        return -EMSGSIZE;
+    }
+
+    size_t send_len;
+    if (ble_central_encrypt_payload(conn, shared_cmd_buf, cmd_len, encrypt_buf,
+                                    sizeof(encrypt_buf), &send_len) != 0) {
+        LOG_ERR("Payload encryption failed");
+        return -EIO;
+    }
+
+#ifdef CONFIG_BLERPC_CENTRAL_L2CAP
+    /* Large requests go as one SDU over the bulk channel, if it is open */
+    if (send_len >= CONFIG_BLERPC_CENTRAL_L2CAP_THRESHOLD &&
+        send_len <= ble_central_bulk_max_payload(conn)) {
+        int err = ble_central_bulk_send(conn, tid, encrypt_buf, send_len);
+        if (err) {
+            LOG_ERR("Bulk send failed: %d", err);
+            return -EIO;
+        }
+        return 0;
+    }
+#endif
+
+    uint16_t mtu = ble_central_get_mtu(conn);
+    int rc = container_split_and_send(tid, encrypt_buf, send_len, mtu, send_container, conn);
+    if (rc < 0) {
+        LOG_ERR("Container split/send failed: %d", rc);
+        return -EIO;
+    }
+    return 0;
+}
+
+/* Serialize one request packet, named by cmd_id if it is nonzero.
+ * @return packet length, negative if it does not fit in size */
+static int serialize_request(uint8_t *buf, size_t size, uint8_t cmd_id, const char *cmd_name,
+                             uint8_t name_len, const uint8_t *req_data, size_t req_len)
+{
+    const char id_name = (char)cmd_id;
+    int cmd_len = command_serialize(COMMAND_TYPE_REQUEST, cmd_id ? &id_name : cmd_name,
+                                    cmd_id ? 1 : name_len, req_data, (uint16_t)req_len, buf,
+                                    size);
+    if (cmd_len >= 0 && cmd_id) {
+        buf[0] |= COMMAND_FLAG_ID;
+    }
+    return cmd_len;
+}
+
+#ifdef CONFIG_BLERPC_COMPRESSION
+/* Request encoder, guarded by send_mutex */
+static struct blerpc_compress request_compress;
+
+struct compress_sink {
+    uint8_t *buf;
+    size_t size;
+    size_t len;
+};
+
+/* Fails once the output would no longer be smaller than the input */
+static int compress_to_buf(const uint8_t *data, size_t len, void *ctx)
+{
+    struct compress_sink *sink = ctx;
+    if (len > sink->size - sink->len) {
+        return -ENOSPC;
+    }
+    memcpy(sink->buf + sink->len, data, len);
+    sink->len += len;
+    return 0;
+}
+
+/* Serialize a request with its data compressed, if the peripheral expands
+ * it and it shrinks.
+ * @return packet length, 0 to send it uncompressed instead */
+static int serialize_compressed(ble_central_conn_t *conn, uint8_t cmd_id, const char *cmd_name,
+                                uint8_t name_len, const uint8_t *req_data, size_t req_len)
+{
+    if (!(ble_central_get_capability_flags(conn) & CAPABILITY_FLAG_COMPRESSION) ||
+        req_len < CONFIG_BLERPC_COMPRESSION_MIN_SIZE ||
+        req_len > ble_central_get_inflate_limit(conn)) {
+        return 0;
+    }
+
+    size_t name_size = cmd_id ? 1 : name_len;
+    size_t hdr_size = 2 + name_size + 2;
+    size_t data_off = hdr_size + BLERPC_COMPRESS_HEADER_SIZE;
+    if (data_off + req_len > sizeof(shared_cmd_buf)) {
+        return 0;
+    }
+    struct compress_sink sink = {
+        .buf = shared_cmd_buf + data_off,
+        .size = req_len - BLERPC_COMPRESS_HEADER_SIZE - 1,
+        .len = 0,
+    };
+    blerpc_compress_begin(&request_compress, compress_to_buf, &sink);
+    blerpc_compress_write(&request_compress, req_data, req_len);
+    if (blerpc_compress_finish(&request_compress) != 0) {
+        return 0;
+    }
+
+    size_t data_len = BLERPC_COMPRESS_HEADER_SIZE + sink.len;
+    shared_cmd_buf[0] = ((COMMAND_TYPE_REQUEST & 0x01) << 7) | COMMAND_FLAG_COMPRESSED |
+                        (cmd_id ? COMMAND_FLAG_ID : 0);
+    shared_cmd_buf[1] = (uint8_t)name_size;
+    if (cmd_id) {
+        shared_cmd_buf[2] = cmd_id;
+    } else {
+        memcpy(shared_cmd_buf + 2, cmd_name, name_len);
+    }
+    shared_cmd_buf[hdr_size - 2] = (uint8_t)(data_len & 0xFF);
+    shared_cmd_buf[hdr_size - 1] = (uint8_t)(data_len >> 8);
+    shared_cmd_buf[hdr_size] = (uint8_t)(req_len & 0xFF);
+    shared_cmd_buf[hdr_size + 1] = (uint8_t)(req_len >> 8);
+    return (int)(hdr_size + data_len);
+}
+#endif /* CONFIG_BLERPC_COMPRESSION */
+
+/* Serialize, encrypt and send one request. Caller must hold send_mutex. */
+static int send_request(ble_central_conn_t *conn, uint8_t tid, uint8_t cmd_id,
+                        const char *cmd_name, uint8_t name_len, const uint8_t *req_data,
+                        size_t req_len)
+{
+#ifdef CONFIG_BLERPC_COMPRESSION
+    int z_len = serialize_compressed(conn, cmd_id, cmd_name, name_len, req_data, req_len);
+    if (z_len > 0) {
+        return send_cmd_buf(conn, tid, (size_t)z_len);
+    }
+#endif
+    int cmd_len = serialize_request(shared_cmd_buf, sizeof(shared_cmd_buf), cmd_id, cmd_name,
+                                    name_len, req_data, req_len);
+    if (cmd_len < 0) {
+        LOG_ERR("Command serialize failed");
+        return -EINVAL;
+    }
+    return send_cmd_buf(conn, tid, (size_t)cmd_len);
+}
+
+/* Serialize a batch frame (empty name, the request packets as its data),
+ * then encrypt and send it. Caller must hold send_mutex. */
+static int send_batch(ble_central_conn_t *conn, uint8_t tid, const struct blerpc_batch_call *calls,
+                      size_t count)
+{
+    size_t off = 4;
+    for (size_t i = 0; i < count; i++) {
+        int n = serialize_request(shared_cmd_buf + off, sizeof(shared_cmd_buf) - off,
+                                  wire_cmd_id(conn, calls[i].cmd_id), calls[i].cmd_name,
+                                  (uint8_t)strlen(calls[i].cmd_name), calls[i].req_data,
+                                  calls[i].req_len);
+        if (n < 0) {
+            LOG_ERR("Batch serialize failed at call %zu", i);
+            return -EMSGSIZE;
+        }
+        off += (size_t)n;
+    }
+
+    size_t body_len = off - 4;
+    shared_cmd_buf[0] = ((COMMAND_TYPE_REQUEST & 0x01) << 7) | COMMAND_FLAG_BATCH;
+    shared_cmd_buf[1] = 0;
+    shared_cmd_buf[2] = (uint8_t)(body_len & 0xFF);
+    shared_cmd_buf[3] = (uint8_t)((body_len >> 8) & 0xFF);
+    return send_cmd_buf(conn, tid, off);
+}
+
+/* ── Streaming request writer ────────────────────────────────────────── */
+
+/* Packs a request into containers as it is encoded and writes each one as
+ * soon as it fills, encrypting on the fly while the link's session is
+ * encrypted, so the request is never held in RAM in full. Always GATT: a
+ * bulk SDU needs the whole payload up front. */
+struct req_stream {
+    ble_central_conn_t *conn;
+    uint8_t transaction_id;
+    uint16_t mtu;
+    uint16_t total_length; /* total payload for FIRST container header */
+    uint8_t buf[252];      /* one container at a time (max effective MTU) */
+    uint8_t seq;
+    uint8_t payload_used; /* payload bytes buffered in current container */
+    bool first_sent;
+    int error;
+#ifdef CONFIG_BLERPC_ENCRYPTION
+    bool encrypt; /* payload bytes pass through crypto before packing */
+    struct stream_crypto_tx crypto;
+#endif
+};
+
+static uint8_t req_stream_header_size(struct req_stream *rs)
+{
+    return rs->first_sent ? CONTAINER_SUBSEQUENT_HEADER_SIZE : CONTAINER_FIRST_HEADER_SIZE;
+}
+
+static int req_stream_flush(struct req_stream *rs)
+{
+    if (rs->payload_used == 0) {
+        return 0;
+    }
+
+    uint8_t hdr_size = req_stream_header_size(rs);
+    rs->buf[0] = rs->transaction_id;
+    rs->buf[1] = rs->seq;
+    if (!rs->first_sent) {
+        rs->buf[2] = ((CONTAINER_TYPE_FIRST & 0x03) << 6);
+        rs->buf[3] = (uint8_t)(rs->total_length & 0xFF);
+        rs->buf[4] = (uint8_t)(rs->total_length >> 8);
+        rs->buf[5] = rs->payload_used;
+    } else {
+        rs->buf[2] = ((CONTAINER_TYPE_SUBSEQUENT & 0x03) << 6);
+        rs->buf[3] = rs->payload_used;
+    }
+
+    int rc = ble_central_write(rs->conn, rs->buf, hdr_size + rs->payload_used);
+    if (rc < 0) {
+        LOG_ERR("Request container write failed: %d", rc);
+        rs->error = -EIO;
+        return rs->error;
+    }
+
+    rs->seq++;
+    rs->first_sent = true;
+    rs->payload_used = 0;
+    return 0;
+}
+
+static int req_stream_write_raw(struct req_stream *rs, const uint8_t *data, size_t len)
+{
+    while (len > 0 && !rs->error) {
+        uint8_t hdr_size = req_stream_header_size(rs);
+        uint8_t max_payload = (uint8_t)(rs->mtu - CONTAINER_ATT_OVERHEAD - hdr_size);
+        uint8_t n = (uint8_t)MIN(len, (size_t)(max_payload - rs->payload_used));
+
+        memcpy(rs->buf + hdr_size + rs->payload_used, data, n);
+        rs->payload_used += n;
+        data += n;
+        len -= n;
+
+        if (rs->payload_used >= max_payload) {
+            req_stream_flush(rs);
+        }
+    }
+    return rs->error;
+}
+
+#ifdef CONFIG_BLERPC_ENCRYPTION
+/* Plaintext bytes encrypted per crypto call */
+#define REQ_STREAM_CRYPTO_CHUNK 64
+
+static int req_stream_write_encrypted(struct req_stream *rs, const uint8_t *data, size_t len)
+{
+    uint8_t out[PSA_AEAD_UPDATE_OUTPUT_MAX_SIZE(REQ_STREAM_CRYPTO_CHUNK)];
+
+    while (len > 0 && !rs->error) {
+        size_t n = MIN(len, REQ_STREAM_CRYPTO_CHUNK);
+        size_t out_len;
+        if (stream_crypto_tx_update(&rs->crypto, data, n, out, sizeof(out), &out_len) != 0) {
+            LOG_ERR("Request encryption failed");
+            rs->encrypt = false;
+            rs->error = -EIO;
+            break;
+        }
+        req_stream_write_raw(rs, out, out_len);
+        data += n;
+        len -= n;
+    }
+    return rs->error;
+}
+#endif
+
+static int req_stream_write(struct req_stream *rs, const uint8_t *data, size_t len)
+{
+#ifdef CONFIG_BLERPC_ENCRYPTION
+    if (rs->encrypt) {
+        return req_stream_write_encrypted(rs, data, len);
+    }
+#endif
+    return req_stream_write_raw(rs, data, len);
+}
+
+/* Start a request on conn carrying payload_len plaintext bytes. Every begin
+ * is paired with req_stream_end() or req_stream_abort(). */
+static int req_stream_begin(struct req_stream *rs, ble_central_conn_t *conn, uint8_t tid,
+                            size_t payload_len)
+{
+    size_t wire_len = payload_len;
+
+    rs->conn = conn;
+    rs->transaction_id = tid;
+    rs->mtu = MIN(ble_central_get_mtu(conn), sizeof(rs->buf) + CONTAINER_ATT_OVERHEAD);
+    rs->seq = 0;
+    rs->payload_used = 0;
+    rs->first_sent = false;
+    rs->error = 0;
+
+#ifdef CONFIG_BLERPC_ENCRYPTION
+    rs->encrypt = ble_central_is_encrypted(conn);
+    if (rs->encrypt) {
+        wire_len += BLERPC_ENCRYPTED_OVERHEAD;
+    }
+#endif
+
+    uint16_t max_req = ble_central_get_max_request_payload_size(conn);
+    if (wire_len > UINT16_MAX || (max_req > 0 && wire_len > max_req)) {
+        LOG_ERR("Request too large: %zu > %u", wire_len, max_req ? max_req : UINT16_MAX);
+#ifdef CONFIG_BLERPC_ENCRYPTION
+        rs->encrypt = false;
+#endif
+        return -EMSGSIZE;
+    }
+    rs->total_length = (uint16_t)wire_len;
+
+#ifdef CONFIG_BLERPC_ENCRYPTION
+    if (rs->encrypt) {
+        uint8_t counter[STREAM_CRYPTO_COUNTER_SIZE];
+        if (ble_central_encrypt_begin(conn, &rs->crypto, payload_len, counter) != 0) {
+            LOG_ERR("Request encryption failed");
+            rs->encrypt = false;
+            return -EIO;
+        }
+        req_stream_write_raw(rs, counter, sizeof(counter));
+    }
+#endif
+    return rs->error;
+}
+
+static void req_stream_abort(struct req_stream *rs)
+{
+#ifdef CONFIG_BLERPC_ENCRYPTION
+    if (rs->encrypt) {
+        stream_crypto_tx_abort(&rs->crypto);
+        rs->encrypt = false;
+    }
+#else
+    (void)rs;
+#endif
+}
+
+/* Append the GCM tag (if encrypting), then flush the last partial container */
+static int req_stream_end(struct req_stream *rs)
+{
+    if (rs->error) {
+        req_stream_abort(rs);
+        return rs->error;
+    }
+
+#ifdef CONFIG_BLERPC_ENCRYPTION
+    if (rs->encrypt) {
+        uint8_t out[PSA_AEAD_FINISH_OUTPUT_MAX_SIZE];
+        uint8_t tag[STREAM_CRYPTO_TAG_SIZE];
+        size_t out_len;
+        rs->encrypt = false;
+        if (stream_crypto_tx_finish(&rs->crypto, out, sizeof(out), &out_len, tag) != 0) {
+            LOG_ERR("Request encryption failed");
+            return -EIO;
+        }
+        req_stream_write_raw(rs, out, out_len);
+        req_stream_write_raw(rs, tag, sizeof(tag));
+    }
+#endif
+
+    if (!rs->error) {
+        req_stream_flush(rs);
+    }
+    return rs->error;
+}
+
+static bool req_stream_pb_callback(pb_ostream_t *stream, const uint8_t *buf, size_t count)
+{
+    return req_stream_write(stream->state, buf, count) == 0;
+}
+
+/* Send a request whose req_len payload bytes encode writes while it goes
+ * out. Containers already sent stay sent if encode fails; the peripheral's
+ * assembler for that transaction ID is reclaimed once it has been idle for
+ * CONFIG_BLERPC_ASSEMBLER_TIMEOUT_MS, or evicted earlier as the least
+ * recently used one. Caller must hold send_mutex. */
+static int send_encoded(ble_central_conn_t *conn, uint8_t tid, uint8_t cmd_id,
+                        const char *cmd_name, uint8_t name_len, size_t req_len,
+                        blerpc_rpc_encode_t encode, void *encode_ctx)
+{
+    const char id_name = (char)cmd_id;
+    if (cmd_id) {
+        cmd_name = &id_name;
+        name_len = 1;
+    }
+    if (req_len > UINT16_MAX) {
+        LOG_ERR("Request too large: %zu", req_len);
+        return -EMSGSIZE;
+    }
+
+    /* type(1) + name_len(1) + name + data_len(2) */
+    uint8_t hdr[4 + UINT8_MAX];
+    size_t hdr_size = 4 + name_len;
+    hdr[0] = (COMMAND_TYPE_REQUEST & 0x01) << 7;
+    if (cmd_id) {
+        hdr[0] |= COMMAND_FLAG_ID;
+    }
+    hdr[1] = name_len;
+    memcpy(hdr + 2, cmd_name, name_len);
+    hdr[2 + name_len] = (uint8_t)(req_len & 0xFF);
+    hdr[3 + name_len] = (uint8_t)((req_len >> 8) & 0xFF);
+
+    struct req_stream rs;
+    int rc = req_stream_begin(&rs, conn, tid, hdr_size + req_len);
+    if (rc != 0) {
+        req_stream_abort(&rs);
+        return rc;
+    }
+    req_stream_write(&rs, hdr, hdr_size);
+
+    pb_ostream_t ostream = {
+        .callback = req_stream_pb_callback,
+        .state = &rs,
+        .max_size = req_len,
+        .bytes_written = 0,
+    };
+    if (!encode(&ostream, encode_ctx) || ostream.bytes_written != req_len) {
+        LOG_ERR("Request encode failed (%zu of %zu bytes)", ostream.bytes_written, req_len);
+        req_stream_abort(&rs);
+        return -EIO;
+    }
+    return req_stream_end(&rs);
+}
+
+static void slot_release(struct rpc_slot *slot)
+{
+    k_spinlock_key_t key = k_spin_lock(&slots_lock);
+    slot->state = RPC_SLOT_FREE;
+    k_spin_unlock(&slots_lock, key);
+    k_sem_give(&slot->link->window_sem);
+}
+
+/* Take ownership of a pending slot. Only one of response, error and timeout
+ * paths wins; the others see the slot as no longer pending. */
+static bool slot_claim(struct rpc_slot *slot)
+{
+    bool claimed = false;
+    k_spinlock_key_t key = k_spin_lock(&slots_lock);
+    if (slot->state == RPC_SLOT_PENDING) {
+        slot->state = RPC_SLOT_RESERVED;
+        claimed = true;
+    }
+    k_spin_unlock(&slots_lock, key);
+    return claimed;
+}
+
+static struct rpc_slot *slot_find_pending(ble_central_conn_t *conn, uint8_t tid)
+{
+    struct rpc_slot *slots = rpc_link_get(conn)->slots;
+    struct rpc_slot *found = NULL;
+    k_spinlock_key_t key = k_spin_lock(&slots_lock);
+    for (size_t i = 0; i < CONFIG_BLERPC_RPC_WINDOW_SIZE; i++) {
+        if (slots[i].state == RPC_SLOT_PENDING && slots[i].transaction_id == tid) {
+            slots[i].state = RPC_SLOT_RESERVED;
+            found = &slots[i];
+            break;
+        }
+    }
+    k_spin_unlock(&slots_lock, key);
+    return found;
+}
+
+/* Finish a claimed slot: free it, then notify the caller. */
+static void slot_complete(struct rpc_slot *slot, int status, size_t resp_len)
+{
+    blerpc_rpc_done_cb_t done = slot->done;
+    void *user_data = slot->user_data;
+
+    k_work_cancel_delayable(&slot->timeout_work);
+    slot_release(slot);
+    done(status, resp_len, user_data);
+}
+
+/* Claims the slot only once its deadline has passed: a handler already
+ * running when its call completed may find the slot reused by a newer call,
+ * whose deadline is still ahead. That call keeps its own timeout. */
+static void slot_timeout_handler(struct k_work *work)
+{
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct rpc_slot *slot = CONTAINER_OF(dwork, struct rpc_slot, timeout_work);
+    bool pending = false;
+    bool expired = false;
+
+    k_spinlock_key_t key = k_spin_lock(&slots_lock);
+    if (slot->state == RPC_SLOT_PENDING) {
+        pending = true;
+        expired = sys_timepoint_expired(slot->deadline);
+        if (expired) {
+            slot->state = RPC_SLOT_RESERVED;
+        }
+    }
+    k_timepoint_t deadline = slot->deadline;
+    k_spin_unlock(&slots_lock, key);
+
+    if (!pending) {
+        return;
+    }
+    if (!expired) {
+        /* No-op if the newer call's timeout is already scheduled */
+        k_work_schedule_for_queue(&rpc_work_q, &slot->timeout_work,
+                                  sys_timepoint_timeout(deadline));
+        return;
+    }
+    LOG_ERR("Response timeout (tid=%u)", slot->transaction_id);
+    slot_complete(slot, -ETIMEDOUT, 0);
+}
+
+/* Whether a response packet names the command its request was sent as:
+ * the peripheral answers in the form the request used. */
+static bool response_names(const uint8_t *data, const struct command_packet *resp_cmd,
+                           uint8_t cmd_id, const char *cmd_name, uint8_t name_len)
+{
+    if (cmd_id) {
+        return (data[0] & COMMAND_FLAG_ID) && resp_cmd->cmd_name_len == 1 &&
+               (uint8_t)resp_cmd->cmd_name[0] == cmd_id;
+    }
+    return resp_cmd->cmd_name_len == name_len &&
+           memcmp(resp_cmd->cmd_name, cmd_name, name_len) == 0;
+}
+
+/* Split each call's response off a batch response, in request order */
+static void slot_deliver_batch(ble_central_conn_t *conn, struct rpc_slot *slot,
+                               const struct command_packet *batch_cmd)
+{
+    const uint8_t *p = batch_cmd->data;
+    size_t left = batch_cmd->data_len;
+
+    for (size_t i = 0; i < slot->batch_count; i++) {
+        struct blerpc_batch_call *call = &slot->batch[i];
+        struct command_packet resp_cmd;
+        size_t n = 0;
+
+        if (left >= 4 && left >= 4 + (size_t)p[1]) {
+            n = 4 + p[1] + (p[2 + p[1]] | (p[3 + p[1]] << 8));
+        }
+        if (n == 0 || n > left || command_parse(p, n, &resp_cmd) != 0 ||
+            !response_names(p, &resp_cmd, wire_cmd_id(conn, call->cmd_id), call->cmd_name,
+                            (uint8_t)strlen(call->cmd_name))) {
+            LOG_ERR("Batch response %zu malformed", i);
+            slot_complete(slot, -EIO, 0);
+            return;
+        }
+        if (resp_cmd.data_len > call->resp_size) {
+            LOG_ERR("Batch response %zu too large: %u > %zu", i, resp_cmd.data_len,
+                    call->resp_size);
+            slot_complete(slot, -EMSGSIZE, 0);
+            return;
+        }
+        memcpy(call->resp_data, resp_cmd.data, resp_cmd.data_len);
+        call->resp_len = resp_cmd.data_len;
+        p += n;
+        left -= n;
+    }
+
+    if (left != 0) {
+        LOG_ERR("Batch response has %zu trailing bytes", left);
+        slot_complete(slot, -EIO, 0);
+        return;
+    }
+    slot_complete(slot, 0, batch_cmd->data_len);
+}
+
+#ifdef CONFIG_BLERPC_COMPRESSION
+/* Compressed responses are expanded here on rpc_work_q, one at a time */
+static uint8_t inflate_buf[CONFIG_BLERPC_COMPRESSION_BUF_SIZE];
+
+/* Point a compressed response's data at its expansion in inflate_buf */
+static int response_inflate(struct command_packet *resp_cmd)
+{
+    size_t len;
+    if (blerpc_decompress(resp_cmd->data, resp_cmd->data_len, inflate_buf, sizeof(inflate_buf),
+                          &len) != 0) {
+        LOG_ERR("Compressed response malformed or over %d bytes",
+                CONFIG_BLERPC_COMPRESSION_BUF_SIZE);
+        return -1;
+    }
+    resp_cmd->data = inflate_buf;
+    resp_cmd->data_len = (uint16_t)len;
+    return 0;
+}
+#endif
+
+static void slot_deliver(ble_central_conn_t *conn, struct rpc_slot *slot, const uint8_t *data,
+                         size_t len)
+{
+    struct command_packet resp_cmd;
+    if (command_parse(data, len, &resp_cmd) != 0) {
+        LOG_ERR("Response command parse failed");
+        slot_complete(slot, -EIO, 0);
+        return;
+    }
+
+    if (resp_cmd.cmd_type != COMMAND_TYPE_RESPONSE) {
+        LOG_ERR("Expected response, got type %d", resp_cmd.cmd_type);
+        slot_complete(slot, -EIO, 0);
+        return;
+    }
+
+    if (slot->batch) {
+        if (!(data[0] & COMMAND_FLAG_BATCH)) {
+            LOG_ERR("Expected batch response");
+            slot_complete(slot, -EIO, 0);
+            return;
+        }
+        slot_deliver_batch(conn, slot, &resp_cmd);
+        return;
+    }
+
+    if (!response_names(data, &resp_cmd, slot->cmd_id, slot->cmd_name, slot->name_len)) {
+        LOG_ERR("Command name mismatch in response");
+        slot_complete(slot, -EIO, 0);
+        return;
+    }
+
+    if (data[0] & COMMAND_FLAG_COMPRESSED) {
+#ifdef CONFIG_BLERPC_COMPRESSION
+        if (response_inflate(&resp_cmd) != 0) {
+            slot_complete(slot, -EIO, 0);
+            return;
+        }
+#else
+        LOG_ERR("Compressed response, but compression is disabled");
+        slot_complete(slot, -EIO, 0);
+        return;
+#endif
+    }
+
+    if (slot->on_resp) {
+        /* The slot stays claimed while the caller reads the loaned payload */
+        int rc = slot->on_resp(resp_cmd.data, resp_cmd.data_len, slot->resp_ctx);
+        slot_complete(slot, rc == 0 ? 0 : -EIO, resp_cmd.data_len);
+        return;
+    }
+
+    if (resp_cmd.data_len > slot->resp_size) {
+        LOG_ERR("Response data too large: %u > %zu", resp_cmd.data_len, slot->resp_size);
+        slot_complete(slot, -EMSGSIZE, 0);
+        return;
+    }
+
+    memcpy(slot->resp_data, resp_cmd.data, resp_cmd.data_len);
+    slot_complete(slot, 0, resp_cmd.data_len);
+}
+
+static void slot_deliver_work_handler(struct k_work *work)
+{
+    struct rpc_slot *slot = CONTAINER_OF(work, struct rpc_slot, deliver_work);
+    /* Completing frees the slot for the next call; keep the copy until done */
+    uint8_t *data = slot->rx_data;
+
+    if (slot->rx_status != 0) {
+        slot_complete(slot, slot->rx_status, 0);
+    } else {
+        slot_deliver(slot->conn, slot, data, slot->rx_len);
+    }
+    k_heap_free(&resp_heap, data);
+}
+
+/* Hand a claimed slot's response (status 0) or error status to rpc_work_q.
+ * Runs on the RX thread, where data is only valid until the callback
+ * returns, so the response is copied. */
+static void slot_queue(struct rpc_slot *slot, int status, const uint8_t *data, size_t len)
+{
+    slot->rx_data = NULL;
+    slot->rx_len = len;
+    slot->rx_status = status;
+    if (status == 0) {
+        slot->rx_data = k_heap_alloc(&resp_heap, len, K_NO_WAIT);
+        if (slot->rx_data) {
+            memcpy(slot->rx_data, data, len);
+        } else {
+            LOG_ERR("No heap for a %zu byte response (tid=%u)", len, slot->transaction_id);
+            slot->rx_status = -ENOMEM;
+        }
+    }
+    k_work_submit_to_queue(&rpc_work_q, &slot->deliver_work);
+}
+
+static void stream_deliver_one(const uint8_t *data, size_t len)
+{
+    struct command_packet resp_cmd;
+
+    if (stream_status != 0) {
+        /* Already failed; drain the rest until the caller gives up */
+    } else if (command_parse(data, len, &resp_cmd) != 0) {
+        LOG_ERR("Stream response parse failed");
+        stream_status = -EIO;
+    } else if (stream_on_resp) {
+        if (stream_on_resp(resp_cmd.data, resp_cmd.data_len, stream_ctx) != 0) {
+            LOG_ERR("Stream response callback failed");
+            stream_status = -EIO;
+        }
+        stream_received++;
+    } else if (resp_cmd.data_len > stream_resp_size) {
+        LOG_ERR("Response data too large: %u > %zu", resp_cmd.data_len, stream_resp_size);
+        stream_status = -EMSGSIZE;
+    } else {
+        memcpy(stream_resp_data, resp_cmd.data, resp_cmd.data_len);
+        stream_resp_len = resp_cmd.data_len;
+    }
+}
+
+/* Hand a stream response, or each response of a coalesced batch frame, to
+ * the waiting stream call, then wake it */
+static void stream_deliver(const uint8_t *data, size_t len)
+{
+    if (len >= 4 && (data[0] & COMMAND_FLAG_BATCH)) {
+        const uint8_t *p = data + 4;
+        size_t left = len - 4;
+        while (left > 0 && stream_status == 0) {
+            size_t n = 0;
+            if (left >= 4 && left >= 4 + (size_t)p[1]) {
+                n = 4 + p[1] + (p[2 + p[1]] | (p[3 + p[1]] << 8));
+            }
+            if (n == 0 || n > left) {
+                LOG_ERR("Coalesced stream frame malformed");
+                stream_status = -EIO;
+                break;
+            }
+            stream_deliver_one(p, n);
+            p += n;
+            left -= n;
+        }
+    } else {
+        stream_deliver_one(data, len);
+    }
+    k_sem_give(&response_sem);
+}
+
+/* Callback from ble_central when a complete response is assembled */
+static void on_response(ble_central_conn_t *conn, uint8_t transaction_id, const uint8_t *data,
+                        size_t len)
+{
+    struct rpc_slot *slot = slot_find_pending(conn, transaction_id);
+    if (slot) {
+        slot_queue(slot, 0, data, len);
+        return;
+    }
+
+    if (!stream_active || conn != stream_conn) {
+        LOG_WRN("Dropping response with unknown tid=%u", transaction_id);
+        return;
+    }
+
+    stream_deliver(data, len);
+}
+
+/* Callback from ble_central when an ERROR control container is received */
+static void on_error(ble_central_conn_t *conn, uint8_t transaction_id, uint8_t error_code)
+{
+    LOG_ERR("Peripheral error: 0x%02x (link %u, tid=%u)", error_code,
+            (unsigned int)ble_central_conn_index(conn), transaction_id);
+
+    struct rpc_slot *slot = slot_find_pending(conn, transaction_id);
+    if (slot) {
+        int status = -EIO;
+        if (error_code == BLERPC_ERROR_BUSY) {
+            status = -EBUSY;
+        } else if (error_code == BLERPC_ERROR_RESPONSE_TOO_LARGE) {
+            status = -EMSGSIZE;
+        }
+        slot_queue(slot, status, NULL, 0);
+        return;
+    }
+
+    if (stream_active && conn == stream_conn) {
+        rpc_error_code = error_code;
+        k_sem_give(&response_sem);
+    }
+}
+
+/* Take every window permit of a link, i.e. wait until nothing is in flight
+ * on it. */
+static int window_take_all(struct rpc_link *link, k_timepoint_t end)
+{
+    for (int i = 0; i < CONFIG_BLERPC_RPC_WINDOW_SIZE; i++) {
+        if (k_sem_take(&link->window_sem, sys_timepoint_timeout(end)) != 0) {
+            while (i-- > 0) {
+                k_sem_give(&link->window_sem);
+            }
+            return -EAGAIN;
+        }
+    }
+    return 0;
+}
+
+static void window_give_all(struct rpc_link *link)
+{
+    for (int i = 0; i < CONFIG_BLERPC_RPC_WINDOW_SIZE; i++) {
+        k_sem_give(&link->window_sem);
+    }
+}
+
+/* Hold the link's whole window so a stream has the link to itself. */
+static int stream_begin(ble_central_conn_t *conn)
+{
+    k_timepoint_t end = sys_timepoint_calc(RPC_TIMEOUT);
+
+    if (k_mutex_lock(&stream_mutex, sys_timepoint_timeout(end)) != 0) {
+        LOG_ERR("Timed out waiting for another link's stream");
+        return -EAGAIN;
+    }
+
+    if (window_take_all(rpc_link_get(conn), end) != 0) {
+        LOG_ERR("Timed out waiting for in-flight calls before stream");
+        k_mutex_unlock(&stream_mutex);
+        return -EAGAIN;
+    }
+
+    k_sem_reset(&response_sem);
+    rpc_error_code = 0;
+    stream_status = 0;
+    stream_on_resp = NULL;
+    stream_resp_data = NULL;
+    stream_resp_size = 0;
+    stream_resp_len = 0;
+    stream_conn = conn;
+    stream_active = true;
+    return 0;
+}
+
+static void stream_finish(ble_central_conn_t *conn)
+{
+    stream_active = false;
+    stream_conn = NULL;
+    window_give_all(rpc_link_get(conn));
+    k_mutex_unlock(&stream_mutex);
+}
+
+/* ── Public API ──────────────────────────────────────────────────────── */
+
+void blerpc_rpc_init(void)
+{
+    k_work_queue_start(&rpc_work_q, rpc_work_stack, K_THREAD_STACK_SIZEOF(rpc_work_stack),
+                       K_PRIO_COOP(CONFIG_BLERPC_RPC_WORK_PRIO), NULL);
+    for (size_t l = 0; l < ARRAY_SIZE(rpc_links); l++) {
+        struct rpc_link *link = &rpc_links[l];
+
+        k_sem_init(&link->window_sem, CONFIG_BLERPC_RPC_WINDOW_SIZE,
+                   CONFIG_BLERPC_RPC_WINDOW_SIZE);
+        for (size_t i = 0; i < ARRAY_SIZE(link->slots); i++) {
+            k_work_init_delayable(&link->slots[i].timeout_work, slot_timeout_handler);
+            k_work_init(&link->slots[i].deliver_work, slot_deliver_work_handler);
+            link->slots[i].state = RPC_SLOT_FREE;
+            link->slots[i].link = link;
+        }
+    }
+    ble_central_init(on_response, on_error);
+}
+
+/* Take a window permit and a free slot on link */
+static struct rpc_slot *slot_reserve(struct rpc_link *link, k_timeout_t wait)
+{
+    if (k_sem_take(&link->window_sem, wait) != 0) {
+        return NULL;
+    }
+
+    struct rpc_slot *slot = NULL;
+    k_spinlock_key_t key = k_spin_lock(&slots_lock);
+    for (size_t i = 0; i < ARRAY_SIZE(link->slots); i++) {
+        if (link->slots[i].state == RPC_SLOT_FREE) {
+            link->slots[i].state = RPC_SLOT_RESERVED;
+            slot = &link->slots[i];
+            break;
+        }
+    }
+    k_spin_unlock(&slots_lock, key);
+    __ASSERT_NO_MSG(slot != NULL);
+    return slot;
+}
+
+/* Send the request a reserved slot describes (req_data for single calls,
+ * req_len for encoded ones) and arm its timeout */
+static int slot_submit(ble_central_conn_t *conn, struct rpc_slot *slot, const uint8_t *req_data,
+                       size_t req_len)
+{
+    k_mutex_lock(&send_mutex, K_FOREVER);
+
+    /* Publish the slot before sending: the response may arrive before
+     * container_split_and_send() returns. */
+    k_spinlock_key_t key = k_spin_lock(&slots_lock);
+    slot->transaction_id = next_transaction_id(conn);
+    slot->conn = conn;
+    slot->deadline = sys_timepoint_calc(RPC_TIMEOUT);
+    slot->state = RPC_SLOT_PENDING;
+    k_spin_unlock(&slots_lock, key);
+    k_work_schedule_for_queue(&rpc_work_q, &slot->timeout_work, RPC_TIMEOUT);
+
+    int rc;
+    if (slot->batch) {
+        rc = send_batch(conn, slot->transaction_id, slot->batch, slot->batch_count);
+    } else if (slot->encode) {
+        rc = send_encoded(conn, slot->transaction_id, slot->cmd_id, slot->cmd_name,
+                          slot->name_len, req_len, slot->encode, slot->encode_ctx);
+    } else {
+        rc = send_request(conn, slot->transaction_id, slot->cmd_id, slot->cmd_name,
+                          slot->name_len, req_data, req_len);
+    }
+
+    k_mutex_unlock(&send_mutex);
+
+    if (rc != 0 && slot_claim(slot)) {
+        /* Never sent: release without invoking the callback */
+        k_work_cancel_delayable(&slot->timeout_work);
+        slot_release(slot);
+        return rc;
+    }
+
+    /* rc != 0 but the slot was already claimed means the peripheral answered
+     * (e.g. BUSY) the containers that did go out; the callback has run or is
+     * queued. */
+    return 0;
+}
+
+/* Reserve a slot for a single call and describe it; the response goes to
+ * on_resp if set, else is copied into resp_data. */
+static struct rpc_slot *slot_prepare(ble_central_conn_t *conn, uint8_t cmd_id,
+                                     const char *cmd_name, blerpc_rpc_done_cb_t done,
+                                     void *user_data, k_timeout_t wait)
+{
+    struct rpc_slot *slot = slot_reserve(rpc_link_get(conn), wait);
+    if (!slot) {
+        return NULL;
+    }
+
+    slot->cmd_id = wire_cmd_id(conn, cmd_id);
+    slot->cmd_name = cmd_name;
+    slot->name_len = (uint8_t)strlen(cmd_name);
+    slot->resp_data = NULL;
+    slot->resp_size = 0;
+    slot->on_resp = NULL;
+    slot->resp_ctx = NULL;
+    slot->encode = NULL;
+    slot->encode_ctx = NULL;
+    slot->batch = NULL;
+    slot->batch_count = 0;
+    slot->done = done;
+    slot->user_data = user_data;
+    return slot;
+}
+
+int blerpc_rpc_call_async(ble_central_conn_t *conn, uint8_t cmd_id, const char *cmd_name,
+                          const uint8_t *req_data, size_t req_len, uint8_t *resp_data,
+                          size_t resp_size, blerpc_rpc_done_cb_t done, void *user_data,
+                          k_timeout_t wait)
+{
+    struct rpc_slot *slot = slot_prepare(conn, cmd_id, cmd_name, done, user_data, wait);
+    if (!slot) {
+        return -EAGAIN;
+    }
+
+    slot->resp_data = resp_data;
+    slot->resp_size = resp_size;
+    return slot_submit(conn, slot, req_data, req_len);
+}
+
+int blerpc_rpc_call_loan_async(ble_central_conn_t *conn, uint8_t cmd_id, const char *cmd_name,
+                               const uint8_t *req_data, size_t req_len,
+                               blerpc_rpc_resp_cb_t on_resp, void *resp_ctx,
+                               blerpc_rpc_done_cb_t done, void *user_data, k_timeout_t wait)
+{
+    struct rpc_slot *slot = slot_prepare(conn, cmd_id, cmd_name, done, user_data, wait);
+    if (!slot) {
+        return -EAGAIN;
+    }
+
+    slot->on_resp = on_resp;
+    slot->resp_ctx = resp_ctx;
+    return slot_submit(conn, slot, req_data, req_len);
+}
+
+int blerpc_rpc_call_encode_async(ble_central_conn_t *conn, uint8_t cmd_id, const char *cmd_name,
+                                 size_t req_len, blerpc_rpc_encode_t encode, void *encode_ctx,
+                                 blerpc_rpc_resp_cb_t on_resp, void *resp_ctx,
+                                 blerpc_rpc_done_cb_t done, void *user_data, k_timeout_t wait)
+{
+    struct rpc_slot *slot = slot_prepare(conn, cmd_id, cmd_name, done, user_data, wait);
+    if (!slot) {
+        return -EAGAIN;
+    }
+
+    slot->on_resp = on_resp;
+    slot->resp_ctx = resp_ctx;
+    slot->encode = encode;
+    slot->encode_ctx = encode_ctx;
+    return slot_submit(conn, slot, NULL, req_len);
+}
+
+int blerpc_rpc_call_batch_async(ble_central_conn_t *conn, struct blerpc_batch_call *calls,
+                                size_t count, blerpc_rpc_done_cb_t done, void *user_data,
+                                k_timeout_t wait)
+{
+    if (count == 0) {
+        return -EINVAL;
+    }
+    if (!(ble_central_get_capability_flags(conn) & CAPABILITY_FLAG_BATCH)) {
+        return -ENOTSUP;
+    }
+
+    struct rpc_slot *slot = slot_reserve(rpc_link_get(conn), wait);
+    if (!slot) {
+        return -EAGAIN;
+    }
+
+    slot->cmd_id = 0;
+    slot->cmd_name = NULL;
+    slot->name_len = 0;
+    slot->resp_data = NULL;
+    slot->resp_size = 0;
+    slot->on_resp = NULL;
+    slot->resp_ctx = NULL;
+    slot->encode = NULL;
+    slot->encode_ctx = NULL;
+    slot->batch = calls;
+    slot->batch_count = count;
+    slot->done = done;
+    slot->user_data = user_data;
+
+    return slot_submit(conn, slot, NULL, 0);
+}
+
+int blerpc_rpc_flush(ble_central_conn_t *conn, k_timeout_t timeout)
+{
+    k_timepoint_t end = sys_timepoint_calc(timeout);
+
+    for (size_t l = 0; l < ARRAY_SIZE(rpc_links); l++) {
+        struct rpc_link *link = &rpc_links[l];
+        if (conn && link != rpc_link_get(conn)) {
+            continue;
+        }
+        int rc = window_take_all(link, end);
+        if (rc != 0) {
+            return rc;
+        }
+        window_give_all(link);
+    }
+    return 0;
+}
+
+static size_t link_in_flight(const struct rpc_link *link)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < ARRAY_SIZE(link->slots); i++) {
+        if (link->slots[i].state != RPC_SLOT_FREE) {
+            n++;
+        }
+    }
+    return n;
+}
+
+size_t blerpc_rpc_in_flight(ble_central_conn_t *conn)
+{
+    size_t n = 0;
+    k_spinlock_key_t key = k_spin_lock(&slots_lock);
+    if (conn) {
+        n = link_in_flight(rpc_link_get(conn));
+    } else {
+        for (size_t l = 0; l < ARRAY_SIZE(rpc_links); l++) {
+            n += link_in_flight(&rpc_links[l]);
+        }
+    }
+    k_spin_unlock(&slots_lock, key);
+    return n;
+}
+
+ble_central_conn_t *blerpc_rpc_pick_conn(void)
+{
+    ble_central_conn_t *best = NULL;
+    size_t best_load = SIZE_MAX;
+
+    k_spinlock_key_t key = k_spin_lock(&slots_lock);
+    for (size_t l = 0; l < ARRAY_SIZE(rpc_links); l++) {
+        ble_central_conn_t *conn = ble_central_conn_get(l);
+        if (!conn) {
+            continue;
+        }
+        size_t load = link_in_flight(&rpc_links[l]);
+        if (load < best_load) {
+            best = conn;
+            best_load = load;
+        }
+    }
+    k_spin_unlock(&slots_lock, key);
+    return best;
+}
+
+/* ── RPC transport functions (extern'd by generated_client.h) ────────── */
+
+struct rpc_sync_ctx {
+    struct k_sem done;
+    int status;
+    size_t resp_len;
+};
+
+static void rpc_sync_done(int status, size_t resp_len, void *user_data)
+{
+    struct rpc_sync_ctx *ctx = user_data;
+    ctx->status = status;
+    ctx->resp_len = resp_len;
+    k_sem_give(&ctx->done);
+}
+
+int blerpc_rpc_call(ble_central_conn_t *conn, uint8_t cmd_id, const char *cmd_name,
+                    const uint8_t *req_data, size_t req_len, uint8_t *resp_data,
+                    size_t resp_size, size_t *resp_len)
+{
+    struct rpc_sync_ctx ctx;
+    k_sem_init(&ctx.done, 0, 1);
+
+    int rc = blerpc_rpc_call_async(conn, cmd_id, cmd_name, req_data, req_len, resp_data,
+                                   resp_size, rpc_sync_done, &ctx, RPC_TIMEOUT);
+    if (rc != 0) {
+        LOG_ERR("RPC submit failed: %d", rc);
+        return -1;
+    }
+
+    /* The slot timeout guarantees the callback runs */
+    k_sem_take(&ctx.done, K_FOREVER);
+    if (ctx.status != 0) {
+        LOG_ERR("RPC failed: %d", ctx.status);
+        return -1;
+    }
+
+    *resp_len = ctx.resp_len;
+    return 0;
+}
+
+int blerpc_rpc_call_loan(ble_central_conn_t *conn, uint8_t cmd_id, const char *cmd_name,
+                         const uint8_t *req_data, size_t req_len, blerpc_on_resp_t on_resp,
+                         void *ctx)
+{
+    struct rpc_sync_ctx sync;
+    k_sem_init(&sync.done, 0, 1);
+
+    int rc = blerpc_rpc_call_loan_async(conn, cmd_id, cmd_name, req_data, req_len, on_resp, ctx,
+                                        rpc_sync_done, &sync, RPC_TIMEOUT);
+    if (rc != 0) {
+        LOG_ERR("RPC submit failed: %d", rc);
+        return -1;
+    }
+
+    k_sem_take(&sync.done, K_FOREVER);
+    if (sync.status != 0) {
+        LOG_ERR("RPC failed: %d", sync.status);
+        return -1;
+    }
+    return 0;
+}
+
+int blerpc_rpc_call_encode(ble_central_conn_t *conn, uint8_t cmd_id, const char *cmd_name,
+                           size_t req_len, blerpc_encode_req_t encode, void *encode_ctx,
+                           blerpc_on_resp_t on_resp, void *ctx)
+{
+    struct rpc_sync_ctx sync;
+    k_sem_init(&sync.done, 0, 1);
+
+    int rc = blerpc_rpc_call_encode_async(conn, cmd_id, cmd_name, req_len, encode, encode_ctx,
+                                          on_resp, ctx, rpc_sync_done, &sync, RPC_TIMEOUT);
+    if (rc != 0) {
+        LOG_ERR("RPC submit failed: %d", rc);
+        return -1;
+    }
+
+    k_sem_take(&sync.done, K_FOREVER);
+    if (sync.status != 0) {
+        LOG_ERR("RPC failed: %d", sync.status);
+        return -1;
+    }
+    return 0;
+}
+
+int blerpc_rpc_call_batch(ble_central_conn_t *conn, struct blerpc_batch_call *calls,
+                          size_t count)
+{
+    struct rpc_sync_ctx ctx;
+    k_sem_init(&ctx.done, 0, 1);
+
+    int rc = blerpc_rpc_call_batch_async(conn, calls, count, rpc_sync_done, &ctx, RPC_TIMEOUT);
+    if (rc != 0) {
+        LOG_ERR("Batch submit failed: %d", rc);
+        return -1;
+    }
+
+    k_sem_take(&ctx.done, K_FOREVER);
+    if (ctx.status != 0) {
+        LOG_ERR("Batch failed: %d", ctx.status);
+        return -1;
+    }
+    return 0;
+}
+
+/* Stream end signaling for blerpc_stream_receive */
+static volatile bool _stream_ended;
+
+static void _stream_end_cb(ble_central_conn_t *conn)
+{
+    if (conn != stream_conn) {
+        return;
+    }
+    _stream_ended = true;
+    k_sem_give(&response_sem);
+}
+
+int blerpc_stream_receive(ble_central_conn_t *conn, uint8_t cmd_id, const char *cmd_name,
+                          const uint8_t *req_data, size_t req_len,
+                          blerpc_on_stream_resp_t on_resp, void *ctx)
+{
+    uint8_t name_len = (uint8_t)strlen(cmd_name);
+
+    if (stream_begin(conn) != 0) {
+        return -1;
+    }
+
+    _stream_ended = false;
+    stream_on_resp = on_resp;
+    stream_ctx = ctx;
+    stream_received = 0;
+    ble_central_set_stream_end_cb(_stream_end_cb);
+
+    /* Credits granted ahead of the request pace the stream from its first
+     * message; the rest are granted back as messages are handled */
+    const uint32_t window = CONFIG_BLERPC_RPC_STREAM_CREDITS;
+    bool paced = window > 0 &&
+                 (ble_central_get_capability_flags(conn) & CAPABILITY_FLAG_STREAM_CREDITS);
+    uint32_t granted = paced ? window : 0;
+
+    /* Serialize and send the initial request */
+    k_mutex_lock(&send_mutex, K_FOREVER);
+    int rc = 0;
+    if (paced) {
+        rc = ble_central_send_stream_credit(conn, (uint16_t)window, STREAM_CREDIT_FLAG_COALESCE);
+    }
+    if (rc == 0) {
+        rc = send_request(conn, next_transaction_id(conn), wire_cmd_id(conn, cmd_id), cmd_name,
+                          name_len, req_data, req_len);
+    }
+    k_mutex_unlock(&send_mutex);
+    if (rc != 0) {
+        goto fail;
+    }
+
+    /* Receive responses until STREAM_END_P2C */
+    while (true) {
+        rc = k_sem_take(&response_sem, RPC_TIMEOUT);
+        if (rc != 0) {
+            LOG_ERR("Stream response timeout");
+            goto fail;
+        }
+
+        if (rpc_error_code != 0) {
+            LOG_ERR("Stream error: 0x%02x", rpc_error_code);
+            goto fail;
+        }
+
+        if (stream_status != 0) {
+            goto fail;
+        }
+
+        /* Messages were already handed to on_resp as they arrived */
+        if (_stream_ended) {
+            break;
+        }
+
+        uint32_t handled = stream_received - (granted - window);
+        if (paced && handled > 0 && handled >= (window + 1) / 2) {
+            k_mutex_lock(&send_mutex, K_FOREVER);
+            rc = ble_central_send_stream_credit(conn, (uint16_t)handled,
+                                                STREAM_CREDIT_FLAG_COALESCE);
+            k_mutex_unlock(&send_mutex);
+            if (rc != 0) {
+                LOG_ERR("Stream credit grant failed: %d", rc);
+                goto fail;
+            }
+            granted += handled;
+        }
+    }
+
+    ble_central_set_stream_end_cb(NULL);
+    stream_finish(conn);
+    return 0;
+
+fail:
+    ble_central_set_stream_end_cb(NULL);
+    stream_finish(conn);
+    return -1;
+}
+
+/* Send C2P stream message index as its own request. hdr0 is command byte 0. */
+static int stream_send_single(ble_central_conn_t *conn, uint8_t hdr0, const char *cmd_name,
+                              uint8_t name_len, size_t index, blerpc_next_msg_t next_msg,
+                              void *msg_ctx)
+{
+    /* type(1) + name_len(1) + name + data_len(2); the message is encoded
+     * straight into shared_cmd_buf after the header */
+    size_t cmd_hdr_size = 2 + name_len + 2;
+    uint8_t *msg_buf = shared_cmd_buf + cmd_hdr_size;
+    size_t msg_len;
+
+    k_mutex_lock(&send_mutex, K_FOREVER);
+    if (next_msg(index, msg_buf, sizeof(shared_cmd_buf) - cmd_hdr_size, &msg_len, msg_ctx) !=
+        0) {
+        k_mutex_unlock(&send_mutex);
+        LOG_ERR("next_msg callback failed at %zu", index);
+        return -EINVAL;
+    }
+
+    shared_cmd_buf[0] = hdr0;
+    shared_cmd_buf[1] = name_len;
+    memcpy(shared_cmd_buf + 2, cmd_name, name_len);
+    shared_cmd_buf[2 + name_len] = (uint8_t)(msg_len & 0xFF);
+    shared_cmd_buf[3 + name_len] = (uint8_t)((msg_len >> 8) & 0xFF);
+
+    int rc = send_cmd_buf(conn, next_transaction_id(conn), cmd_hdr_size + msg_len);
+    k_mutex_unlock(&send_mutex);
+    if (rc != 0) {
+        LOG_ERR("Stream message send failed at %zu", index);
+    }
+    return rc;
+}
+
+#if CONFIG_BLERPC_RPC_STREAM_COALESCE_BUF_SIZE > 0
+/* Coalesced C2P stream frame being packed. Only the stream holding
+ * stream_mutex uses it, so it is filled outside send_mutex. */
+static uint8_t stream_frame_buf[CONFIG_BLERPC_RPC_STREAM_COALESCE_BUF_SIZE];
+
+/* Largest coalesced frame that still goes out in one FIRST container */
+static size_t stream_frame_limit(ble_central_conn_t *conn)
+{
+    size_t limit = ble_central_get_mtu(conn) - CONTAINER_ATT_OVERHEAD -
+                   CONTAINER_FIRST_HEADER_SIZE;
+    uint16_t max_req = ble_central_get_max_request_payload_size(conn);
+
+    if (max_req > 0) {
+        limit = MIN(limit, max_req);
+    }
+#ifdef CONFIG_BLERPC_ENCRYPTION
+    if (ble_central_is_encrypted(conn)) {
+        limit -= MIN(limit, BLERPC_ENCRYPTED_OVERHEAD);
+    }
+#endif
+    return MIN(limit, sizeof(stream_frame_buf));
+}
+
+static int stream_frame_send(ble_central_conn_t *conn, size_t hdr_size, size_t frame_len)
+{
+    size_t body_len = frame_len - hdr_size;
+    stream_frame_buf[hdr_size - 2] = (uint8_t)(body_len & 0xFF);
+    stream_frame_buf[hdr_size - 1] = (uint8_t)((body_len >> 8) & 0xFF);
+
+    k_mutex_lock(&send_mutex, K_FOREVER);
+    memcpy(shared_cmd_buf, stream_frame_buf, frame_len);
+    int rc = send_cmd_buf(conn, next_transaction_id(conn), frame_len);
+    k_mutex_unlock(&send_mutex);
+    if (rc != 0) {
+        LOG_ERR("Coalesced stream frame send failed");
+    }
+    return rc;
+}
+
+/* Pack as many messages as fit one container into each coalesced frame:
+ * header [type|BATCH][name_len][name][data_len], then [len(2)][message]
+ * entries. Each message is encoded into the free tail of stream_frame_buf;
+ * one that overflows the frame is moved into the next. A message encode that
+ * fails for lack of room is retried once into an empty frame, and one too
+ * large for the buffer goes out on its own. */
+static int stream_send_coalesced(ble_central_conn_t *conn, uint8_t hdr0, const char *cmd_name,
+                                 uint8_t name_len, size_t msg_count, blerpc_next_msg_t next_msg,
+                                 void *msg_ctx)
+{
+    size_t hdr_size = 2 + name_len + 2;
+    size_t limit = stream_frame_limit(conn);
+    size_t frame_len = hdr_size;
+    size_t frame_count = 0;
+    int rc;
+
+    stream_frame_buf[0] = hdr0 | COMMAND_FLAG_BATCH;
+    stream_frame_buf[1] = name_len;
+    memcpy(stream_frame_buf + 2, cmd_name, name_len);
+
+    for (size_t i = 0; i < msg_count;) {
+        uint8_t *entry = stream_frame_buf + frame_len;
+        size_t room = sizeof(stream_frame_buf) - frame_len;
+        size_t msg_len = 0;
+        bool encoded = room > 2 && next_msg(i, entry + 2, room - 2, &msg_len, msg_ctx) == 0;
+
+        if (!encoded && frame_count == 0) {
+            rc = stream_send_single(conn, hdr0, cmd_name, name_len, i, next_msg, msg_ctx);
+            if (rc != 0) {
+                return rc;
+            }
+            i++;
+            continue;
+        }
+
+        if (!encoded || (frame_count > 0 && frame_len + 2 + msg_len > limit)) {
+            rc = stream_frame_send(conn, hdr_size, frame_len);
+            if (rc != 0) {
+                return rc;
+            }
+            frame_count = 0;
+            frame_len = hdr_size;
+            if (!encoded) {
+                continue;
+            }
+            memmove(stream_frame_buf + hdr_size + 2, entry + 2, msg_len);
+            entry = stream_frame_buf + hdr_size;
+        }
+
+        entry[0] = (uint8_t)(msg_len & 0xFF);
+        entry[1] = (uint8_t)((msg_len >> 8) & 0xFF);
+        frame_len += 2 + msg_len;
+        frame_count++;
+        i++;
+    }
+
+    return frame_count > 0 ? stream_frame_send(conn, hdr_size, frame_len) : 0;
+}
+#endif
+
+int blerpc_stream_send(ble_central_conn_t *conn, uint8_t cmd_id, const char *cmd_name,
+                       size_t msg_count, blerpc_next_msg_t next_msg, void *msg_ctx,
+                       const char *final_cmd_name, uint8_t *resp_data, size_t resp_size,
+                       size_t *resp_len)
+{
+    (void)final_cmd_name;
+    const char id_name = (char)wire_cmd_id(conn, cmd_id);
+    if (id_name) {
+        cmd_name = &id_name;
+    }
+    uint8_t name_len = id_name ? 1 : (uint8_t)strlen(cmd_name);
+    uint8_t hdr0 = ((COMMAND_TYPE_REQUEST & 0x01) << 7) | (id_name ? COMMAND_FLAG_ID : 0);
+    int rc;
+
+    if (stream_begin(conn) != 0) {
+        return -1;
+    }
+    stream_resp_data = resp_data;
+    stream_resp_size = resp_size;
+
+#if CONFIG_BLERPC_RPC_STREAM_COALESCE_BUF_SIZE > 0
+    if ((ble_central_get_capability_flags(conn) & CAPABILITY_FLAG_STREAM_COALESCE) &&
+        stream_frame_limit(conn) > 2 + name_len + 2 + 2) {
+        if (stream_send_coalesced(conn, hdr0, cmd_name, name_len, msg_count, next_msg,
+                                  msg_ctx) != 0) {
+            goto fail;
+        }
+    } else
+#endif
+    {
+        for (size_t i = 0; i < msg_count; i++) {
+            if (stream_send_single(conn, hdr0, cmd_name, name_len, i, next_msg, msg_ctx) !=
+                0) {
+                goto fail;
+            }
+        }
+    }
+
+    /* Send STREAM_END_C2P */
+    if (ble_central_send_stream_end_c2p(conn) < 0) {
+        LOG_ERR("STREAM_END_C2P send failed");
+        goto fail;
+    }
+
+    /* Wait for final response */
+    rc = k_sem_take(&response_sem, RPC_TIMEOUT);
+    if (rc != 0) {
+        LOG_ERR("Final response timeout");
+        goto fail;
+    }
+
+    if (rpc_error_code != 0) {
+        LOG_ERR("RPC error from peripheral: 0x%02x", rpc_error_code);
+        goto fail;
+    }
+
+    if (stream_status != 0) {
+        goto fail;
+    }
+
+    *resp_len = stream_resp_len;
+    stream_finish(conn);
+    return 0;
+
+fail:
+    stream_finish(conn);
+    return -1;
+}
@@ -0,0 +1,149 @@
+#ifndef BLERPC_RPC_H
+#define BLERPC_RPC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <zephyr/kernel.h>
+#include <pb_encode.h>
+
+#include "ble_central.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Completion callback for a pipelined RPC call.
+ *
+ * Invoked exactly once per successfully submitted call, on the RPC work
+ * queue, which also decodes responses, so the Bluetooth RX thread only
+ * copies them. Must not block and must not submit new calls.
+ *
+ * @param status    0 on success, -ETIMEDOUT, -EBUSY (peripheral had no free
+ *                  request slot), -EMSGSIZE (response too large), -ENOMEM
+ *                  (no room in CONFIG_BLERPC_RPC_RESPONSE_HEAP_SIZE to queue
+ *                  the response) or -EIO
+ * @param resp_len  Number of response bytes copied into the caller's buffer
+ * @param user_data Pointer passed to blerpc_rpc_call_async()
+ */
+typedef void (*blerpc_rpc_done_cb_t)(int status, size_t resp_len, void *user_data);
+
+/**
+ * Initialize the RPC transport and register it with the BLE central module.
+ * Must be called once before ble_central_connect().
+ */
+void blerpc_rpc_init(void);
+
+/**
+ * Submit an RPC call on one link without waiting for its response.
+ *
+ * Up to CONFIG_BLERPC_RPC_WINDOW_SIZE calls may be in flight per link; each
+ * owns a response slot matched by transaction ID. The request is serialized
+ * and sent before this function returns, so req_data may be reused
+ * immediately. cmd_name and resp_data must stay valid until the callback runs.
+ *
+ * @param cmd_id  Generated command ID (BLERPC_CMD_ID_*), sent instead of
+ *                cmd_name when the peripheral supports IDs for this schema;
+ *                0 always sends the name
+ * @param wait    How long to wait for a free window slot on conn
+ * @return 0 if submitted (callback will be invoked), -EAGAIN if no slot
+ *         became free within wait, other negative on send failure
+ */
+int blerpc_rpc_call_async(ble_central_conn_t *conn, uint8_t cmd_id, const char *cmd_name,
+                          const uint8_t *req_data, size_t req_len, uint8_t *resp_data,
+                          size_t resp_size, blerpc_rpc_done_cb_t done, void *user_data,
+                          k_timeout_t wait);
+
+/**
+ * Reader for a loaned response payload.
+ *
+ * Called on the RPC work queue with the command data as the RX thread
+ * queued it, just before the completion callback. data is only valid until
+ * this returns; decode or copy what is needed. Must not block.
+ *
+ * @return 0 on success, nonzero to fail the call with -EIO
+ */
+typedef int (*blerpc_rpc_resp_cb_t)(const uint8_t *data, size_t len, void *ctx);
+
+/**
+ * Like blerpc_rpc_call_async(), but the response is loaned to on_resp instead
+ * of being copied into a caller buffer, so any response size the peripheral
+ * may send is accepted. done receives the payload length as resp_len.
+ */
+int blerpc_rpc_call_loan_async(ble_central_conn_t *conn, uint8_t cmd_id, const char *cmd_name,
+                               const uint8_t *req_data, size_t req_len,
+                               blerpc_rpc_resp_cb_t on_resp, void *resp_ctx,
+                               blerpc_rpc_done_cb_t done, void *user_data, k_timeout_t wait);
+
+/**
+ * Writer for a request payload sent while it is produced.
+ *
+ * Called once, from the submitting thread with the link's send path held,
+ * to write exactly the announced number of bytes into stream (e.g. with
+ * pb_encode()). Each container goes out as soon as it fills, so the request
+ * is never staged in RAM.
+ *
+ * @return true on success; false, or a short write, fails the call
+ */
+typedef bool (*blerpc_rpc_encode_t)(pb_ostream_t *stream, void *ctx);
+
+/**
+ * Like blerpc_rpc_call_loan_async(), but the req_len byte request is written
+ * by encode while it is being sent instead of being passed in a buffer.
+ * Encoded requests always travel in GATT containers, never over the bulk
+ * channel.
+ */
+int blerpc_rpc_call_encode_async(ble_central_conn_t *conn, uint8_t cmd_id, const char *cmd_name,
+                                 size_t req_len, blerpc_rpc_encode_t encode, void *encode_ctx,
+                                 blerpc_rpc_resp_cb_t on_resp, void *resp_ctx,
+                                 blerpc_rpc_done_cb_t done, void *user_data, k_timeout_t wait);
+
+/* One call of a batch, defined by generated_client.h */
+struct blerpc_batch_call;
+
+/**
+ * Submit several calls as one batch request without waiting for the
+ * response.
+ *
+ * The requests travel in one command frame and one transaction, and the
+ * peripheral answers them in order in one batch response, which is split
+ * into each call's resp_data and resp_len before done runs. The batch takes
+ * a single window slot. calls and the buffers they point to must stay valid
+ * until the callback runs. Stream commands cannot be batched. A batch the
+ * peripheral refuses completes with -EBUSY, or -EMSGSIZE if it has more
+ * commands than the peripheral takes or too large a response.
+ *
+ * @return 0 if submitted, -ENOTSUP if the peripheral does not advertise
+ *         CAPABILITY_FLAG_BATCH, -EAGAIN if no slot became free within wait,
+ *         other negative on send failure
+ */
+int blerpc_rpc_call_batch_async(ble_central_conn_t *conn, struct blerpc_batch_call *calls,
+                                size_t count, blerpc_rpc_done_cb_t done, void *user_data,
+                                k_timeout_t wait);
+
+/**
+ * Wait until all in-flight calls on conn (or on every link if conn is NULL)
+ * have completed.
+ * @return 0 on success, -EAGAIN on timeout
+ */
+int blerpc_rpc_flush(ble_central_conn_t *conn, k_timeout_t timeout);
+
+/**
+ * Number of calls currently in flight on conn, or on every link if conn is
+ * NULL.
+ */
+size_t blerpc_rpc_in_flight(ble_central_conn_t *conn);
+
+/**
+ * Pick the connected link with the fewest calls in flight, so callers can
+ * spread independent requests across peripherals.
+ * @return handle, or NULL if no link is connected
+ */
+ble_central_conn_t *blerpc_rpc_pick_conn(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLERPC_RPC_H */
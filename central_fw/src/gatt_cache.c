@@ -0,0 +1,177 @@
+#include "gatt_cache.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/util.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(gatt_cache, LOG_LEVEL_INF);
+
+#define GATT_CACHE_TREE "blerpc/gc"
+/* An address as key: its type and value bytes, in hex */
+#define ADDR_HEX_LEN (2 * sizeof(bt_addr_le_t))
+#define KEY_SIZE (sizeof(GATT_CACHE_TREE "/") + ADDR_HEX_LEN)
+
+struct gatt_cache_entry {
+    bool valid;
+    bt_addr_le_t addr;
+    uint32_t last_used; /* use_clock at the last lookup or store */
+    struct gatt_cache_record rec;
+};
+
+static struct gatt_cache_entry entries[CONFIG_BLERPC_CENTRAL_FAST_CONNECT_CACHE_SIZE];
+static uint32_t use_clock;
+static K_MUTEX_DEFINE(cache_lock);
+
+static void make_key(const bt_addr_le_t *addr, char key[KEY_SIZE])
+{
+    memcpy(key, GATT_CACHE_TREE "/", sizeof(GATT_CACHE_TREE "/") - 1);
+    bin2hex((const uint8_t *)addr, sizeof(*addr), key + sizeof(GATT_CACHE_TREE "/") - 1,
+            ADDR_HEX_LEN + 1);
+}
+
+static struct gatt_cache_entry *entry_find(const bt_addr_le_t *addr)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(entries); i++) {
+        if (entries[i].valid && bt_addr_le_cmp(&entries[i].addr, addr) == 0) {
+            return &entries[i];
+        }
+    }
+    return NULL;
+}
+
+/* A free entry, else the least recently used one */
+static struct gatt_cache_entry *entry_victim(void)
+{
+    struct gatt_cache_entry *victim = &entries[0];
+    for (size_t i = 0; i < ARRAY_SIZE(entries); i++) {
+        if (!entries[i].valid) {
+            return &entries[i];
+        }
+        if (entries[i].last_used < victim->last_used) {
+            victim = &entries[i];
+        }
+    }
+    return victim;
+}
+
+static int cache_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg)
+{
+    const char *next;
+    bt_addr_le_t addr;
+
+    if (settings_name_next(name, &next) != ADDR_HEX_LEN || next ||
+        hex2bin(name, ADDR_HEX_LEN, (uint8_t *)&addr, sizeof(addr)) != sizeof(addr)) {
+        return -ENOENT;
+    }
+    if (len != sizeof(struct gatt_cache_record)) {
+        /* Written by a build with another record layout */
+        LOG_WRN("Ignoring cached record of %zu bytes", len);
+        return 0;
+    }
+
+    k_mutex_lock(&cache_lock, K_FOREVER);
+    struct gatt_cache_entry *e = entry_find(&addr);
+    if (!e) {
+        e = entry_victim();
+    }
+    int rc = read_cb(cb_arg, &e->rec, sizeof(e->rec));
+    if (rc == sizeof(e->rec)) {
+        bt_addr_le_copy(&e->addr, &addr);
+        e->last_used = ++use_clock;
+        e->valid = true;
+    }
+    k_mutex_unlock(&cache_lock);
+    return rc < 0 ? rc : 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(blerpc_gatt_cache, GATT_CACHE_TREE, NULL, cache_set, NULL, NULL);
+
+bool gatt_cache_lookup(const bt_addr_le_t *addr, struct gatt_cache_record *out)
+{
+    k_mutex_lock(&cache_lock, K_FOREVER);
+    struct gatt_cache_entry *e = entry_find(addr);
+    if (e) {
+        *out = e->rec;
+        e->last_used = ++use_clock;
+    }
+    k_mutex_unlock(&cache_lock);
+    return e != NULL;
+}
+
+int gatt_cache_store(const bt_addr_le_t *addr, const struct gatt_cache_record *rec)
+{
+    char key[KEY_SIZE];
+    int rc = 0;
+
+    k_mutex_lock(&cache_lock, K_FOREVER);
+    struct gatt_cache_entry *e = entry_find(addr);
+    if (e && memcmp(&e->rec, rec, sizeof(*rec)) == 0) {
+        goto out;
+    }
+    if (!e) {
+        e = entry_victim();
+        if (e->valid) {
+            make_key(&e->addr, key);
+            settings_delete(key);
+        }
+        bt_addr_le_copy(&e->addr, addr);
+        e->valid = true;
+    }
+    e->rec = *rec;
+    e->last_used = ++use_clock;
+
+    make_key(addr, key);
+    rc = settings_save_one(key, rec, sizeof(*rec));
+    if (rc) {
+        LOG_WRN("Saving cached handles failed (err %d)", rc);
+    }
+out:
+    k_mutex_unlock(&cache_lock);
+    return rc;
+}
+
+void gatt_cache_forget(const bt_addr_le_t *addr)
+{
+    char key[KEY_SIZE];
+
+    k_mutex_lock(&cache_lock, K_FOREVER);
+    struct gatt_cache_entry *e = entry_find(addr);
+    if (e) {
+        e->valid = false;
+        make_key(addr, key);
+        settings_delete(key);
+    }
+    k_mutex_unlock(&cache_lock);
+}
+
+size_t gatt_cache_addrs(bt_addr_le_t *out, size_t max)
+{
+    uint32_t used[ARRAY_SIZE(entries)];
+    size_t n = 0;
+
+    max = MIN(max, ARRAY_SIZE(entries));
+    k_mutex_lock(&cache_lock, K_FOREVER);
+    for (size_t i = 0; i < ARRAY_SIZE(entries); i++) {
+        if (!entries[i].valid) {
+            continue;
+        }
+        /* Insertion sort, newest first; the table is a handful of entries */
+        size_t pos = n;
+        while (pos > 0 && used[pos - 1] < entries[i].last_used) {
+            pos--;
+        }
+        if (pos >= max) {
+            continue;
+        }
+        size_t tail = MIN(n, max - 1) - pos;
+        memmove(&out[pos + 1], &out[pos], tail * sizeof(out[0]));
+        memmove(&used[pos + 1], &used[pos], tail * sizeof(used[0]));
+        bt_addr_le_copy(&out[pos], &entries[i].addr);
+        used[pos] = entries[i].last_used;
+        n = MIN(n + 1, max);
+    }
+    k_mutex_unlock(&cache_lock);
+    return n;
+}
@@ -0,0 +1,66 @@
+#ifndef BLERPC_GATT_CACHE_H
+#define BLERPC_GATT_CACHE_H
+
+#include <zephyr/bluetooth/addr.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * What a connect learns about a peripheral before its first RPC, kept in
+ * settings under "blerpc/gc/<address>" so the next connect to the same
+ * address can skip GATT discovery and the wait for capabilities.
+ *
+ * Entries are loaded by settings_load(), at most
+ * CONFIG_BLERPC_CENTRAL_FAST_CONNECT_CACHE_SIZE of them; storing another
+ * drops the least recently used. A record that fails to subscribe or whose
+ * schema hash changed is forgotten, and one whose other capabilities
+ * changed is rewritten.
+ */
+
+/** Handles and capabilities of one peripheral. */
+struct gatt_cache_record {
+    uint16_t value_handle;
+    uint16_t ccc_handle;
+    uint16_t max_request_payload_size;
+    uint16_t max_response_payload_size;
+    uint16_t capability_flags;
+    uint16_t schema_hash;
+    uint16_t inflate_limit;
+    uint16_t bulk_psm;
+    int8_t rssi; /* of the advertisement last connected from */
+};
+
+/**
+ * Get the record for addr.
+ * @return true if there is one
+ */
+bool gatt_cache_lookup(const bt_addr_le_t *addr, struct gatt_cache_record *out);
+
+/**
+ * Store the record for addr, in RAM and in settings. Records equal to the
+ * stored one are not written again.
+ * @return 0 on success, negative settings error
+ */
+int gatt_cache_store(const bt_addr_le_t *addr, const struct gatt_cache_record *rec);
+
+/**
+ * Drop the record for addr, if any.
+ */
+void gatt_cache_forget(const bt_addr_le_t *addr);
+
+/**
+ * List the cached addresses, most recently used first.
+ * @return number written to out
+ */
+size_t gatt_cache_addrs(bt_addr_le_t *out, size_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLERPC_GATT_CACHE_H */
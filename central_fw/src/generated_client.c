@@ -1,10 +1,18 @@
 /* Auto-generated by generate-handlers — DO NOT EDIT */
 #include "generated_client.h"
 
-#ifndef BLERPC_GENERATED_RESP_BUF_SIZE
-#define BLERPC_GENERATED_RESP_BUF_SIZE 4096
-#endif
-static uint8_t _blerpc_resp_buf[BLERPC_GENERATED_RESP_BUF_SIZE];
+/* Decode context for a loaned unary response */
+struct _blerpc_msg_decode_ctx {
+    const pb_msgdesc_t *fields;
+    void *msg;
+};
+
+static int _blerpc_decode_msg(const uint8_t *data, size_t len, void *ctx)
+{
+    const struct _blerpc_msg_decode_ctx *c = ctx;
+    pb_istream_t istream = pb_istream_from_buffer(data, len);
+    return pb_decode(&istream, c->fields, c->msg) ? 0 : -1;
+}
 
 /* Decode context for FT_CALLBACK bytes fields */
 struct _blerpc_bytes_decode_ctx {
@@ -26,6 +34,54 @@ static bool _blerpc_decode_bytes_cb(pb_istream_t *stream,
     return true;
 }
 
+/* Bytes pulled from a producer per call */
+#ifndef BLERPC_PRODUCE_CHUNK_SIZE
+#define BLERPC_PRODUCE_CHUNK_SIZE 64
+#endif
+
+/* Encode context for FT_CALLBACK bytes fields read from a producer */
+struct _blerpc_bytes_produce_ctx {
+    size_t len;
+    blerpc_produce_t produce;
+    void *ctx;
+};
+
+static bool _blerpc_encode_produced_cb(pb_ostream_t *stream,
+                                        const pb_field_t *field,
+                                        void *const *arg)
+{
+    const struct _blerpc_bytes_produce_ctx *ctx =
+        *(const struct _blerpc_bytes_produce_ctx **)arg;
+    if (!pb_encode_tag_for_field(stream, field)) return false;
+    if (!pb_encode_varint(stream, ctx->len)) return false;
+    /* Sizing pass: count the bytes without producing them */
+    if (stream->callback == NULL) return pb_write(stream, NULL, ctx->len);
+
+    uint8_t chunk[BLERPC_PRODUCE_CHUNK_SIZE];
+    size_t off = 0;
+    while (off < ctx->len) {
+        size_t want = ctx->len - off;
+        if (want > sizeof(chunk)) want = sizeof(chunk);
+        int n = ctx->produce(off, chunk, want, ctx->ctx);
+        if (n <= 0 || (size_t)n > want) return false;
+        if (!pb_write(stream, chunk, (size_t)n)) return false;
+        off += (size_t)n;
+    }
+    return true;
+}
+
+/* Whole-message writer for blerpc_rpc_call_encode() */
+struct _blerpc_msg_encode_ctx {
+    const pb_msgdesc_t *fields;
+    const void *msg;
+};
+
+static bool _blerpc_encode_msg(pb_ostream_t *stream, void *ctx)
+{
+    const struct _blerpc_msg_encode_ctx *c = ctx;
+    return pb_encode(stream, c->fields, c->msg);
+}
+
 /* Encode context for FT_CALLBACK bytes fields */
 struct _blerpc_bytes_encode_ctx {
     const uint8_t *data;
@@ -43,7 +99,96 @@ static bool _blerpc_encode_bytes_cb(pb_ostream_t *stream,
     return pb_write(stream, ctx->data, ctx->data_len);
 }
 
-int blerpc_echo(const char *message, blerpc_EchoResponse *resp)
+/* Direct codecs for fixed-layout stream messages: the bytes pb_encode()
+ * writes, without walking nanopb's field tables */
+static uint8_t *_blerpc_put_varint32(uint8_t *p, uint32_t v)
+{
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+static uint8_t *_blerpc_put_varint(uint8_t *p, uint64_t v)
+{
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+/* NULL if the varint is truncated, longer than ten bytes or over 64 bits */
+static const uint8_t *_blerpc_get_varint(const uint8_t *p, const uint8_t *end,
+                                         uint64_t *out)
+{
+    uint64_t v = 0;
+    for (unsigned int shift = 0; shift < 70 && p < end; shift += 7) {
+        uint8_t byte = *p++;
+        if (shift == 63 && (byte & 0x7E)) {
+            return NULL; /* bits past 64, nanopb's "varint overflow" */
+        }
+        v |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *out = v;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+static size_t _blerpc_CounterUploadRequest_encode_direct(const blerpc_CounterUploadRequest *msg, uint8_t *buf)
+{
+    uint8_t *p = buf;
+    if (msg->seq) {
+        *p++ = 0x08;
+        p = _blerpc_put_varint32(p, msg->seq);
+    }
+    if (msg->value) {
+        *p++ = 0x10;
+        p = _blerpc_put_varint(p, (uint64_t)(int64_t)msg->value);
+    }
+    return (size_t)(p - buf);
+}
+
+static bool _blerpc_CounterStreamResponse_decode_direct(const uint8_t *data, size_t len, blerpc_CounterStreamResponse *msg)
+{
+    const uint8_t *p = data;
+    const uint8_t *end = data + len;
+    uint64_t tag;
+    uint64_t v;
+
+    *msg = (blerpc_CounterStreamResponse)blerpc_CounterStreamResponse_init_zero;
+    while (p < end) {
+        p = _blerpc_get_varint(p, end, &tag);
+        p = p ? _blerpc_get_varint(p, end, &v) : NULL;
+        if (!p) goto fallback;
+        switch (tag) {
+        case 0x08:
+            if (v > UINT32_MAX) goto fallback;
+            msg->seq = (uint32_t)v;
+            break;
+        case 0x10:
+            if ((int64_t)v < INT32_MIN || (int64_t)v > INT32_MAX) goto fallback;
+            msg->value = (int32_t)v;
+            break;
+        default:
+            goto fallback;
+        }
+    }
+    return true;
+
+fallback:;
+    /* Not the layout this codec knows: nanopb decides */
+    pb_istream_t stream = pb_istream_from_buffer(data, len);
+    *msg = (blerpc_CounterStreamResponse)blerpc_CounterStreamResponse_init_zero;
+    return pb_decode(&stream, blerpc_CounterStreamResponse_fields, msg);
+}
+
+int blerpc_echo(struct blerpc_conn *conn, const char *message, blerpc_EchoResponse *resp)
 {
     blerpc_EchoRequest req = blerpc_EchoRequest_init_zero;
     strncpy(req.message, message, sizeof(req.message) - 1);
@@ -52,19 +197,17 @@ int blerpc_echo(const char *message, blerpc_EchoResponse *resp)
     pb_ostream_t ostream = pb_ostream_from_buffer(req_buf, sizeof(req_buf));
     if (!pb_encode(&ostream, blerpc_EchoRequest_fields, &req)) return -1;
 
-    uint8_t resp_buf[blerpc_EchoResponse_size];
-    size_t resp_len;
-    if (blerpc_rpc_call("echo", req_buf, ostream.bytes_written,
-                        resp_buf, sizeof(resp_buf), &resp_len) != 0) return -1;
-
     *resp = (blerpc_EchoResponse)blerpc_EchoResponse_init_zero;
-    pb_istream_t istream = pb_istream_from_buffer(resp_buf, resp_len);
-    if (!pb_decode(&istream, blerpc_EchoResponse_fields, resp)) return -1;
+    struct _blerpc_msg_decode_ctx dctx = {
+        .fields = blerpc_EchoResponse_fields, .msg = resp
+    };
+    if (blerpc_rpc_call_loan(conn, BLERPC_CMD_ID_ECHO, "echo", req_buf,
+                             ostream.bytes_written, _blerpc_decode_msg, &dctx) != 0) return -1;
 
     return 0;
 }
 
-int blerpc_flash_read(uint32_t address, uint32_t length, blerpc_FlashReadResponse *resp, uint8_t *data_buf, size_t data_buf_size, size_t *data_len)
+int blerpc_flash_read(struct blerpc_conn *conn, uint32_t address, uint32_t length, blerpc_FlashReadResponse *resp, uint8_t *data_buf, size_t data_buf_size, size_t *data_len)
 {
     blerpc_FlashReadRequest req = blerpc_FlashReadRequest_init_zero;
     req.address = address;
@@ -74,26 +217,24 @@ int blerpc_flash_read(uint32_t address, uint32_t length, blerpc_FlashReadRespons
     pb_ostream_t ostream = pb_ostream_from_buffer(req_buf, sizeof(req_buf));
     if (!pb_encode(&ostream, blerpc_FlashReadRequest_fields, &req)) return -1;
 
-    size_t resp_len;
-    if (blerpc_rpc_call("flash_read", req_buf, ostream.bytes_written,
-                        _blerpc_resp_buf, sizeof(_blerpc_resp_buf),
-                        &resp_len) != 0) return -1;
-
     struct _blerpc_bytes_decode_ctx _data_ctx = {
         .buf = data_buf, .buf_size = data_buf_size, .decoded_len = 0
     };
     *resp = (blerpc_FlashReadResponse)blerpc_FlashReadResponse_init_zero;
     resp->data.funcs.decode = _blerpc_decode_bytes_cb;
     resp->data.arg = &_data_ctx;
-    pb_istream_t istream = pb_istream_from_buffer(_blerpc_resp_buf, resp_len);
-    if (!pb_decode(&istream, blerpc_FlashReadResponse_fields, resp)) return -1;
+    struct _blerpc_msg_decode_ctx dctx = {
+        .fields = blerpc_FlashReadResponse_fields, .msg = resp
+    };
+    if (blerpc_rpc_call_loan(conn, BLERPC_CMD_ID_FLASH_READ, "flash_read", req_buf,
+                             ostream.bytes_written, _blerpc_decode_msg, &dctx) != 0) return -1;
 
     *data_len = _data_ctx.decoded_len;
 
     return 0;
 }
 
-int blerpc_data_write(const uint8_t *data, size_t data_len, uint8_t *work_buf, size_t work_buf_size, blerpc_DataWriteResponse *resp)
+int blerpc_data_write(struct blerpc_conn *conn, const uint8_t *data, size_t data_len, uint8_t *work_buf, size_t work_buf_size, blerpc_DataWriteResponse *resp)
 {
     struct _blerpc_bytes_encode_ctx _data_ctx = {
         .data = data, .data_len = data_len
@@ -109,14 +250,12 @@ int blerpc_data_write(const uint8_t *data, size_t data_len, uint8_t *work_buf, s
     pb_ostream_t ostream = pb_ostream_from_buffer(work_buf, work_buf_size);
     if (!pb_encode(&ostream, blerpc_DataWriteRequest_fields, &req)) return -1;
 
-    uint8_t resp_buf[blerpc_DataWriteResponse_size];
-    size_t resp_len;
-    if (blerpc_rpc_call("data_write", work_buf, ostream.bytes_written,
-                        resp_buf, sizeof(resp_buf), &resp_len) != 0) return -1;
-
     *resp = (blerpc_DataWriteResponse)blerpc_DataWriteResponse_init_zero;
-    pb_istream_t istream = pb_istream_from_buffer(resp_buf, resp_len);
-    if (!pb_decode(&istream, blerpc_DataWriteResponse_fields, resp)) return -1;
+    struct _blerpc_msg_decode_ctx dctx = {
+        .fields = blerpc_DataWriteResponse_fields, .msg = resp
+    };
+    if (blerpc_rpc_call_loan(conn, BLERPC_CMD_ID_DATA_WRITE, "data_write", work_buf,
+                             ostream.bytes_written, _blerpc_decode_msg, &dctx) != 0) return -1;
 
     return 0;
 }
@@ -132,14 +271,12 @@ static int _blerpc_counter_stream_on_resp(const uint8_t *data, size_t len,
 {
     struct _blerpc_counter_stream_ctx *c = (struct _blerpc_counter_stream_ctx *)ctx;
     if (c->count >= c->max_results) return -1;
-    c->results[c->count] = (blerpc_CounterStreamResponse)blerpc_CounterStreamResponse_init_zero;
-    pb_istream_t istream = pb_istream_from_buffer(data, len);
-    if (!pb_decode(&istream, blerpc_CounterStreamResponse_fields, &c->results[c->count])) return -1;
+    if (!_blerpc_CounterStreamResponse_decode_direct(data, len, &c->results[c->count])) return -1;
     c->count++;
     return 0;
 }
 
-int blerpc_counter_stream(uint32_t count, blerpc_CounterStreamResponse *results, size_t max_results, size_t *result_count)
+int blerpc_counter_stream(struct blerpc_conn *conn, uint32_t count, blerpc_CounterStreamResponse *results, size_t max_results, size_t *result_count)
 {
     blerpc_CounterStreamRequest req = blerpc_CounterStreamRequest_init_zero;
     req.count = count;
@@ -151,8 +288,9 @@ int blerpc_counter_stream(uint32_t count, blerpc_CounterStreamResponse *results,
     struct _blerpc_counter_stream_ctx ctx = {
         .results = results, .max_results = max_results, .count = 0
     };
-    if (blerpc_stream_receive("counter_stream", req_buf, ostream.bytes_written,
-                              _blerpc_counter_stream_on_resp, &ctx) != 0) return -1;
+    if (blerpc_stream_receive(conn, BLERPC_CMD_ID_COUNTER_STREAM, "counter_stream", req_buf,
+                              ostream.bytes_written, _blerpc_counter_stream_on_resp,
+                              &ctx) != 0) return -1;
 
     *result_count = ctx.count;
     return 0;
@@ -166,19 +304,21 @@ static int _blerpc_counter_upload_next(size_t index, uint8_t *buf,
                                          size_t buf_size, size_t *len, void *ctx)
 {
     struct _blerpc_counter_upload_ctx *c = (struct _blerpc_counter_upload_ctx *)ctx;
-    pb_ostream_t ostream = pb_ostream_from_buffer(buf, buf_size);
-    if (!pb_encode(&ostream, blerpc_CounterUploadRequest_fields, &c->messages[index])) return -1;
-    *len = ostream.bytes_written;
+    uint8_t msg_buf[blerpc_CounterUploadRequest_size];
+    size_t msg_len = _blerpc_CounterUploadRequest_encode_direct(&c->messages[index], msg_buf);
+    if (msg_len > buf_size) return -1;
+    memcpy(buf, msg_buf, msg_len);
+    *len = msg_len;
     return 0;
 }
 
-int blerpc_counter_upload(const blerpc_CounterUploadRequest *messages, size_t msg_count, blerpc_CounterUploadResponse *resp)
+int blerpc_counter_upload(struct blerpc_conn *conn, const blerpc_CounterUploadRequest *messages, size_t msg_count, blerpc_CounterUploadResponse *resp)
 {
     struct _blerpc_counter_upload_ctx ctx = { .messages = messages };
 
     uint8_t resp_buf[blerpc_CounterUploadResponse_size];
     size_t resp_len;
-    if (blerpc_stream_send("counter_upload", msg_count,
+    if (blerpc_stream_send(conn, BLERPC_CMD_ID_COUNTER_UPLOAD, "counter_upload", msg_count,
                            _blerpc_counter_upload_next, &ctx,
                            "counter_upload", resp_buf, sizeof(resp_buf),
                            &resp_len) != 0) return -1;
@@ -190,3 +330,96 @@ int blerpc_counter_upload(const blerpc_CounterUploadRequest *messages, size_t ms
     return 0;
 }
 
+int blerpc_flash_dump(struct blerpc_conn *conn, uint32_t address, uint32_t length, blerpc_on_stream_resp_t on_resp, void *ctx)
+{
+    blerpc_FlashDumpRequest req = blerpc_FlashDumpRequest_init_zero;
+    req.address = address;
+    req.length = length;
+
+    uint8_t req_buf[blerpc_FlashDumpRequest_size];
+    pb_ostream_t ostream = pb_ostream_from_buffer(req_buf, sizeof(req_buf));
+    if (!pb_encode(&ostream, blerpc_FlashDumpRequest_fields, &req)) return -1;
+
+    return blerpc_stream_receive(conn, BLERPC_CMD_ID_FLASH_DUMP, "flash_dump", req_buf,
+                                 ostream.bytes_written, on_resp, ctx);
+}
+
+int blerpc_data_write_streamed(struct blerpc_conn *conn, size_t data_len, blerpc_produce_t data_produce, void *data_ctx, blerpc_DataWriteResponse *resp)
+{
+    struct _blerpc_bytes_produce_ctx _data_ctx = {
+        .len = data_len, .produce = data_produce, .ctx = data_ctx
+    };
+    blerpc_DataWriteRequest req = blerpc_DataWriteRequest_init_zero;
+    req.data.funcs.encode = _blerpc_encode_produced_cb;
+    req.data.arg = &_data_ctx;
+
+    pb_ostream_t sizing = PB_OSTREAM_SIZING;
+    if (!pb_encode(&sizing, blerpc_DataWriteRequest_fields, &req)) return -1;
+
+    *resp = (blerpc_DataWriteResponse)blerpc_DataWriteResponse_init_zero;
+    struct _blerpc_msg_encode_ctx ectx = {
+        .fields = blerpc_DataWriteRequest_fields, .msg = &req
+    };
+    struct _blerpc_msg_decode_ctx dctx = {
+        .fields = blerpc_DataWriteResponse_fields, .msg = resp
+    };
+    if (blerpc_rpc_call_encode(conn, BLERPC_CMD_ID_DATA_WRITE, "data_write", sizing.bytes_written,
+                               _blerpc_encode_msg, &ectx, _blerpc_decode_msg,
+                               &dctx) != 0) return -1;
+
+    return 0;
+}
+
+void blerpc_batch_init(struct blerpc_batch *batch)
+{
+    batch->count = 0;
+    batch->used = 0;
+}
+
+/* Encode a request into the batch buffer and reserve its response space */
+static int _blerpc_batch_add(struct blerpc_batch *batch, uint8_t cmd_id,
+                             const char *cmd_name, const pb_msgdesc_t *req_fields,
+                             const void *req, const pb_msgdesc_t *resp_fields,
+                             size_t resp_size, void *resp)
+{
+    if (batch->count >= BLERPC_BATCH_MAX_CALLS) return -1;
+    uint8_t *req_buf = batch->buf + batch->used;
+    size_t left = sizeof(batch->buf) - batch->used;
+    pb_ostream_t ostream = pb_ostream_from_buffer(req_buf, left);
+    if (!pb_encode(&ostream, req_fields, req)) return -1;
+    if (resp_size > left - ostream.bytes_written) return -1;
+
+    struct blerpc_batch_call *call = &batch->calls[batch->count];
+    call->cmd_id = cmd_id;
+    call->cmd_name = cmd_name;
+    call->req_data = req_buf;
+    call->req_len = ostream.bytes_written;
+    call->resp_data = req_buf + ostream.bytes_written;
+    call->resp_size = resp_size;
+    call->resp_len = 0;
+    batch->resp_fields[batch->count] = resp_fields;
+    batch->resp[batch->count] = resp;
+    batch->count++;
+    batch->used += ostream.bytes_written + resp_size;
+    return 0;
+}
+
+int blerpc_batch_send(struct blerpc_conn *conn, struct blerpc_batch *batch)
+{
+    if (blerpc_rpc_call_batch(conn, batch->calls, batch->count) != 0) return -1;
+    for (size_t i = 0; i < batch->count; i++) {
+        pb_istream_t istream =
+            pb_istream_from_buffer(batch->calls[i].resp_data, batch->calls[i].resp_len);
+        if (!pb_decode(&istream, batch->resp_fields[i], batch->resp[i])) return -1;
+    }
+    return 0;
+}
+
+int blerpc_batch_echo(struct blerpc_batch *batch, const char *message, blerpc_EchoResponse *resp)
+{
+    blerpc_EchoRequest req = blerpc_EchoRequest_init_zero;
+    strncpy(req.message, message, sizeof(req.message) - 1);
+    return _blerpc_batch_add(batch, BLERPC_CMD_ID_ECHO, "echo", blerpc_EchoRequest_fields, &req,
+                             blerpc_EchoResponse_fields, blerpc_EchoResponse_size, resp);
+}
+
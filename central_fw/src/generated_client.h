@@ -17,30 +17,116 @@ extern "C" {
 /* Callback for P2C streaming response payloads */
 typedef int (*blerpc_on_stream_resp_t)(const uint8_t *data, size_t len, void *ctx);
 
+/* Callback for a unary response payload. data is loaned from the transport's
+ * receive buffer and only valid until the callback returns. */
+typedef int (*blerpc_on_resp_t)(const uint8_t *data, size_t len, void *ctx);
+
+/* Producer for a streamed bytes field: fill buf with up to size bytes of the
+ * field starting at offset. Returns the number of bytes written (> 0), or
+ * negative on error. */
+typedef int (*blerpc_produce_t)(size_t offset, uint8_t *buf, size_t size, void *ctx);
+
+/* Writer for a request payload of exactly the announced length */
+typedef bool (*blerpc_encode_req_t)(pb_ostream_t *stream, void *ctx);
+
 /* Callback for C2P streaming message serialization */
 typedef int (*blerpc_next_msg_t)(size_t index, uint8_t *buf, size_t buf_size,
                                  size_t *len, void *ctx);
 
-/* User-provided RPC transport functions */
-extern int blerpc_rpc_call(const char *cmd_name,
-                           const uint8_t *req_data, size_t req_len,
+/* Connection handle, defined by the transport */
+struct blerpc_conn;
+
+/* User-provided RPC transport functions. cmd_id is the command's wire ID,
+ * which the transport may send instead of cmd_name when the peer's schema
+ * hash matches BLERPC_SCHEMA_HASH. */
+extern int blerpc_rpc_call(struct blerpc_conn *conn, uint8_t cmd_id,
+                           const char *cmd_name, const uint8_t *req_data, size_t req_len,
                            uint8_t *resp_data, size_t resp_size, size_t *resp_len);
 
-extern int blerpc_stream_receive(const char *cmd_name,
-                                 const uint8_t *req_data, size_t req_len,
-                                 blerpc_on_stream_resp_t on_resp, void *ctx);
+/* Like blerpc_rpc_call(), but hands the response payload to on_resp in place
+ * instead of copying it out; on_resp runs before this returns. */
+extern int blerpc_rpc_call_loan(struct blerpc_conn *conn, uint8_t cmd_id,
+                                const char *cmd_name, const uint8_t *req_data,
+                                size_t req_len, blerpc_on_resp_t on_resp, void *ctx);
 
-extern int blerpc_stream_send(const char *cmd_name, size_t msg_count,
+/* Like blerpc_rpc_call_loan(), but encode writes the req_len byte request
+ * into a stream that sends it as it is produced, so it is never staged. */
+extern int blerpc_rpc_call_encode(struct blerpc_conn *conn, uint8_t cmd_id,
+                                  const char *cmd_name, size_t req_len,
+                                  blerpc_encode_req_t encode, void *encode_ctx,
+                                  blerpc_on_resp_t on_resp, void *ctx);
+
+extern int blerpc_stream_receive(struct blerpc_conn *conn, uint8_t cmd_id,
+                                 const char *cmd_name, const uint8_t *req_data,
+                                 size_t req_len, blerpc_on_stream_resp_t on_resp,
+                                 void *ctx);
+
+extern int blerpc_stream_send(struct blerpc_conn *conn, uint8_t cmd_id,
+                              const char *cmd_name, size_t msg_count,
                               blerpc_next_msg_t next_msg, void *msg_ctx,
                               const char *final_cmd_name,
                               uint8_t *resp_data, size_t resp_size, size_t *resp_len);
 
+/* Command IDs for the 1-byte wire form, dense in schema order: append new
+ * commands to keep existing IDs stable. 0 means the command has no ID. */
+#define BLERPC_CMD_ID_ECHO 1
+#define BLERPC_CMD_ID_FLASH_READ 2
+#define BLERPC_CMD_ID_DATA_WRITE 3
+#define BLERPC_CMD_ID_COUNTER_STREAM 4
+#define BLERPC_CMD_ID_COUNTER_UPLOAD 5
+#define BLERPC_CMD_ID_FLASH_DUMP 6
+#define BLERPC_CMD_COUNT 6
+
+/* Identifies the ID assignment; peers only use IDs when theirs match */
+#define BLERPC_SCHEMA_HASH 0x59de
+
+/* Batched calls: blerpc_batch_<command>() queues a request and blerpc_batch_send()
+ * sends the queue as one command frame, then decodes every response */
+#ifndef BLERPC_BATCH_MAX_CALLS
+#define BLERPC_BATCH_MAX_CALLS 32
+#endif
+#ifndef BLERPC_BATCH_BUF_SIZE
+#define BLERPC_BATCH_BUF_SIZE 1024
+#endif
+
+struct blerpc_batch_call {
+    uint8_t cmd_id;
+    const char *cmd_name;
+    const uint8_t *req_data;
+    size_t req_len;
+    uint8_t *resp_data;
+    size_t resp_size;
+    size_t resp_len; /* set by the transport */
+};
+
+struct blerpc_batch {
+    struct blerpc_batch_call calls[BLERPC_BATCH_MAX_CALLS];
+    const pb_msgdesc_t *resp_fields[BLERPC_BATCH_MAX_CALLS];
+    void *resp[BLERPC_BATCH_MAX_CALLS];
+    size_t count;
+    size_t used; /* bytes of buf taken by encoded requests and response space */
+    uint8_t buf[BLERPC_BATCH_BUF_SIZE];
+};
+
+extern int blerpc_rpc_call_batch(struct blerpc_conn *conn,
+                                 struct blerpc_batch_call *calls, size_t count);
+
 /* Generated typed RPC functions */
-int blerpc_echo(const char *message, blerpc_EchoResponse *resp);
-int blerpc_flash_read(uint32_t address, uint32_t length, blerpc_FlashReadResponse *resp, uint8_t *data_buf, size_t data_buf_size, size_t *data_len);
-int blerpc_data_write(const uint8_t *data, size_t data_len, uint8_t *work_buf, size_t work_buf_size, blerpc_DataWriteResponse *resp);
-int blerpc_counter_stream(uint32_t count, blerpc_CounterStreamResponse *results, size_t max_results, size_t *result_count);
-int blerpc_counter_upload(const blerpc_CounterUploadRequest *messages, size_t msg_count, blerpc_CounterUploadResponse *resp);
+int blerpc_echo(struct blerpc_conn *conn, const char *message, blerpc_EchoResponse *resp);
+int blerpc_flash_read(struct blerpc_conn *conn, uint32_t address, uint32_t length, blerpc_FlashReadResponse *resp, uint8_t *data_buf, size_t data_buf_size, size_t *data_len);
+int blerpc_data_write(struct blerpc_conn *conn, const uint8_t *data, size_t data_len, uint8_t *work_buf, size_t work_buf_size, blerpc_DataWriteResponse *resp);
+int blerpc_counter_stream(struct blerpc_conn *conn, uint32_t count, blerpc_CounterStreamResponse *results, size_t max_results, size_t *result_count);
+int blerpc_counter_upload(struct blerpc_conn *conn, const blerpc_CounterUploadRequest *messages, size_t msg_count, blerpc_CounterUploadResponse *resp);
+int blerpc_flash_dump(struct blerpc_conn *conn, uint32_t address, uint32_t length, blerpc_on_stream_resp_t on_resp, void *ctx);
+
+/* Generated streamed-request functions: bytes fields are pulled from a
+ * producer while the request is sent instead of passed in a buffer */
+int blerpc_data_write_streamed(struct blerpc_conn *conn, size_t data_len, blerpc_produce_t data_produce, void *data_ctx, blerpc_DataWriteResponse *resp);
+
+/* Generated batch functions */
+void blerpc_batch_init(struct blerpc_batch *batch);
+int blerpc_batch_send(struct blerpc_conn *conn, struct blerpc_batch *batch);
+int blerpc_batch_echo(struct blerpc_batch *batch, const char *message, blerpc_EchoResponse *resp);
 
 #ifdef __cplusplus
 }
@@ -1,332 +1,211 @@
 #include <zephyr/kernel.h>
 #include <zephyr/bluetooth/bluetooth.h>
 #include <zephyr/logging/log.h>
+#include <stdio.h>
 #include <string.h>
 
 #include "ble_central.h"
+#include "blerpc_rpc.h"
 #include <blerpc_protocol/container.h>
-#include <blerpc_protocol/command.h>
 #include "generated_client.h"
+#ifdef CONFIG_BLERPC_BENCH
+#include "bench.h"
+#endif
 #ifdef CONFIG_BLERPC_ENCRYPTION
 #include <mbedtls/platform.h>
 #endif
+#ifdef CONFIG_SETTINGS
+#include <zephyr/settings/settings.h>
+#endif
 
 LOG_MODULE_REGISTER(main, LOG_LEVEL_INF);
 
 /* Max test payload adapts to assembler buffer size (leave headroom for headers) */
 #define MAX_TEST_PAYLOAD (CONFIG_BLERPC_PROTOCOL_ASSEMBLER_BUF_SIZE - 128)
 
-/* Response buffer and synchronization */
-static uint8_t response_buf[CONFIG_BLERPC_PROTOCOL_ASSEMBLER_BUF_SIZE];
-static size_t response_len;
-
-/* Shared encryption buffer (reused across sequential calls) */
-static uint8_t encrypt_buf[CONFIG_BLERPC_PROTOCOL_ASSEMBLER_BUF_SIZE + 20];
-
 /* Shared work buffers (tests run sequentially, not concurrently) */
-static uint8_t shared_cmd_buf[CONFIG_BLERPC_PROTOCOL_ASSEMBLER_BUF_SIZE];
 static uint8_t shared_work_buf[CONFIG_BLERPC_PROTOCOL_ASSEMBLER_BUF_SIZE];
 static uint8_t shared_decode_buf[CONFIG_BLERPC_PROTOCOL_ASSEMBLER_BUF_SIZE];
 
-static int rpc_error_code;
-static K_SEM_DEFINE(response_sem, 0, 10);
-
-static uint8_t transaction_counter;
-
-static uint8_t next_transaction_id(void)
-{
-    return transaction_counter++;
-}
-
-/* Callback from ble_central when a complete response is assembled */
-static void on_response(const uint8_t *data, size_t len)
-{
-    if (len > sizeof(response_buf)) {
-        LOG_ERR("Response too large: %zu > %zu", len, sizeof(response_buf));
-        return;
-    }
-    memcpy(response_buf, data, len);
-    response_len = len;
-    rpc_error_code = 0;
-    k_sem_give(&response_sem);
-}
-
-/* Callback from ble_central when an ERROR control container is received */
-static void on_error(uint8_t error_code)
-{
-    LOG_ERR("Peripheral error: 0x%02x", error_code);
-    rpc_error_code = error_code;
-    k_sem_give(&response_sem);
-}
-
-/* Send container callback for container_split_and_send */
-static int send_container(const uint8_t *data, size_t len, void *ctx)
-{
-    (void)ctx;
-    return ble_central_write(data, len);
-}
-
-/* ── RPC transport functions (extern'd by generated_client.h) ────────── */
+/* ── Test functions ──────────────────────────────────────────────────── */
 
-int blerpc_rpc_call(const char *cmd_name, const uint8_t *req_data, size_t req_len,
-                    uint8_t *resp_data, size_t resp_size, size_t *resp_len)
+static int test_echo(ble_central_conn_t *conn)
 {
-    uint8_t name_len = (uint8_t)strlen(cmd_name);
-
-    int cmd_len = command_serialize(COMMAND_TYPE_REQUEST, cmd_name, name_len, req_data,
-                                    (uint16_t)req_len, shared_cmd_buf, sizeof(shared_cmd_buf));
-    if (cmd_len < 0) {
-        LOG_ERR("Command serialize failed");
-        return -1;
-    }
-
-    uint16_t max_req = ble_central_get_max_request_payload_size();
-    if (max_req > 0 && (size_t)cmd_len > max_req) {
-        LOG_ERR("Request too large: %d > %u", cmd_len, max_req);
-        return -1;
-    }
-
-    /* Encrypt if encryption is active */
-    size_t send_len;
-    if (ble_central_encrypt_payload(shared_cmd_buf, (size_t)cmd_len, encrypt_buf,
-                                    sizeof(encrypt_buf), &send_len) != 0) {
-        LOG_ERR("Payload encryption failed");
-        return -1;
-    }
-
-    uint8_t tid = next_transaction_id();
-    uint16_t mtu = ble_central_get_mtu();
-
-    int rc = container_split_and_send(tid, encrypt_buf, send_len, mtu, send_container, NULL);
-    if (rc < 0) {
-        LOG_ERR("Container split/send failed: %d", rc);
-        return -1;
-    }
-
-    /* Wait for response */
-    rc = k_sem_take(&response_sem, K_SECONDS(10));
-    if (rc != 0) {
-        LOG_ERR("Response timeout");
-        return -1;
-    }
-
-    if (rpc_error_code != 0) {
-        LOG_ERR("RPC error from peripheral: 0x%02x", rpc_error_code);
-        return -1;
-    }
+    LOG_INF("=== Echo Test ===");
 
-    /* Parse command response */
-    struct command_packet resp_cmd;
-    if (command_parse(response_buf, response_len, &resp_cmd) != 0) {
-        LOG_ERR("Response command parse failed");
-        return -1;
-    }
+    static const char msg[] = "Hello from nRF54L15 central!";
 
-    if (resp_cmd.cmd_type != COMMAND_TYPE_RESPONSE) {
-        LOG_ERR("Expected response, got type %d", resp_cmd.cmd_type);
+    blerpc_EchoResponse resp;
+    if (blerpc_echo(conn, msg, &resp) != 0) {
+        LOG_ERR("Echo RPC failed");
         return -1;
     }
 
-    if (resp_cmd.cmd_name_len != name_len || memcmp(resp_cmd.cmd_name, cmd_name, name_len) != 0) {
-        LOG_ERR("Command name mismatch in response");
-        return -1;
-    }
+    LOG_INF("Echo response: '%s'", resp.message);
 
-    if (resp_cmd.data_len > resp_size) {
-        LOG_ERR("Response data too large: %u > %zu", resp_cmd.data_len, resp_size);
+    if (strcmp(resp.message, msg) != 0) {
+        LOG_ERR("Echo mismatch! Expected '%s', got '%s'", msg, resp.message);
         return -1;
     }
 
-    memcpy(resp_data, resp_cmd.data, resp_cmd.data_len);
-    *resp_len = resp_cmd.data_len;
+    LOG_INF("Echo test PASSED");
     return 0;
 }
 
-/* Stream end signaling for blerpc_stream_receive */
-static volatile bool _stream_ended;
+/* Number of echo calls issued by the pipelined echo test */
+#define PIPELINE_CALLS 16
+
+struct pipeline_result {
+    int status;
+    blerpc_EchoResponse resp;
+};
+
+static struct pipeline_result pipeline_results[PIPELINE_CALLS];
+static atomic_t pipeline_remaining;
+static K_SEM_DEFINE(pipeline_sem, 0, 1);
 
-static void _stream_end_cb(void)
+/* Decode each response straight out of the receive buffer it was loaned from */
+static int pipeline_decode(const uint8_t *data, size_t len, void *ctx)
 {
-    _stream_ended = true;
-    k_sem_give(&response_sem);
+    struct pipeline_result *res = ctx;
+    pb_istream_t istream = pb_istream_from_buffer(data, len);
+    return pb_decode(&istream, blerpc_EchoResponse_fields, &res->resp) ? 0 : -1;
 }
 
-int blerpc_stream_receive(const char *cmd_name, const uint8_t *req_data, size_t req_len,
-                          blerpc_on_stream_resp_t on_resp, void *ctx)
+static void pipeline_done(int status, size_t resp_len, void *user_data)
 {
-    uint8_t name_len = (uint8_t)strlen(cmd_name);
-
-    _stream_ended = false;
-    ble_central_set_stream_end_cb(_stream_end_cb);
-
-    /* Serialize and send the initial request */
-    int cmd_len = command_serialize(COMMAND_TYPE_REQUEST, cmd_name, name_len, req_data,
-                                    (uint16_t)req_len, shared_cmd_buf, sizeof(shared_cmd_buf));
-    if (cmd_len < 0) {
-        LOG_ERR("Command serialize failed");
-        ble_central_set_stream_end_cb(NULL);
-        return -1;
-    }
-
-    size_t send_len;
-    if (ble_central_encrypt_payload(shared_cmd_buf, (size_t)cmd_len, encrypt_buf,
-                                    sizeof(encrypt_buf), &send_len) != 0) {
-        LOG_ERR("Payload encryption failed");
-        ble_central_set_stream_end_cb(NULL);
-        return -1;
+    struct pipeline_result *res = user_data;
+    ARG_UNUSED(resp_len);
+    res->status = status;
+    if (atomic_dec(&pipeline_remaining) == 1) {
+        k_sem_give(&pipeline_sem);
     }
+}
 
-    uint8_t tid = next_transaction_id();
-    uint16_t mtu = ble_central_get_mtu();
-    int rc = container_split_and_send(tid, encrypt_buf, send_len, mtu, send_container, NULL);
-    if (rc < 0) {
-        LOG_ERR("Container split/send failed: %d", rc);
-        ble_central_set_stream_end_cb(NULL);
-        return -1;
-    }
+static int test_pipelined_echo(ble_central_conn_t *conn)
+{
+    LOG_INF("=== Pipelined Echo Test (%d calls, window %d) ===", PIPELINE_CALLS,
+            CONFIG_BLERPC_RPC_WINDOW_SIZE);
 
-    /* Receive responses until STREAM_END_P2C */
-    while (true) {
-        rc = k_sem_take(&response_sem, K_SECONDS(10));
-        if (rc != 0) {
-            LOG_ERR("Stream response timeout");
-            ble_central_set_stream_end_cb(NULL);
+    /* Sequential baseline */
+    uint32_t start = k_uptime_get_32();
+    for (int i = 0; i < PIPELINE_CALLS; i++) {
+        blerpc_EchoResponse resp;
+        if (blerpc_echo(conn, "ping", &resp) != 0) {
+            LOG_ERR("Sequential echo failed at %d", i);
             return -1;
         }
+    }
+    uint32_t sequential_ms = k_uptime_get_32() - start;
 
-        if (_stream_ended) {
-            break;
-        }
+    /* Pipelined: keep the window full, each response decoded as it lands */
+    atomic_set(&pipeline_remaining, PIPELINE_CALLS);
+    k_sem_reset(&pipeline_sem);
 
-        if (rpc_error_code != 0) {
-            LOG_ERR("Stream error: 0x%02x", rpc_error_code);
-            ble_central_set_stream_end_cb(NULL);
-            return -1;
-        }
+    start = k_uptime_get_32();
+    for (int i = 0; i < PIPELINE_CALLS; i++) {
+        blerpc_EchoRequest req = blerpc_EchoRequest_init_zero;
+        snprintf(req.message, sizeof(req.message), "ping %d", i);
 
-        struct command_packet resp_cmd;
-        if (command_parse(response_buf, response_len, &resp_cmd) != 0) {
-            LOG_ERR("Stream response parse failed");
-            ble_central_set_stream_end_cb(NULL);
+        uint8_t req_buf[blerpc_EchoRequest_size];
+        pb_ostream_t ostream = pb_ostream_from_buffer(req_buf, sizeof(req_buf));
+        if (!pb_encode(&ostream, blerpc_EchoRequest_fields, &req)) {
+            LOG_ERR("Echo request encode failed");
             return -1;
         }
 
-        if (on_resp(resp_cmd.data, resp_cmd.data_len, ctx) != 0) {
-            LOG_ERR("Stream response callback failed");
-            ble_central_set_stream_end_cb(NULL);
+        pipeline_results[i].resp = (blerpc_EchoResponse)blerpc_EchoResponse_init_zero;
+        int rc = blerpc_rpc_call_loan_async(conn, BLERPC_CMD_ID_ECHO, "echo", req_buf,
+                                            ostream.bytes_written, pipeline_decode,
+                                            &pipeline_results[i], pipeline_done,
+                                            &pipeline_results[i], K_SECONDS(10));
+        if (rc != 0) {
+            LOG_ERR("Pipelined echo submit failed at %d: %d", i, rc);
+            /* Drain whatever is already in flight before returning */
+            blerpc_rpc_flush(conn, K_SECONDS(15));
             return -1;
         }
     }
 
-    ble_central_set_stream_end_cb(NULL);
-    return 0;
-}
-
-int blerpc_stream_send(const char *cmd_name, size_t msg_count, blerpc_next_msg_t next_msg,
-                       void *msg_ctx, const char *final_cmd_name, uint8_t *resp_data,
-                       size_t resp_size, size_t *resp_len)
-{
-    (void)final_cmd_name;
-    uint8_t name_len = (uint8_t)strlen(cmd_name);
-
-    /* Send each message */
-    for (size_t i = 0; i < msg_count; i++) {
-        size_t msg_len;
-        if (next_msg(i, shared_work_buf, sizeof(shared_work_buf), &msg_len, msg_ctx) != 0) {
-            LOG_ERR("next_msg callback failed at %zu", i);
-            return -1;
-        }
-
-        int cmd_len = command_serialize(COMMAND_TYPE_REQUEST, cmd_name, name_len, shared_work_buf,
-                                        (uint16_t)msg_len, shared_cmd_buf, sizeof(shared_cmd_buf));
-        if (cmd_len < 0) {
-            LOG_ERR("Command serialize failed at %zu", i);
-            return -1;
-        }
+    if (k_sem_take(&pipeline_sem, K_SECONDS(15)) != 0) {
+        LOG_ERR("Pipelined echo completion timeout");
+        return -1;
+    }
+    uint32_t pipelined_ms = k_uptime_get_32() - start;
 
-        size_t send_len;
-        if (ble_central_encrypt_payload(shared_cmd_buf, (size_t)cmd_len, encrypt_buf,
-                                        sizeof(encrypt_buf), &send_len) != 0) {
-            LOG_ERR("Payload encryption failed at %zu", i);
+    for (int i = 0; i < PIPELINE_CALLS; i++) {
+        if (pipeline_results[i].status != 0) {
+            LOG_ERR("Pipelined echo %d failed: %d", i, pipeline_results[i].status);
             return -1;
         }
 
-        uint8_t tid = next_transaction_id();
-        uint16_t mtu = ble_central_get_mtu();
-        int rc = container_split_and_send(tid, encrypt_buf, send_len, mtu, send_container, NULL);
-        if (rc < 0) {
-            LOG_ERR("Container split/send failed at %zu: %d", i, rc);
+        char expected[16];
+        snprintf(expected, sizeof(expected), "ping %d", i);
+        if (strcmp(pipeline_results[i].resp.message, expected) != 0) {
+            LOG_ERR("Pipelined echo mismatch at %d: got '%s'", i,
+                    pipeline_results[i].resp.message);
             return -1;
         }
     }
 
-    /* Send STREAM_END_C2P */
-    if (ble_central_send_stream_end_c2p() < 0) {
-        LOG_ERR("STREAM_END_C2P send failed");
-        return -1;
-    }
-
-    /* Wait for final response */
-    int rc = k_sem_take(&response_sem, K_SECONDS(10));
-    if (rc != 0) {
-        LOG_ERR("Final response timeout");
-        return -1;
-    }
-
-    if (rpc_error_code != 0) {
-        LOG_ERR("RPC error from peripheral: 0x%02x", rpc_error_code);
-        return -1;
-    }
-
-    struct command_packet resp_cmd;
-    if (command_parse(response_buf, response_len, &resp_cmd) != 0) {
-        LOG_ERR("Response command parse failed");
-        return -1;
-    }
-
-    if (resp_cmd.data_len > resp_size) {
-        LOG_ERR("Response data too large: %u > %zu", resp_cmd.data_len, resp_size);
-        return -1;
-    }
-
-    memcpy(resp_data, resp_cmd.data, resp_cmd.data_len);
-    *resp_len = resp_cmd.data_len;
+    LOG_INF("Echo: sequential %u ms, pipelined %u ms", sequential_ms, pipelined_ms);
+    LOG_INF("Pipelined echo test PASSED");
     return 0;
 }
 
-/* ── Test functions ──────────────────────────────────────────────────── */
+/* Number of echo calls packed into the batched echo test */
+#define BATCH_CALLS 16
 
-static int test_echo(void)
+static int test_batched_echo(ble_central_conn_t *conn)
 {
-    LOG_INF("=== Echo Test ===");
+    LOG_INF("=== Batched Echo Test (%d calls) ===", BATCH_CALLS);
 
-    static const char msg[] = "Hello from nRF54L15 central!";
-
-    blerpc_EchoResponse resp;
-    if (blerpc_echo(msg, &resp) != 0) {
-        LOG_ERR("Echo RPC failed");
-        return -1;
+    if (!(ble_central_get_capability_flags(conn) & CAPABILITY_FLAG_BATCH)) {
+        LOG_INF("Peripheral does not support batches, skipping");
+        return 0;
     }
 
-    LOG_INF("Echo response: '%s'", resp.message);
+    static struct blerpc_batch batch;
+    static blerpc_EchoResponse resps[BATCH_CALLS];
 
-    if (strcmp(resp.message, msg) != 0) {
-        LOG_ERR("Echo mismatch! Expected '%s', got '%s'", msg, resp.message);
+    uint32_t start = k_uptime_get_32();
+    blerpc_batch_init(&batch);
+    for (int i = 0; i < BATCH_CALLS; i++) {
+        char msg[16];
+        snprintf(msg, sizeof(msg), "batch %d", i);
+        if (blerpc_batch_echo(&batch, msg, &resps[i]) != 0) {
+            LOG_ERR("Batch echo queue failed at %d", i);
+            return -1;
+        }
+    }
+    if (blerpc_batch_send(conn, &batch) != 0) {
+        LOG_ERR("Batch send failed");
         return -1;
     }
+    uint32_t batched_ms = k_uptime_get_32() - start;
 
-    LOG_INF("Echo test PASSED");
+    for (int i = 0; i < BATCH_CALLS; i++) {
+        char expected[16];
+        snprintf(expected, sizeof(expected), "batch %d", i);
+        if (strcmp(resps[i].message, expected) != 0) {
+            LOG_ERR("Batched echo mismatch at %d: got '%s'", i, resps[i].message);
+            return -1;
+        }
+    }
+
+    LOG_INF("Echo: %d calls in one batch %u ms", BATCH_CALLS, batched_ms);
+    LOG_INF("Batched echo test PASSED");
     return 0;
 }
 
-static int test_flash_read(uint32_t length)
+static int test_flash_read(ble_central_conn_t *conn, uint32_t length)
 {
     LOG_INF("=== FlashRead Test (len=%u) ===", length);
 
     blerpc_FlashReadResponse resp;
     size_t data_len;
-    if (blerpc_flash_read(0x00000000, length, &resp, shared_decode_buf, sizeof(shared_decode_buf),
-                          &data_len) != 0) {
+    if (blerpc_flash_read(conn, 0x00000000, length, &resp, shared_decode_buf,
+                          sizeof(shared_decode_buf), &data_len) != 0) {
         LOG_ERR("FlashRead RPC failed");
         return -1;
     }
@@ -342,35 +221,7 @@ static int test_flash_read(uint32_t length)
     return 0;
 }
 
-static int test_throughput(void)
-{
-    LOG_INF("=== Throughput Test (10x flash_read %u) ===", MAX_TEST_PAYLOAD);
-
-    /* Warm up */
-    if (test_flash_read(MAX_TEST_PAYLOAD) != 0) {
-        LOG_ERR("Throughput warm-up failed");
-        return -1;
-    }
-
-    uint32_t start = k_uptime_get_32();
-
-    for (int i = 0; i < 10; i++) {
-        if (test_flash_read(MAX_TEST_PAYLOAD) != 0) {
-            LOG_ERR("Throughput test failed at iteration %d", i);
-            return -1;
-        }
-    }
-
-    uint32_t elapsed = k_uptime_get_32() - start;
-    uint32_t total_bytes = 10 * MAX_TEST_PAYLOAD;
-    uint32_t kbps = (total_bytes * 1000) / (elapsed * 1024);
-
-    LOG_INF("Throughput: %u bytes in %u ms = %u KB/s", total_bytes, elapsed, kbps);
-    LOG_INF("Throughput test PASSED");
-    return 0;
-}
-
-static int test_data_write(uint32_t length)
+static int test_data_write(ble_central_conn_t *conn, uint32_t length)
 {
     LOG_INF("=== DataWrite Test (len=%u) ===", length);
 
@@ -380,8 +231,8 @@ static int test_data_write(uint32_t length)
     }
 
     blerpc_DataWriteResponse resp;
-    if (blerpc_data_write(shared_decode_buf, length, shared_work_buf, sizeof(shared_work_buf),
-                          &resp) != 0) {
+    if (blerpc_data_write(conn, shared_decode_buf, length, shared_work_buf,
+                          sizeof(shared_work_buf), &resp) != 0) {
         LOG_ERR("DataWrite RPC failed");
         return -1;
     }
@@ -397,35 +248,40 @@ static int test_data_write(uint32_t length)
     return 0;
 }
 
-static int test_write_throughput(void)
+/* Produces the same incrementing pattern as test_data_write() on demand */
+static int pattern_produce(size_t offset, uint8_t *buf, size_t size, void *ctx)
 {
-    LOG_INF("=== Write Throughput Test (10x data_write %u) ===", MAX_TEST_PAYLOAD);
-
-    /* Warm up */
-    if (test_data_write(MAX_TEST_PAYLOAD) != 0) {
-        LOG_ERR("Write throughput warm-up failed");
-        return -1;
+    ARG_UNUSED(ctx);
+    for (size_t i = 0; i < size; i++) {
+        buf[i] = (uint8_t)((offset + i) & 0xFF);
     }
+    return (int)size;
+}
 
-    uint32_t start = k_uptime_get_32();
+static int test_streamed_data_write(ble_central_conn_t *conn, uint32_t length)
+{
+    LOG_INF("=== Streamed DataWrite Test (len=%u) ===", length);
 
-    for (int i = 0; i < 10; i++) {
-        if (test_data_write(MAX_TEST_PAYLOAD) != 0) {
-            LOG_ERR("Write throughput test failed at iteration %d", i);
-            return -1;
-        }
+    /* The payload is produced while its containers go out, never staged */
+    uint32_t start = k_uptime_get_32();
+    blerpc_DataWriteResponse resp;
+    if (blerpc_data_write_streamed(conn, length, pattern_produce, NULL, &resp) != 0) {
+        LOG_ERR("Streamed DataWrite RPC failed");
+        return -1;
     }
-
     uint32_t elapsed = k_uptime_get_32() - start;
-    uint32_t total_bytes = 10 * MAX_TEST_PAYLOAD;
-    uint32_t kbps = (total_bytes * 1000) / (elapsed * 1024);
 
-    LOG_INF("Write throughput: %u bytes in %u ms = %u KB/s", total_bytes, elapsed, kbps);
-    LOG_INF("Write throughput test PASSED");
+    if (resp.length != length) {
+        LOG_ERR("Streamed DataWrite length mismatch: expected %u, got %u", length, resp.length);
+        return -1;
+    }
+
+    LOG_INF("Streamed DataWrite: %u bytes in %u ms", length, elapsed);
+    LOG_INF("Streamed DataWrite test PASSED");
     return 0;
 }
 
-static int test_counter_stream(void)
+static int test_counter_stream(ble_central_conn_t *conn)
 {
     LOG_INF("=== CounterStream Test ===");
 
@@ -433,7 +289,7 @@ static int test_counter_stream(void)
     blerpc_CounterStreamResponse results[10];
     size_t result_count;
 
-    if (blerpc_counter_stream(count, results, 10, &result_count) != 0) {
+    if (blerpc_counter_stream(conn, count, results, 10, &result_count) != 0) {
         LOG_ERR("CounterStream failed");
         return -1;
     }
@@ -456,7 +312,7 @@ static int test_counter_stream(void)
     return 0;
 }
 
-static int test_counter_upload(void)
+static int test_counter_upload(ble_central_conn_t *conn)
 {
     LOG_INF("=== CounterUpload Test ===");
 
@@ -469,7 +325,7 @@ static int test_counter_upload(void)
     }
 
     blerpc_CounterUploadResponse resp;
-    if (blerpc_counter_upload(messages, count, &resp) != 0) {
+    if (blerpc_counter_upload(conn, messages, count, &resp) != 0) {
         LOG_ERR("CounterUpload failed");
         return -1;
     }
@@ -485,6 +341,145 @@ static int test_counter_upload(void)
     return 0;
 }
 
+/* Per-call read size and total calls per link for the multi-link test */
+#define MULTI_READ_LEN 1024
+#define MULTI_CALLS_PER_LINK 8
+
+/* One response buffer per call that can be in flight across the pool
+ * (data plus headroom for the address and length fields) */
+#define MULTI_BLOCK_SIZE ROUND_UP(MULTI_READ_LEN + 32, 4)
+K_MEM_SLAB_DEFINE_STATIC(multi_slab, MULTI_BLOCK_SIZE,
+                         CONFIG_BT_MAX_CONN * CONFIG_BLERPC_RPC_WINDOW_SIZE, 4);
+
+static atomic_t multi_remaining;
+static atomic_t multi_bytes;
+static atomic_t multi_failures;
+static K_SEM_DEFINE(multi_sem, 0, 1);
+
+static void multi_done(int status, size_t resp_len, void *user_data)
+{
+    if (status != 0) {
+        atomic_inc(&multi_failures);
+    } else {
+        atomic_add(&multi_bytes, (atomic_val_t)resp_len);
+    }
+    k_mem_slab_free(&multi_slab, user_data);
+    if (atomic_dec(&multi_remaining) == 1) {
+        k_sem_give(&multi_sem);
+    }
+}
+
+/* Keep every link's window full of flash reads, always topping up the least
+ * loaded link, and report the aggregate collection rate. */
+static int test_multi_link_collect(void)
+{
+    size_t links = ble_central_conn_count();
+    size_t calls = links * MULTI_CALLS_PER_LINK;
+
+    LOG_INF("=== Multi-Link Collect Test (%zu links, %zu x flash_read %u) ===", links, calls,
+            MULTI_READ_LEN);
+
+    blerpc_FlashReadRequest req = blerpc_FlashReadRequest_init_zero;
+    req.address = 0;
+    req.length = MULTI_READ_LEN;
+    uint8_t req_buf[blerpc_FlashReadRequest_size];
+    pb_ostream_t ostream = pb_ostream_from_buffer(req_buf, sizeof(req_buf));
+    if (!pb_encode(&ostream, blerpc_FlashReadRequest_fields, &req)) {
+        LOG_ERR("FlashRead request encode failed");
+        return -1;
+    }
+
+    atomic_set(&multi_remaining, (atomic_val_t)calls);
+    atomic_clear(&multi_bytes);
+    atomic_clear(&multi_failures);
+    k_sem_reset(&multi_sem);
+
+    uint32_t start = k_uptime_get_32();
+    for (size_t i = 0; i < calls; i++) {
+        void *block;
+        if (k_mem_slab_alloc(&multi_slab, &block, K_SECONDS(10)) != 0) {
+            LOG_ERR("Multi-link response buffer timeout at %zu", i);
+            blerpc_rpc_flush(NULL, K_SECONDS(15));
+            return -1;
+        }
+
+        ble_central_conn_t *conn = blerpc_rpc_pick_conn();
+        int rc = conn ? blerpc_rpc_call_async(conn, BLERPC_CMD_ID_FLASH_READ, "flash_read",
+                                              req_buf, ostream.bytes_written, block,
+                                              MULTI_BLOCK_SIZE, multi_done, block,
+                                              K_SECONDS(10))
+                      : -ENOTCONN;
+        if (rc != 0) {
+            LOG_ERR("Multi-link submit failed at %zu: %d", i, rc);
+            k_mem_slab_free(&multi_slab, block);
+            blerpc_rpc_flush(NULL, K_SECONDS(15));
+            return -1;
+        }
+    }
+
+    if (k_sem_take(&multi_sem, K_SECONDS(30)) != 0) {
+        LOG_ERR("Multi-link completion timeout");
+        return -1;
+    }
+    uint32_t elapsed = k_uptime_get_32() - start;
+
+    if (atomic_get(&multi_failures) != 0) {
+        LOG_ERR("Multi-link: %ld call(s) failed", (long)atomic_get(&multi_failures));
+        return -1;
+    }
+
+    uint32_t total_bytes = (uint32_t)atomic_get(&multi_bytes);
+    uint32_t kbps = (total_bytes * 1000) / (MAX(elapsed, 1) * 1024);
+    LOG_INF("Multi-link: %zu links, %u bytes in %u ms = %u KB/s", links, total_bytes, elapsed,
+            kbps);
+    LOG_INF("Multi-link collect test PASSED");
+    return 0;
+}
+
+/* Capabilities and key exchange for a freshly connected peripheral */
+static void node_setup(ble_central_conn_t *conn)
+{
+    int err;
+
+    struct ble_central_link_params params;
+    ble_central_get_link_params(conn, &params);
+    LOG_INF("Link %zu MTU: %u, PHY tx %u rx %u, data len %u, interval %u",
+            ble_central_conn_index(conn), ble_central_get_mtu(conn), params.tx_phy,
+            params.rx_phy, params.tx_max_len, params.interval);
+
+    /* Request capabilities from peripheral */
+    err = ble_central_request_capabilities(conn);
+    if (err) {
+        LOG_WRN("Capabilities request failed (err %d), continuing without limits", err);
+    } else {
+        LOG_INF("Peripheral capabilities: max_request=%u, max_response=%u",
+                ble_central_get_max_request_payload_size(conn),
+                ble_central_get_max_response_payload_size(conn));
+    }
+
+    /* Perform key exchange if peripheral supports encryption */
+    uint16_t cap_flags = ble_central_get_capability_flags(conn);
+    if (cap_flags & CAPABILITY_FLAG_ENCRYPTION_SUPPORTED) {
+        LOG_INF("Peripheral supports encryption, performing key exchange...");
+        err = ble_central_perform_key_exchange(conn);
+        if (err) {
+            LOG_WRN("Key exchange failed (err %d), continuing without encryption", err);
+        } else {
+            LOG_INF("Encryption active: %s", ble_central_is_encrypted(conn) ? "yes" : "no");
+        }
+    }
+
+    /* Large transfers such as flash_read use the bulk channel when offered */
+    if (cap_flags & CAPABILITY_FLAG_L2CAP_SUPPORTED) {
+        err = ble_central_bulk_open(conn);
+        if (err) {
+            LOG_WRN("Bulk channel unavailable (err %d), using GATT only", err);
+        } else {
+            LOG_INF("Bulk channel: %zu bytes per SDU", ble_central_bulk_max_payload(conn));
+        }
+    }
+}
+
 /* ── Main ────────────────────────────────────────────────────────────── */
 
 int main(void)
@@ -506,83 +501,97 @@ int main(void)
     }
     LOG_INF("Bluetooth initialized");
 
-    ble_central_init(on_response, on_error);
+#ifdef CONFIG_SETTINGS
+    /* Loads the GATT cache, so the first connect can use it */
+    err = settings_subsys_init();
+    if (err == 0) {
+        err = settings_load();
+    }
+    if (err) {
+        LOG_WRN("Settings load failed (err %d)", err);
+    }
+#endif
 
-    err = ble_central_connect();
+    blerpc_rpc_init();
+
+    /* The first peripheral is required; fill the rest of the pool with
+     * whatever else is advertising */
+    ble_central_conn_t *node;
+    err = ble_central_connect(K_SECONDS(10), &node);
     if (err) {
         LOG_ERR("Connect failed (err %d)", err);
         return err;
     }
+    node_setup(node);
 
-    LOG_INF("MTU: %u", ble_central_get_mtu());
+    ble_central_conn_t *extra;
+    while (ble_central_connect(K_SECONDS(3), &extra) == 0) {
+        node_setup(extra);
+    }
+    LOG_INF("Connected to %zu peripheral(s)", ble_central_conn_count());
 
-    /* Request capabilities from peripheral */
-    err = ble_central_request_capabilities();
-    if (err) {
-        LOG_WRN("Capabilities request failed (err %d), continuing without limits", err);
-    } else {
-        LOG_INF("Peripheral capabilities: max_request=%u, max_response=%u",
-                ble_central_get_max_request_payload_size(),
-                ble_central_get_max_response_payload_size());
+    /* Run tests */
+    int failures = 0;
+
+    if (test_echo(node) != 0) {
+        failures++;
     }
 
-    /* Perform key exchange if peripheral supports encryption */
-    uint16_t cap_flags = ble_central_get_capability_flags();
-    if (cap_flags & CAPABILITY_FLAG_ENCRYPTION_SUPPORTED) {
-        LOG_INF("Peripheral supports encryption, performing key exchange...");
-        err = ble_central_perform_key_exchange();
-        if (err) {
-            LOG_WRN("Key exchange failed (err %d), continuing without encryption", err);
-        } else {
-            LOG_INF("Encryption active: %s", ble_central_is_encrypted() ? "yes" : "no");
-        }
+    k_sleep(K_MSEC(100));
+
+    if (test_pipelined_echo(node) != 0) {
+        failures++;
     }
 
-    /* Allow subscription to settle */
-    k_sleep(K_MSEC(200));
+    k_sleep(K_MSEC(100));
+
+    if (test_batched_echo(node) != 0) {
+        failures++;
+    }
 
-    /* Run tests */
-    int failures = 0;
+    k_sleep(K_MSEC(100));
 
-    if (test_echo() != 0) {
+    if (test_flash_read(node, MAX_TEST_PAYLOAD) != 0) {
         failures++;
     }
 
     k_sleep(K_MSEC(100));
 
-    if (test_flash_read(MAX_TEST_PAYLOAD) != 0) {
+    if (test_data_write(node, MAX_TEST_PAYLOAD) != 0) {
         failures++;
     }
 
     k_sleep(K_MSEC(100));
 
-    if (test_throughput() != 0) {
+    if (test_streamed_data_write(node, MAX_TEST_PAYLOAD) != 0) {
         failures++;
     }
 
     k_sleep(K_MSEC(100));
 
-    if (test_data_write(MAX_TEST_PAYLOAD) != 0) {
+    if (test_counter_stream(node) != 0) {
         failures++;
     }
 
     k_sleep(K_MSEC(100));
 
-    if (test_write_throughput() != 0) {
+    if (test_counter_upload(node) != 0) {
         failures++;
     }
 
     k_sleep(K_MSEC(100));
 
-    if (test_counter_stream() != 0) {
+    if (test_multi_link_collect() != 0) {
         failures++;
     }
 
+#ifdef CONFIG_BLERPC_BENCH
     k_sleep(K_MSEC(100));
 
-    if (test_counter_upload() != 0) {
+    if (bench_run(node, MAX_TEST_PAYLOAD) != 0) {
         failures++;
     }
+#endif
 
     LOG_INF("===========================");
     if (failures == 0) {
@@ -0,0 +1 @@
+../../peripheral_fw/src/session_resume.c
\ No newline at end of file
@@ -0,0 +1 @@
+../../peripheral_fw/src/session_resume.h
\ No newline at end of file
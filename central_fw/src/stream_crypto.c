@@ -0,0 +1 @@
+../../peripheral_fw/src/stream_crypto.c
\ No newline at end of file
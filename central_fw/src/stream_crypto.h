@@ -0,0 +1 @@
+../../peripheral_fw/src/stream_crypto.h
\ No newline at end of file
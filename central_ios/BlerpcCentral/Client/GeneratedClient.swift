@@ -45,4 +45,12 @@ extension GeneratedClientProtocol {
         let respData = try await streamSend(cmdName: "counter_upload", messages: raw, finalCmdName: "counter_upload")
         return try Blerpc_CounterUploadResponse(serializedBytes: respData)
     }
+
+    func flashDump(address: UInt32 = 0, length: UInt32 = 0) async throws -> [Blerpc_FlashDumpResponse] {
+        var req = Blerpc_FlashDumpRequest()
+        req.address = address
+        req.length = length
+        let responses = try await streamReceive(cmdName: "flash_dump", requestData: try req.serializedData())
+        return try responses.map { try Blerpc_FlashDumpResponse(serializedBytes: $0) }
+    }
 }
@@ -0,0 +1,89 @@
+"""Collect the central firmware's benchmark results over RTT.
+
+Usage:
+    python3 central_py/bench.py --out run.json [--baseline old.json]
+    python3 tools/rtt_reader.py | python3 central_py/bench.py --input -
+
+Without --input, tools/rtt_reader.py is started with --reset so the central
+reboots into the suite (build it with CONFIG_BLERPC_BENCH=y). With --baseline,
+exits non-zero when any point regressed by more than --tolerance.
+"""
+
+import argparse
+import json
+import subprocess
+import sys
+from pathlib import Path
+
+from blerpc.bench import BenchRun, compare, parse_lines
+
+RTT_READER = Path(__file__).resolve().parent.parent / "tools" / "rtt_reader.py"
+
+
+def collect(args) -> BenchRun:
+    if args.input == "-":
+        return parse_lines(sys.stdin)
+    if args.input:
+        with open(args.input) as f:
+            return parse_lines(f)
+
+    cmd = [sys.executable, str(RTT_READER), "--reset", *args.rtt_args]
+    with subprocess.Popen(cmd, stdout=subprocess.PIPE, text=True) as proc:
+        try:
+            return parse_lines(proc.stdout)
+        finally:
+            proc.terminate()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Collect blerpc benchmark results")
+    parser.add_argument("--input", help="log file to parse, - for stdin")
+    parser.add_argument("--out", help="write the run as JSON")
+    parser.add_argument("--baseline", help="JSON run to compare against")
+    parser.add_argument(
+        "--tolerance",
+        type=float,
+        default=10.0,
+        help="allowed p99 rise / goodput drop in percent (default: 10)",
+    )
+    parser.add_argument(
+        "rtt_args", nargs="*", help="extra arguments for tools/rtt_reader.py"
+    )
+    args = parser.parse_args()
+
+    run = collect(args)
+    if not run.complete:
+        print(
+            f"warning: run incomplete ({len(run.points)} points)", file=sys.stderr
+        )
+    for p in run.points:
+        print(
+            f"{p.sweep:8} {p.op:5} size={p.size:<5} mtu={p.mtu:<3} phy={p.phy} "
+            f"int={p.interval:<3} depth={p.depth} enc={p.enc} "
+            f"p50={p.p50_us}us p99={p.p99_us}us {p.bytes_per_s} B/s"
+            + (f" FAIL {p.fail}" if p.fail else "")
+        )
+
+    if args.out:
+        with open(args.out, "w") as f:
+            json.dump(run.to_json(), f, indent=2)
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = BenchRun.from_json(json.load(f))
+        regressions = compare(run, baseline, args.tolerance / 100)
+        for r in regressions:
+            p = r.point
+            print(
+                f"REGRESSION {p.sweep} {p.op} size={p.size} mtu={p.mtu} "
+                f"phy={p.phy} int={p.interval} depth={p.depth}: {r.reason}",
+                file=sys.stderr,
+            )
+        if regressions:
+            sys.exit(1)
+    if not run.complete or any(p.fail for p in run.points):
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
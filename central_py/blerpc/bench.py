@@ -0,0 +1,121 @@
+"""Collect and compare results of the central firmware's benchmark suite.
+
+The suite (CONFIG_BLERPC_BENCH) logs one line per point, ``BENCH `` followed
+by a JSON object, between a ``{"suite": "begin"}`` and a ``{"suite": "end"}``
+line. Log prefixes and unrelated output around them are ignored.
+"""
+
+from __future__ import annotations
+
+import json
+import re
+from collections.abc import Iterable
+from dataclasses import asdict, dataclass, field
+
+_BENCH_LINE = re.compile(r"BENCH (\{.*\})")
+
+# Fields that identify a point across runs
+POINT_KEY = ("sweep", "op", "size", "mtu", "phy", "interval", "depth", "enc")
+
+
+@dataclass(frozen=True)
+class BenchPoint:
+    """One measured point: ``n`` timed calls with identical parameters."""
+
+    sweep: str  # parameter varied: size, mtu, phy, interval or depth
+    op: str  # read (flash_read) or write (data_write)
+    size: int
+    mtu: int
+    phy: int  # 1 = 1M, 2 = 2M, 4 = coded
+    interval: int  # 1.25 ms units
+    depth: int  # calls kept in flight
+    enc: int
+    bulk: int
+    n: int
+    fail: int
+    p50_us: int
+    p99_us: int
+    max_us: int
+    bytes_per_s: int
+
+    @property
+    def key(self) -> tuple:
+        return tuple(getattr(self, k) for k in POINT_KEY)
+
+
+@dataclass
+class BenchRun:
+    """Output of one suite run."""
+
+    info: dict = field(default_factory=dict)
+    points: list[BenchPoint] = field(default_factory=list)
+    complete: bool = False
+
+    def to_json(self) -> dict:
+        return {
+            "info": self.info,
+            "complete": self.complete,
+            "points": [asdict(p) for p in self.points],
+        }
+
+    @classmethod
+    def from_json(cls, obj: dict) -> BenchRun:
+        return cls(
+            info=obj.get("info", {}),
+            points=[BenchPoint(**p) for p in obj.get("points", [])],
+            complete=obj.get("complete", False),
+        )
+
+
+def parse_lines(lines: Iterable[str]) -> BenchRun:
+    """Parse a suite run from log output, stopping at its end marker."""
+    run = BenchRun()
+    for line in lines:
+        m = _BENCH_LINE.search(line)
+        if not m:
+            continue
+        try:
+            obj = json.loads(m.group(1))
+        except json.JSONDecodeError:
+            continue  # a line cut short by a dropped log message
+        suite = obj.pop("suite", None)
+        if suite == "begin":
+            run = BenchRun(info=obj)
+        elif suite == "end":
+            run.info.update(obj)
+            run.complete = True
+            break
+        else:
+            run.points.append(BenchPoint(**obj))
+    return run
+
+
+@dataclass(frozen=True)
+class Regression:
+    point: BenchPoint
+    baseline: BenchPoint
+    reason: str
+
+
+def compare(
+    run: BenchRun, baseline: BenchRun, tolerance: float = 0.10
+) -> list[Regression]:
+    """Points of run that fail, or whose p99 latency rose or goodput fell by
+    more than tolerance relative to the same point of baseline."""
+    base = {p.key: p for p in baseline.points}
+    regressions = []
+    for p in run.points:
+        b = base.get(p.key)
+        if b is None:
+            continue
+        if p.fail > b.fail:
+            regressions.append(Regression(p, b, f"{p.fail} failed calls"))
+        elif b.p99_us and p.p99_us > b.p99_us * (1 + tolerance):
+            regressions.append(
+                Regression(p, b, f"p99 {b.p99_us} -> {p.p99_us} us")
+            )
+        elif b.bytes_per_s and p.bytes_per_s < b.bytes_per_s * (1 - tolerance):
+            regressions.append(
+                Regression(p, b, f"goodput {b.bytes_per_s} -> {p.bytes_per_s} B/s")
+            )
+    return regressions
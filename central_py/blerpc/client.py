@@ -3,8 +3,13 @@
 from __future__ import annotations
 
 import asyncio
+import hmac
 import logging
+import os
+import zlib
 from collections.abc import AsyncIterator
+from contextlib import aclosing
+from dataclasses import dataclass
 
 from blerpc_protocol.command import CommandPacket, CommandType
 from blerpc_protocol.container import (
@@ -22,11 +27,142 @@ from blerpc_protocol.container import (
 )
 from blerpc_protocol.crypto import BlerpcCryptoSession, central_perform_key_exchange
 
+from . import resume
+from .compress import compress, decompress
+from .generated import blerpc_pb2
 from .generated.generated_client import GeneratedClientMixin
 from .transport import SERVICE_UUID, BleTransport, ScannedDevice
 
 logger = logging.getLogger(__name__)
 
+# Stream pacing, not yet in blerpc_protocol: the central grants the
+# peripheral credits for P->C stream messages, and may let it coalesce
+# small ones into batch frames.
+CAPABILITY_FLAG_STREAM_CREDITS = 0x0010
+CONTROL_CMD_STREAM_CREDIT = 7
+STREAM_CREDIT_FLAG_COALESCE = 0x01
+COMMAND_FLAG_BATCH = 0x20
+# The peripheral accepts C->P stream messages packed into one frame
+CAPABILITY_FLAG_STREAM_COALESCE = 0x0020
+# ATT header + FIRST container header, and counter + tag per encrypted payload
+_FIRST_CONTAINER_OVERHEAD = 3 + 6
+_ENCRYPTED_OVERHEAD = 20
+# Peripheral instrumentation (CONFIG_BLERPC_STATS), read one page at a time
+CAPABILITY_FLAG_STATS = 0x0040
+CONTROL_CMD_STATS = 8
+# Page 0 counters and per-command latency phases, in wire order
+STATS_COUNTERS = (
+    "requests",
+    "responses",
+    "busy_errors",
+    "notify_retries",
+    "notify_failures",
+    "assembler_resets",
+    "decrypt_failures",
+    "bytes_in",
+    "bytes_out",
+    "cache_hits",
+)
+STATS_PHASES = ("assemble", "decrypt", "queue", "handler", "send")
+_STATS_BUCKETS = 12
+# Command data compression: the peripheral reports the largest request it
+# inflates at capabilities offset 22, and the central's CAPABILITIES request
+# carries its own flags and limit
+CAPABILITY_FLAG_COMPRESSION = 0x0080
+COMMAND_FLAG_COMPRESSED = 0x10
+# Smaller data rarely shrinks enough to pay for the raw length header
+COMPRESS_MIN_SIZE = 64
+# Transaction IDs are one byte on the wire
+_MAX_CALLS_IN_FLIGHT = 256
+
+
+@dataclass(frozen=True)
+class LinkParams:
+    """Radio parameters of the link as reported by the peripheral."""
+
+    tx_phy: int  # 1 = 1M, 2 = 2M, 4 = coded
+    rx_phy: int
+    tx_max_len: int  # link-layer payload octets
+    rx_max_len: int
+    interval: int  # 1.25 ms units
+    latency: int  # connection events
+    timeout: int  # 10 ms units
+
+    @property
+    def interval_ms(self) -> float:
+        return self.interval * 1.25
+
+    @classmethod
+    def from_capabilities(cls, payload: bytes) -> LinkParams | None:
+        """Parse the optional tail (bytes 6..17) of a capabilities payload.
+
+        A zero PHY means the peripheral padded the tail without knowing its
+        link, to reach a later field.
+        """
+        if len(payload) < 18 or payload[6] == 0:
+            return None
+
+        def u16(off: int) -> int:
+            return int.from_bytes(payload[off : off + 2], "little")
+
+        return cls(
+            tx_phy=payload[6],
+            rx_phy=payload[7],
+            tx_max_len=u16(8),
+            rx_max_len=u16(10),
+            interval=u16(12),
+            latency=u16(14),
+            timeout=u16(16),
+        )
+
+
+@dataclass(frozen=True)
+class PhaseStats:
+    """Latency of one request phase of a command on the peripheral.
+
+    Bucket 0 counts samples under 128 us, bucket k samples in
+    [64 << k, 128 << k) us; the last bucket is open-ended.
+    """
+
+    count: int
+    total_us: int
+    max_us: int
+    buckets: tuple[int, ...]
+
+    @property
+    def avg_us(self) -> float:
+        return self.total_us / self.count if self.count else 0.0
+
+
+@dataclass(frozen=True)
+class CommandStats:
+    """Calls, errors and per-phase latency of one command on the peripheral."""
+
+    calls: int
+    errors: int
+    phases: dict[str, PhaseStats]
+
+    @classmethod
+    def from_page(cls, data: bytes) -> CommandStats:
+        """Parse a command page (without its page byte)."""
+
+        def u32(off: int) -> int:
+            return int.from_bytes(data[off : off + 4], "little")
+
+        phase_size = 12 + 2 * _STATS_BUCKETS
+        phases = {}
+        off = 8
+        for name in STATS_PHASES:
+            if off + phase_size > len(data):
+                break
+            buckets = tuple(
+                int.from_bytes(data[b : b + 2], "little")
+                for b in range(off + 12, off + phase_size, 2)
+            )
+            phases[name] = PhaseStats(u32(off), u32(off + 4), u32(off + 8), buckets)
+            off += phase_size
+        return cls(calls=u32(0), errors=u32(4), phases=phases)
+
 
 class PayloadTooLargeError(Exception):
     """Raised when a request payload exceeds the peripheral's max_payload_size."""
@@ -43,25 +179,90 @@ class ResponseTooLargeError(Exception):
     """Raised when the response exceeds max_response_payload_size."""
 
 
+class FlashDumpError(Exception):
+    """Raised when a flash_dump chunk fails its offset or CRC check."""
+
+
+class FlashDump:
+    """Progress of a resumable flash_dump; ``data`` holds only verified bytes."""
+
+    def __init__(self, address: int, length: int):
+        self.address = address
+        self.length = length
+        self.data = bytearray()
+
+    @property
+    def next_offset(self) -> int:
+        return self.address + len(self.data)
+
+    @property
+    def remaining(self) -> int:
+        return self.length - len(self.data)
+
+    @property
+    def done(self) -> bool:
+        return self.remaining == 0
+
+
+class _Receiver:
+    """Traffic the receive loop routes to one waiting call."""
+
+    def __init__(self, transaction_id: int | None = None):
+        self.transaction_id = transaction_id
+        self.assembler = ContainerAssembler()
+        # Control containers, decrypted payloads, or an exception to raise
+        self.queue: asyncio.Queue[Container | bytes | Exception] = asyncio.Queue()
+
+
 class BlerpcClient(GeneratedClientMixin):
-    """High-level RPC client that communicates over BLE."""
+    """High-level RPC client that communicates over BLE.
+
+    Unary calls may be issued concurrently from several tasks: a receive
+    loop routes response containers to each call by transaction ID. Streams
+    and stats reads run alone, since P->C stream messages carry the
+    peripheral's own transaction IDs; they wait for calls in flight to
+    finish, and new calls wait for them.
+    """
 
     def __init__(
         self,
         known_keys_path: str | None = None,
         require_encryption: bool = True,
+        stream_credits: int = 16,
+        transport: BleTransport | None = None,
+        compression: bool = True,
+        resumption: bool = True,
     ):
-        self._transport = BleTransport()
+        # Any object with BleTransport's interface, e.g. a loopback link's
+        self._transport = transport if transport is not None else BleTransport()
         self._splitter: ContainerSplitter | None = None
-        self._assembler = ContainerAssembler()
         self._timeout_s = 0.1  # Default 100ms
         self._max_request_payload_size: int | None = None
         self._max_response_payload_size: int | None = None
+        self._link_params: LinkParams | None = None
+        self._capability_flags = 0
+        # P->C stream messages the peripheral may send ahead of the consumer
+        self._stream_credits = stream_credits
+        self._compression = compression
+        # Largest request data the peripheral inflates; 0 if it can't
+        self._inflate_limit = 0
+
+        # Receive demultiplexing: unary calls by transaction ID, or one
+        # exclusive caller that takes every container
+        self._calls: dict[int, _Receiver] = {}
+        self._exclusive: _Receiver | None = None
+        self._exclusive_waiting = 0
+        self._rx_changed = asyncio.Condition()
+        self._rx_task: asyncio.Task | None = None
+        self._send_lock = asyncio.Lock()
 
         # Encryption state
         self._session: BlerpcCryptoSession | None = None
         self._known_keys_path = known_keys_path
         self._require_encryption = require_encryption
+        # Resumption secret and ticket per peripheral address, used once each
+        self._resumption = resumption
+        self._tickets: dict[str, tuple[bytes, bytes]] = {}
 
     @property
     def mtu(self) -> int:
@@ -75,6 +276,11 @@ class BlerpcClient(GeneratedClientMixin):
     def max_response_payload_size(self) -> int | None:
         return self._max_response_payload_size
 
+    @property
+    def link_params(self) -> LinkParams | None:
+        """PHY, data length and connection parameters, if the peripheral reports them."""
+        return self._link_params
+
     @property
     def is_encrypted(self) -> bool:
         return self._session is not None
@@ -135,9 +341,19 @@ class BlerpcClient(GeneratedClientMixin):
             )
 
     async def _request_capabilities(self) -> None:
-        """Request capabilities from peripheral (6-byte format)."""
+        """Request capabilities from peripheral (6-byte format, optional link tail)."""
         tid = self._splitter.next_transaction_id()
-        req = make_capabilities_request(transaction_id=tid)
+        if self._compression:
+            req = Container(
+                transaction_id=tid,
+                sequence_number=0,
+                container_type=ContainerType.CONTROL,
+                control_cmd=ControlCmd.CAPABILITIES,
+                payload=CAPABILITY_FLAG_COMPRESSION.to_bytes(2, "little")
+                + (0xFFFF).to_bytes(2, "little"),
+            )
+        else:
+            req = make_capabilities_request(transaction_id=tid)
         await self._transport.write(req.serialize())
         data = await self._transport.read_notify(timeout=1.0)
         resp = Container.deserialize(data)
@@ -158,6 +374,17 @@ class BlerpcClient(GeneratedClientMixin):
                 )
             self._max_request_payload_size = max_req
             self._max_response_payload_size = max_resp
+            self._capability_flags = flags
+            self._link_params = LinkParams.from_capabilities(resp.payload)
+            self._inflate_limit = 0
+            if (
+                self._compression
+                and flags & CAPABILITY_FLAG_COMPRESSION
+                and len(resp.payload) >= 24
+            ):
+                self._inflate_limit = int.from_bytes(resp.payload[22:24], "little")
+            if self._link_params is not None:
+                logger.info("Peripheral link: %s", self._link_params)
             logger.info(
                 "Peripheral capabilities: max_request=%d, "
                 "max_response=%d, flags=0x%04x",
@@ -178,7 +405,14 @@ class BlerpcClient(GeneratedClientMixin):
             )
 
     async def _perform_key_exchange(self) -> None:
-        """Perform the 4-step key exchange handshake."""
+        """Resume from a cached ticket, or perform the 4-step handshake."""
+        resumable = (
+            self._resumption
+            and self._capability_flags & resume.CAPABILITY_FLAG_RESUMPTION
+        )
+        if resumable and await self._resume_session():
+            logger.info("E2E encryption resumed")
+            return
 
         async def send(payload: bytes) -> None:
             tid = self._splitter.next_transaction_id()
@@ -215,6 +449,77 @@ class BlerpcClient(GeneratedClientMixin):
             return
 
         logger.info("E2E encryption established")
+        if resumable:
+            await self._fetch_ticket()
+
+    async def _resume_exchange(self, payload: bytes) -> bytes:
+        """Send a RESUME control payload and return the reply's."""
+        tid = self._splitter.next_transaction_id()
+        req = Container(
+            transaction_id=tid,
+            sequence_number=0,
+            container_type=ContainerType.CONTROL,
+            control_cmd=resume.CONTROL_CMD_RESUME,
+            payload=payload,
+        )
+        await self._transport.write(req.serialize())
+        data = await self._transport.read_notify(timeout=2.0)
+        resp = Container.deserialize(data)
+        if (
+            resp.container_type != ContainerType.CONTROL
+            or resp.control_cmd != resume.CONTROL_CMD_RESUME
+            or not resp.payload
+        ):
+            raise ValueError("Expected RESUME response, got something else")
+        return resp.payload
+
+    async def _resume_session(self) -> bool:
+        """Rekey from this peripheral's cached ticket; False to run a full KX."""
+        cached = self._tickets.pop(self._transport.address, None)
+        if cached is None:
+            return False
+        secret, ticket = cached
+        nonce_c = os.urandom(resume.NONCE_SIZE)
+        try:
+            reply = await self._resume_exchange(
+                bytes([resume.OP_HELLO]) + ticket + nonce_c
+            )
+        except (ValueError, asyncio.TimeoutError) as e:
+            logger.warning("Resumption failed: %s", e)
+            return False
+        if reply[0] != resume.OP_ACCEPT or len(reply) < resume.ACCEPT_MIN_SIZE:
+            logger.info("Peripheral refused resumption")
+            return False
+        nonce_p = reply[1 : 1 + resume.NONCE_SIZE]
+        keys = resume.derive(secret, nonce_c, nonce_p)
+        if not hmac.compare_digest(
+            keys.confirm, reply[1 + resume.NONCE_SIZE : resume.ACCEPT_MIN_SIZE]
+        ):
+            logger.warning("Resumption confirm mismatch")
+            return False
+        next_ticket = reply[resume.ACCEPT_MIN_SIZE :]
+        if len(next_ticket) == resume.TICKET_SIZE:
+            self._tickets[self._transport.address] = (keys.next_secret, next_ticket)
+        self._session = BlerpcCryptoSession(keys.session_key, is_central=True)
+        return True
+
+    async def _fetch_ticket(self) -> None:
+        """Ask for a ticket after a full KX; without one, the next connect
+        runs a full KX too."""
+        try:
+            reply = await self._resume_exchange(bytes([resume.OP_TICKET_REQUEST]))
+            if reply[0] != resume.OP_TICKET:
+                raise ValueError(f"unexpected op 0x{reply[0]:02x}")
+            plain = self._session.decrypt(reply[1:])
+        except (ValueError, RuntimeError, asyncio.TimeoutError) as e:
+            logger.warning("No resumption ticket: %s", e)
+            return
+        if len(plain) != resume.SECRET_SIZE + resume.TICKET_SIZE:
+            return
+        self._tickets[self._transport.address] = (
+            plain[: resume.SECRET_SIZE],
+            plain[resume.SECRET_SIZE :],
+        )
 
     def _encrypt_payload(self, payload: bytes) -> bytes:
         """Encrypt payload if encryption is active."""
@@ -243,7 +548,7 @@ class BlerpcClient(GeneratedClientMixin):
             cmd_name=cmd_name,
             data=request_data,
         )
-        payload = cmd.serialize()
+        payload = self._compress_request(cmd) or cmd.serialize()
 
         if (
             self._max_request_payload_size is not None
@@ -251,40 +556,17 @@ class BlerpcClient(GeneratedClientMixin):
         ):
             raise PayloadTooLargeError(len(payload), self._max_request_payload_size)
 
-        # Encrypt if active, then split into containers and send
-        send_payload = self._encrypt_payload(payload)
-        containers = self._splitter.split(send_payload)
-        for c in containers:
-            await self._transport.write(c.serialize())
-
-        # Receive response containers
-        self._assembler.reset()
-        while True:
-            notify_data = await self._transport.read_notify(timeout=self._timeout_s)
-            container = Container.deserialize(notify_data)
-
-            if container.container_type == ContainerType.CONTROL:
-                if (
-                    container.control_cmd == ControlCmd.ERROR
-                    and len(container.payload) >= 1
-                ):
-                    error_code = container.payload[0]
-                    if error_code == BLERPC_ERROR_RESPONSE_TOO_LARGE:
-                        raise ResponseTooLargeError(
-                            "Response exceeds peripheral's max_response_payload_size"
-                        )
-                    raise RuntimeError(f"Peripheral error: 0x{error_code:02x}")
-                continue  # Skip other control containers
-
-            result = self._assembler.feed(container)
-            if result is not None:
-                break
-
-        # Decrypt if active
-        result = self._decrypt_payload(result)
+        rx = await self._open_call()
+        try:
+            await self._send(payload, rx.transaction_id)
+            result = await self._receive_response(rx)
+        finally:
+            await self._close(rx)
 
         # Decode command response
         resp = CommandPacket.deserialize(result)
+        if result[0] & COMMAND_FLAG_COMPRESSED:
+            resp.data = decompress(resp.data)
         if resp.cmd_type != CommandType.RESPONSE:
             raise RuntimeError(f"Expected response, got type={resp.cmd_type}")
         if resp.cmd_name != cmd_name:
@@ -294,18 +576,200 @@ class BlerpcClient(GeneratedClientMixin):
 
         return resp.data
 
+    def _compress_request(self, cmd: CommandPacket) -> bytes | None:
+        """Serialize cmd with compressed data, or None if not worth it."""
+        size = len(cmd.data)
+        if not COMPRESS_MIN_SIZE <= size <= self._inflate_limit:
+            return None
+        data = compress(cmd.data)
+        if len(data) >= size:
+            return None
+        payload = bytearray(
+            CommandPacket(
+                cmd_type=cmd.cmd_type, cmd_name=cmd.cmd_name, data=data
+            ).serialize()
+        )
+        payload[0] |= COMMAND_FLAG_COMPRESSED
+        return bytes(payload)
+
+    # ── Receive demultiplexing ──
+
+    async def _open_call(self) -> _Receiver:
+        """Register a unary call under a free transaction ID."""
+        async with self._rx_changed:
+            await self._rx_changed.wait_for(
+                lambda: self._exclusive is None
+                and not self._exclusive_waiting
+                and len(self._calls) < _MAX_CALLS_IN_FLIGHT
+            )
+            tid = self._splitter.next_transaction_id()
+            while tid in self._calls:
+                tid = self._splitter.next_transaction_id()
+            rx = self._calls[tid] = _Receiver(tid)
+        self._start_receiver()
+        return rx
+
+    async def _open_exclusive(self) -> _Receiver:
+        """Register a caller that receives every container, once calls drain."""
+        async with self._rx_changed:
+            self._exclusive_waiting += 1
+            try:
+                await self._rx_changed.wait_for(
+                    lambda: self._exclusive is None and not self._calls
+                )
+            finally:
+                self._exclusive_waiting -= 1
+                self._rx_changed.notify_all()
+            rx = self._exclusive = _Receiver()
+        self._start_receiver()
+        return rx
+
+    async def _close(self, rx: _Receiver) -> None:
+        async with self._rx_changed:
+            if rx is self._exclusive:
+                self._exclusive = None
+            else:
+                del self._calls[rx.transaction_id]
+            self._rx_changed.notify_all()
+            idle = self._exclusive is None and not self._calls
+        # Stop reading while nothing waits; late containers are dropped later
+        if idle and self._rx_task is not None:
+            self._rx_task.cancel()
+            self._rx_task = None
+
+    def _start_receiver(self) -> None:
+        if self._rx_task is None or self._rx_task.done():
+            self._rx_task = asyncio.create_task(self._receive_loop())
+
+    async def _receive_loop(self) -> None:
+        while True:
+            try:
+                data = await self._transport.read_notify(timeout=None)
+            except Exception as e:
+                # The link failed: so does every call waiting on it
+                for rx in (*self._calls.values(), self._exclusive):
+                    if rx is not None:
+                        rx.queue.put_nowait(e)
+                return
+            self._route(data)
+
+    def _route(self, data: bytes) -> None:
+        try:
+            container = Container.deserialize(data)
+        except Exception as e:
+            logger.warning("Dropping malformed notification: %s", e)
+            return
+        rx = self._calls.get(container.transaction_id, self._exclusive)
+        if rx is None:
+            logger.debug(
+                "Dropping container for tid=%d: no call waiting",
+                container.transaction_id,
+            )
+            return
+        if container.container_type == ContainerType.CONTROL:
+            rx.queue.put_nowait(container)
+            return
+        result = rx.assembler.feed(container)
+        if result is None:
+            return
+        # Decrypt here, in arrival order, so the session's counter advances
+        # in the order the peripheral encrypted
+        try:
+            rx.queue.put_nowait(self._decrypt_payload(result))
+        except Exception as e:
+            rx.queue.put_nowait(e)
+
+    async def _receive(
+        self, rx: _Receiver, timeout: float | None = None
+    ) -> Container | bytes:
+        """Next control container or response payload routed to rx."""
+        item = await asyncio.wait_for(
+            rx.queue.get(), timeout=self._timeout_s if timeout is None else timeout
+        )
+        if isinstance(item, Exception):
+            raise item
+        return item
+
+    @staticmethod
+    def _raise_for_error(container: Container) -> None:
+        if container.control_cmd == ControlCmd.ERROR and len(container.payload) >= 1:
+            error_code = container.payload[0]
+            if error_code == BLERPC_ERROR_RESPONSE_TOO_LARGE:
+                raise ResponseTooLargeError(
+                    "Response exceeds peripheral's max_response_payload_size"
+                )
+            raise RuntimeError(f"Peripheral error: 0x{error_code:02x}")
+
+    async def _receive_response(self, rx: _Receiver) -> bytes:
+        """Wait for rx's response payload, skipping other control containers."""
+        while True:
+            item = await self._receive(rx)
+            if isinstance(item, bytes):
+                return item
+            self._raise_for_error(item)
+
+    async def _send(self, payload: bytes, transaction_id: int) -> None:
+        """Encrypt one request and write its containers back to back.
+
+        Holding the lock across both keeps the session counter in write
+        order and each request's containers unbroken.
+        """
+        async with self._send_lock:
+            send_payload = self._encrypt_payload(payload)
+            for c in self._splitter.split(send_payload, transaction_id=transaction_id):
+                await self._transport.write(c.serialize())
+
+    async def _grant_stream_credits(self, credits: int) -> None:
+        # control_cmd is a plain int until blerpc_protocol knows STREAM_CREDIT
+        grant = Container(
+            transaction_id=0,
+            sequence_number=0,
+            container_type=ContainerType.CONTROL,
+            control_cmd=CONTROL_CMD_STREAM_CREDIT,
+            payload=credits.to_bytes(2, "little")
+            + bytes([STREAM_CREDIT_FLAG_COALESCE]),
+        )
+        await self._transport.write(grant.serialize())
+
+    @staticmethod
+    def _split_stream_frame(payload: bytes) -> list[bytes]:
+        """Split a coalesced batch frame into its command packets."""
+        if len(payload) < 4 or not payload[0] & COMMAND_FLAG_BATCH:
+            return [payload]
+        packets = []
+        off = 4
+        while off < len(payload):
+            end = off + 4
+            if end <= len(payload):
+                name_len = payload[off + 1]
+                hdr_end = off + 4 + name_len
+                data_len = int.from_bytes(payload[hdr_end - 2 : hdr_end], "little")
+                end = hdr_end + data_len
+            if end > len(payload):
+                raise RuntimeError("Malformed coalesced stream frame")
+            packets.append(payload[off:end])
+            off = end
+        return packets
+
     async def stream_receive(
         self, cmd_name: str, request_data: bytes
     ) -> AsyncIterator[bytes]:
         """P->C stream: send request, yield response data until STREAM_END_P2C.
 
         Each yielded bytes object is the protobuf-encoded data portion
-        of a single CommandPacket response.
+        of a single CommandPacket response. When the peripheral paces
+        streams, credits are granted back as messages are consumed, so a
+        slow consumer holds the stream back instead of losing notifications.
+        Other calls wait until the stream ends or the generator is closed.
         """
         if self._splitter is None:
             raise RuntimeError("Not connected: call connect() first")
 
-        # Send initial request (same as _call send path)
+        window = 0
+        if self._capability_flags & CAPABILITY_FLAG_STREAM_CREDITS:
+            window = min(self._stream_credits, 0xFFFF)
+        handled = 0
+
         cmd = CommandPacket(
             cmd_type=CommandType.REQUEST,
             cmd_name=cmd_name,
@@ -319,39 +783,100 @@ class BlerpcClient(GeneratedClientMixin):
         ):
             raise PayloadTooLargeError(len(payload), self._max_request_payload_size)
 
-        send_payload = self._encrypt_payload(payload)
-        containers = self._splitter.split(send_payload)
-        for c in containers:
-            await self._transport.write(c.serialize())
-
-        # Receive stream responses until STREAM_END_P2C
-        self._assembler.reset()
-        while True:
-            notify_data = await self._transport.read_notify(timeout=self._timeout_s)
-            container = Container.deserialize(notify_data)
-
-            if container.container_type == ContainerType.CONTROL:
-                if container.control_cmd == ControlCmd.STREAM_END_P2C:
-                    break
-                if (
-                    container.control_cmd == ControlCmd.ERROR
-                    and len(container.payload) >= 1
-                ):
-                    error_code = container.payload[0]
-                    if error_code == BLERPC_ERROR_RESPONSE_TOO_LARGE:
-                        raise ResponseTooLargeError(
-                            "Response exceeds peripheral's max_response_payload_size"
+        rx = await self._open_exclusive()
+        try:
+            if window > 0:
+                await self._grant_stream_credits(window)
+            await self._send(payload, self._splitter.next_transaction_id())
+
+            # Receive stream responses until STREAM_END_P2C
+            while True:
+                item = await self._receive(rx)
+                if isinstance(item, Container):
+                    if item.control_cmd == ControlCmd.STREAM_END_P2C:
+                        break
+                    self._raise_for_error(item)
+                    continue
+
+                for packet in self._split_stream_frame(item):
+                    resp = CommandPacket.deserialize(packet)
+                    if resp.cmd_type != CommandType.RESPONSE:
+                        raise RuntimeError(
+                            f"Expected response, got type={resp.cmd_type}"
                         )
-                    raise RuntimeError(f"Peripheral error: 0x{error_code:02x}")
-                continue
+                    yield resp.data
+                    handled += 1
+                    if window > 0 and handled >= (window + 1) // 2:
+                        await self._grant_stream_credits(handled)
+                        handled = 0
+        finally:
+            await self._close(rx)
+
+    async def flash_dump_resume(self, dump: FlashDump) -> FlashDump:
+        """Stream the part of ``dump`` not yet received, verifying each chunk.
+
+        If the link drops or a chunk fails verification, ``dump`` keeps
+        every chunk verified so far: reconnect and call again to resume.
+        """
+        if dump.done:
+            return dump
+        req = blerpc_pb2.FlashDumpRequest(
+            address=dump.next_offset, length=dump.remaining
+        )
+        # Closed on the way out so a rejected chunk frees the link at once
+        stream = self.stream_receive("flash_dump", req.SerializeToString())
+        async with aclosing(stream):
+            async for data in stream:
+                resp = blerpc_pb2.FlashDumpResponse()
+                resp.ParseFromString(data)
+                if resp.offset != dump.next_offset:
+                    raise FlashDumpError(
+                        f"Chunk at 0x{resp.offset:08x}, "
+                        f"expected 0x{dump.next_offset:08x}"
+                    )
+                if len(resp.data) > dump.remaining:
+                    raise FlashDumpError(f"Chunk at 0x{resp.offset:08x} overruns dump")
+                if zlib.crc32(resp.data) != resp.crc32:
+                    raise FlashDumpError(
+                        f"CRC mismatch in chunk at 0x{resp.offset:08x}"
+                    )
+                dump.data += resp.data
+        if not dump.done:
+            raise FlashDumpError(
+                f"Stream ended at 0x{dump.next_offset:08x} with "
+                f"{dump.remaining} bytes left"
+            )
+        return dump
 
-            result = self._assembler.feed(container)
-            if result is not None:
-                result = self._decrypt_payload(result)
-                resp = CommandPacket.deserialize(result)
-                if resp.cmd_type != CommandType.RESPONSE:
-                    raise RuntimeError(f"Expected response, got type={resp.cmd_type}")
-                yield resp.data
+    def _coalesce_stream_messages(
+        self, cmd_name: str, messages: list[bytes]
+    ) -> list[bytes]:
+        """Pack C->P stream messages into coalesced frames of one container each.
+
+        A frame is a batch request naming the command once, whose data is a
+        run of [len LE16][message] entries. A message too large to share a
+        frame goes in one of its own.
+        """
+        name = cmd_name.encode()
+        header = bytes([(CommandType.REQUEST << 7) | COMMAND_FLAG_BATCH, len(name)])
+        header += name
+        limit = self.mtu - _FIRST_CONTAINER_OVERHEAD
+        if self._max_request_payload_size is not None:
+            limit = min(limit, self._max_request_payload_size)
+        if self._session is not None:
+            limit -= _ENCRYPTED_OVERHEAD
+
+        frames = []
+        body = bytearray()
+        for msg_data in messages:
+            entry = len(msg_data).to_bytes(2, "little") + msg_data
+            if body and len(header) + 2 + len(body) + len(entry) > limit:
+                frames.append(header + len(body).to_bytes(2, "little") + body)
+                body = bytearray()
+            body += entry
+        if body:
+            frames.append(header + len(body).to_bytes(2, "little") + body)
+        return frames
 
     async def stream_send(
         self,
@@ -368,48 +893,33 @@ class BlerpcClient(GeneratedClientMixin):
         if self._splitter is None:
             raise RuntimeError("Not connected: call connect() first")
 
-        # Send each message as an independent request
-        for msg_data in messages:
-            cmd = CommandPacket(
-                cmd_type=CommandType.REQUEST,
-                cmd_name=cmd_name,
-                data=msg_data,
-            )
-            payload = cmd.serialize()
-            send_payload = self._encrypt_payload(payload)
-            containers = self._splitter.split(send_payload)
-            for c in containers:
-                await self._transport.write(c.serialize())
-
-        # Send STREAM_END_C2P
-        tid = self._splitter.next_transaction_id()
-        stream_end = make_stream_end_c2p(transaction_id=tid)
-        await self._transport.write(stream_end.serialize())
-
-        # Wait for final response
-        self._assembler.reset()
-        while True:
-            notify_data = await self._transport.read_notify(timeout=self._timeout_s)
-            container = Container.deserialize(notify_data)
+        if self._capability_flags & CAPABILITY_FLAG_STREAM_COALESCE:
+            payloads = self._coalesce_stream_messages(cmd_name, messages)
+        else:
+            # Send each message as an independent request
+            payloads = [
+                CommandPacket(
+                    cmd_type=CommandType.REQUEST,
+                    cmd_name=cmd_name,
+                    data=msg_data,
+                ).serialize()
+                for msg_data in messages
+            ]
+        # The final response comes under the peripheral's own transaction ID
+        rx = await self._open_exclusive()
+        try:
+            for payload in payloads:
+                await self._send(payload, self._splitter.next_transaction_id())
 
-            if container.container_type == ContainerType.CONTROL:
-                if (
-                    container.control_cmd == ControlCmd.ERROR
-                    and len(container.payload) >= 1
-                ):
-                    error_code = container.payload[0]
-                    if error_code == BLERPC_ERROR_RESPONSE_TOO_LARGE:
-                        raise ResponseTooLargeError(
-                            "Response exceeds peripheral's max_response_payload_size"
-                        )
-                    raise RuntimeError(f"Peripheral error: 0x{error_code:02x}")
-                continue
+            # Send STREAM_END_C2P
+            tid = self._splitter.next_transaction_id()
+            stream_end = make_stream_end_c2p(transaction_id=tid)
+            await self._transport.write(stream_end.serialize())
 
-            result = self._assembler.feed(container)
-            if result is not None:
-                break
+            result = await self._receive_response(rx)
+        finally:
+            await self._close(rx)
 
-        result = self._decrypt_payload(result)
         resp = CommandPacket.deserialize(result)
         if resp.cmd_type != CommandType.RESPONSE:
             raise RuntimeError(f"Expected response, got type={resp.cmd_type}")
@@ -420,6 +930,56 @@ class BlerpcClient(GeneratedClientMixin):
             )
         return resp.data
 
+    async def read_stats(self, page: int = 0) -> bytes:
+        """Read one raw instrumentation page from the peripheral.
+
+        Page 0 holds the link counters, a command ID page that command's
+        latency histograms. Returns the page without its page byte.
+        """
+        if not self._capability_flags & CAPABILITY_FLAG_STATS:
+            raise RuntimeError("Peripheral does not report stats")
+        # control_cmd is a plain int until blerpc_protocol knows STATS
+        req = Container(
+            transaction_id=0,
+            sequence_number=0,
+            container_type=ContainerType.CONTROL,
+            control_cmd=CONTROL_CMD_STATS,
+            payload=bytes([page]),
+        )
+        rx = await self._open_exclusive()
+        try:
+            await self._transport.write(req.serialize())
+            while True:
+                resp = await self._receive(rx, timeout=1.0)
+                if (
+                    isinstance(resp, Container)
+                    and resp.control_cmd == CONTROL_CMD_STATS
+                    and resp.payload[:1] == bytes([page])
+                ):
+                    return resp.payload[1:]
+                logger.debug("Skipping container while waiting for stats")
+        finally:
+            await self._close(rx)
+
+    async def link_stats(self) -> dict[str, int]:
+        """Read the peripheral's link counters, keyed by STATS_COUNTERS names."""
+        data = await self.read_stats(0)
+        return {
+            name: int.from_bytes(data[i * 4 : i * 4 + 4], "little")
+            for i, name in enumerate(STATS_COUNTERS)
+            if i * 4 + 4 <= len(data)
+        }
+
+    async def command_stats(self, command_id: int) -> CommandStats:
+        """Read one command's latency histograms (IDs in schema order, from 1)."""
+        data = await self.read_stats(command_id)
+        if len(data) < 8:
+            raise ValueError(f"Peripheral has no command with ID {command_id}")
+        return CommandStats.from_page(data)
+
     async def disconnect(self) -> None:
         """Disconnect from the peripheral."""
+        if self._rx_task is not None:
+            self._rx_task.cancel()
+            self._rx_task = None
         await self._transport.disconnect()
@@ -0,0 +1,101 @@
+"""LZSS codec for command data sent with COMMAND_FLAG_COMPRESSED.
+
+Same format as peripheral_fw/src/blerpc_compress.h: raw_len (2 bytes LE),
+then groups of up to 8 items, each led by a control byte whose bit i (LSB
+first) marks item i as a match. A literal is one byte; a match is 2 bytes
+LE, distance - 1 in the low 12 bits and length - 3 in the high 4, copying
+length bytes from distance back in the output (possibly overlapping).
+"""
+
+from __future__ import annotations
+
+HEADER_SIZE = 2
+MIN_MATCH = 3
+MAX_MATCH = 18
+MAX_DISTANCE = 4096
+
+
+class DecompressError(ValueError):
+    """Compressed data is malformed or larger than allowed."""
+
+
+def compress(data: bytes, window: int = MAX_DISTANCE) -> bytes:
+    """Compress data (at most 65535 bytes) into the wire format.
+
+    Each item is the longest match within window bytes back, nearest first
+    on ties, as in the firmware encoder: with window set to its
+    1 << CONFIG_BLERPC_COMPRESSION_WINDOW_BITS the output is the same.
+    """
+    data = bytes(data)
+    if len(data) > 0xFFFF:
+        raise ValueError(f"{len(data)} bytes is more than one data field holds")
+    window = min(window, MAX_DISTANCE)
+    out = bytearray(len(data).to_bytes(2, "little"))
+    group = bytearray(1)
+    items = 0
+    pos = 0
+    end = len(data)
+    while pos < end:
+        # Grow the match while a nearest occurrence of the longer prefix
+        # starts in the window; rfind keeps the search out of Python loops
+        best = 0
+        distance = 0
+        lowest = max(0, pos - window)
+        for n in range(MIN_MATCH, min(MAX_MATCH, end - pos) + 1):
+            found = data.rfind(data[pos : pos + n], lowest, pos + n - 1)
+            if found < 0:
+                break
+            best, distance = n, pos - found
+        if best:
+            group[0] |= 1 << items
+            group += ((distance - 1) | ((best - MIN_MATCH) << 12)).to_bytes(2, "little")
+            pos += best
+        else:
+            group.append(data[pos])
+            pos += 1
+        items += 1
+        if items == 8:
+            out += group
+            group = bytearray(1)
+            items = 0
+    if items:
+        out += group
+    return bytes(out)
+
+
+def decompress(data: bytes, max_size: int = 0xFFFF) -> bytes:
+    """Decompress a data field, raising DecompressError if malformed."""
+    if len(data) < HEADER_SIZE:
+        raise DecompressError("missing raw length")
+    raw_len = int.from_bytes(data[:HEADER_SIZE], "little")
+    if raw_len > max_size:
+        raise DecompressError(f"raw length {raw_len} exceeds {max_size}")
+    out = bytearray()
+    i = HEADER_SIZE
+    end = len(data)
+    while i < end:
+        ctrl = data[i]
+        i += 1
+        for bit in range(8):
+            if i >= end:
+                break
+            if not ctrl & (1 << bit):
+                out.append(data[i])
+                i += 1
+                continue
+            if end - i < 2:
+                raise DecompressError("truncated match")
+            v = int.from_bytes(data[i : i + 2], "little")
+            i += 2
+            distance = (v & 0x0FFF) + 1
+            length = (v >> 12) + MIN_MATCH
+            if distance > len(out):
+                raise DecompressError("match before start of data")
+            start = len(out) - distance
+            for k in range(length):
+                out.append(out[start + k])
+        if len(out) > raw_len:
+            raise DecompressError("data longer than raw length")
+    if len(out) != raw_len:
+        raise DecompressError(f"got {len(out)} bytes, expected {raw_len}")
+    return bytes(out)
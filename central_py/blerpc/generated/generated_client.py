@@ -54,3 +54,15 @@ class GeneratedClientMixin:
         resp = blerpc_pb2.CounterUploadResponse()
         resp.ParseFromString(resp_data)
         return resp
+
+    async def flash_dump(self, *, address=0, length=0):
+        """P2C stream: flash_dump."""
+        req = blerpc_pb2.FlashDumpRequest(address=address, length=length)
+        results = []
+        async for data in self.stream_receive(
+            "flash_dump", req.SerializeToString()
+        ):
+            resp = blerpc_pb2.FlashDumpResponse()
+            resp.ParseFromString(data)
+            results.append(resp)
+        return results
@@ -0,0 +1,217 @@
+"""In-process loopback link between a BlerpcClient and a peripheral.
+
+Stands in for the radio so the container, command and encryption layers can
+be exercised without hardware: ``LoopbackLink.transport`` replaces
+``BleTransport`` on the central side, and a peripheral attaches its write
+handler and notifies through ``LoopbackLink.notify()`` (see
+``BlerpcPeripheral.attach()`` in peripheral_py/server.py).
+
+Each packet arrives ``latency_s`` after it was sent, in order, unless it is
+lost. At most ``tx_depth`` packets per direction are in flight: the central's
+writes wait for room, and ``notify()`` reports a full buffer the way a GATT
+server does, so the peripheral's retry path runs.
+"""
+
+from __future__ import annotations
+
+import asyncio
+import collections
+import queue
+import random
+import threading
+from collections.abc import Callable
+from dataclasses import dataclass
+
+from .transport import DEFAULT_TIMEOUT_S, ScannedDevice
+
+
+@dataclass
+class LinkStats:
+    """Packet counters of one loopback link."""
+
+    writes: int = 0  # central -> peripheral packets sent
+    notifications: int = 0  # peripheral -> central packets sent
+    bytes_c2p: int = 0
+    bytes_p2c: int = 0
+    lost: int = 0
+    notify_full: int = 0  # notify() calls refused for a full TX buffer
+
+
+class _Pipe:
+    """One direction of the link: ordered delivery after a fixed latency."""
+
+    def __init__(self, loop: asyncio.AbstractEventLoop, latency_s: float, deliver):
+        self._loop = loop
+        self._latency_s = latency_s
+        self._deliver = deliver
+        self._pending: collections.deque[tuple[float, bytes]] = collections.deque()
+        self._timer: asyncio.TimerHandle | None = None
+
+    def send(self, data: bytes) -> None:
+        due = self._loop.time() + self._latency_s
+        if self._pending:
+            due = max(due, self._pending[-1][0])
+        self._pending.append((due, data))
+        if self._timer is None:
+            self._timer = self._loop.call_at(due, self._pump)
+
+    def _pump(self) -> None:
+        self._timer = None
+        now = self._loop.time()
+        while self._pending and self._pending[0][0] <= now:
+            _, data = self._pending.popleft()
+            self._deliver(data)
+        if self._pending:
+            self._timer = self._loop.call_at(self._pending[0][0], self._pump)
+
+
+class LoopbackLink:
+    """Simulated connection between one central and one peripheral."""
+
+    def __init__(
+        self,
+        mtu: int = 247,
+        latency_s: float = 0.0,
+        loss: float = 0.0,
+        tx_depth: int = 20,
+        seed: int | None = None,
+    ):
+        if tx_depth < 1:
+            raise ValueError("tx_depth must be at least 1")
+        self.mtu = mtu
+        self.latency_s = latency_s
+        self.loss = loss
+        self.tx_depth = tx_depth
+        self.stats = LinkStats()
+        self.transport = LoopbackTransport(self)
+        self._rng = random.Random(seed)
+        self._on_write: Callable[[bytes], None] | None = None
+        self._on_ready: Callable[[], None] | None = None
+        self._loop: asyncio.AbstractEventLoop | None = None
+        self._c2p: _Pipe | None = None
+        self._p2c: _Pipe | None = None
+        self._write_slots: asyncio.Semaphore | None = None
+        self._notify_lock = threading.Lock()
+        self._notify_in_flight = 0
+        self._inbox: queue.Queue[bytes | None] = queue.Queue()
+        self._worker: threading.Thread | None = None
+
+    def attach(
+        self,
+        on_write: Callable[[bytes], None],
+        on_ready: Callable[[], None] | None = None,
+    ) -> None:
+        """Set the peripheral's write handler and TX-ready callback.
+
+        on_write runs on one thread per link, one write at a time, like a
+        BLE stack's RX thread, and may block (e.g. in notify retries).
+        on_ready runs on the event loop each time a notification leaves the
+        TX buffer, so a peripheral refused by notify() can wait for it.
+        """
+        self._on_write = on_write
+        self._on_ready = on_ready
+
+    def notify(self, data: bytes) -> bool:
+        """Send a notification to the central; False if the TX buffer is full.
+
+        Safe to call from any thread.
+        """
+        loop = self._loop
+        if loop is None or loop.is_closed():
+            return False
+        with self._notify_lock:
+            if self._notify_in_flight >= self.tx_depth:
+                self.stats.notify_full += 1
+                return False
+            self._notify_in_flight += 1
+            self.stats.notifications += 1
+            self.stats.bytes_p2c += len(data)
+        loop.call_soon_threadsafe(self._p2c.send, bytes(data))
+        return True
+
+    # ── Central side, called by LoopbackTransport ──
+
+    def _open(self) -> None:
+        self._loop = asyncio.get_running_loop()
+        self._c2p = _Pipe(self._loop, self.latency_s, self._deliver_c2p)
+        self._p2c = _Pipe(self._loop, self.latency_s, self._deliver_p2c)
+        self._write_slots = asyncio.Semaphore(self.tx_depth)
+        self._worker = threading.Thread(target=self._run_peripheral, daemon=True)
+        self._worker.start()
+
+    def _close(self) -> None:
+        if self._worker is not None:
+            self._inbox.put(None)
+            self._worker = None
+        self._loop = None
+
+    async def _write(self, data: bytes) -> None:
+        await self._write_slots.acquire()
+        self.stats.writes += 1
+        self.stats.bytes_c2p += len(data)
+        self._c2p.send(bytes(data))
+
+    def _lost(self) -> bool:
+        if self.loss > 0 and self._rng.random() < self.loss:
+            self.stats.lost += 1
+            return True
+        return False
+
+    def _deliver_c2p(self, data: bytes) -> None:
+        self._write_slots.release()
+        if not self._lost():
+            self._inbox.put(data)
+
+    def _deliver_p2c(self, data: bytes) -> None:
+        with self._notify_lock:
+            self._notify_in_flight -= 1
+        if self._on_ready is not None:
+            self._on_ready()
+        if not self._lost():
+            self.transport._notify_queue.put_nowait(data)
+
+    def _run_peripheral(self) -> None:
+        while (data := self._inbox.get()) is not None:
+            if self._on_write is not None:
+                self._on_write(data)
+
+
+class LoopbackTransport:
+    """Central end of a LoopbackLink, with the interface of BleTransport."""
+
+    def __init__(self, link: LoopbackLink):
+        self._link = link
+        self._notify_queue: asyncio.Queue[bytes] = asyncio.Queue()
+        self._connected = False
+
+    @property
+    def mtu(self) -> int:
+        return self._link.mtu
+
+    @property
+    def address(self) -> str | None:
+        return "loopback" if self._connected else None
+
+    @property
+    def is_connected(self) -> bool:
+        return self._connected
+
+    async def scan(self, **kwargs) -> list[ScannedDevice]:
+        return [ScannedDevice(name="blerpc", address="loopback", rssi=0)]
+
+    async def connect(self, device: ScannedDevice) -> None:
+        self._notify_queue = asyncio.Queue()
+        self._link._open()
+        self._connected = True
+
+    async def write(self, data: bytes) -> None:
+        if not self._connected:
+            raise ConnectionError("Not connected")
+        await self._link._write(data)
+
+    async def read_notify(self, timeout: float = DEFAULT_TIMEOUT_S) -> bytes:
+        return await asyncio.wait_for(self._notify_queue.get(), timeout=timeout)
+
+    async def disconnect(self) -> None:
+        self._connected = False
+        self._link._close()
@@ -0,0 +1,137 @@
+"""Session resumption tickets, carried by the RESUME control command.
+
+Same protocol as peripheral_fw/src/session_resume.h. After a full key
+exchange the central sends TICKET_REQUEST and receives, encrypted under the
+new session, a random secret and a ticket sealing it. A reconnecting central
+sends HELLO (ticket || nonce_c); the peripheral answers ACCEPT (nonce_p ||
+confirm || next ticket, if any are left) or REJECT, and both sides take
+session_key || next_secret || confirm from
+HKDF-SHA256(secret, salt=nonce_c || nonce_p, info="blerpc-resume").
+"""
+
+from __future__ import annotations
+
+import hashlib
+import hmac
+import os
+import struct
+import time
+from collections.abc import Callable
+from dataclasses import dataclass
+
+from cryptography.exceptions import InvalidTag
+from cryptography.hazmat.primitives.ciphers.aead import AESGCM
+
+CAPABILITY_FLAG_RESUMPTION = 0x0100
+CONTROL_CMD_RESUME = 9
+
+OP_TICKET_REQUEST = 0x01
+OP_TICKET = 0x02
+OP_HELLO = 0x03
+OP_ACCEPT = 0x04
+OP_REJECT = 0x05
+
+SECRET_SIZE = 32
+NONCE_SIZE = 16
+CONFIRM_SIZE = 16
+KEY_SIZE = 16
+# key_id(1) || gcm_nonce(12) || sealed{secret(32) issued(4) uses_left(1)} || tag(16)
+TICKET_SIZE = 66
+HELLO_SIZE = 1 + TICKET_SIZE + NONCE_SIZE
+ACCEPT_MIN_SIZE = 1 + NONCE_SIZE + CONFIRM_SIZE
+
+_INFO = b"blerpc-resume"
+_TICKET_NONCE_SIZE = 12
+
+
+def hkdf_sha256(secret: bytes, salt: bytes, info: bytes, length: int) -> bytes:
+    """HKDF-SHA256 (RFC 5869)."""
+    prk = hmac.new(salt or bytes(32), secret, hashlib.sha256).digest()
+    okm = b""
+    block = b""
+    counter = 1
+    while len(okm) < length:
+        block = hmac.new(prk, block + info + bytes([counter]), hashlib.sha256).digest()
+        okm += block
+        counter += 1
+    return okm[:length]
+
+
+@dataclass(frozen=True)
+class ResumeKeys:
+    """Keys of a resumed session."""
+
+    session_key: bytes
+    next_secret: bytes
+    confirm: bytes
+
+
+def derive(secret: bytes, nonce_c: bytes, nonce_p: bytes) -> ResumeKeys:
+    size = KEY_SIZE + SECRET_SIZE + CONFIRM_SIZE
+    okm = hkdf_sha256(secret, nonce_c + nonce_p, _INFO, size)
+    return ResumeKeys(
+        session_key=okm[:KEY_SIZE],
+        next_secret=okm[KEY_SIZE : KEY_SIZE + SECRET_SIZE],
+        confirm=okm[KEY_SIZE + SECRET_SIZE :],
+    )
+
+
+@dataclass(frozen=True)
+class Ticket:
+    """What a ticket seals, once opened."""
+
+    secret: bytes
+    issued: int  # seconds, on the sealer's clock, of the full handshake
+    uses_left: int
+
+
+class TicketSealer:
+    """Peripheral side: seals and opens tickets.
+
+    The sealing key rotates every lifetime_s and the one before it still
+    opens tickets, so a ticket is refused lifetime_s after its full
+    handshake and unrecoverable two lifetimes after.
+    """
+
+    def __init__(
+        self, lifetime_s: int = 3600, clock: Callable[[], float] = time.monotonic
+    ):
+        self.lifetime_s = lifetime_s
+        self._clock = clock
+        self._key_id = 0
+        self._keys = {0: AESGCM.generate_key(bit_length=KEY_SIZE * 8)}
+        self._rotated = self.now()
+
+    def now(self) -> int:
+        return int(self._clock()) & 0xFFFFFFFF
+
+    def seal(self, secret: bytes, issued: int, uses_left: int) -> bytes:
+        now = self.now()
+        if (now - self._rotated) & 0xFFFFFFFF >= self.lifetime_s:
+            self._key_id = (self._key_id + 1) & 0xFF
+            self._keys = {
+                self._key_id: AESGCM.generate_key(bit_length=KEY_SIZE * 8),
+                (self._key_id - 1) & 0xFF: self._keys[(self._key_id - 1) & 0xFF],
+            }
+            self._rotated = now
+        key_id = bytes([self._key_id])
+        nonce = os.urandom(_TICKET_NONCE_SIZE)
+        plain = secret + struct.pack("<IB", issued & 0xFFFFFFFF, uses_left)
+        sealed = AESGCM(self._keys[self._key_id]).encrypt(nonce, plain, key_id)
+        return key_id + nonce + sealed
+
+    def open(self, ticket: bytes) -> Ticket | None:
+        """The ticket's contents, or None if it is forged, expired or spent."""
+        if len(ticket) != TICKET_SIZE or ticket[0] not in self._keys:
+            return None
+        nonce = ticket[1 : 1 + _TICKET_NONCE_SIZE]
+        try:
+            plain = AESGCM(self._keys[ticket[0]]).decrypt(
+                nonce, ticket[1 + _TICKET_NONCE_SIZE :], ticket[:1]
+            )
+        except InvalidTag:
+            return None
+        issued, uses_left = struct.unpack_from("<IB", plain, SECRET_SIZE)
+        if uses_left == 0 or (self.now() - issued) & 0xFFFFFFFF >= self.lifetime_s:
+            return None
+        return Ticket(secret=plain[:SECRET_SIZE], issued=issued, uses_left=uses_left)
@@ -0,0 +1,87 @@
+"""Tests for parsing and comparing benchmark suite output."""
+
+import json
+
+from blerpc.bench import BenchRun, compare, parse_lines
+
+
+def point_line(**overrides) -> str:
+    point = {
+        "sweep": "size",
+        "op": "read",
+        "size": 1024,
+        "mtu": 247,
+        "phy": 2,
+        "interval": 24,
+        "depth": 1,
+        "enc": 1,
+        "bulk": 0,
+        "n": 20,
+        "fail": 0,
+        "p50_us": 40000,
+        "p99_us": 52000,
+        "max_us": 52000,
+        "bytes_per_s": 25000,
+    }
+    point.update(overrides)
+    return "[00:00:05.123,456] <inf> bench: BENCH " + json.dumps(point)
+
+
+def run_lines(*points: str) -> list[str]:
+    return [
+        "[00:00:01.000,000] <inf> main: blerpc central starting",
+        '[00:00:04.000,000] <inf> bench: BENCH {"suite":"begin","calls":20,'
+        '"window":2,"max_payload":12160,"enc":1}',
+        *points,
+        '[00:00:09.000,000] <inf> bench: BENCH {"suite":"end","points":2,'
+        '"failed_points":0}',
+        "trailing output after the suite",
+    ]
+
+
+class TestParse:
+    def test_parse_run(self):
+        run = parse_lines(run_lines(point_line(), point_line(op="write")))
+        assert run.complete
+        assert run.info["window"] == 2
+        assert run.info["points"] == 2
+        assert [p.op for p in run.points] == ["read", "write"]
+        assert run.points[0].p99_us == 52000
+
+    def test_truncated_line_skipped(self):
+        lines = run_lines(point_line()[:-10], point_line(size=16))
+        run = parse_lines(lines)
+        assert [p.size for p in run.points] == [16]
+
+    def test_incomplete_run(self):
+        run = parse_lines(run_lines(point_line())[:-2])
+        assert not run.complete
+        assert len(run.points) == 1
+
+    def test_json_roundtrip(self):
+        run = parse_lines(run_lines(point_line()))
+        again = BenchRun.from_json(json.loads(json.dumps(run.to_json())))
+        assert again.points == run.points
+        assert again.complete
+
+
+class TestCompare:
+    def test_within_tolerance(self):
+        base = parse_lines(run_lines(point_line()))
+        run = parse_lines(run_lines(point_line(p99_us=55000, bytes_per_s=23000)))
+        assert compare(run, base, 0.10) == []
+
+    def test_latency_and_goodput_regressions(self):
+        base = parse_lines(run_lines(point_line(), point_line(op="write")))
+        run = parse_lines(
+            run_lines(point_line(p99_us=60000), point_line(op="write", fail=1))
+        )
+        regressions = compare(run, base, 0.10)
+        assert [r.point.op for r in regressions] == ["read", "write"]
+        assert "p99" in regressions[0].reason
+        assert "failed" in regressions[1].reason
+
+    def test_unmatched_points_ignored(self):
+        base = parse_lines(run_lines(point_line(enc=0)))
+        run = parse_lines(run_lines(point_line(enc=1, bytes_per_s=1)))
+        assert compare(run, base) == []
@@ -5,14 +5,26 @@ without requiring BLE hardware.
 """
 
 import asyncio
+import itertools
+import os
+import zlib
 
 import pytest
-from blerpc.client import BlerpcClient, PayloadTooLargeError, ResponseTooLargeError
+from blerpc.client import (
+    BlerpcClient,
+    FlashDump,
+    FlashDumpError,
+    LinkParams,
+    PayloadTooLargeError,
+    ResponseTooLargeError,
+)
+from blerpc.compress import compress, decompress
 from blerpc.generated import blerpc_pb2
 from blerpc_protocol.command import CommandPacket, CommandType
 from blerpc_protocol.container import (
     BLERPC_ERROR_RESPONSE_TOO_LARGE,
     Container,
+    ContainerAssembler,
     ContainerSplitter,
     ContainerType,
     ControlCmd,
@@ -250,6 +262,60 @@ async def test_sequential_calls_increment_transaction_id():
     assert len(tids) == 3
 
 
+@pytest.mark.asyncio
+async def test_concurrent_calls_routed_by_transaction_id():
+    """Interleaved, out-of-order responses each reach the call that sent it."""
+    transport = MockTransport(mtu=50)
+    client = make_client(transport)
+
+    streams = []
+    for tid in (2, 0, 1):
+        resp = blerpc_pb2.EchoResponse(message=f"msg{tid}" * 20)
+        cmd = CommandPacket(
+            cmd_type=CommandType.RESPONSE,
+            cmd_name="echo",
+            data=resp.SerializeToString(),
+        )
+        splitter = ContainerSplitter(mtu=transport.mtu)
+        streams.append(splitter.split(cmd.serialize(), transaction_id=tid))
+    for group in itertools.zip_longest(*streams):
+        for c in group:
+            if c is not None:
+                transport._notify_queue.put_nowait(c.serialize())
+
+    results = await asyncio.gather(
+        *(client.echo(message=f"msg{i}") for i in range(3))
+    )
+    assert [r.message for r in results] == [f"msg{i}" * 20 for i in range(3)]
+    assert not client._calls
+
+
+@pytest.mark.asyncio
+async def test_stream_waits_for_calls_in_flight():
+    """A P->C stream starts only after pending unary calls complete."""
+    transport = MockTransport()
+    client = make_client(transport)
+
+    echo = asyncio.create_task(client.echo(message="first"))
+    await asyncio.sleep(0)
+    stream = asyncio.create_task(client.counter_stream(count=1))
+    await asyncio.sleep(0.05)
+    # Only the echo request has gone out
+    assert len(transport._written) == 1
+
+    resp = blerpc_pb2.EchoResponse(message="first")
+    transport.inject_response("echo", resp.SerializeToString(), transaction_id=0)
+    assert (await echo).message == "first"
+
+    msg = blerpc_pb2.CounterStreamResponse(seq=0, value=0)
+    transport.inject_response(
+        "counter_stream", msg.SerializeToString(), transaction_id=7
+    )
+    inject_stream_end_p2c(transport, transaction_id=8)
+    assert [r.seq for r in await stream] == [0]
+    assert len(transport._written) == 2
+
+
 # ── Payload size limit tests ─────────────────────────────────────────────
 
 
@@ -370,6 +436,49 @@ async def test_counter_stream_empty():
     assert results == []
 
 
+def inject_coalesced(transport: MockTransport, cmd_name: str, datas: list[bytes]):
+    """Enqueue one batch frame carrying several stream responses."""
+    packets = b"".join(
+        CommandPacket(
+            cmd_type=CommandType.RESPONSE, cmd_name=cmd_name, data=d
+        ).serialize()
+        for d in datas
+    )
+    frame = bytes([0x80 | 0x20, 0]) + len(packets).to_bytes(2, "little") + packets
+    splitter = ContainerSplitter(mtu=transport.mtu)
+    for c in splitter.split(frame, transaction_id=20):
+        transport._notify_queue.put_nowait(c.serialize())
+
+
+@pytest.mark.asyncio
+async def test_counter_stream_credits():
+    """Paced streams grant credits up front and hand back half a window."""
+    transport = MockTransport()
+    client = BlerpcClient(require_encryption=False, stream_credits=4)
+    client._transport = transport
+    client._splitter = ContainerSplitter(mtu=transport.mtu)
+    client._timeout_s = 2.0
+    client._capability_flags = 0x0010
+
+    msgs = [
+        blerpc_pb2.CounterStreamResponse(seq=i, value=i * 10).SerializeToString()
+        for i in range(4)
+    ]
+    inject_coalesced(transport, "counter_stream", msgs[:2])
+    for i in (2, 3):
+        transport.inject_response("counter_stream", msgs[i], transaction_id=30 + i)
+    inject_stream_end_p2c(transport, transaction_id=100)
+
+    results = await client.counter_stream(count=4)
+
+    assert [r.seq for r in results] == [0, 1, 2, 3]
+    # credit(4), the request, then a credit(2) per half window consumed
+    assert len(transport._written) == 4
+    assert transport._written[0].endswith(bytes([4, 0, 0x01]))
+    assert transport._written[2].endswith(bytes([2, 0, 0x01]))
+    assert transport._written[3].endswith(bytes([2, 0, 0x01]))
+
+
 @pytest.mark.asyncio
 async def test_counter_upload():
     """Test C->P stream: send N requests, STREAM_END_C2P, get response."""
@@ -407,6 +516,110 @@ async def test_counter_upload():
     assert len(data_containers) == count
 
 
+@pytest.mark.asyncio
+async def test_counter_upload_coalesced():
+    """Peripherals taking coalesced frames get many messages per container."""
+    transport = MockTransport(mtu=64)
+    client = make_client(transport)
+    client._capability_flags = 0x0020
+
+    resp = blerpc_pb2.CounterUploadResponse(received_count=10)
+    transport.inject_response(
+        "counter_upload", resp.SerializeToString(), transaction_id=50
+    )
+
+    messages = [
+        blerpc_pb2.CounterUploadRequest(seq=i, value=i * 10) for i in range(10)
+    ]
+    result = await client.counter_upload(messages)
+    assert result.received_count == 10
+
+    frames = [
+        c.payload
+        for c in (Container.deserialize(w) for w in transport._written)
+        if c.container_type != ContainerType.CONTROL
+    ]
+    assert 1 < len(frames) < len(messages)
+    unpacked = []
+    for frame in frames:
+        assert len(frame) <= 64 - 9
+        assert frame[0] & 0x20
+        name_len = frame[1]
+        assert frame[2 : 2 + name_len] == b"counter_upload"
+        body = frame[4 + name_len :]
+        assert int.from_bytes(frame[2 + name_len : 4 + name_len], "little") == len(
+            body
+        )
+        while body:
+            n = int.from_bytes(body[:2], "little")
+            unpacked.append(body[2 : 2 + n])
+            body = body[2 + n :]
+    assert unpacked == [m.SerializeToString() for m in messages]
+
+
+def inject_flash_dump_chunk(
+    transport: MockTransport, offset: int, data: bytes, crc32: int | None = None
+):
+    resp = blerpc_pb2.FlashDumpResponse(
+        offset=offset,
+        data=data,
+        crc32=zlib.crc32(data) if crc32 is None else crc32,
+    )
+    transport.inject_response(
+        "flash_dump", resp.SerializeToString(), transaction_id=offset & 0xFF
+    )
+
+
+def last_flash_dump_request(transport: MockTransport) -> blerpc_pb2.FlashDumpRequest:
+    container = Container.deserialize(transport._written[-1])
+    cmd = CommandPacket.deserialize(container.payload)
+    req = blerpc_pb2.FlashDumpRequest()
+    req.ParseFromString(cmd.data)
+    return req
+
+
+@pytest.mark.asyncio
+async def test_flash_dump_resume_after_bad_chunk():
+    """A rejected chunk keeps earlier data; the retry asks for the rest."""
+    transport = MockTransport()
+    client = make_client(transport)
+    image = bytes(range(256)) * 3
+
+    dump = FlashDump(address=0x1000, length=len(image))
+    inject_flash_dump_chunk(transport, 0x1000, image[:256])
+    inject_flash_dump_chunk(transport, 0x1100, image[256:512], crc32=0)
+    with pytest.raises(FlashDumpError):
+        await client.flash_dump_resume(dump)
+    assert dump.next_offset == 0x1100
+    assert bytes(dump.data) == image[:256]
+
+    transport._notify_queue = asyncio.Queue()
+    inject_flash_dump_chunk(transport, 0x1100, image[256:512])
+    inject_flash_dump_chunk(transport, 0x1200, image[512:])
+    inject_stream_end_p2c(transport, transaction_id=100)
+    await client.flash_dump_resume(dump)
+
+    req = last_flash_dump_request(transport)
+    assert (req.address, req.length) == (0x1100, 512)
+    assert dump.done
+    assert bytes(dump.data) == image
+
+
+@pytest.mark.asyncio
+async def test_flash_dump_short_stream_raises():
+    """STREAM_END_P2C before the last chunk leaves the dump resumable."""
+    transport = MockTransport()
+    client = make_client(transport)
+
+    dump = FlashDump(address=0, length=64)
+    inject_flash_dump_chunk(transport, 0, b"\xaa" * 32)
+    inject_stream_end_p2c(transport, transaction_id=100)
+    with pytest.raises(FlashDumpError):
+        await client.flash_dump_resume(dump)
+    assert dump.next_offset == 32
+    assert dump.remaining == 32
+
+
 @pytest.mark.asyncio
 async def test_stream_receive_error_during_stream():
     """ERROR control during P→C stream raises."""
@@ -596,3 +809,188 @@ async def test_payload_too_large_attributes():
         await client.echo(message="A" * 256)
     assert exc_info.value.limit == 10
     assert exc_info.value.actual > 10
+
+
+# ── Capabilities tests ───────────────────────────────────────────────────
+
+
+def _inject_capabilities(transport: MockTransport, payload: bytes) -> None:
+    caps = Container(
+        transaction_id=0,
+        sequence_number=0,
+        container_type=ContainerType.CONTROL,
+        control_cmd=ControlCmd.CAPABILITIES,
+        payload=payload,
+    )
+    transport._notify_queue.put_nowait(caps.serialize())
+
+
+@pytest.mark.asyncio
+async def test_capabilities_link_params():
+    """The 18-byte capabilities payload carries the link's radio parameters."""
+    transport = MockTransport()
+    client = make_client(transport)
+    payload = (
+        (244).to_bytes(2, "little")
+        + (4096).to_bytes(2, "little")
+        + (0).to_bytes(2, "little")
+        + bytes([2, 2])
+        + (251).to_bytes(2, "little")
+        + (251).to_bytes(2, "little")
+        + (24).to_bytes(2, "little")
+        + (0).to_bytes(2, "little")
+        + (100).to_bytes(2, "little")
+    )
+    _inject_capabilities(transport, payload)
+
+    await client._request_capabilities()
+
+    assert client.max_request_payload_size == 244
+    assert client.link_params == LinkParams(
+        tx_phy=2,
+        rx_phy=2,
+        tx_max_len=251,
+        rx_max_len=251,
+        interval=24,
+        latency=0,
+        timeout=100,
+    )
+    assert client.link_params.interval_ms == 30.0
+
+
+@pytest.mark.asyncio
+async def test_capabilities_without_link_params():
+    """Peripherals sending the 6-byte form leave link_params unset."""
+    transport = MockTransport()
+    client = make_client(transport)
+    _inject_capabilities(transport, bytes([0xF4, 0x00, 0x00, 0x10, 0x00, 0x00]))
+
+    await client._request_capabilities()
+
+    assert client.max_response_payload_size == 4096
+    assert client.link_params is None
+
+
+
+@pytest.mark.asyncio
+async def test_capabilities_compression():
+    """The request offers compression; the reply's offset 22 sets the limit."""
+    transport = MockTransport()
+    client = make_client(transport)
+    payload = (
+        (65535).to_bytes(2, "little")
+        + (65535).to_bytes(2, "little")
+        + (0x0080).to_bytes(2, "little")
+        + bytes(16)
+        + (2048).to_bytes(2, "little")
+    )
+    _inject_capabilities(transport, payload)
+
+    await client._request_capabilities()
+
+    req = Container.deserialize(transport._written[0])
+    assert req.payload == (0x0080).to_bytes(2, "little") + b"\xff\xff"
+    assert client._inflate_limit == 2048
+    assert client.link_params is None  # zero PHY: padding, not a link
+
+
+# ── Compression tests ────────────────────────────────────────────────────
+
+
+@pytest.mark.asyncio
+async def test_compressed_request_and_response():
+    transport = MockTransport()
+    client = make_client(transport)
+    client._inflate_limit = 4096
+    msg = "sensor reading ok; " * 40
+
+    resp_data = blerpc_pb2.EchoResponse(message=msg).SerializeToString()
+    resp = bytearray(
+        CommandPacket(
+            cmd_type=CommandType.RESPONSE, cmd_name="echo", data=compress(resp_data)
+        ).serialize()
+    )
+    resp[0] |= 0x10
+    for c in ContainerSplitter(mtu=transport.mtu).split(bytes(resp), transaction_id=0):
+        transport._notify_queue.put_nowait(c.serialize())
+
+    result = await client.echo(message=msg)
+    assert result.message == msg
+
+    assembler = ContainerAssembler()
+    for data in transport._written:
+        payload = assembler.feed(Container.deserialize(data))
+    assert payload[0] & 0x10
+    cmd = CommandPacket.deserialize(payload)
+    assert len(cmd.data) < len(msg) // 4
+    req = blerpc_pb2.EchoRequest()
+    req.ParseFromString(decompress(cmd.data))
+    assert req.message == msg
+
+
+@pytest.mark.asyncio
+async def test_request_not_compressed_without_limit_or_gain():
+    transport = MockTransport()
+    client = make_client(transport)
+    # Peripheral without compression
+    transport.inject_response("data_write", b"", transaction_id=0)
+    await client.data_write(data=bytes(1000))
+    # Incompressible data
+    client._inflate_limit = 4096
+    transport.inject_response("data_write", b"", transaction_id=1)
+    await client.data_write(data=os.urandom(500))
+
+    assembler = ContainerAssembler()
+    payloads = []
+    for data in transport._written:
+        payload = assembler.feed(Container.deserialize(data))
+        if payload is not None:
+            payloads.append(payload)
+    assert len(payloads) == 2
+    assert not any(p[0] & 0x10 for p in payloads)
+
+# ── Stats tests ───────────────────────────────────────────────────────────
+
+
+def inject_stats_page(transport: MockTransport, page: int, data: bytes):
+    """Enqueue a STATS control reply."""
+    ctrl = Container(
+        transaction_id=0,
+        sequence_number=0,
+        container_type=ContainerType.CONTROL,
+        control_cmd=8,
+        payload=bytes([page]) + data,
+    )
+    transport._notify_queue.put_nowait(ctrl.serialize())
+
+
+@pytest.mark.asyncio
+async def test_stats_pages():
+    """Link counters and a command page parse from STATS replies."""
+    transport = MockTransport()
+    client = make_client(transport)
+    client._capability_flags = 0x0040
+
+    counters = b"".join(v.to_bytes(4, "little") for v in (3, 3, 1, 2))
+    inject_stats_page(transport, 0, counters)
+    stats = await client.link_stats()
+    assert stats == {
+        "requests": 3,
+        "responses": 3,
+        "busy_errors": 1,
+        "notify_retries": 2,
+    }
+    assert transport._written[0].endswith(bytes([0]))
+
+    buckets = [0] * 12
+    buckets[1] = 2
+    phase = (2).to_bytes(4, "little") + (300).to_bytes(4, "little")
+    phase += (200).to_bytes(4, "little")
+    phase += b"".join(b.to_bytes(2, "little") for b in buckets)
+    page = (2).to_bytes(4, "little") + (0).to_bytes(4, "little") + phase * 2
+    inject_stats_page(transport, 1, page)
+    echo = await client.command_stats(1)
+    assert echo.calls == 2 and echo.errors == 0
+    assert list(echo.phases) == ["assemble", "decrypt"]
+    assert echo.phases["decrypt"].avg_us == 150
+    assert echo.phases["decrypt"].buckets[1] == 2
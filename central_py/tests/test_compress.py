@@ -0,0 +1,83 @@
+"""Tests for the LZSS codec of compressed command data."""
+
+import os
+
+import pytest
+from blerpc.compress import (
+    HEADER_SIZE,
+    DecompressError,
+    compress,
+    decompress,
+)
+
+SAMPLES = [
+    b"",
+    b"a",
+    b"abc",
+    b"a" * 1000,
+    bytes(range(256)) * 4,
+    b"temperature=21.5 humidity=40 " * 50,
+    os.urandom(2000),
+]
+
+
+@pytest.mark.parametrize("data", SAMPLES)
+def test_roundtrip(data):
+    assert decompress(compress(data)) == data
+
+
+def test_header_is_raw_length():
+    assert compress(b"hello")[:HEADER_SIZE] == (5).to_bytes(2, "little")
+
+
+def test_repetitive_data_shrinks():
+    data = b"temperature=21.5 humidity=40 " * 50
+    assert len(compress(data)) < len(data) // 5
+
+
+def test_incompressible_data_bounded():
+    """At worst one control byte per 8 literals, plus the header."""
+    data = os.urandom(800)
+    assert len(compress(data)) <= HEADER_SIZE + 800 + 100
+
+
+def test_overlapping_match():
+    """A run is coded as a literal and one match copying its own output."""
+    assert compress(b"aaaaaa") == bytes([6, 0, 0x02, ord("a"), 0x00, 0x20])
+    assert decompress(bytes([6, 0, 0x02, ord("a"), 0x00, 0x20])) == b"aaaaaa"
+
+
+def test_window_limits_distance():
+    block = os.urandom(600)
+    data = block + block
+    assert len(compress(data)) < len(data) * 2 // 3
+    # The repeat is further back than a 512-byte window reaches
+    assert len(compress(data, window=512)) > len(data)
+
+
+def test_too_large_input():
+    with pytest.raises(ValueError):
+        compress(bytes(0x10000))
+
+
+@pytest.mark.parametrize(
+    "data",
+    [
+        b"",
+        b"\x05",
+        bytes([3, 0, 0x01, 0x00]),  # truncated match
+        bytes([3, 0, 0x01, 0x00, 0x00]),  # match before start of data
+        bytes([2, 0, 0x00, 1, 2, 3]),  # longer than raw length
+        bytes([4, 0, 0x00, 1, 2, 3]),  # shorter than raw length
+    ],
+)
+def test_malformed(data):
+    with pytest.raises(DecompressError):
+        decompress(data)
+
+
+def test_max_size():
+    data = compress(bytes(1000))
+    assert decompress(data, max_size=1000) == bytes(1000)
+    with pytest.raises(DecompressError):
+        decompress(data, max_size=999)
@@ -0,0 +1,138 @@
+"""Tests for the in-process loopback link."""
+
+import asyncio
+import struct
+import time
+
+import pytest
+from blerpc.client import BlerpcClient
+from blerpc.generated import blerpc_pb2
+from blerpc.loopback import LoopbackLink
+from blerpc_protocol.command import CommandPacket, CommandType
+from blerpc_protocol.container import (
+    Container,
+    ContainerAssembler,
+    ContainerSplitter,
+    ContainerType,
+    ControlCmd,
+)
+
+
+async def connect(link: LoopbackLink) -> None:
+    devices = await link.transport.scan()
+    await link.transport.connect(devices[0])
+
+
+@pytest.mark.asyncio
+async def test_packets_delivered_in_order_after_latency():
+    link = LoopbackLink(latency_s=0.02)
+    link.attach(lambda data: link.notify(data[::-1]))
+    await connect(link)
+
+    loop = asyncio.get_running_loop()
+    start = loop.time()
+    for i in range(5):
+        await link.transport.write(bytes([i, 0xFF]))
+    received = [await link.transport.read_notify(timeout=1.0) for _ in range(5)]
+
+    assert received == [bytes([0xFF, i]) for i in range(5)]
+    assert loop.time() - start >= 0.04  # one latency each way
+    assert link.stats.writes == 5
+    assert link.stats.notifications == 5
+    assert link.stats.bytes_c2p == link.stats.bytes_p2c == 10
+    await link.transport.disconnect()
+
+
+@pytest.mark.asyncio
+async def test_notify_reports_full_tx_buffer():
+    link = LoopbackLink(latency_s=0.05, tx_depth=2)
+    await connect(link)
+
+    assert link.notify(b"a")
+    assert link.notify(b"b")
+    assert not link.notify(b"c")
+    assert link.stats.notify_full == 1
+
+    assert await link.transport.read_notify(timeout=1.0) == b"a"
+    assert link.notify(b"c")
+    await link.transport.disconnect()
+
+
+@pytest.mark.asyncio
+async def test_loss_drops_packets():
+    link = LoopbackLink(loss=1.0, seed=1)
+    link.attach(link.notify)
+    await connect(link)
+
+    await link.transport.write(b"lost")
+    with pytest.raises(asyncio.TimeoutError):
+        await link.transport.read_notify(timeout=0.05)
+    assert link.stats.lost == 1
+    await link.transport.disconnect()
+
+
+@pytest.mark.asyncio
+async def test_on_ready_after_each_delivered_notification():
+    link = LoopbackLink(tx_depth=1)
+    ready = asyncio.Event()
+    link.attach(lambda data: None, on_ready=ready.set)
+    await connect(link)
+
+    assert link.notify(b"a")
+    assert not link.notify(b"b")
+    await asyncio.wait_for(ready.wait(), timeout=1.0)
+    assert link.notify(b"b")
+    assert await link.transport.read_notify(timeout=1.0) == b"a"
+    await link.transport.disconnect()
+
+
+def test_notify_before_connect():
+    link = LoopbackLink()
+    assert not link.notify(b"x")
+
+
+@pytest.mark.asyncio
+async def test_client_echo_over_loopback():
+    link = LoopbackLink(mtu=64, latency_s=0.001)
+    assembler = ContainerAssembler()
+    splitter = ContainerSplitter(mtu=link.mtu)
+
+    def on_write(data: bytes) -> None:
+        container = Container.deserialize(data)
+        if container.container_type == ContainerType.CONTROL:
+            replies = {
+                ControlCmd.TIMEOUT: struct.pack("<H", 1000),
+                ControlCmd.CAPABILITIES: struct.pack("<HHH", 65535, 65535, 0),
+            }
+            link.notify(
+                Container(
+                    transaction_id=container.transaction_id,
+                    sequence_number=0,
+                    container_type=ContainerType.CONTROL,
+                    control_cmd=container.control_cmd,
+                    payload=replies[container.control_cmd],
+                ).serialize()
+            )
+            return
+        payload = assembler.feed(container)
+        if payload is None:
+            return
+        req = CommandPacket.deserialize(payload)
+        resp = CommandPacket(
+            cmd_type=CommandType.RESPONSE, cmd_name=req.cmd_name, data=req.data
+        )
+        for c in splitter.split(
+            resp.serialize(), transaction_id=container.transaction_id
+        ):
+            while not link.notify(c.serialize()):
+                time.sleep(0.001)
+
+    link.attach(on_write)
+    client = BlerpcClient(require_encryption=False, transport=link.transport)
+    await client.connect((await client.scan())[0])
+
+    message = "loopback " * 20  # spans several containers at this MTU
+    result = await client.echo(message=message)
+    assert result == blerpc_pb2.EchoResponse(message=message)
+    assert link.stats.writes > 1
+    await client.disconnect()
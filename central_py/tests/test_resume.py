@@ -0,0 +1,262 @@
+"""Tests for session resumption tickets and the client's resume path."""
+
+import asyncio
+import os
+import sys
+
+import pytest
+from blerpc import resume
+from blerpc.client import BlerpcClient
+from blerpc.loopback import LoopbackLink
+from blerpc_protocol.container import (
+    CAPABILITY_FLAG_ENCRYPTION_SUPPORTED,
+    Container,
+    ContainerSplitter,
+    ContainerType,
+    ControlCmd,
+)
+
+PERIPHERAL_PY = os.path.join(os.path.dirname(__file__), "..", "..", "peripheral_py")
+sys.path.insert(0, PERIPHERAL_PY)
+from server import BlerpcPeripheral  # noqa: E402
+
+ADDRESS = "AA:BB:CC:DD:EE:FF"
+
+
+class FakeClock:
+    def __init__(self, t: float = 1000.0):
+        self.t = t
+
+    def __call__(self) -> float:
+        return self.t
+
+
+# ── Key derivation ───────────────────────────────────────────────────────
+
+
+def test_hkdf_rfc5869_case1():
+    okm = resume.hkdf_sha256(
+        bytes([0x0B] * 22), bytes(range(0x0D)), bytes(range(0xF0, 0xFA)), 42
+    )
+    assert okm == bytes.fromhex(
+        "3cb25f25faacd57a90434f64d0362f2a2d2d0a90cf1a5a4c5db02d56ecc4c5bf"
+        "34007208d5b887185865"
+    )
+
+
+def test_derive_splits_and_depends_on_both_nonces():
+    secret = os.urandom(resume.SECRET_SIZE)
+    nonce_c = os.urandom(resume.NONCE_SIZE)
+    nonce_p = os.urandom(resume.NONCE_SIZE)
+    keys = resume.derive(secret, nonce_c, nonce_p)
+    assert len(keys.session_key) == resume.KEY_SIZE
+    assert len(keys.next_secret) == resume.SECRET_SIZE
+    assert len(keys.confirm) == resume.CONFIRM_SIZE
+    assert keys == resume.derive(secret, nonce_c, nonce_p)
+    assert keys != resume.derive(secret, nonce_c, os.urandom(resume.NONCE_SIZE))
+    assert keys != resume.derive(secret, os.urandom(resume.NONCE_SIZE), nonce_p)
+
+
+# ── Tickets ──────────────────────────────────────────────────────────────
+
+
+def test_ticket_roundtrip():
+    sealer = resume.TicketSealer()
+    secret = os.urandom(resume.SECRET_SIZE)
+    ticket = sealer.seal(secret, sealer.now(), 5)
+    assert len(ticket) == resume.TICKET_SIZE
+    opened = sealer.open(ticket)
+    assert opened == resume.Ticket(secret=secret, issued=sealer.now(), uses_left=5)
+
+
+def test_ticket_tampered_or_foreign_rejected():
+    sealer = resume.TicketSealer()
+    ticket = bytearray(sealer.seal(os.urandom(resume.SECRET_SIZE), sealer.now(), 5))
+    ticket[20] ^= 1
+    assert sealer.open(bytes(ticket)) is None
+    other = resume.TicketSealer()
+    assert other.open(other.seal(bytes(32), other.now(), 5)) is not None
+    assert sealer.open(other.seal(bytes(32), other.now(), 5)) is None
+    assert sealer.open(b"\x00" * 10) is None
+
+
+def test_ticket_spent_rejected():
+    sealer = resume.TicketSealer()
+    assert sealer.open(sealer.seal(bytes(32), sealer.now(), 0)) is None
+
+
+def test_ticket_expires_one_lifetime_after_handshake():
+    clock = FakeClock()
+    sealer = resume.TicketSealer(lifetime_s=100, clock=clock)
+    issued = sealer.now()
+    ticket = sealer.seal(bytes(32), issued, 5)
+    clock.t += 60
+    # Reissued after a resumption, still dated from the full handshake
+    reissued = sealer.seal(bytes(32), issued, 4)
+    assert sealer.open(ticket) is not None
+    clock.t += 40
+    assert sealer.open(ticket) is None
+    assert sealer.open(reissued) is None
+
+
+def test_key_rotation_still_opens_previous_key():
+    clock = FakeClock()
+    sealer = resume.TicketSealer(lifetime_s=100, clock=clock)
+    clock.t += 90
+    old = sealer.seal(bytes(32), sealer.now(), 5)
+    clock.t += 10
+    # Sealing a lifetime after the last rotation rotates the key
+    fresh = sealer.seal(bytes(32), sealer.now(), 5)
+    assert fresh[0] != old[0]
+    assert sealer.open(old) is not None
+    assert sealer.open(fresh) is not None
+
+
+# ── Client ───────────────────────────────────────────────────────────────
+
+
+class ResumeTransport:
+    """Answers RESUME from a TicketSealer, and refuses key exchanges."""
+
+    def __init__(self, sealer: resume.TicketSealer):
+        self.address = ADDRESS
+        self.sealer = sealer
+        self.confirm_ok = True
+        self.written: list[Container] = []
+        self._notify_queue: asyncio.Queue[bytes] = asyncio.Queue()
+
+    @property
+    def mtu(self) -> int:
+        return 247
+
+    async def write(self, data: bytes):
+        req = Container.deserialize(data)
+        self.written.append(req)
+        if req.control_cmd == ControlCmd.KEY_EXCHANGE:
+            reply, cmd = b"", ControlCmd.TIMEOUT  # not a KEY_EXCHANGE step
+        else:
+            reply, cmd = self._resume(req.payload), resume.CONTROL_CMD_RESUME
+        resp = Container(
+            transaction_id=req.transaction_id,
+            sequence_number=0,
+            container_type=ContainerType.CONTROL,
+            control_cmd=cmd,
+            payload=reply,
+        )
+        self._notify_queue.put_nowait(resp.serialize())
+
+    def _resume(self, payload: bytes) -> bytes:
+        assert payload[0] == resume.OP_HELLO
+        assert len(payload) == resume.HELLO_SIZE
+        ticket = self.sealer.open(payload[1 : 1 + resume.TICKET_SIZE])
+        if ticket is None:
+            return bytes([resume.OP_REJECT])
+        nonce_p = os.urandom(resume.NONCE_SIZE)
+        keys = resume.derive(ticket.secret, payload[1 + resume.TICKET_SIZE :], nonce_p)
+        self.keys = keys
+        confirm = keys.confirm if self.confirm_ok else bytes(resume.CONFIRM_SIZE)
+        reply = bytes([resume.OP_ACCEPT]) + nonce_p + confirm
+        if ticket.uses_left > 1:
+            reply += self.sealer.seal(
+                keys.next_secret, ticket.issued, ticket.uses_left - 1
+            )
+        return reply
+
+    async def read_notify(self, timeout: float = 5.0) -> bytes:
+        return await asyncio.wait_for(self._notify_queue.get(), timeout=timeout)
+
+
+def make_client(transport: ResumeTransport, uses_left: int) -> BlerpcClient:
+    client = BlerpcClient(require_encryption=False)
+    client._transport = transport
+    client._splitter = ContainerSplitter(mtu=transport.mtu)
+    client._capability_flags = (
+        CAPABILITY_FLAG_ENCRYPTION_SUPPORTED | resume.CAPABILITY_FLAG_RESUMPTION
+    )
+    secret = os.urandom(resume.SECRET_SIZE)
+    sealer = transport.sealer
+    client._tickets[ADDRESS] = (secret, sealer.seal(secret, sealer.now(), uses_left))
+    return client
+
+
+@pytest.mark.asyncio
+async def test_client_resumes_and_keeps_next_ticket():
+    transport = ResumeTransport(resume.TicketSealer())
+    client = make_client(transport, uses_left=3)
+
+    await client._perform_key_exchange()
+
+    assert client.is_encrypted
+    assert len(transport.written) == 1  # HELLO only, no key exchange
+    secret, ticket = client._tickets[ADDRESS]
+    assert secret == transport.keys.next_secret
+    assert transport.sealer.open(ticket).uses_left == 2
+
+
+@pytest.mark.asyncio
+async def test_client_last_resumption_leaves_no_ticket():
+    transport = ResumeTransport(resume.TicketSealer())
+    client = make_client(transport, uses_left=1)
+
+    await client._perform_key_exchange()
+
+    assert client.is_encrypted
+    assert ADDRESS not in client._tickets
+
+
+@pytest.mark.asyncio
+async def test_client_falls_back_to_key_exchange_on_reject():
+    transport = ResumeTransport(resume.TicketSealer())
+    client = make_client(transport, uses_left=3)
+    transport.sealer = resume.TicketSealer()  # peripheral rebooted
+
+    await client._perform_key_exchange()
+
+    assert [c.control_cmd for c in transport.written] == [
+        resume.CONTROL_CMD_RESUME,
+        ControlCmd.KEY_EXCHANGE,
+    ]
+    assert ADDRESS not in client._tickets
+    assert not client.is_encrypted
+
+
+@pytest.mark.asyncio
+async def test_client_rejects_bad_confirm():
+    transport = ResumeTransport(resume.TicketSealer())
+    transport.confirm_ok = False
+    client = make_client(transport, uses_left=3)
+
+    await client._perform_key_exchange()
+
+    assert transport.written[-1].control_cmd == ControlCmd.KEY_EXCHANGE
+    assert ADDRESS not in client._tickets
+
+
+# ── Peripheral ───────────────────────────────────────────────────────────
+
+
+@pytest.mark.asyncio
+async def test_peripheral_takes_key_exchange_after_refused_resumption():
+    link = LoopbackLink()
+    peripheral = BlerpcPeripheral(ed25519_private_key_hex=os.urandom(32).hex())
+    peripheral.attach(link)
+    try:
+        first = BlerpcClient(transport=link.transport)
+        await first.connect((await first.scan())[0])
+        address = link.transport.address
+        _, ticket = first._tickets[address]
+        await first.disconnect()
+
+        # The ticket opens, so the peripheral starts the resumed session, but
+        # the confirm does not match and the central falls back to a full KX
+        second = BlerpcClient(transport=link.transport)
+        second._tickets[address] = (bytes(resume.SECRET_SIZE), ticket)
+        await second.connect((await second.scan())[0])
+
+        assert second.is_encrypted
+        assert second._tickets[address][1] != ticket  # from the new handshake
+        resp = await second.echo(message="after fallback")
+        assert resp.message == "after fallback"
+        await second.disconnect()
+    finally:
+        await peripheral.stop()
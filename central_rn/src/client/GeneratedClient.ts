@@ -53,4 +53,15 @@ export abstract class GeneratedClient {
     const respData = await this.streamSend('counter_upload', raw, 'counter_upload');
     return blerpc.CounterUploadResponse.decode(respData);
   }
+
+  async flashDump({ address = 0, length = 0 }: { address?: number; length?: number } = {}): Promise<
+    blerpc.FlashDumpResponse[]
+  > {
+    const req = blerpc.FlashDumpRequest.create({ address, length });
+    const responses = await this.streamReceive(
+      'flash_dump',
+      blerpc.FlashDumpRequest.encode(req).finish(),
+    );
+    return responses.map((data) => blerpc.FlashDumpResponse.decode(data));
+  }
 }
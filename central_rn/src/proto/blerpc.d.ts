@@ -1100,4 +1100,236 @@ export namespace blerpc {
      */
     public static getTypeUrl(typeUrlPrefix?: string): string;
   }
+
+  /** Properties of a FlashDumpRequest. */
+  interface IFlashDumpRequest {
+    /** FlashDumpRequest address */
+    address?: number | null;
+
+    /** FlashDumpRequest length */
+    length?: number | null;
+  }
+
+  /** Represents a FlashDumpRequest. */
+  class FlashDumpRequest implements IFlashDumpRequest {
+    /**
+     * Constructs a new FlashDumpRequest.
+     * @param [properties] Properties to set
+     */
+    constructor(properties?: blerpc.IFlashDumpRequest);
+
+    /** FlashDumpRequest address. */
+    public address: number;
+
+    /** FlashDumpRequest length. */
+    public length: number;
+
+    /**
+     * Creates a new FlashDumpRequest instance using the specified properties.
+     * @param [properties] Properties to set
+     * @returns FlashDumpRequest instance
+     */
+    public static create(properties?: blerpc.IFlashDumpRequest): blerpc.FlashDumpRequest;
+
+    /**
+     * Encodes the specified FlashDumpRequest message. Does not implicitly {@link blerpc.FlashDumpRequest.verify|verify} messages.
+     * @param message FlashDumpRequest message or plain object to encode
+     * @param [writer] Writer to encode to
+     * @returns Writer
+     */
+    public static encode(
+      message: blerpc.IFlashDumpRequest,
+      writer?: $protobuf.Writer,
+    ): $protobuf.Writer;
+
+    /**
+     * Encodes the specified FlashDumpRequest message, length delimited. Does not implicitly {@link blerpc.FlashDumpRequest.verify|verify} messages.
+     * @param message FlashDumpRequest message or plain object to encode
+     * @param [writer] Writer to encode to
+     * @returns Writer
+     */
+    public static encodeDelimited(
+      message: blerpc.IFlashDumpRequest,
+      writer?: $protobuf.Writer,
+    ): $protobuf.Writer;
+
+    /**
+     * Decodes a FlashDumpRequest message from the specified reader or buffer.
+     * @param reader Reader or buffer to decode from
+     * @param [length] Message length if known beforehand
+     * @returns FlashDumpRequest
+     * @throws {Error} If the payload is not a reader or valid buffer
+     * @throws {$protobuf.util.ProtocolError} If required fields are missing
+     */
+    public static decode(
+      reader: $protobuf.Reader | Uint8Array,
+      length?: number,
+    ): blerpc.FlashDumpRequest;
+
+    /**
+     * Decodes a FlashDumpRequest message from the specified reader or buffer, length delimited.
+     * @param reader Reader or buffer to decode from
+     * @returns FlashDumpRequest
+     * @throws {Error} If the payload is not a reader or valid buffer
+     * @throws {$protobuf.util.ProtocolError} If required fields are missing
+     */
+    public static decodeDelimited(reader: $protobuf.Reader | Uint8Array): blerpc.FlashDumpRequest;
+
+    /**
+     * Verifies a FlashDumpRequest message.
+     * @param message Plain object to verify
+     * @returns `null` if valid, otherwise the reason why it is not
+     */
+    public static verify(message: { [k: string]: any }): string | null;
+
+    /**
+     * Creates a FlashDumpRequest message from a plain object. Also converts values to their respective internal types.
+     * @param object Plain object
+     * @returns FlashDumpRequest
+     */
+    public static fromObject(object: { [k: string]: any }): blerpc.FlashDumpRequest;
+
+    /**
+     * Creates a plain object from a FlashDumpRequest message. Also converts values to other types if specified.
+     * @param message FlashDumpRequest
+     * @param [options] Conversion options
+     * @returns Plain object
+     */
+    public static toObject(
+      message: blerpc.FlashDumpRequest,
+      options?: $protobuf.IConversionOptions,
+    ): { [k: string]: any };
+
+    /**
+     * Converts this FlashDumpRequest to JSON.
+     * @returns JSON object
+     */
+    public toJSON(): { [k: string]: any };
+
+    /**
+     * Gets the default type url for FlashDumpRequest
+     * @param [typeUrlPrefix] your custom typeUrlPrefix(default "type.googleapis.com")
+     * @returns The default type url
+     */
+    public static getTypeUrl(typeUrlPrefix?: string): string;
+  }
+
+  /** Properties of a FlashDumpResponse. */
+  interface IFlashDumpResponse {
+    /** FlashDumpResponse offset */
+    offset?: number | null;
+
+    /** FlashDumpResponse data */
+    data?: Uint8Array | null;
+
+    /** FlashDumpResponse crc32 */
+    crc32?: number | null;
+  }
+
+  /** Represents a FlashDumpResponse. */
+  class FlashDumpResponse implements IFlashDumpResponse {
+    /**
+     * Constructs a new FlashDumpResponse.
+     * @param [properties] Properties to set
+     */
+    constructor(properties?: blerpc.IFlashDumpResponse);
+
+    /** FlashDumpResponse offset. */
+    public offset: number;
+
+    /** FlashDumpResponse data. */
+    public data: Uint8Array;
+
+    /** FlashDumpResponse crc32. */
+    public crc32: number;
+
+    /**
+     * Creates a new FlashDumpResponse instance using the specified properties.
+     * @param [properties] Properties to set
+     * @returns FlashDumpResponse instance
+     */
+    public static create(properties?: blerpc.IFlashDumpResponse): blerpc.FlashDumpResponse;
+
+    /**
+     * Encodes the specified FlashDumpResponse message. Does not implicitly {@link blerpc.FlashDumpResponse.verify|verify} messages.
+     * @param message FlashDumpResponse message or plain object to encode
+     * @param [writer] Writer to encode to
+     * @returns Writer
+     */
+    public static encode(
+      message: blerpc.IFlashDumpResponse,
+      writer?: $protobuf.Writer,
+    ): $protobuf.Writer;
+
+    /**
+     * Encodes the specified FlashDumpResponse message, length delimited. Does not implicitly {@link blerpc.FlashDumpResponse.verify|verify} messages.
+     * @param message FlashDumpResponse message or plain object to encode
+     * @param [writer] Writer to encode to
+     * @returns Writer
+     */
+    public static encodeDelimited(
+      message: blerpc.IFlashDumpResponse,
+      writer?: $protobuf.Writer,
+    ): $protobuf.Writer;
+
+    /**
+     * Decodes a FlashDumpResponse message from the specified reader or buffer.
+     * @param reader Reader or buffer to decode from
+     * @param [length] Message length if known beforehand
+     * @returns FlashDumpResponse
+     * @throws {Error} If the payload is not a reader or valid buffer
+     * @throws {$protobuf.util.ProtocolError} If required fields are missing
+     */
+    public static decode(
+      reader: $protobuf.Reader | Uint8Array,
+      length?: number,
+    ): blerpc.FlashDumpResponse;
+
+    /**
+     * Decodes a FlashDumpResponse message from the specified reader or buffer, length delimited.
+     * @param reader Reader or buffer to decode from
+     * @returns FlashDumpResponse
+     * @throws {Error} If the payload is not a reader or valid buffer
+     * @throws {$protobuf.util.ProtocolError} If required fields are missing
+     */
+    public static decodeDelimited(reader: $protobuf.Reader | Uint8Array): blerpc.FlashDumpResponse;
+
+    /**
+     * Verifies a FlashDumpResponse message.
+     * @param message Plain object to verify
+     * @returns `null` if valid, otherwise the reason why it is not
+     */
+    public static verify(message: { [k: string]: any }): string | null;
+
+    /**
+     * Creates a FlashDumpResponse message from a plain object. Also converts values to their respective internal types.
+     * @param object Plain object
+     * @returns FlashDumpResponse
+     */
+    public static fromObject(object: { [k: string]: any }): blerpc.FlashDumpResponse;
+
+    /**
+     * Creates a plain object from a FlashDumpResponse message. Also converts values to other types if specified.
+     * @param message FlashDumpResponse
+     * @param [options] Conversion options
+     * @returns Plain object
+     */
+    public static toObject(
+      message: blerpc.FlashDumpResponse,
+      options?: $protobuf.IConversionOptions,
+    ): { [k: string]: any };
+
+    /**
+     * Converts this FlashDumpResponse to JSON.
+     * @returns JSON object
+     */
+    public toJSON(): { [k: string]: any };
+
+    /**
+     * Gets the default type url for FlashDumpResponse
+     * @param [typeUrlPrefix] your custom typeUrlPrefix(default "type.googleapis.com")
+     * @returns The default type url
+     */
+    public static getTypeUrl(typeUrlPrefix?: string): string;
+  }
 }
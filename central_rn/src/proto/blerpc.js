@@ -2182,6 +2182,496 @@ $root.blerpc = (function() {
         return CounterUploadResponse;
     })();
 
+    blerpc.FlashDumpRequest = (function() {
+
+        /**
+         * Properties of a FlashDumpRequest.
+         * @memberof blerpc
+         * @interface IFlashDumpRequest
+         * @property {number|null} [address] FlashDumpRequest address
+         * @property {number|null} [length] FlashDumpRequest length
+         */
+
+        /**
+         * Constructs a new FlashDumpRequest.
+         * @memberof blerpc
+         * @classdesc Represents a FlashDumpRequest.
+         * @implements IFlashDumpRequest
+         * @constructor
+         * @param {blerpc.IFlashDumpRequest=} [properties] Properties to set
+         */
+        function FlashDumpRequest(properties) {
+            if (properties)
+                for (var keys = Object.keys(properties), i = 0; i < keys.length; ++i)
+                    if (properties[keys[i]] != null)
+                        this[keys[i]] = properties[keys[i]];
+        }
+
+        /**
+         * FlashDumpRequest address.
+         * @member {number} address
+         * @memberof blerpc.FlashDumpRequest
+         * @instance
+         */
+        FlashDumpRequest.prototype.address = 0;
+
+        /**
+         * FlashDumpRequest length.
+         * @member {number} length
+         * @memberof blerpc.FlashDumpRequest
+         * @instance
+         */
+        FlashDumpRequest.prototype.length = 0;
+
+        /**
+         * Creates a new FlashDumpRequest instance using the specified properties.
+         * @function create
+         * @memberof blerpc.FlashDumpRequest
+         * @static
+         * @param {blerpc.IFlashDumpRequest=} [properties] Properties to set
+         * @returns {blerpc.FlashDumpRequest} FlashDumpRequest instance
+         */
+        FlashDumpRequest.create = function create(properties) {
+            return new FlashDumpRequest(properties);
+        };
+
+        /**
+         * Encodes the specified FlashDumpRequest message. Does not implicitly {@link blerpc.FlashDumpRequest.verify|verify} messages.
+         * @function encode
+         * @memberof blerpc.FlashDumpRequest
+         * @static
+         * @param {blerpc.IFlashDumpRequest} message FlashDumpRequest message or plain object to encode
+         * @param {$protobuf.Writer} [writer] Writer to encode to
+         * @returns {$protobuf.Writer} Writer
+         */
+        FlashDumpRequest.encode = function encode(message, writer) {
+            if (!writer)
+                writer = $Writer.create();
+            if (message.address != null && Object.hasOwnProperty.call(message, "address"))
+                writer.uint32(/* id 1, wireType 0 =*/8).uint32(message.address);
+            if (message.length != null && Object.hasOwnProperty.call(message, "length"))
+                writer.uint32(/* id 2, wireType 0 =*/16).uint32(message.length);
+            return writer;
+        };
+
+        /**
+         * Encodes the specified FlashDumpRequest message, length delimited. Does not implicitly {@link blerpc.FlashDumpRequest.verify|verify} messages.
+         * @function encodeDelimited
+         * @memberof blerpc.FlashDumpRequest
+         * @static
+         * @param {blerpc.IFlashDumpRequest} message FlashDumpRequest message or plain object to encode
+         * @param {$protobuf.Writer} [writer] Writer to encode to
+         * @returns {$protobuf.Writer} Writer
+         */
+        FlashDumpRequest.encodeDelimited = function encodeDelimited(message, writer) {
+            return this.encode(message, writer).ldelim();
+        };
+
+        /**
+         * Decodes a FlashDumpRequest message from the specified reader or buffer.
+         * @function decode
+         * @memberof blerpc.FlashDumpRequest
+         * @static
+         * @param {$protobuf.Reader|Uint8Array} reader Reader or buffer to decode from
+         * @param {number} [length] Message length if known beforehand
+         * @returns {blerpc.FlashDumpRequest} FlashDumpRequest
+         * @throws {Error} If the payload is not a reader or valid buffer
+         * @throws {$protobuf.util.ProtocolError} If required fields are missing
+         */
+        FlashDumpRequest.decode = function decode(reader, length, error) {
+            if (!(reader instanceof $Reader))
+                reader = $Reader.create(reader);
+            var end = length === undefined ? reader.len : reader.pos + length, message = new $root.blerpc.FlashDumpRequest();
+            while (reader.pos < end) {
+                var tag = reader.uint32();
+                if (tag === error)
+                    break;
+                switch (tag >>> 3) {
+                case 1: {
+                        message.address = reader.uint32();
+                        break;
+                    }
+                case 2: {
+                        message.length = reader.uint32();
+                        break;
+                    }
+                default:
+                    reader.skipType(tag & 7);
+                    break;
+                }
+            }
+            return message;
+        };
+
+        /**
+         * Decodes a FlashDumpRequest message from the specified reader or buffer, length delimited.
+         * @function decodeDelimited
+         * @memberof blerpc.FlashDumpRequest
+         * @static
+         * @param {$protobuf.Reader|Uint8Array} reader Reader or buffer to decode from
+         * @returns {blerpc.FlashDumpRequest} FlashDumpRequest
+         * @throws {Error} If the payload is not a reader or valid buffer
+         * @throws {$protobuf.util.ProtocolError} If required fields are missing
+         */
+        FlashDumpRequest.decodeDelimited = function decodeDelimited(reader) {
+            if (!(reader instanceof $Reader))
+                reader = new $Reader(reader);
+            return this.decode(reader, reader.uint32());
+        };
+
+        /**
+         * Verifies a FlashDumpRequest message.
+         * @function verify
+         * @memberof blerpc.FlashDumpRequest
+         * @static
+         * @param {Object.<string,*>} message Plain object to verify
+         * @returns {string|null} `null` if valid, otherwise the reason why it is not
+         */
+        FlashDumpRequest.verify = function verify(message) {
+            if (typeof message !== "object" || message === null)
+                return "object expected";
+            if (message.address != null && message.hasOwnProperty("address"))
+                if (!$util.isInteger(message.address))
+                    return "address: integer expected";
+            if (message.length != null && message.hasOwnProperty("length"))
+                if (!$util.isInteger(message.length))
+                    return "length: integer expected";
+            return null;
+        };
+
+        /**
+         * Creates a FlashDumpRequest message from a plain object. Also converts values to their respective internal types.
+         * @function fromObject
+         * @memberof blerpc.FlashDumpRequest
+         * @static
+         * @param {Object.<string,*>} object Plain object
+         * @returns {blerpc.FlashDumpRequest} FlashDumpRequest
+         */
+        FlashDumpRequest.fromObject = function fromObject(object) {
+            if (object instanceof $root.blerpc.FlashDumpRequest)
+                return object;
+            var message = new $root.blerpc.FlashDumpRequest();
+            if (object.address != null)
+                message.address = object.address >>> 0;
+            if (object.length != null)
+                message.length = object.length >>> 0;
+            return message;
+        };
+
+        /**
+         * Creates a plain object from a FlashDumpRequest message. Also converts values to other types if specified.
+         * @function toObject
+         * @memberof blerpc.FlashDumpRequest
+         * @static
+         * @param {blerpc.FlashDumpRequest} message FlashDumpRequest
+         * @param {$protobuf.IConversionOptions} [options] Conversion options
+         * @returns {Object.<string,*>} Plain object
+         */
+        FlashDumpRequest.toObject = function toObject(message, options) {
+            if (!options)
+                options = {};
+            var object = {};
+            if (options.defaults) {
+                object.address = 0;
+                object.length = 0;
+            }
+            if (message.address != null && message.hasOwnProperty("address"))
+                object.address = message.address;
+            if (message.length != null && message.hasOwnProperty("length"))
+                object.length = message.length;
+            return object;
+        };
+
+        /**
+         * Converts this FlashDumpRequest to JSON.
+         * @function toJSON
+         * @memberof blerpc.FlashDumpRequest
+         * @instance
+         * @returns {Object.<string,*>} JSON object
+         */
+        FlashDumpRequest.prototype.toJSON = function toJSON() {
+            return this.constructor.toObject(this, $protobuf.util.toJSONOptions);
+        };
+
+        /**
+         * Gets the default type url for FlashDumpRequest
+         * @function getTypeUrl
+         * @memberof blerpc.FlashDumpRequest
+         * @static
+         * @param {string} [typeUrlPrefix] your custom typeUrlPrefix(default "type.googleapis.com")
+         * @returns {string} The default type url
+         */
+        FlashDumpRequest.getTypeUrl = function getTypeUrl(typeUrlPrefix) {
+            if (typeUrlPrefix === undefined) {
+                typeUrlPrefix = "type.googleapis.com";
+            }
+            return typeUrlPrefix + "/blerpc.FlashDumpRequest";
+        };
+
+        return FlashDumpRequest;
+    })();
+
+    blerpc.FlashDumpResponse = (function() {
+
+        /**
+         * Properties of a FlashDumpResponse.
+         * @memberof blerpc
+         * @interface IFlashDumpResponse
+         * @property {number|null} [offset] FlashDumpResponse offset
+         * @property {Uint8Array|null} [data] FlashDumpResponse data
+         * @property {number|null} [crc32] FlashDumpResponse crc32
+         */
+
+        /**
+         * Constructs a new FlashDumpResponse.
+         * @memberof blerpc
+         * @classdesc Represents a FlashDumpResponse.
+         * @implements IFlashDumpResponse
+         * @constructor
+         * @param {blerpc.IFlashDumpResponse=} [properties] Properties to set
+         */
+        function FlashDumpResponse(properties) {
+            if (properties)
+                for (var keys = Object.keys(properties), i = 0; i < keys.length; ++i)
+                    if (properties[keys[i]] != null)
+                        this[keys[i]] = properties[keys[i]];
+        }
+
+        /**
+         * FlashDumpResponse offset.
+         * @member {number} offset
+         * @memberof blerpc.FlashDumpResponse
+         * @instance
+         */
+        FlashDumpResponse.prototype.offset = 0;
+
+        /**
+         * FlashDumpResponse data.
+         * @member {Uint8Array} data
+         * @memberof blerpc.FlashDumpResponse
+         * @instance
+         */
+        FlashDumpResponse.prototype.data = $util.newBuffer([]);
+
+        /**
+         * FlashDumpResponse crc32.
+         * @member {number} crc32
+         * @memberof blerpc.FlashDumpResponse
+         * @instance
+         */
+        FlashDumpResponse.prototype.crc32 = 0;
+
+        /**
+         * Creates a new FlashDumpResponse instance using the specified properties.
+         * @function create
+         * @memberof blerpc.FlashDumpResponse
+         * @static
+         * @param {blerpc.IFlashDumpResponse=} [properties] Properties to set
+         * @returns {blerpc.FlashDumpResponse} FlashDumpResponse instance
+         */
+        FlashDumpResponse.create = function create(properties) {
+            return new FlashDumpResponse(properties);
+        };
+
+        /**
+         * Encodes the specified FlashDumpResponse message. Does not implicitly {@link blerpc.FlashDumpResponse.verify|verify} messages.
+         * @function encode
+         * @memberof blerpc.FlashDumpResponse
+         * @static
+         * @param {blerpc.IFlashDumpResponse} message FlashDumpResponse message or plain object to encode
+         * @param {$protobuf.Writer} [writer] Writer to encode to
+         * @returns {$protobuf.Writer} Writer
+         */
+        FlashDumpResponse.encode = function encode(message, writer) {
+            if (!writer)
+                writer = $Writer.create();
+            if (message.offset != null && Object.hasOwnProperty.call(message, "offset"))
+                writer.uint32(/* id 1, wireType 0 =*/8).uint32(message.offset);
+            if (message.data != null && Object.hasOwnProperty.call(message, "data"))
+                writer.uint32(/* id 2, wireType 2 =*/18).bytes(message.data);
+            if (message.crc32 != null && Object.hasOwnProperty.call(message, "crc32"))
+                writer.uint32(/* id 3, wireType 0 =*/24).uint32(message.crc32);
+            return writer;
+        };
+
+        /**
+         * Encodes the specified FlashDumpResponse message, length delimited. Does not implicitly {@link blerpc.FlashDumpResponse.verify|verify} messages.
+         * @function encodeDelimited
+         * @memberof blerpc.FlashDumpResponse
+         * @static
+         * @param {blerpc.IFlashDumpResponse} message FlashDumpResponse message or plain object to encode
+         * @param {$protobuf.Writer} [writer] Writer to encode to
+         * @returns {$protobuf.Writer} Writer
+         */
+        FlashDumpResponse.encodeDelimited = function encodeDelimited(message, writer) {
+            return this.encode(message, writer).ldelim();
+        };
+
+        /**
+         * Decodes a FlashDumpResponse message from the specified reader or buffer.
+         * @function decode
+         * @memberof blerpc.FlashDumpResponse
+         * @static
+         * @param {$protobuf.Reader|Uint8Array} reader Reader or buffer to decode from
+         * @param {number} [length] Message length if known beforehand
+         * @returns {blerpc.FlashDumpResponse} FlashDumpResponse
+         * @throws {Error} If the payload is not a reader or valid buffer
+         * @throws {$protobuf.util.ProtocolError} If required fields are missing
+         */
+        FlashDumpResponse.decode = function decode(reader, length, error) {
+            if (!(reader instanceof $Reader))
+                reader = $Reader.create(reader);
+            var end = length === undefined ? reader.len : reader.pos + length, message = new $root.blerpc.FlashDumpResponse();
+            while (reader.pos < end) {
+                var tag = reader.uint32();
+                if (tag === error)
+                    break;
+                switch (tag >>> 3) {
+                case 1: {
+                        message.offset = reader.uint32();
+                        break;
+                    }
+                case 2: {
+                        message.data = reader.bytes();
+                        break;
+                    }
+                case 3: {
+                        message.crc32 = reader.uint32();
+                        break;
+                    }
+                default:
+                    reader.skipType(tag & 7);
+                    break;
+                }
+            }
+            return message;
+        };
+
+        /**
+         * Decodes a FlashDumpResponse message from the specified reader or buffer, length delimited.
+         * @function decodeDelimited
+         * @memberof blerpc.FlashDumpResponse
+         * @static
+         * @param {$protobuf.Reader|Uint8Array} reader Reader or buffer to decode from
+         * @returns {blerpc.FlashDumpResponse} FlashDumpResponse
+         * @throws {Error} If the payload is not a reader or valid buffer
+         * @throws {$protobuf.util.ProtocolError} If required fields are missing
+         */
+        FlashDumpResponse.decodeDelimited = function decodeDelimited(reader) {
+            if (!(reader instanceof $Reader))
+                reader = new $Reader(reader);
+            return this.decode(reader, reader.uint32());
+        };
+
+        /**
+         * Verifies a FlashDumpResponse message.
+         * @function verify
+         * @memberof blerpc.FlashDumpResponse
+         * @static
+         * @param {Object.<string,*>} message Plain object to verify
+         * @returns {string|null} `null` if valid, otherwise the reason why it is not
+         */
+        FlashDumpResponse.verify = function verify(message) {
+            if (typeof message !== "object" || message === null)
+                return "object expected";
+            if (message.offset != null && message.hasOwnProperty("offset"))
+                if (!$util.isInteger(message.offset))
+                    return "offset: integer expected";
+            if (message.data != null && message.hasOwnProperty("data"))
+                if (!(message.data && typeof message.data.length === "number" || $util.isString(message.data)))
+                    return "data: buffer expected";
+            if (message.crc32 != null && message.hasOwnProperty("crc32"))
+                if (!$util.isInteger(message.crc32))
+                    return "crc32: integer expected";
+            return null;
+        };
+
+        /**
+         * Creates a FlashDumpResponse message from a plain object. Also converts values to their respective internal types.
+         * @function fromObject
+         * @memberof blerpc.FlashDumpResponse
+         * @static
+         * @param {Object.<string,*>} object Plain object
+         * @returns {blerpc.FlashDumpResponse} FlashDumpResponse
+         */
+        FlashDumpResponse.fromObject = function fromObject(object) {
+            if (object instanceof $root.blerpc.FlashDumpResponse)
+                return object;
+            var message = new $root.blerpc.FlashDumpResponse();
+            if (object.offset != null)
+                message.offset = object.offset >>> 0;
+            if (object.data != null)
+                if (typeof object.data === "string")
+                    $util.base64.decode(object.data, message.data = $util.newBuffer($util.base64.length(object.data)), 0);
+                else if (object.data.length >= 0)
+                    message.data = object.data;
+            if (object.crc32 != null)
+                message.crc32 = object.crc32 >>> 0;
+            return message;
+        };
+
+        /**
+         * Creates a plain object from a FlashDumpResponse message. Also converts values to other types if specified.
+         * @function toObject
+         * @memberof blerpc.FlashDumpResponse
+         * @static
+         * @param {blerpc.FlashDumpResponse} message FlashDumpResponse
+         * @param {$protobuf.IConversionOptions} [options] Conversion options
+         * @returns {Object.<string,*>} Plain object
+         */
+        FlashDumpResponse.toObject = function toObject(message, options) {
+            if (!options)
+                options = {};
+            var object = {};
+            if (options.defaults) {
+                object.offset = 0;
+                if (options.bytes === String)
+                    object.data = "";
+                else {
+                    object.data = [];
+                    if (options.bytes !== Array)
+                        object.data = $util.newBuffer(object.data);
+                }
+                object.crc32 = 0;
+            }
+            if (message.offset != null && message.hasOwnProperty("offset"))
+                object.offset = message.offset;
+            if (message.data != null && message.hasOwnProperty("data"))
+                object.data = options.bytes === String ? $util.base64.encode(message.data, 0, message.data.length) : options.bytes === Array ? Array.prototype.slice.call(message.data) : message.data;
+            if (message.crc32 != null && message.hasOwnProperty("crc32"))
+                object.crc32 = message.crc32;
+            return object;
+        };
+
+        /**
+         * Converts this FlashDumpResponse to JSON.
+         * @function toJSON
+         * @memberof blerpc.FlashDumpResponse
+         * @instance
+         * @returns {Object.<string,*>} JSON object
+         */
+        FlashDumpResponse.prototype.toJSON = function toJSON() {
+            return this.constructor.toObject(this, $protobuf.util.toJSONOptions);
+        };
+
+        /**
+         * Gets the default type url for FlashDumpResponse
+         * @function getTypeUrl
+         * @memberof blerpc.FlashDumpResponse
+         * @static
+         * @param {string} [typeUrlPrefix] your custom typeUrlPrefix(default "type.googleapis.com")
+         * @returns {string} The default type url
+         */
+        FlashDumpResponse.getTypeUrl = function getTypeUrl(typeUrlPrefix) {
+            if (typeUrlPrefix === undefined) {
+                typeUrlPrefix = "type.googleapis.com";
+            }
+            return typeUrlPrefix + "/blerpc.FlashDumpResponse";
+        };
+
+        return FlashDumpResponse;
+    })();
+
     return blerpc;
 })();
 
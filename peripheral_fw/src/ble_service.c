@@ -1,19 +1,36 @@
 #include "ble_service.h"
 #include <blerpc_protocol/container.h>
 #include <blerpc_protocol/command.h>
+#include "blerpc_stats.h"
 #include "handlers.h"
+#include "request_queue.h"
+#include "response_cache.h"
 
 #include <zephyr/kernel.h>
 #include <zephyr/bluetooth/bluetooth.h>
 #include <zephyr/bluetooth/gap.h>
+#include <zephyr/bluetooth/hci.h>
 #include <zephyr/sys/atomic.h>
 #include <zephyr/logging/log.h>
 #include <pb_encode.h>
 
+#ifdef CONFIG_BLERPC_L2CAP
+#include <zephyr/bluetooth/l2cap.h>
+#endif
+
 #ifdef CONFIG_BLERPC_ENCRYPTION
 #include <blerpc_protocol/crypto.h>
 #include <mbedtls/platform_util.h>
 #include <psa/crypto.h>
+#include "stream_crypto.h"
+#endif
+
+#ifdef CONFIG_BLERPC_COMPRESSION
+#include "blerpc_compress.h"
+#endif
+
+#ifdef CONFIG_BLERPC_RESUMPTION
+#include "session_resume.h"
 #endif
 
 LOG_MODULE_REGISTER(ble_service, LOG_LEVEL_INF);
@@ -24,15 +41,122 @@ LOG_MODULE_REGISTER(ble_service, LOG_LEVEL_INF);
 static struct bt_uuid_128 blerpc_svc_uuid = BT_UUID_INIT_128(BLERPC_SERVICE_UUID);
 static struct bt_uuid_128 blerpc_char_uuid = BT_UUID_INIT_128(BLERPC_CHAR_UUID);
 
-static struct bt_conn *current_conn;
-static struct container_assembler assembler;
 static ble_service_stream_end_cb_t stream_end_cb;
-static uint8_t transaction_counter;
+
+/* Reassembly pool: one assembler per in-progress transaction, so interleaved
+ * or stray containers only disturb their own transaction. Payload bytes are
+ * written straight into the transaction's request queue entry. */
+struct assembler_slot {
+    struct request_entry *entry;
+    int64_t last_activity;
+    uint16_t received;
+    uint8_t transaction_id;
+    uint8_t expected_seq;
+    bool active;
+};
+
+/* P→C stream in progress on a link. tx_buf holds the frame being filled:
+ * one response, or with coalescing a batch header followed by responses. */
+struct p2c_stream {
+    struct k_work_delayable work;
+    struct ble_service_p2c_stream desc;
+    atomic_t credits;   /* messages the central has granted and not received */
+    bool credit_flow;   /* the central paces this link's streams */
+    bool want_coalesce; /* set by the latest grant, latched at stream start */
+    bool coalesce;
+    bool active;
+    uint32_t index;         /* next message to produce */
+    uint16_t frame_len;     /* bytes of tx_buf in use */
+    uint16_t frame_count;   /* messages in tx_buf */
+    int64_t last_progress;  /* uptime of the last frame sent */
+    uint8_t tx_buf[CONFIG_BLERPC_STREAM_BUF_SIZE];
+};
+
+/* Per-connection state, indexed by bt_conn_index(). Requests from all links
+ * share the request queue and work queue; everything else is per link. */
+struct link_ctx {
+    struct bt_conn *conn; /* NULL while the slot is unused */
+    /* Disconnected, ref held until reset_work has torn the link down on
+     * blerpc_work_q; the slot stays taken until then */
+    struct bt_conn *closing;
+    struct k_work reset_work;
+    struct k_fifo request_fifo;
+    /* TX credits: one per notification handed to the stack and not yet sent */
+    struct k_sem notify_credits;
+    /* Given each time a notification is sent, for send_with_retry() */
+    struct k_sem notify_done;
+    struct assembler_slot assembler_pool[CONFIG_BLERPC_ASSEMBLER_POOL_SIZE];
+    uint8_t transaction_counter;
+    struct ble_service_link_params params;
+    struct p2c_stream stream;
+#ifdef CONFIG_BLERPC_LINK_TUNING
+    struct k_work tune_work;
+#endif
+#ifdef CONFIG_BLERPC_POWER_POLICY
+    /* On the system workqueue: parameter updates may block on HCI */
+    struct k_work_delayable power_work;
+    atomic_t queued;     /* requests waiting on request_fifo */
+    int64_t last_active; /* uptime the link last finished some work */
+    uint8_t profile;     /* enum power_profile last requested */
+    bool large_tx;       /* a response of bulk size is being sent */
+    /* Containers held for one connection event: len(1) || container each */
+    struct k_work_delayable batch_work;
+    uint16_t batch_used;
+    uint8_t batch_buf[CONFIG_BLERPC_POWER_BATCH_BUF_SIZE];
+#endif
+#ifdef CONFIG_BLERPC_L2CAP
+    struct bt_l2cap_le_chan bulk_chan;
+    struct k_sem bulk_sent; /* given once the SDU in flight has been sent */
+    bool bulk_connected;
+#endif
+#ifdef CONFIG_BLERPC_ENCRYPTION
+    struct blerpc_crypto_session crypto_session;
+    struct blerpc_peripheral_key_exchange peripheral_kx;
+    bool encryption_active;
+#endif
+#ifdef CONFIG_BLERPC_RESUMPTION
+    /* A full handshake just completed and no request has arrived since */
+    bool ticket_allowed;
+    /* Resumed, and no request has decrypted under the session yet: the
+     * central may not have accepted it and fall back to a key exchange */
+    bool session_tentative;
+#endif
+#ifdef CONFIG_BLERPC_COMPRESSION
+    uint16_t inflate_limit; /* largest response data the central expands, 0: none */
+#endif
+};
+
+static struct link_ctx links[CONFIG_BT_MAX_CONN];
+
+/* Link whose request the work queue is currently processing */
+static struct link_ctx *active_link;
+
+static struct link_ctx *link_get(struct bt_conn *conn)
+{
+    if (!conn) {
+        return NULL;
+    }
+    uint8_t index = bt_conn_index(conn);
+    if (index >= ARRAY_SIZE(links) || links[index].conn != conn) {
+        return NULL;
+    }
+    return &links[index];
+}
+
+#ifdef CONFIG_BLERPC_RESUMPTION
+/* Shared by all links; only touched from the BT RX thread */
+static struct session_resume_tickets resume_tickets;
+
+/* First payload byte of the central's opening key exchange message */
+#define KX_STEP1 0x01
+
+static uint32_t uptime_s(void)
+{
+    return (uint32_t)(k_uptime_get() / 1000);
+}
+#endif
 
 #ifdef CONFIG_BLERPC_ENCRYPTION
-static struct blerpc_crypto_session crypto_session;
-static struct blerpc_peripheral_key_exchange peripheral_kx;
-static bool encryption_active;
 
 static int hex_to_bytes(const char *hex, uint8_t *out, size_t out_len)
 {
@@ -70,13 +194,23 @@ static int load_keys(void)
         return -1;
     }
 
-    /* Initialize peripheral key exchange (X25519 keypair generated per session) */
-    if (blerpc_peripheral_kx_init(&peripheral_kx, ed25519_privkey) != 0) {
-        LOG_ERR("Failed to initialize peripheral key exchange");
-        return -1;
+    /* Initialize each link's key exchange (X25519 keypair generated per session) */
+    for (size_t i = 0; i < ARRAY_SIZE(links); i++) {
+        if (blerpc_peripheral_kx_init(&links[i].peripheral_kx, ed25519_privkey) != 0) {
+            LOG_ERR("Failed to initialize peripheral key exchange");
+            mbedtls_platform_zeroize(ed25519_privkey, sizeof(ed25519_privkey));
+            return -1;
+        }
     }
 
     mbedtls_platform_zeroize(ed25519_privkey, sizeof(ed25519_privkey));
+#ifdef CONFIG_BLERPC_RESUMPTION
+    if (session_resume_tickets_init(&resume_tickets, CONFIG_BLERPC_RESUMPTION_LIFETIME_S,
+                                    uptime_s()) != 0) {
+        LOG_ERR("Failed to generate the ticket key");
+        return -1;
+    }
+#endif
     LOG_INF("Encryption keys loaded");
     return 0;
 }
@@ -86,23 +220,19 @@ static int load_keys(void)
 static struct k_work_q blerpc_work_q;
 static K_THREAD_STACK_DEFINE(blerpc_work_stack, CONFIG_BLERPC_WORK_STACK_SIZE);
 
-struct request_work {
-    struct k_work work;
-    uint8_t transaction_id;
-    size_t len;
-    uint8_t data[CONFIG_BLERPC_PROTOCOL_ASSEMBLER_BUF_SIZE];
-};
+/* Complete requests wait in a byte ring sized by actual request length,
+ * queued on their link's fifo; the work handler serves links round-robin. */
+static uint8_t request_ring[CONFIG_BLERPC_REQUEST_QUEUE_SIZE] __aligned(sizeof(void *));
+static struct request_queue request_queue;
+static struct k_work request_work;
 
-#ifdef CONFIG_BLERPC_DOUBLE_BUFFER
-static struct request_work req_work_pool[2];
-static atomic_t req_work_index;
-#else
-static struct request_work req_work;
-#endif
+/* Restarts advertising from the system workqueue when a link slot is free */
+static struct k_work adv_work;
 
 /* ── Streaming container sender ──────────────────────────────────────── */
 
 struct streaming_ctx {
+    struct link_ctx *link;
     uint8_t transaction_id;
     uint16_t mtu;
     uint16_t total_length; /* total payload for FIRST container header */
@@ -111,22 +241,428 @@ struct streaming_ctx {
     uint8_t payload_used; /* payload bytes buffered in current container */
     bool first_sent;
     int error;
+#ifdef CONFIG_BLERPC_L2CAP
+    struct net_buf *bulk_buf; /* non-NULL: response goes out as one bulk SDU */
+#endif
+#ifdef CONFIG_BLERPC_ENCRYPTION
+    bool encrypt; /* payload bytes pass through crypto before packing */
+    struct stream_crypto_tx crypto;
+#endif
 };
 
-static int send_with_retry(const uint8_t *data, size_t len)
+static int notify_link(struct link_ctx *link, const uint8_t *data, size_t len,
+                       k_timeout_t timeout);
+
+/* Send one container, waiting for TX credits instead of dropping it. If the
+ * stack is still out of buffers (shared with other ATT traffic), retry when
+ * one of this link's notifications has been sent and freed one; with none in
+ * flight there is nothing to wait for. All waits share one notify timeout. */
+static int send_with_retry(struct link_ctx *link, const uint8_t *data, size_t len)
 {
+    k_timepoint_t deadline = sys_timepoint_calc(K_MSEC(CONFIG_BLERPC_NOTIFY_TIMEOUT_MS));
     int rc;
-    for (int retries = 0; retries < 10; retries++) {
-        rc = ble_service_notify(data, len);
-        if (rc != -ENOMEM) {
-            return rc;
+    while (true) {
+        k_sem_reset(&link->notify_done);
+        rc = notify_link(link, data, len, sys_timepoint_timeout(deadline));
+        if (rc != -ENOMEM ||
+            k_sem_count_get(&link->notify_credits) == CONFIG_BLERPC_NOTIFY_INFLIGHT_MAX) {
+            break;
+        }
+        BLERPC_STATS_INC(notify_retries);
+        if (k_sem_take(&link->notify_done, sys_timepoint_timeout(deadline)) != 0) {
+            rc = -EAGAIN;
+            break;
         }
-        k_sleep(K_MSEC(5));
     }
-    LOG_ERR("Notify failed after retries: %d", rc);
+    if (rc < 0) {
+        BLERPC_STATS_INC(notify_failures);
+        LOG_ERR("Notify failed: %d", rc);
+    }
+    return rc;
+}
+
+/* Send a control reply from the BT RX thread. The credits send_with_retry()
+ * waits for come back from TX-complete callbacks that this thread runs, so
+ * only take one that is free: a lost reply costs the central a retry. */
+static int send_from_rx(struct link_ctx *link, const uint8_t *data, size_t len)
+{
+    int rc = notify_link(link, data, len, K_NO_WAIT);
+    if (rc < 0) {
+        BLERPC_STATS_INC(notify_failures);
+        LOG_WRN("Control reply dropped: %d", rc);
+    }
     return rc;
 }
 
+/* ── Power policy ────────────────────────────────────────────────────── */
+
+#ifdef CONFIG_BLERPC_POWER_POLICY
+enum power_profile {
+    POWER_PROFILE_NONE, /* whatever the central connected with */
+    POWER_PROFILE_BULK,
+    POWER_PROFILE_IDLE,
+};
+
+/* Retry delay for a parameter update the stack refused, e.g. while the
+ * previous one is still in progress */
+#define POWER_RETRY_MS 1000
+
+BUILD_ASSERT(CONFIG_BLERPC_POWER_BULK_INTERVAL_MIN <= CONFIG_BLERPC_POWER_BULK_INTERVAL_MAX &&
+                 CONFIG_BLERPC_POWER_IDLE_INTERVAL_MIN <= CONFIG_BLERPC_POWER_IDLE_INTERVAL_MAX,
+             "power profile interval range is empty");
+/* Supervision timeout (10 ms units) must outlast two intervals of skipped
+ * events: timeout * 10 ms > (1 + latency) * interval_max * 2.5 ms */
+#define POWER_TIMEOUT_OK(timeout, latency, interval_max)                                         \
+    ((uint32_t)(timeout) * 4 > (uint32_t)(1 + (latency)) * (interval_max))
+
+BUILD_ASSERT(POWER_TIMEOUT_OK(CONFIG_BLERPC_POWER_BULK_TIMEOUT, CONFIG_BLERPC_POWER_BULK_LATENCY,
+                              CONFIG_BLERPC_POWER_BULK_INTERVAL_MAX) &&
+                 POWER_TIMEOUT_OK(CONFIG_BLERPC_POWER_IDLE_TIMEOUT,
+                                  CONFIG_BLERPC_POWER_IDLE_LATENCY,
+                                  CONFIG_BLERPC_POWER_IDLE_INTERVAL_MAX),
+             "power profile supervision timeout too short for its interval and latency");
+BUILD_ASSERT(CONFIG_BLERPC_POWER_ADV_INTERVAL_MIN <= CONFIG_BLERPC_POWER_ADV_INTERVAL_MAX,
+             "advertising interval range is empty");
+
+static struct ble_service_power_policy power_policy = {
+    .bulk =
+        {
+            .interval_min = CONFIG_BLERPC_POWER_BULK_INTERVAL_MIN,
+            .interval_max = CONFIG_BLERPC_POWER_BULK_INTERVAL_MAX,
+            .latency = CONFIG_BLERPC_POWER_BULK_LATENCY,
+            .timeout = CONFIG_BLERPC_POWER_BULK_TIMEOUT,
+        },
+    .idle =
+        {
+            .interval_min = CONFIG_BLERPC_POWER_IDLE_INTERVAL_MIN,
+            .interval_max = CONFIG_BLERPC_POWER_IDLE_INTERVAL_MAX,
+            .latency = CONFIG_BLERPC_POWER_IDLE_LATENCY,
+            .timeout = CONFIG_BLERPC_POWER_IDLE_TIMEOUT,
+        },
+    .bulk_queue_depth = CONFIG_BLERPC_POWER_BULK_QUEUE_DEPTH,
+    .bulk_response_size = CONFIG_BLERPC_POWER_BULK_RESPONSE_SIZE,
+    .idle_delay_ms = CONFIG_BLERPC_POWER_IDLE_DELAY_MS,
+    .batch_window_ms = CONFIG_BLERPC_POWER_BATCH_WINDOW_MS,
+    .adv_interval_min = CONFIG_BLERPC_POWER_ADV_INTERVAL_MIN,
+    .adv_interval_max = CONFIG_BLERPC_POWER_ADV_INTERVAL_MAX,
+    .adv_backoff_s = CONFIG_BLERPC_POWER_ADV_BACKOFF_S,
+};
+/* Read from the BT RX thread and both work queues, written by the app */
+static struct k_spinlock power_lock;
+
+static void power_policy_get(struct ble_service_power_policy *out)
+{
+    k_spinlock_key_t key = k_spin_lock(&power_lock);
+    *out = power_policy;
+    k_spin_unlock(&power_lock, key);
+}
+
+static bool power_link_busy(const struct link_ctx *link, const struct ble_service_power_policy *p)
+{
+    return atomic_get(&link->queued) >= p->bulk_queue_depth || link->stream.active ||
+           link->large_tx;
+}
+
+/* Work arrived on link: ask for the bulk profile at once if that makes it
+ * busy */
+static void power_demand(struct link_ctx *link)
+{
+    struct ble_service_power_policy p;
+
+    power_policy_get(&p);
+    if (link->profile != POWER_PROFILE_BULK && power_link_busy(link, &p)) {
+        k_work_reschedule(&link->power_work, K_NO_WAIT);
+    }
+}
+
+/* Link finished some work: drop to the idle profile once it has had none
+ * for idle_delay_ms. An earlier evaluation already pending is kept; it
+ * reschedules itself for the rest of the quiet time. */
+static void power_settle(struct link_ctx *link)
+{
+    struct ble_service_power_policy p;
+
+    power_policy_get(&p);
+    link->last_active = k_uptime_get();
+    if (link->profile != POWER_PROFILE_IDLE) {
+        k_work_schedule(&link->power_work, K_MSEC(p.idle_delay_ms));
+    }
+}
+
+static void power_request_queued(struct link_ctx *link)
+{
+    atomic_inc(&link->queued);
+    power_demand(link);
+}
+
+static void power_request_done(struct link_ctx *link)
+{
+    atomic_dec(&link->queued);
+    power_settle(link);
+}
+
+static void power_response_begin(struct link_ctx *link, size_t wire_len)
+{
+    struct ble_service_power_policy p;
+
+    power_policy_get(&p);
+    if (wire_len >= p.bulk_response_size) {
+        link->large_tx = true;
+        power_demand(link);
+    }
+}
+
+static void power_response_end(struct link_ctx *link)
+{
+    if (link->large_tx) {
+        link->large_tx = false;
+        power_settle(link);
+    }
+}
+
+static void power_work_handler(struct k_work *work)
+{
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct link_ctx *link = CONTAINER_OF(dwork, struct link_ctx, power_work);
+    struct bt_conn *conn = link->conn;
+    struct ble_service_power_policy p;
+    enum power_profile want = POWER_PROFILE_BULK;
+
+    if (!conn) {
+        return;
+    }
+    power_policy_get(&p);
+    if (!power_link_busy(link, &p)) {
+        int64_t quiet = k_uptime_get() - link->last_active;
+        if (quiet < p.idle_delay_ms) {
+            if (link->profile != POWER_PROFILE_IDLE) {
+                k_work_schedule(dwork, K_MSEC(p.idle_delay_ms - quiet));
+            }
+            return;
+        }
+        want = POWER_PROFILE_IDLE;
+    }
+    if (link->profile == want) {
+        return;
+    }
+
+    const struct ble_service_conn_profile *prof = want == POWER_PROFILE_BULK ? &p.bulk : &p.idle;
+    struct bt_le_conn_param param =
+        BT_LE_CONN_PARAM_INIT(prof->interval_min, prof->interval_max, prof->latency, prof->timeout);
+    int err = bt_conn_le_param_update(conn, &param);
+    if (err) {
+        LOG_WRN("%s profile request failed (err %d)", want == POWER_PROFILE_BULK ? "Bulk" : "Idle",
+                err);
+        k_work_schedule(dwork, K_MSEC(POWER_RETRY_MS));
+        return;
+    }
+    link->profile = want;
+    LOG_DBG("Link %u: %s profile", bt_conn_index(conn),
+            want == POWER_PROFILE_BULK ? "bulk" : "idle");
+}
+
+/* Hand every held container to the stack, back to back, so they go out in
+ * the same connection event. Work queue only, like everything that sends
+ * responses. */
+static int notify_batch_flush(struct link_ctx *link)
+{
+    int rc = 0;
+
+    k_work_cancel_delayable(&link->batch_work);
+    for (size_t off = 0; off < link->batch_used && rc >= 0; off += 1 + link->batch_buf[off]) {
+        rc = send_with_retry(link, &link->batch_buf[off + 1], link->batch_buf[off]);
+    }
+    link->batch_used = 0;
+    return rc < 0 ? rc : 0;
+}
+
+/* Hold a single-container response while the link is idle, until the batch
+ * window has passed since the first one held or the buffer is full.
+ * @return false if it must be sent now */
+static bool notify_batch_add(struct link_ctx *link, const uint8_t *data, size_t len)
+{
+    struct ble_service_power_policy p;
+
+    power_policy_get(&p);
+    if (p.batch_window_ms == 0 || link->profile != POWER_PROFILE_IDLE ||
+        1 + len > sizeof(link->batch_buf)) {
+        return false;
+    }
+    if (link->batch_used + 1 + len > sizeof(link->batch_buf) && notify_batch_flush(link) != 0) {
+        return false;
+    }
+    if (link->batch_used == 0) {
+        k_work_schedule_for_queue(&blerpc_work_q, &link->batch_work, K_MSEC(p.batch_window_ms));
+    }
+    link->batch_buf[link->batch_used] = (uint8_t)len;
+    memcpy(&link->batch_buf[link->batch_used + 1], data, len);
+    link->batch_used += 1 + len;
+    return true;
+}
+
+static void batch_work_handler(struct k_work *work)
+{
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct link_ctx *link = CONTAINER_OF(dwork, struct link_ctx, batch_work);
+
+    if (link->conn) {
+        notify_batch_flush(link);
+    } else {
+        link->batch_used = 0;
+    }
+}
+
+static void power_link_reset(struct link_ctx *link)
+{
+    struct k_work_sync sync;
+
+    k_work_cancel_delayable_sync(&link->power_work, &sync);
+    k_work_cancel_delayable_sync(&link->batch_work, &sync);
+    atomic_clear(&link->queued);
+    link->profile = POWER_PROFILE_NONE;
+    link->large_tx = false;
+    link->batch_used = 0;
+}
+#else
+static inline void power_demand(struct link_ctx *link)
+{
+    (void)link;
+}
+
+static inline void power_settle(struct link_ctx *link)
+{
+    (void)link;
+}
+
+static inline void power_request_queued(struct link_ctx *link)
+{
+    (void)link;
+}
+
+static inline void power_request_done(struct link_ctx *link)
+{
+    (void)link;
+}
+
+static inline void power_response_begin(struct link_ctx *link, size_t wire_len)
+{
+    (void)link;
+    (void)wire_len;
+}
+
+static inline void power_response_end(struct link_ctx *link)
+{
+    (void)link;
+}
+#endif /* CONFIG_BLERPC_POWER_POLICY */
+
+/* Send one container of a response. A whole response in one container may
+ * be held for the batch; anything else first sends what is held, so the
+ * link's notifications keep their order (and encrypted ones their counter
+ * order). */
+static int send_container(struct link_ctx *link, const uint8_t *data, size_t len, bool whole)
+{
+#ifdef CONFIG_BLERPC_POWER_POLICY
+    if (whole && notify_batch_add(link, data, len)) {
+        return 0;
+    }
+    if (link->batch_used > 0) {
+        int rc = notify_batch_flush(link);
+        if (rc < 0) {
+            return rc;
+        }
+    }
+#else
+    (void)whole;
+#endif
+    return send_with_retry(link, data, len);
+}
+
+#ifdef CONFIG_BLERPC_L2CAP
+/* Bulk channel SDU: transaction_id(1) || payload, where payload is exactly
+ * what the GATT path carries in containers (a command packet, encrypted
+ * while the session is). One SDU per request or response. */
+#define BULK_SDU_HEADER_SIZE 1
+
+NET_BUF_POOL_FIXED_DEFINE(bulk_rx_pool, CONFIG_BT_MAX_CONN,
+                          BT_L2CAP_SDU_BUF_SIZE(CONFIG_BLERPC_L2CAP_MTU), 8, NULL);
+/* Responses are sent one at a time from the work queue */
+NET_BUF_POOL_FIXED_DEFINE(bulk_tx_pool, 1, BT_L2CAP_SDU_BUF_SIZE(CONFIG_BLERPC_L2CAP_MTU),
+                          CONFIG_BT_CONN_TX_USER_DATA_SIZE, NULL);
+
+/* Wait until every notification queued on link has been sent. The stack
+ * interleaves ATT and bulk channel PDUs, so without this an SDU could
+ * overtake earlier notifications and the central would see encrypted
+ * payloads out of counter order. */
+static int notify_drain(struct link_ctx *link)
+{
+    k_timepoint_t deadline = sys_timepoint_calc(K_MSEC(CONFIG_BLERPC_NOTIFY_TIMEOUT_MS));
+    int taken;
+
+    for (taken = 0; taken < CONFIG_BLERPC_NOTIFY_INFLIGHT_MAX; taken++) {
+        if (k_sem_take(&link->notify_credits, sys_timepoint_timeout(deadline)) != 0) {
+            break;
+        }
+    }
+    for (int i = 0; i < taken; i++) {
+        k_sem_give(&link->notify_credits);
+    }
+    return taken == CONFIG_BLERPC_NOTIFY_INFLIGHT_MAX ? 0 : -EAGAIN;
+}
+
+/* Buffer for a wire_len byte response on link's bulk channel, or NULL if it
+ * should go over GATT: channel closed, response small or larger than either
+ * side's SDU, or no buffer / notification drain within the notify timeout. */
+static struct net_buf *bulk_begin(struct link_ctx *link, uint8_t transaction_id,
+                                  size_t wire_len)
+{
+    if (!link->bulk_connected || wire_len < CONFIG_BLERPC_L2CAP_THRESHOLD ||
+        BULK_SDU_HEADER_SIZE + wire_len > MIN(link->bulk_chan.tx.mtu, CONFIG_BLERPC_L2CAP_MTU)) {
+        return NULL;
+    }
+
+    struct net_buf *buf =
+        net_buf_alloc(&bulk_tx_pool, K_MSEC(CONFIG_BLERPC_NOTIFY_TIMEOUT_MS));
+    if (!buf) {
+        LOG_WRN("No bulk TX buffer, falling back to GATT");
+        return NULL;
+    }
+#ifdef CONFIG_BLERPC_POWER_POLICY
+    if (link->batch_used > 0 && notify_batch_flush(link) != 0) {
+        net_buf_unref(buf);
+        return NULL;
+    }
+#endif
+    if (notify_drain(link) != 0) {
+        LOG_WRN("Notifications still queued, falling back to GATT");
+        net_buf_unref(buf);
+        return NULL;
+    }
+    net_buf_reserve(buf, BT_L2CAP_SDU_CHAN_SEND_RESERVE);
+    net_buf_add_u8(buf, transaction_id);
+    return buf;
+}
+
+/* Hand a finished SDU to the stack and wait until it is sent, for the same
+ * ordering reason as notify_drain(). Consumes buf. */
+static int bulk_send(struct link_ctx *link, struct net_buf *buf)
+{
+    k_sem_reset(&link->bulk_sent);
+    BLERPC_STATS_ADD(bytes_out, buf->len);
+    int rc = bt_l2cap_chan_send(&link->bulk_chan.chan, buf);
+    if (rc < 0) {
+        LOG_ERR("Bulk send failed: %d", rc);
+        net_buf_unref(buf);
+        return rc;
+    }
+    if (k_sem_take(&link->bulk_sent, K_MSEC(CONFIG_BLERPC_NOTIFY_TIMEOUT_MS)) != 0) {
+        LOG_WRN("Bulk SDU still in flight");
+        return -ETIMEDOUT;
+    }
+    return link->bulk_connected ? 0 : -ENOTCONN;
+}
+#endif /* CONFIG_BLERPC_L2CAP */
+
 static uint8_t streaming_header_size(struct streaming_ctx *ctx)
 {
     return ctx->first_sent ? CONTAINER_SUBSEQUENT_HEADER_SIZE : CONTAINER_FIRST_HEADER_SIZE;
@@ -159,7 +695,8 @@ static int streaming_flush_container(struct streaming_ctx *ctx)
         ctx->buf[3] = ctx->payload_used;
     }
 
-    int rc = send_with_retry(ctx->buf, hdr_size + ctx->payload_used);
+    bool whole = !ctx->first_sent && ctx->payload_used == ctx->total_length;
+    int rc = send_container(ctx->link, ctx->buf, hdr_size + ctx->payload_used, whole);
     if (rc < 0) {
         ctx->error = rc;
         return rc;
@@ -171,12 +708,20 @@ static int streaming_flush_container(struct streaming_ctx *ctx)
     return 0;
 }
 
-static int streaming_write(struct streaming_ctx *ctx, const uint8_t *data, size_t len)
+static int streaming_write_raw(struct streaming_ctx *ctx, const uint8_t *data, size_t len)
 {
     if (ctx->error) {
         return ctx->error;
     }
 
+#ifdef CONFIG_BLERPC_L2CAP
+    if (ctx->bulk_buf) {
+        /* Sized for the whole response by streaming_begin() */
+        net_buf_add_mem(ctx->bulk_buf, data, len);
+        return 0;
+    }
+#endif
+
     while (len > 0) {
         uint8_t hdr_size = streaming_header_size(ctx);
         uint8_t max_payload = streaming_max_payload(ctx);
@@ -198,188 +743,1682 @@ static int streaming_write(struct streaming_ctx *ctx, const uint8_t *data, size_
     return 0;
 }
 
-static bool streaming_pb_callback(pb_ostream_t *stream, const uint8_t *buf, size_t count)
+#ifdef CONFIG_BLERPC_ENCRYPTION
+/* Plaintext bytes encrypted per crypto call */
+#define STREAMING_CRYPTO_CHUNK 64
+
+static int streaming_write_encrypted(struct streaming_ctx *ctx, const uint8_t *data, size_t len)
 {
-    struct streaming_ctx *ctx = (struct streaming_ctx *)stream->state;
-    return streaming_write(ctx, buf, count) == 0;
+    uint8_t out[PSA_AEAD_UPDATE_OUTPUT_MAX_SIZE(STREAMING_CRYPTO_CHUNK)];
+
+    while (len > 0 && !ctx->error) {
+        size_t n = MIN(len, STREAMING_CRYPTO_CHUNK);
+        size_t out_len;
+        if (stream_crypto_tx_update(&ctx->crypto, data, n, out, sizeof(out), &out_len) != 0) {
+            LOG_ERR("Response encryption failed");
+            ctx->encrypt = false;
+            ctx->error = -EIO;
+            break;
+        }
+        streaming_write_raw(ctx, out, out_len);
+        data += n;
+        len -= n;
+    }
+    return ctx->error;
 }
+#endif
 
-/* Callback for container_split_and_send */
-static int container_send_cb(const uint8_t *data, size_t len, void *ctx)
+static int streaming_write(struct streaming_ctx *ctx, const uint8_t *data, size_t len)
 {
-    (void)ctx;
-    return send_with_retry(data, len);
+#ifdef CONFIG_BLERPC_ENCRYPTION
+    if (ctx->encrypt) {
+        return streaming_write_encrypted(ctx, data, len);
+    }
+#endif
+    return streaming_write_raw(ctx, data, len);
 }
 
-/* Send an ERROR(BUSY) control container to signal the central to retry. */
-static void send_busy_error(uint8_t transaction_id)
+/* Bytes the wire payload adds on top of the plaintext command payload */
+static size_t streaming_overhead(const struct link_ctx *link)
 {
-    uint8_t ctrl_buf[8];
-    struct container_header ctrl = {
-        .transaction_id = transaction_id,
-        .sequence_number = 0,
-        .type = CONTAINER_TYPE_CONTROL,
-        .control_cmd = CONTROL_CMD_ERROR,
-        .payload_len = 1,
-    };
-    uint8_t err_payload[1] = {BLERPC_ERROR_BUSY};
-    ctrl.payload = err_payload;
-    int n = container_serialize(&ctrl, ctrl_buf, sizeof(ctrl_buf));
-    if (n > 0) {
-        send_with_retry(ctrl_buf, (size_t)n);
+#ifdef CONFIG_BLERPC_ENCRYPTION
+    if (link->encryption_active) {
+        return BLERPC_ENCRYPTED_OVERHEAD;
     }
+#endif
+    return 0;
 }
 
-/* ── Request processing ──────────────────────────────────────────────── */
+/* Start a response on link carrying payload_len plaintext bytes, encrypting
+ * on the fly while the link's session is encrypted. Large responses go over
+ * the bulk channel when it is open, otherwise containers over GATT. The
+ * caller must check that the wire length (payload_len + streaming_overhead())
+ * fits in 16 bits. Every begin is paired with streaming_end() or
+ * streaming_abort(). */
+static int streaming_begin(struct streaming_ctx *ctx, struct link_ctx *link,
+                           uint8_t transaction_id, size_t payload_len)
+{
+    ctx->link = link;
+    ctx->transaction_id = transaction_id;
+    ctx->mtu = ble_service_get_mtu(link->conn);
+    ctx->total_length = (uint16_t)(payload_len + streaming_overhead(link));
+    ctx->seq = 0;
+    ctx->payload_used = 0;
+    ctx->first_sent = false;
+    ctx->error = 0;
+    power_response_begin(link, ctx->total_length);
+#ifdef CONFIG_BLERPC_L2CAP
+    ctx->bulk_buf = bulk_begin(link, transaction_id, ctx->total_length);
+#endif
+
+#ifdef CONFIG_BLERPC_ENCRYPTION
+    ctx->encrypt = link->encryption_active;
+    if (ctx->encrypt) {
+        uint8_t counter[STREAM_CRYPTO_COUNTER_SIZE];
+        if (stream_crypto_tx_begin(&ctx->crypto, &link->crypto_session,
+                                   STREAM_CRYPTO_DIRECTION_P2C, payload_len, counter) != 0) {
+            LOG_ERR("Response encryption failed");
+            ctx->encrypt = false;
+            return -EIO;
+        }
+        streaming_write_raw(ctx, counter, sizeof(counter));
+    }
+#endif
+    return ctx->error;
+}
 
-static void process_request(const uint8_t *data, size_t len, uint8_t transaction_id)
+static void streaming_abort(struct streaming_ctx *ctx)
 {
-    /* Parse command */
-    struct command_packet cmd;
-    if (command_parse(data, len, &cmd) != 0) {
-        LOG_ERR("Command parse failed");
-        return;
+    power_response_end(ctx->link);
+#ifdef CONFIG_BLERPC_ENCRYPTION
+    if (ctx->encrypt) {
+        stream_crypto_tx_abort(&ctx->crypto);
+        ctx->encrypt = false;
     }
+#endif
+#ifdef CONFIG_BLERPC_L2CAP
+    if (ctx->bulk_buf) {
+        net_buf_unref(ctx->bulk_buf);
+        ctx->bulk_buf = NULL;
+    }
+#endif
+}
 
-    if (cmd.cmd_type != COMMAND_TYPE_REQUEST) {
-        LOG_ERR("Expected request, got type %d", cmd.cmd_type);
-        return;
+/* Append the GCM tag (if encrypting), then flush the last partial container
+ * or send the bulk SDU */
+static int streaming_end(struct streaming_ctx *ctx)
+{
+    if (ctx->error) {
+        streaming_abort(ctx);
+        return ctx->error;
     }
 
-    /* Look up handler */
-    command_handler_fn handler = handlers_lookup(cmd.cmd_name, cmd.cmd_name_len);
-    if (!handler) {
-        LOG_ERR("Unknown command: %.*s", cmd.cmd_name_len, cmd.cmd_name);
-        return;
+#ifdef CONFIG_BLERPC_ENCRYPTION
+    if (ctx->encrypt) {
+        uint8_t out[PSA_AEAD_FINISH_OUTPUT_MAX_SIZE];
+        uint8_t tag[STREAM_CRYPTO_TAG_SIZE];
+        size_t out_len;
+        ctx->encrypt = false;
+        if (stream_crypto_tx_finish(&ctx->crypto, out, sizeof(out), &out_len, tag) != 0) {
+            LOG_ERR("Response encryption failed");
+            streaming_abort(ctx);
+            return -EIO;
+        }
+        streaming_write_raw(ctx, out, out_len);
+        streaming_write_raw(ctx, tag, sizeof(tag));
     }
+#endif
 
-    /* Pass 1: Calculate protobuf encoded size (sizing stream, no I/O) */
-    pb_ostream_t sizing = PB_OSTREAM_SIZING;
-    int handler_rc = handler(cmd.data, cmd.data_len, &sizing);
-    if (handler_rc == -2) {
-        /* Handler manages its own response (e.g. stream handlers) */
-        return;
+#ifdef CONFIG_BLERPC_L2CAP
+    if (ctx->bulk_buf) {
+        struct net_buf *buf = ctx->bulk_buf;
+        ctx->bulk_buf = NULL;
+        int rc = bulk_send(ctx->link, buf);
+        if (rc == 0) {
+            BLERPC_STATS_INC(responses);
+        }
+        power_response_end(ctx->link);
+        return rc;
     }
-    if (handler_rc != 0) {
-        LOG_ERR("Handler sizing pass failed");
+#endif
+
+    if (!ctx->error) {
+        streaming_flush_container(ctx);
+    }
+    if (!ctx->error) {
+        BLERPC_STATS_INC(responses);
+    }
+    power_response_end(ctx->link);
+    return ctx->error;
+}
+
+static bool streaming_pb_callback(pb_ostream_t *stream, const uint8_t *buf, size_t count)
+{
+    struct streaming_ctx *ctx = (struct streaming_ctx *)stream->state;
+    return streaming_write(ctx, buf, count) == 0;
+}
+
+/* Send an ERROR control container for a transaction.
+ * from_rx: called on the BT RX thread, see send_from_rx(). */
+static void send_error(struct link_ctx *link, uint8_t transaction_id, uint8_t error_code,
+                       bool from_rx)
+{
+    uint8_t ctrl_buf[8];
+    struct container_header ctrl = {
+        .transaction_id = transaction_id,
+        .sequence_number = 0,
+        .type = CONTAINER_TYPE_CONTROL,
+        .control_cmd = CONTROL_CMD_ERROR,
+        .payload_len = 1,
+    };
+    uint8_t err_payload[1] = {error_code};
+    ctrl.payload = err_payload;
+    int n = container_serialize(&ctrl, ctrl_buf, sizeof(ctrl_buf));
+    if (n <= 0) {
         return;
     }
-    size_t pb_size = sizing.bytes_written;
+    if (from_rx) {
+        send_from_rx(link, ctrl_buf, (size_t)n);
+    } else {
+        send_with_retry(link, ctrl_buf, (size_t)n);
+    }
+}
 
-    /* Calculate total command payload size */
-    size_t cmd_hdr_size = 2 + cmd.cmd_name_len + 2;
-    size_t total_length = cmd_hdr_size + pb_size;
+/* Send an ERROR(BUSY) control container to signal the central to retry. */
+static void send_busy_error(struct link_ctx *link, uint8_t transaction_id, bool from_rx)
+{
+    BLERPC_STATS_INC(busy_errors);
+    send_error(link, transaction_id, BLERPC_ERROR_BUSY, from_rx);
+}
+
+/* ── Request processing ──────────────────────────────────────────────── */
+
+#if CONFIG_BLERPC_SINGLE_PASS_BUF_SIZE > 0
+/* Bounded responses are encoded here once, then streamed out */
+static uint8_t single_pass_buf[CONFIG_BLERPC_SINGLE_PASS_BUF_SIZE];
+#define SINGLE_PASS_BUF_AT(off) (single_pass_buf + (off))
+#else
+#define SINGLE_PASS_BUF_AT(off) NULL
+#endif
+
+/* Reply with RESPONSE_TOO_LARGE if the wire payload for total_length
+ * plaintext bytes exceeds the configured max (or the 16-bit length field).
+ * @return true if the response must not be sent */
+static bool response_too_large(struct link_ctx *link, uint8_t transaction_id,
+                               size_t total_length)
+{
+    total_length += streaming_overhead(link);
+    if (total_length <= MIN(CONFIG_BLERPC_MAX_RESPONSE_PAYLOAD_SIZE, UINT16_MAX)) {
+        return false;
+    }
+
+    send_error(link, transaction_id, BLERPC_ERROR_RESPONSE_TOO_LARGE, false);
+    LOG_WRN("Response too large: %zu > %u", total_length, CONFIG_BLERPC_MAX_RESPONSE_PAYLOAD_SIZE);
+    return true;
+}
 
-    /* Check response size against max */
-    if (CONFIG_BLERPC_MAX_RESPONSE_PAYLOAD_SIZE < 65535 &&
-        total_length > CONFIG_BLERPC_MAX_RESPONSE_PAYLOAD_SIZE) {
-        uint8_t ctrl_buf[8];
-        struct container_header ctrl = {
-            .transaction_id = transaction_id,
-            .sequence_number = 0,
-            .type = CONTAINER_TYPE_CONTROL,
-            .control_cmd = CONTROL_CMD_ERROR,
-            .payload_len = 1,
-        };
-        uint8_t err_payload[1] = {BLERPC_ERROR_RESPONSE_TOO_LARGE};
-        ctrl.payload = err_payload;
-        int n = container_serialize(&ctrl, ctrl_buf, sizeof(ctrl_buf));
-        if (n > 0) {
-            send_with_retry(ctrl_buf, (size_t)n);
+/* Find the handler a request names, by ID when the central sent the 1-byte
+ * form */
+static const struct handler_entry *request_handler(const uint8_t *data,
+                                                   const struct command_packet *cmd)
+{
+    const struct handler_entry *entry;
+    if (data[0] & COMMAND_FLAG_ID) {
+        entry = cmd->cmd_name_len == 1 ? handlers_find_id((uint8_t)cmd->cmd_name[0]) : NULL;
+        if (!entry) {
+            LOG_ERR("Unknown command ID");
         }
-        LOG_WRN("Response too large: %zu > %u", total_length,
-                CONFIG_BLERPC_MAX_RESPONSE_PAYLOAD_SIZE);
-        return;
+        return entry;
+    }
+    entry = handlers_find(cmd->cmd_name, cmd->cmd_name_len);
+    if (!entry) {
+        LOG_ERR("Unknown command: %.*s", cmd->cmd_name_len, cmd->cmd_name);
+    }
+    return entry;
+}
+
+/* Build the response command header for a request, answering in the name
+ * form the request used. data_len (the last 2 bytes) is left to the caller.
+ * @return header size, 0 if the name does not fit */
+static size_t response_header(uint8_t *hdr, const uint8_t *data, const struct command_packet *cmd)
+{
+    size_t size = 2 + cmd->cmd_name_len + 2;
+    if (size > CMD_HEADER_MAX_SIZE) {
+        LOG_ERR("Command name too long for response header: %u", cmd->cmd_name_len);
+        return 0;
+    }
+    hdr[0] = (COMMAND_TYPE_RESPONSE & 0x01) << 7;
+    if (data[0] & COMMAND_FLAG_ID) {
+        hdr[0] |= COMMAND_FLAG_ID;
+    }
+    hdr[1] = cmd->cmd_name_len;
+    memcpy(hdr + 2, cmd->cmd_name, cmd->cmd_name_len);
+    return size;
+}
+
+/* Where response_encode() left a response */
+enum resp_source {
+    RESP_SIZED,  /* only sized: the handler runs again to write it */
+    RESP_BUF,    /* encoded into the caller's buffer */
+    RESP_CACHED, /* a cache hit */
+    RESP_STORED, /* encoded into a new cache slot */
+};
+
+/* Run a request's handler once where it can be kept: serve a cache hit
+ * without it, encode a bounded response that fits buf, or else size the
+ * response. A cacheable response is then stored, its second pass going into
+ * the cache slot instead of the stream. *encoded is NULL for RESP_SIZED;
+ * cache bytes stay valid until the next response_cache_reserve().
+ * @return 0, -2 if the handler manages its own response, other nonzero if
+ *         it failed */
+static int response_encode(const struct handler_entry *entry, const struct command_packet *cmd,
+                           uint8_t *buf, size_t buf_size, const uint8_t **encoded,
+                           size_t *pb_size, enum resp_source *src)
+{
+    uint32_t cache_epoch = response_cache_epoch(entry);
+    int rc;
+
+    *encoded = response_cache_get(entry, cmd->data, cmd->data_len, pb_size);
+    if (*encoded) {
+        *src = RESP_CACHED;
+        return 0;
+    }
+    if (entry->max_resp_size > 0 && entry->max_resp_size <= buf_size) {
+        pb_ostream_t ostream = pb_ostream_from_buffer(buf, buf_size);
+        rc = entry->handler(cmd->data, cmd->data_len, &ostream);
+        *encoded = buf;
+        *pb_size = ostream.bytes_written;
+        *src = RESP_BUF;
+    } else {
+        /* Pass 1: Calculate protobuf encoded size (sizing stream, no I/O) */
+        pb_ostream_t sizing = PB_OSTREAM_SIZING;
+        rc = entry->handler(cmd->data, cmd->data_len, &sizing);
+        *pb_size = sizing.bytes_written;
+        *src = RESP_SIZED;
+    }
+    if (rc == -2) {
+        return rc;
+    }
+    if (rc != 0) {
+        LOG_ERR("Handler %s pass failed", *src == RESP_BUF ? "encode" : "sizing");
+        return rc;
+    }
+
+    uint8_t *cache_slot =
+        response_cache_reserve(entry, cmd->data, cmd->data_len, *pb_size, cache_epoch);
+    if (cache_slot && *encoded) {
+        memcpy(cache_slot, *encoded, *pb_size);
+    } else if (cache_slot) {
+        pb_ostream_t ostream = pb_ostream_from_buffer(cache_slot, *pb_size);
+        if (entry->handler(cmd->data, cmd->data_len, &ostream) != 0 ||
+            ostream.bytes_written != *pb_size) {
+            LOG_ERR("Handler encode pass failed");
+            return -1;
+        }
+        *encoded = cache_slot;
+    }
+    if (cache_slot) {
+        response_cache_commit();
+        if (*src == RESP_SIZED) {
+            *src = RESP_STORED;
+        }
+    }
+    return 0;
+}
+
+/* Encode a sized response straight into the container stream */
+static int response_write_pass(struct streaming_ctx *sctx, const struct handler_entry *entry,
+                               const struct command_packet *cmd, size_t pb_size)
+{
+    /* Pass 2: Encode protobuf directly into container stream */
+    pb_ostream_t ostream = {
+        .callback = streaming_pb_callback,
+        .state = sctx,
+        .max_size = SIZE_MAX,
+        .bytes_written = 0,
+    };
+    if (entry->handler(cmd->data, cmd->data_len, &ostream) != 0 ||
+        ostream.bytes_written != pb_size) {
+        LOG_ERR("Handler encode pass failed");
+        return -1;
+    }
+    return 0;
+}
+
+#if CONFIG_BLERPC_BATCH_MAX_COMMANDS > 0
+/* Split the next request packet off a batch body.
+ * @return its length, 0 if the rest of the body is not a whole request */
+static size_t batch_next(const uint8_t *p, size_t left, struct command_packet *cmd)
+{
+    if (left < 4 || left < 4 + (size_t)p[1]) {
+        return 0;
+    }
+    size_t name_len = p[1];
+    size_t len = 4 + name_len + (p[2 + name_len] | (p[3 + name_len] << 8));
+    if (len > left || command_parse(p, len, cmd) != 0 || cmd->cmd_type != COMMAND_TYPE_REQUEST) {
+        return 0;
     }
+    return len;
+}
 
+/* Run the commands of a batch in order and answer with one batch response
+ * carrying their responses back to back. Every packet is checked before any
+ * handler runs, since stream commands cannot be batched and a stream handler
+ * acts as soon as it is called. Each command then goes through
+ * response_encode() like a single request, its encoding packed into
+ * single_pass_buf after the ones before it, which gives total_length; only
+ * sized responses run their handler again, straight into the container
+ * stream. A batch that cannot be answered gets an ERROR container, so the
+ * central does not wait out its timeout: RESPONSE_TOO_LARGE for one over
+ * CONFIG_BLERPC_BATCH_MAX_COMMANDS or a response over the limit, BUSY for
+ * anything else. */
+static void process_batch(struct link_ctx *link, const struct command_packet *batch,
+                          uint8_t transaction_id)
+{
+    struct {
+        const uint8_t *encoded; /* NULL: write it with response_write_pass() */
+        size_t size;
+        bool in_cache; /* encoded points into the cache arena */
+    } resp[CONFIG_BLERPC_BATCH_MAX_COMMANDS];
+    size_t count = 0;
+    size_t body_len = 0;
+    size_t buf_used = 0;
     uint8_t cmd_hdr[CMD_HEADER_MAX_SIZE];
-    if (cmd_hdr_size > sizeof(cmd_hdr)) {
-        LOG_ERR("Command name too long for response header: %u", cmd.cmd_name_len);
+    struct command_packet cmd;
+    size_t off;
+    size_t n;
+
+    for (off = 0; off < batch->data_len; off += n) {
+        n = batch_next(batch->data + off, batch->data_len - off, &cmd);
+        if (n == 0) {
+            LOG_ERR("Malformed batch request");
+            send_busy_error(link, transaction_id, false);
+            return;
+        }
+        if (count == ARRAY_SIZE(resp)) {
+            LOG_ERR("Batch exceeds %d commands", CONFIG_BLERPC_BATCH_MAX_COMMANDS);
+            send_error(link, transaction_id, BLERPC_ERROR_RESPONSE_TOO_LARGE, false);
+            return;
+        }
+        const struct handler_entry *entry = request_handler(batch->data + off, &cmd);
+        if (!entry || response_header(cmd_hdr, batch->data + off, &cmd) == 0) {
+            send_busy_error(link, transaction_id, false);
+            return;
+        }
+        if (entry->stream != HANDLER_STREAM_NONE) {
+            LOG_ERR("Stream command %s cannot be batched", entry->name);
+            send_busy_error(link, transaction_id, false);
+            return;
+        }
+        count++;
+    }
+
+    off = 0;
+    for (size_t i = 0; i < count; i++, off += n) {
+        n = batch_next(batch->data + off, batch->data_len - off, &cmd);
+        const struct handler_entry *entry = request_handler(batch->data + off, &cmd);
+        uint8_t *buf = SINGLE_PASS_BUF_AT(buf_used);
+        size_t room = CONFIG_BLERPC_SINGLE_PASS_BUF_SIZE - buf_used;
+        enum resp_source src;
+
+        int rc = response_encode(entry, &cmd, buf, room, &resp[i].encoded, &resp[i].size, &src);
+        if (rc != 0) {
+            LOG_ERR("Batched handler failed: %d", rc);
+            send_busy_error(link, transaction_id, false);
+            return;
+        }
+        if (src != RESP_CACHED) {
+            /* A reserved slot may have taken the arena bytes of earlier hits */
+            for (size_t j = 0; j < i; j++) {
+                if (resp[j].in_cache) {
+                    resp[j].encoded = NULL;
+                    resp[j].in_cache = false;
+                }
+            }
+        }
+        resp[i].in_cache = src == RESP_CACHED || src == RESP_STORED;
+        if (resp[i].in_cache && buf && resp[i].size <= room) {
+            memcpy(buf, resp[i].encoded, resp[i].size);
+            resp[i].encoded = buf;
+            resp[i].in_cache = false;
+        }
+        if (buf && resp[i].encoded == buf) {
+            buf_used += resp[i].size;
+        }
+        body_len += response_header(cmd_hdr, batch->data + off, &cmd) + resp[i].size;
+    }
+
+    size_t total_length = 2 + 2 + body_len;
+    if (response_too_large(link, transaction_id, total_length)) {
         return;
     }
-    cmd_hdr[0] = (COMMAND_TYPE_RESPONSE & 0x01) << 7;
-    cmd_hdr[1] = cmd.cmd_name_len;
-    memcpy(cmd_hdr + 2, cmd.cmd_name, cmd.cmd_name_len);
-    size_t dl_offset = 2 + cmd.cmd_name_len;
-    cmd_hdr[dl_offset] = (uint8_t)(pb_size & 0xFF);
-    cmd_hdr[dl_offset + 1] = (uint8_t)((pb_size >> 8) & 0xFF);
 
-    /* Set up streaming container sender */
-    uint16_t mtu = ble_service_get_mtu();
+    struct streaming_ctx sctx;
+    if (streaming_begin(&sctx, link, transaction_id, total_length) != 0) {
+        streaming_abort(&sctx);
+        return;
+    }
 
-#ifdef CONFIG_BLERPC_ENCRYPTION
-    if (encryption_active) {
-        /* When encryption is active, we need to serialize the full command
-         * payload first, encrypt it, then send via container splitter */
-        static uint8_t cmd_plain_buf[CONFIG_BLERPC_PROTOCOL_ASSEMBLER_BUF_SIZE];
-        memcpy(cmd_plain_buf, cmd_hdr, cmd_hdr_size);
-
-        /* Encode protobuf into the buffer after the command header */
-        pb_ostream_t ostream = pb_ostream_from_buffer(cmd_plain_buf + cmd_hdr_size,
-                                                      sizeof(cmd_plain_buf) - cmd_hdr_size);
-        if (handler(cmd.data, cmd.data_len, &ostream) != 0) {
-            LOG_ERR("Handler encode pass failed");
+    /* Batch response header: no name, the responses are its data */
+    cmd_hdr[0] = ((COMMAND_TYPE_RESPONSE & 0x01) << 7) | COMMAND_FLAG_BATCH;
+    cmd_hdr[1] = 0;
+    cmd_hdr[2] = (uint8_t)(body_len & 0xFF);
+    cmd_hdr[3] = (uint8_t)((body_len >> 8) & 0xFF);
+    streaming_write(&sctx, cmd_hdr, 4);
+
+    off = 0;
+    for (size_t i = 0; i < count; i++, off += n) {
+        n = batch_next(batch->data + off, batch->data_len - off, &cmd);
+        const struct handler_entry *entry = request_handler(batch->data + off, &cmd);
+        size_t hdr_size = response_header(cmd_hdr, batch->data + off, &cmd);
+        cmd_hdr[hdr_size - 2] = (uint8_t)(resp[i].size & 0xFF);
+        cmd_hdr[hdr_size - 1] = (uint8_t)((resp[i].size >> 8) & 0xFF);
+        streaming_write(&sctx, cmd_hdr, hdr_size);
+
+        if (resp[i].encoded) {
+            streaming_write(&sctx, resp[i].encoded, resp[i].size);
+        } else if (response_write_pass(&sctx, entry, &cmd, resp[i].size) != 0) {
+            streaming_abort(&sctx);
             return;
         }
+    }
 
-        /* Encrypt the full command payload */
-        static uint8_t
-            encrypted_buf[CONFIG_BLERPC_PROTOCOL_ASSEMBLER_BUF_SIZE + BLERPC_ENCRYPTED_OVERHEAD];
-        size_t encrypted_len;
-        if (blerpc_crypto_session_encrypt(&crypto_session, encrypted_buf, sizeof(encrypted_buf),
-                                          &encrypted_len, cmd_plain_buf, total_length) != 0) {
-            LOG_ERR("Response encryption failed");
+    int rc = streaming_end(&sctx);
+    if (rc < 0) {
+        LOG_ERR("Streaming send failed: %d", rc);
+    }
+}
+#endif
+
+/* Length of the coalesced message at off, or -1 if the frame ends inside
+ * its [len LE16] prefix or its body */
+static int stream_frame_next(const struct command_packet *frame, size_t off)
+{
+    size_t left = frame->data_len - off;
+    size_t msg_len = left >= 2 ? (frame->data[off] | (frame->data[off + 1] << 8)) : 0;
+    return left < 2 || msg_len > left - 2 ? -1 : (int)msg_len;
+}
+
+/* Run the messages of a coalesced C→P stream frame in order, all in this one
+ * work item. The frame must name a C→P stream command and be well formed
+ * before any message runs; a handler that answers anything ends it. */
+static void process_stream_frame(const uint8_t *data, const struct command_packet *frame)
+{
+    const struct handler_entry *entry = request_handler(data, frame);
+    if (!entry) {
+        return;
+    }
+    if (entry->stream != HANDLER_STREAM_C2P) {
+        LOG_ERR("Coalesced frame names %s, not a C→P stream command", entry->name);
+        return;
+    }
+    for (size_t off = 0; off < frame->data_len;) {
+        int msg_len = stream_frame_next(frame, off);
+        if (msg_len < 0) {
+            LOG_ERR("Malformed coalesced stream frame");
             return;
         }
+        off += 2 + msg_len;
+    }
 
-        /* Send encrypted payload via container splitter */
-        int rc = container_split_and_send(transaction_id, encrypted_buf, encrypted_len, mtu,
-                                          container_send_cb, NULL);
-        if (rc < 0) {
-            LOG_ERR("Encrypted container send failed: %d", rc);
+    size_t off = 0;
+    while (off < frame->data_len) {
+        size_t msg_len = (size_t)stream_frame_next(frame, off);
+        off += 2;
+
+        pb_ostream_t sizing = PB_OSTREAM_SIZING;
+        int rc = entry->handler(frame->data + off, msg_len, &sizing);
+        if (rc != -2) {
+            LOG_ERR("Coalesced %.*s message failed: %d", frame->cmd_name_len, frame->cmd_name,
+                    rc);
+            return;
         }
+        off += msg_len;
+    }
+}
+
+#ifdef CONFIG_BLERPC_COMPRESSION
+/* Work queue only: one request is expanded, and one response compressed, at
+ * a time */
+static uint8_t inflate_buf[CONFIG_BLERPC_COMPRESSION_BUF_SIZE];
+static struct blerpc_compress response_compress;
+
+/* Point a compressed request's data at its expansion in inflate_buf */
+static int request_inflate(struct command_packet *cmd)
+{
+    size_t len;
+    if (blerpc_decompress(cmd->data, cmd->data_len, inflate_buf, sizeof(inflate_buf), &len) != 0) {
+        LOG_ERR("Compressed request malformed or over %d bytes", CONFIG_BLERPC_COMPRESSION_BUF_SIZE);
+        return -1;
+    }
+    cmd->data = inflate_buf;
+    cmd->data_len = (uint16_t)len;
+    return 0;
+}
+
+/* The sizing pass only needs out_len, which the encoder counts itself */
+static int compress_discard(const uint8_t *data, size_t len, void *ctx)
+{
+    return 0;
+}
+
+static int compress_to_stream(const uint8_t *data, size_t len, void *ctx)
+{
+    return streaming_write(ctx, data, len);
+}
+
+/* Size of a response's data once compressed, header included, or 0 to send
+ * it as it is: it is not in memory (compressing it would take two more
+ * handler passes), the central cannot expand it, it is too small, or it
+ * would not shrink */
+static size_t response_compressed_size(struct link_ctx *link, const uint8_t *encoded,
+                                       size_t pb_size)
+{
+    if (!encoded || pb_size < CONFIG_BLERPC_COMPRESSION_MIN_SIZE ||
+        pb_size > link->inflate_limit) {
+        return 0;
+    }
+    blerpc_compress_begin(&response_compress, compress_discard, NULL);
+    blerpc_compress_write(&response_compress, encoded, pb_size);
+    if (blerpc_compress_finish(&response_compress) != 0) {
+        LOG_WRN("Compression sizing pass failed, sending uncompressed");
+        return 0;
+    }
+    size_t size = BLERPC_COMPRESS_HEADER_SIZE + response_compress.out_len;
+    return size < pb_size ? size : 0;
+}
+
+/* Write the compressed data sized by response_compressed_size(), from the
+ * same bytes, so it comes out the same length. It goes through
+ * streaming_write(), so it is encrypted after compression. */
+static int response_write_compressed(struct streaming_ctx *sctx, const uint8_t *encoded,
+                                     size_t pb_size)
+{
+    uint8_t raw_len[BLERPC_COMPRESS_HEADER_SIZE] = {
+        (uint8_t)(pb_size & 0xFF),
+        (uint8_t)(pb_size >> 8),
+    };
+    streaming_write(sctx, raw_len, sizeof(raw_len));
+
+    blerpc_compress_begin(&response_compress, compress_to_stream, sctx);
+    blerpc_compress_write(&response_compress, encoded, pb_size);
+    if (blerpc_compress_finish(&response_compress) != 0) {
+        LOG_ERR("Compressed response encode failed");
+        return -1;
+    }
+    return 0;
+}
+#endif /* CONFIG_BLERPC_COMPRESSION */
+
+static void process_request(struct link_ctx *link, const uint8_t *data, size_t len,
+                            uint8_t transaction_id)
+{
+    /* Parse command */
+    struct command_packet cmd;
+    if (command_parse(data, len, &cmd) != 0) {
+        LOG_ERR("Command parse failed");
         return;
     }
+
+    if (cmd.cmd_type != COMMAND_TYPE_REQUEST) {
+        LOG_ERR("Expected request, got type %d", cmd.cmd_type);
+        return;
+    }
+
+    if (data[0] & COMMAND_FLAG_COMPRESSED) {
+#ifdef CONFIG_BLERPC_COMPRESSION
+        if (request_inflate(&cmd) != 0) {
+            return;
+        }
+#else
+        LOG_ERR("Compressed request, but compression is disabled");
+        return;
 #endif
+    }
 
-    struct streaming_ctx sctx = {
-        .transaction_id = transaction_id,
-        .mtu = mtu,
-        .total_length = (uint16_t)total_length,
-    };
+    if ((data[0] & COMMAND_FLAG_BATCH) && cmd.cmd_name_len > 0) {
+        process_stream_frame(data, &cmd);
+        return;
+    }
+#if CONFIG_BLERPC_BATCH_MAX_COMMANDS > 0
+    if (data[0] & COMMAND_FLAG_BATCH) {
+        process_batch(link, &cmd, transaction_id);
+        return;
+    }
+#endif
+
+    const struct handler_entry *entry = request_handler(data, &cmd);
+    if (!entry) {
+        return;
+    }
+    blerpc_stats_request_command(entry);
+
+    uint8_t cmd_hdr[CMD_HEADER_MAX_SIZE];
+    size_t cmd_hdr_size = response_header(cmd_hdr, data, &cmd);
+    if (cmd_hdr_size == 0) {
+        return;
+    }
+    size_t dl_offset = cmd_hdr_size - 2;
+
+    /* Bounded responses that fit the single-pass buffer are encoded once and
+     * the result streamed out; others need a sizing pass first so the FIRST
+     * container can carry total_length. Cached responses skip the handler. */
+    const uint8_t *encoded;
+    size_t pb_size;
+    enum resp_source src;
+    uint32_t phase_start = blerpc_stats_now();
+    int handler_rc = response_encode(entry, &cmd, SINGLE_PASS_BUF_AT(0),
+                                     CONFIG_BLERPC_SINGLE_PASS_BUF_SIZE, &encoded, &pb_size, &src);
+    blerpc_stats_request_phase(BLERPC_STATS_PHASE_HANDLER, phase_start);
+    if (handler_rc == -2) {
+        /* Handler manages its own response (e.g. stream handlers) */
+        return;
+    }
+    if (handler_rc != 0) {
+        blerpc_stats_request_fail();
+        return;
+    }
+
+    size_t data_len = pb_size;
+#ifdef CONFIG_BLERPC_COMPRESSION
+    size_t z_size = response_compressed_size(link, encoded, pb_size);
+    if (z_size > 0) {
+        cmd_hdr[0] |= COMMAND_FLAG_COMPRESSED;
+        data_len = z_size;
+    }
+#endif
+
+    size_t total_length = cmd_hdr_size + data_len;
+    if (response_too_large(link, transaction_id, total_length)) {
+        return;
+    }
+    cmd_hdr[dl_offset] = (uint8_t)(data_len & 0xFF);
+    cmd_hdr[dl_offset + 1] = (uint8_t)((data_len >> 8) & 0xFF);
+
+    phase_start = blerpc_stats_now();
+    struct streaming_ctx sctx;
+    if (streaming_begin(&sctx, link, transaction_id, total_length) != 0) {
+        streaming_abort(&sctx);
+        blerpc_stats_request_fail();
+        return;
+    }
 
     /* Write command header into container stream */
     streaming_write(&sctx, cmd_hdr, cmd_hdr_size);
 
-    /* Pass 2: Encode protobuf directly into container stream */
-    pb_ostream_t ostream = {
-        .callback = streaming_pb_callback,
-        .state = &sctx,
-        .max_size = SIZE_MAX,
-        .bytes_written = 0,
-    };
+#ifdef CONFIG_BLERPC_COMPRESSION
+    if (z_size > 0) {
+        if (response_write_compressed(&sctx, encoded, pb_size) != 0) {
+            streaming_abort(&sctx);
+            blerpc_stats_request_fail();
+            return;
+        }
+    } else
+#endif
+    if (encoded) {
+        streaming_write(&sctx, encoded, pb_size);
+    } else if (response_write_pass(&sctx, entry, &cmd, pb_size) != 0) {
+        streaming_abort(&sctx);
+        blerpc_stats_request_fail();
+        return;
+    }
+
+    int rc = streaming_end(&sctx);
+    blerpc_stats_request_phase(BLERPC_STATS_PHASE_SEND, phase_start);
+    if (rc < 0) {
+        LOG_ERR("Streaming send failed: %d", rc);
+        blerpc_stats_request_fail();
+    }
+}
+
+#ifdef CONFIG_BLERPC_INCREMENTAL_DECODE
+/* ── Incremental request decode ──────────────────────────────────────── */
+
+enum incremental_state {
+    INCREMENTAL_IDLE,
+    INCREMENTAL_ACTIVE,   /* containers are queued for the work queue */
+    INCREMENTAL_DRAINING, /* decode ended early; drop the rest of the request */
+};
+
+/* The one request being decoded while its containers arrive. The BT RX
+ * thread queues each SUBSEQUENT payload on chunks as its own request queue
+ * entry; the work queue pulls them through a pb_istream_t and frees each
+ * one once consumed, so the ring only ever holds what is still unread. */
+struct incremental_rx {
+    struct k_spinlock lock;
+    enum incremental_state state;
+    struct link_ctx *link;
+    int64_t last_activity;
+    uint16_t rx_left; /* payload bytes still to arrive */
+    uint8_t transaction_id;
+    uint8_t expected_seq;
+    bool failed; /* a container was lost or had no room */
+    struct k_fifo chunks;
+    /* Work queue side: the entry being read, starting with the FIRST one */
+    struct request_entry *chunk;
+    const uint8_t *read_ptr;
+    size_t read_left;
+};
+
+static struct incremental_rx inc_rx;
+
+/* Mark the decode failed and wake the work queue if it waits for a chunk.
+ * Called with inc_rx.lock held. */
+static void incremental_fail_locked(void)
+{
+    inc_rx.failed = true;
+    k_fifo_cancel_wait(&inc_rx.chunks);
+}
+
+/* Claim the decoder for a FIRST container that starts a multi-container
+ * request to a command with an istream handler and a response bound that
+ * fits single_pass_buf. The container is queued like a complete request.
+ * @return true if the container was consumed */
+static bool incremental_begin(struct link_ctx *link, const struct container_header *hdr)
+{
+    const uint8_t *p = hdr->payload;
+
+    if (hdr->total_length <= hdr->payload_len ||
+        hdr->total_length > CONFIG_BLERPC_PROTOCOL_ASSEMBLER_BUF_SIZE) {
+        return false;
+    }
+    if (hdr->payload_len < 4 || hdr->payload_len < 4 + (size_t)p[1]) {
+        return false;
+    }
+    if (((p[0] >> 7) & 0x01) != COMMAND_TYPE_REQUEST ||
+        (p[0] & (COMMAND_FLAG_BATCH | COMMAND_FLAG_COMPRESSED))) {
+        return false;
+    }
+    uint8_t name_len = p[1];
+    size_t data_len = p[2 + name_len] | (p[3 + name_len] << 8);
+    if (4 + name_len + data_len != hdr->total_length) {
+        return false;
+    }
+
+    const struct handler_entry *entry;
+    if (p[0] & COMMAND_FLAG_ID) {
+        entry = name_len == 1 ? handlers_find_id(p[2]) : NULL;
+    } else {
+        entry = handlers_find((const char *)p + 2, name_len);
+    }
+    if (!entry || !entry->istream_handler || entry->max_resp_size == 0 ||
+        entry->max_resp_size > sizeof(single_pass_buf)) {
+        return false;
+    }
+
+    int64_t now = k_uptime_get();
+    k_spinlock_key_t key = k_spin_lock(&inc_rx.lock);
+    if (inc_rx.state == INCREMENTAL_DRAINING &&
+        (now - inc_rx.last_activity > CONFIG_BLERPC_ASSEMBLER_TIMEOUT_MS ||
+         (inc_rx.link == link && inc_rx.transaction_id == hdr->transaction_id))) {
+        inc_rx.state = INCREMENTAL_IDLE;
+    }
+    if (inc_rx.state != INCREMENTAL_IDLE) {
+        k_spin_unlock(&inc_rx.lock, key);
+        return false;
+    }
+
+    struct request_entry *req = request_queue_alloc(&request_queue, hdr->payload_len);
+    if (!req) {
+        /* Full reassembly reports BUSY */
+        k_spin_unlock(&inc_rx.lock, key);
+        return false;
+    }
+    memcpy(req->data, p, hdr->payload_len);
+    req->transaction_id = hdr->transaction_id;
+    req->streamed = true;
+
+    inc_rx.state = INCREMENTAL_ACTIVE;
+    inc_rx.link = link;
+    inc_rx.last_activity = now;
+    inc_rx.rx_left = hdr->total_length - hdr->payload_len;
+    inc_rx.transaction_id = hdr->transaction_id;
+    inc_rx.expected_seq = hdr->sequence_number + 1;
+    inc_rx.failed = false;
+    k_spin_unlock(&inc_rx.lock, key);
+
+    k_fifo_put(&link->request_fifo, req);
+    power_request_queued(link);
+    k_work_submit_to_queue(&blerpc_work_q, &request_work);
+    return true;
+}
+
+/* Route a container to the incremental decode. Runs on the BT RX thread.
+ * @return true if the container was consumed */
+static bool incremental_feed(struct link_ctx *link, const struct container_header *hdr)
+{
+    if (hdr->type == CONTAINER_TYPE_FIRST) {
+        return incremental_begin(link, hdr);
+    }
+
+    bool busy = false;
+    k_spinlock_key_t key = k_spin_lock(&inc_rx.lock);
+    if (inc_rx.state == INCREMENTAL_IDLE || inc_rx.link != link ||
+        inc_rx.transaction_id != hdr->transaction_id) {
+        k_spin_unlock(&inc_rx.lock, key);
+        return false;
+    }
+
+    inc_rx.last_activity = k_uptime_get();
+    if (inc_rx.state == INCREMENTAL_ACTIVE && !inc_rx.failed) {
+        struct request_entry *chunk = NULL;
+        if (hdr->sequence_number != inc_rx.expected_seq) {
+            LOG_WRN("Sequence gap (tid=%u): expected %u, got %u", hdr->transaction_id,
+                    inc_rx.expected_seq, hdr->sequence_number);
+        } else if (hdr->payload_len > inc_rx.rx_left) {
+            LOG_WRN("Container overruns request length (tid=%u)", hdr->transaction_id);
+        } else {
+            chunk = request_queue_alloc(&request_queue, hdr->payload_len);
+            busy = !chunk;
+        }
+        if (chunk) {
+            memcpy(chunk->data, hdr->payload, hdr->payload_len);
+            k_fifo_put(&inc_rx.chunks, chunk);
+        } else {
+            incremental_fail_locked();
+        }
+    }
+    inc_rx.expected_seq = hdr->sequence_number + 1;
+    inc_rx.rx_left -= MIN(hdr->payload_len, inc_rx.rx_left);
+    if (inc_rx.state == INCREMENTAL_DRAINING && inc_rx.rx_left == 0) {
+        inc_rx.state = INCREMENTAL_IDLE;
+    }
+    k_spin_unlock(&inc_rx.lock, key);
+
+    if (busy) {
+        LOG_WRN("Request queue full, sending BUSY error");
+        send_busy_error(link, hdr->transaction_id, true);
+    }
+    return true;
+}
+
+/* Abort the decode of a link being reset */
+static void incremental_link_reset(struct link_ctx *link)
+{
+    k_spinlock_key_t key = k_spin_lock(&inc_rx.lock);
+    if (inc_rx.state != INCREMENTAL_IDLE && inc_rx.link == link) {
+        inc_rx.rx_left = 0;
+        incremental_fail_locked();
+    }
+    k_spin_unlock(&inc_rx.lock, key);
+}
+
+/* End the decode and release every chunk it still holds. Also called for a
+ * FIRST entry dropped before the work queue took it. */
+static void incremental_finish(void)
+{
+    struct request_entry *chunk;
+
+    k_spinlock_key_t key = k_spin_lock(&inc_rx.lock);
+    inc_rx.state = inc_rx.rx_left > 0 ? INCREMENTAL_DRAINING : INCREMENTAL_IDLE;
+    k_spin_unlock(&inc_rx.lock, key);
+
+    if (inc_rx.chunk) {
+        request_queue_free(&request_queue, inc_rx.chunk);
+        inc_rx.chunk = NULL;
+    }
+    while ((chunk = k_fifo_get(&inc_rx.chunks, K_NO_WAIT)) != NULL) {
+        request_queue_free(&request_queue, chunk);
+    }
+}
+
+static bool incremental_read(pb_istream_t *stream, uint8_t *buf, size_t count)
+{
+    struct incremental_rx *rx = stream->state;
+
+    while (count > 0) {
+        if (rx->read_left == 0) {
+            if (rx->chunk) {
+                request_queue_free(&request_queue, rx->chunk);
+                rx->chunk = NULL;
+            }
+            k_spinlock_key_t key = k_spin_lock(&rx->lock);
+            bool failed = rx->failed;
+            k_spin_unlock(&rx->lock, key);
+            if (failed) {
+                return false;
+            }
+            rx->chunk = k_fifo_get(&rx->chunks, K_MSEC(CONFIG_BLERPC_ASSEMBLER_TIMEOUT_MS));
+            if (!rx->chunk) {
+                LOG_WRN("Incremental request stalled (tid=%u)", rx->transaction_id);
+                return false;
+            }
+            rx->read_ptr = rx->chunk->data;
+            rx->read_left = rx->chunk->len;
+        }
+        size_t n = MIN(count, rx->read_left);
+        memcpy(buf, rx->read_ptr, n);
+        buf += n;
+        count -= n;
+        rx->read_ptr += n;
+        rx->read_left -= n;
+    }
+    return true;
+}
+
+/* Run a request queued by incremental_begin(). The handler decodes while
+ * the rest of the request is still arriving; req, which holds the command
+ * header and the first bytes of data, is freed once read like any chunk. */
+static void process_incremental(struct link_ctx *link, struct request_entry *req)
+{
+    const uint8_t *data = req->data;
+    uint8_t transaction_id = req->transaction_id;
+    struct command_packet cmd = {
+        .cmd_type = COMMAND_TYPE_REQUEST,
+        .cmd_name_len = data[1],
+        .cmd_name = (const char *)data + 2,
+        .data_len = data[2 + data[1]] | (data[3 + data[1]] << 8),
+    };
+    uint8_t cmd_hdr[CMD_HEADER_MAX_SIZE];
+    const struct handler_entry *entry = request_handler(data, &cmd);
+    size_t cmd_hdr_size = response_header(cmd_hdr, data, &cmd);
+
+    inc_rx.chunk = req;
+    inc_rx.read_ptr = data + 4 + cmd.cmd_name_len;
+    inc_rx.read_left = req->len - 4 - cmd.cmd_name_len;
+    if (!link->conn || !entry || cmd_hdr_size == 0) {
+        incremental_finish();
+        return;
+    }
+
+    pb_istream_t istream = {
+        .callback = incremental_read,
+        .state = &inc_rx,
+        .bytes_left = cmd.data_len,
+    };
+    pb_ostream_t ostream = pb_ostream_from_buffer(single_pass_buf, sizeof(single_pass_buf));
+    int handler_rc = entry->istream_handler(&istream, &ostream);
+    bool consumed = istream.bytes_left == 0;
+    incremental_finish();
+    if (handler_rc != 0 || !consumed) {
+        LOG_ERR("Incremental handler failed: %d", handler_rc);
+        return;
+    }
+
+    size_t pb_size = ostream.bytes_written;
+    size_t total_length = cmd_hdr_size + pb_size;
+    if (response_too_large(link, transaction_id, total_length)) {
+        return;
+    }
+    cmd_hdr[cmd_hdr_size - 2] = (uint8_t)(pb_size & 0xFF);
+    cmd_hdr[cmd_hdr_size - 1] = (uint8_t)((pb_size >> 8) & 0xFF);
+
+    struct streaming_ctx sctx;
+    if (streaming_begin(&sctx, link, transaction_id, total_length) != 0) {
+        streaming_abort(&sctx);
+        return;
+    }
+    streaming_write(&sctx, cmd_hdr, cmd_hdr_size);
+    streaming_write(&sctx, single_pass_buf, pb_size);
+
+    int rc = streaming_end(&sctx);
+    if (rc < 0) {
+        LOG_ERR("Streaming send failed: %d", rc);
+    }
+}
+#endif /* CONFIG_BLERPC_INCREMENTAL_DECODE */
+
+/* ── P→C stream engine ───────────────────────────────────────────────── */
+
+/* Batch response header: type | COMMAND_FLAG_BATCH, empty name, data_len */
+#define STREAM_BATCH_HEADER_SIZE 4
+BUILD_ASSERT(BLE_SERVICE_STREAM_MSG_OVERHEAD(0) == STREAM_BATCH_HEADER_SIZE + 4,
+             "BLE_SERVICE_STREAM_MSG_OVERHEAD must match the frame layout");
+
+/* Bytes a coalesced frame may grow to: one container's payload */
+static size_t stream_frame_limit(struct link_ctx *link)
+{
+    size_t overhead =
+        CONTAINER_ATT_OVERHEAD + CONTAINER_FIRST_HEADER_SIZE + streaming_overhead(link);
+    size_t mtu = ble_service_get_mtu(link->conn);
+    return mtu > overhead ? MIN(mtu - overhead, CONFIG_BLERPC_STREAM_BUF_SIZE) : 0;
+}
+
+/* Send the frame in tx_buf as one response transaction. If none of it went
+ * out the frame is kept for the next attempt; once a container is on the
+ * air the central holds a partial transaction, so resending the frame under
+ * a new tid would deliver its messages twice and the stream is aborted.
+ * @return 0, -EAGAIN to retry, -ENOTCONN, or -EIO after a partial send */
+static int stream_flush(struct link_ctx *link, struct p2c_stream *st)
+{
+    if (st->frame_count == 0) {
+        return 0;
+    }
+
+    const uint8_t *frame = st->tx_buf;
+    size_t len = st->frame_len;
+    if (st->coalesce && st->frame_count == 1) {
+        /* A lone message goes out as a plain response */
+        frame += STREAM_BATCH_HEADER_SIZE;
+        len -= STREAM_BATCH_HEADER_SIZE;
+    } else if (st->coalesce) {
+        size_t body_len = len - STREAM_BATCH_HEADER_SIZE;
+        st->tx_buf[0] = ((COMMAND_TYPE_RESPONSE & 0x01) << 7) | COMMAND_FLAG_BATCH;
+        st->tx_buf[1] = 0;
+        st->tx_buf[2] = (uint8_t)(body_len & 0xFF);
+        st->tx_buf[3] = (uint8_t)(body_len >> 8);
+    }
+
+    struct streaming_ctx sctx;
+    uint8_t tid = ble_service_next_transaction_id(link->conn);
+    int rc = streaming_begin(&sctx, link, tid, len);
+    if (rc == 0) {
+        streaming_write(&sctx, frame, len);
+        rc = streaming_end(&sctx);
+    } else {
+        streaming_abort(&sctx);
+    }
+    if (rc == -ENOTCONN) {
+        return rc;
+    }
+    if (rc != 0 && sctx.first_sent) {
+        LOG_ERR("Stream frame cut off after %u containers: %d", sctx.seq, rc);
+        return -EIO;
+    }
+    if (rc != 0) {
+        return -EAGAIN;
+    }
+    if (st->credit_flow) {
+        atomic_sub(&st->credits, st->frame_count);
+    }
+    st->frame_len = 0;
+    st->frame_count = 0;
+    st->last_progress = k_uptime_get();
+    return 0;
+}
+
+/* Encode the next message into the frame.
+ * @return 0 on success, -ENOSPC if it only fits an empty frame, -ENODATA
+ *         past the last message, other negative if it cannot be sent */
+static int stream_append(struct link_ctx *link, struct p2c_stream *st)
+{
+    const struct ble_service_p2c_stream *d = &st->desc;
+    size_t hdr_size = 2 + d->cmd_name_len + 2;
+    size_t start = st->frame_len;
+    size_t limit = CONFIG_BLERPC_STREAM_BUF_SIZE;
+
+    if (st->coalesce && st->frame_count == 0) {
+        start = STREAM_BATCH_HEADER_SIZE;
+    } else if (st->coalesce) {
+        limit = stream_frame_limit(link);
+    }
+    if (start + hdr_size >= limit) {
+        return st->frame_count > 0 ? -ENOSPC : -EMSGSIZE;
+    }
+
+    uint8_t *p = st->tx_buf + start;
+    pb_ostream_t ostream = pb_ostream_from_buffer(p + hdr_size, limit - start - hdr_size);
+    int rc = d->next(d->ctx, st->index, &ostream);
+    if (rc == -ENODATA) {
+        return rc;
+    }
+    if (rc != 0) {
+        if (st->frame_count > 0) {
+            return -ENOSPC;
+        }
+        LOG_ERR("Stream message %u failed: %d", st->index, rc);
+        return rc;
+    }
+
+    size_t data_len = ostream.bytes_written;
+    p[0] = (COMMAND_TYPE_RESPONSE & 0x01) << 7;
+    p[1] = d->cmd_name_len;
+    memcpy(p + 2, d->cmd_name, d->cmd_name_len);
+    p[hdr_size - 2] = (uint8_t)(data_len & 0xFF);
+    p[hdr_size - 1] = (uint8_t)(data_len >> 8);
+    st->frame_len = (uint16_t)(start + hdr_size + data_len);
+    st->frame_count++;
+    st->index++;
+    return 0;
+}
+
+/* Send up to CONFIG_BLERPC_STREAM_BURST messages.
+ * @return 0 if more remain, 1 once the last is sent, -EAGAIN when out of
+ *         credits or TX buffers, other negative to abort */
+static int stream_burst(struct link_ctx *link, struct p2c_stream *st)
+{
+    int rc = stream_flush(link, st);
+    if (rc != 0) {
+        return rc;
+    }
+
+    for (int n = 0; n < CONFIG_BLERPC_STREAM_BURST; n++) {
+        if (st->credit_flow && atomic_get(&st->credits) <= st->frame_count) {
+            rc = stream_flush(link, st);
+            return rc != 0 ? rc : -EAGAIN;
+        }
+        rc = stream_append(link, st);
+        if (rc == -ENOSPC) {
+            rc = stream_flush(link, st);
+            if (rc == 0) {
+                rc = stream_append(link, st);
+            }
+        }
+        if (rc == -ENODATA) {
+            rc = stream_flush(link, st);
+            return rc != 0 ? rc : 1;
+        }
+        if (rc != 0) {
+            return rc;
+        }
+        if (!st->coalesce) {
+            rc = stream_flush(link, st);
+            if (rc != 0) {
+                return rc;
+            }
+        }
+    }
+    return stream_flush(link, st);
+}
+
+static void stream_stop(struct p2c_stream *st)
+{
+    st->active = false;
+    st->frame_len = 0;
+    st->frame_count = 0;
+    /* Grants for the next stream arrive only after its request */
+    atomic_clear(&st->credits);
+}
+
+static void stream_work_handler(struct k_work *work)
+{
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct p2c_stream *st = CONTAINER_OF(dwork, struct p2c_stream, work);
+    struct link_ctx *link = CONTAINER_OF(st, struct link_ctx, stream);
+
+    if (!st->active || !link->conn) {
+        return;
+    }
+
+    active_link = link;
+    int rc = stream_burst(link, st);
+    active_link = NULL;
+
+    if (rc == 0) {
+        k_work_schedule_for_queue(&blerpc_work_q, &st->work,
+                                  K_MSEC(CONFIG_BLERPC_STREAM_INTERVAL_MS));
+        return;
+    }
+    if (rc == 1) {
+        stream_stop(st);
+        power_settle(link);
+        ble_service_send_stream_end_p2c(link->conn, ble_service_next_transaction_id(link->conn));
+        return;
+    }
+    if (rc == -EAGAIN) {
+        /* A grant reschedules us at once; otherwise retry until the stall
+         * timeout, waiting for credits or for TX buffers to free up */
+        int64_t idle = k_uptime_get() - st->last_progress;
+        if (idle < CONFIG_BLERPC_STREAM_STALL_TIMEOUT_MS) {
+            bool no_credit = st->credit_flow && atomic_get(&st->credits) <= 0;
+            k_timeout_t delay =
+                no_credit ? K_MSEC(CONFIG_BLERPC_STREAM_STALL_TIMEOUT_MS - idle) : K_TICKS(1);
+            k_work_schedule_for_queue(&blerpc_work_q, &st->work, delay);
+            return;
+        }
+        LOG_WRN("Stream stalled for %lld ms, aborting", (long long)idle);
+    } else {
+        LOG_ERR("Stream aborted: %d", rc);
+    }
+    stream_stop(st);
+    power_settle(link);
+    if (rc != -ENOTCONN) {
+        send_busy_error(link, ble_service_next_transaction_id(link->conn), false);
+    }
+}
+
+/* CONTROL_CMD_STREAM_CREDIT, on the BT RX thread */
+static void stream_credit_grant(struct link_ctx *link, const uint8_t *payload, size_t len)
+{
+    struct p2c_stream *st = &link->stream;
+
+    if (len < 2) {
+        return;
+    }
+    st->want_coalesce = len >= 3 && (payload[2] & STREAM_CREDIT_FLAG_COALESCE);
+    st->credit_flow = true;
+    atomic_add(&st->credits, payload[0] | (payload[1] << 8));
+    if (st->active) {
+        k_work_reschedule_for_queue(&blerpc_work_q, &st->work, K_NO_WAIT);
+    }
+}
+
+static void stream_link_reset(struct link_ctx *link)
+{
+    struct p2c_stream *st = &link->stream;
+    struct k_work_sync sync;
+
+    k_work_cancel_delayable_sync(&st->work, &sync);
+    stream_stop(st);
+    st->credit_flow = false;
+    st->want_coalesce = false;
+}
+
+int ble_service_stream_p2c_start(struct bt_conn *conn, const struct ble_service_p2c_stream *stream)
+{
+    struct link_ctx *link = link_get(conn);
+    if (!link) {
+        return -ENOTCONN;
+    }
+    struct p2c_stream *st = &link->stream;
+    if (st->active) {
+        return -EBUSY;
+    }
+
+    st->desc = *stream;
+    st->coalesce = st->want_coalesce;
+    st->index = 0;
+    st->frame_len = 0;
+    st->frame_count = 0;
+    st->last_progress = k_uptime_get();
+    st->active = true;
+    power_demand(link);
+    k_work_schedule_for_queue(&blerpc_work_q, &st->work, K_NO_WAIT);
+    return 0;
+}
+
+/* Serve one request per link per round, so a link with a deep backlog
+ * cannot starve the others */
+static void request_work_handler(struct k_work *work)
+{
+    (void)work;
+    static size_t next_link;
+    bool served = true;
+
+    while (served) {
+        served = false;
+        for (size_t n = 0; n < ARRAY_SIZE(links); n++) {
+            struct link_ctx *link = &links[(next_link + n) % ARRAY_SIZE(links)];
+            struct request_entry *req = k_fifo_get(&link->request_fifo, K_NO_WAIT);
+            if (!req) {
+                continue;
+            }
+#ifdef CONFIG_BLERPC_INCREMENTAL_DECODE
+            if (req->streamed) {
+                /* Takes ownership: req is freed as the decode consumes it */
+                active_link = link;
+                process_incremental(link, req);
+                active_link = NULL;
+                power_request_done(link);
+                served = true;
+                continue;
+            }
+#endif
+            if (link->conn) {
+                active_link = link;
+                blerpc_stats_request_begin(req);
+                process_request(link, req->data, req->len, req->transaction_id);
+                blerpc_stats_request_end();
+                active_link = NULL;
+            }
+            request_queue_free(&request_queue, req);
+            power_request_done(link);
+            served = true;
+        }
+        next_link = (next_link + 1) % ARRAY_SIZE(links);
+    }
+}
+
+/* Capabilities payload: max_request(2) max_response(2) flags(2), then the
+ * link's radio parameters: tx_phy(1) rx_phy(1) tx_max_len(2) rx_max_len(2)
+ * interval(2) latency(2) timeout(2), then the bulk channel psm(2) (0 when
+ * CAPABILITY_FLAG_L2CAP_SUPPORTED is clear), the command ID schema hash(2)
+ * and the largest request data decompressed(2) (0 when
+ * CAPABILITY_FLAG_COMPRESSION is clear), all little-endian. Centrals that
+ * only know a shorter form ignore the tail. */
+#define CAPS_PAYLOAD_SIZE 24
+
+static void put_le16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)(v & 0xFF);
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void caps_put_link_params(uint8_t *p, const struct ble_service_link_params *params)
+{
+    p[0] = params->tx_phy;
+    p[1] = params->rx_phy;
+    put_le16(p + 2, params->tx_max_len);
+    put_le16(p + 4, params->rx_max_len);
+    put_le16(p + 6, params->interval);
+    put_le16(p + 8, params->latency);
+    put_le16(p + 10, params->timeout);
+}
+
+/* Largest request payload reported to the central via capabilities */
+static uint16_t max_request_payload_size(void)
+{
+    size_t max = MIN(CONFIG_BLERPC_PROTOCOL_ASSEMBLER_BUF_SIZE,
+                     request_queue_max_len(&request_queue));
+#ifdef CONFIG_BLERPC_ENCRYPTION
+    /* Ciphertext and plaintext entries coexist while decrypting */
+    size_t pair = (request_queue_max_len(&request_queue) - sizeof(struct request_entry)) / 2;
+    max = MIN(max, pair - BLERPC_ENCRYPTED_OVERHEAD);
+#endif
+    return (uint16_t)MIN(max, UINT16_MAX);
+}
+
+/* ── Reassembly pool ─────────────────────────────────────────────────── */
+
+static void assembler_slot_release(struct assembler_slot *slot)
+{
+    if (slot->entry) {
+        /* Completed requests are detached from their slot first */
+        BLERPC_STATS_INC(assembler_resets);
+        request_queue_free(&request_queue, slot->entry);
+        slot->entry = NULL;
+    }
+    slot->active = false;
+}
+
+/* Append one container to the slot's request entry.
+ * @return 1 when the request is complete, 0 if more containers are needed,
+ *         -ENOMEM if the request queue has no room, -1 on protocol error */
+static int assembler_slot_feed(struct assembler_slot *slot, const struct container_header *hdr)
+{
+    if (hdr->type == CONTAINER_TYPE_FIRST) {
+        if (slot->entry) {
+            request_queue_free(&request_queue, slot->entry);
+            slot->entry = NULL;
+        }
+        if (hdr->total_length > CONFIG_BLERPC_PROTOCOL_ASSEMBLER_BUF_SIZE) {
+            LOG_ERR("Request too large: %u", hdr->total_length);
+            return -1;
+        }
+        slot->entry = request_queue_alloc(&request_queue, hdr->total_length);
+        if (!slot->entry) {
+            return -ENOMEM;
+        }
+        BLERPC_STATS_STAMP(slot->entry->stats_first);
+        slot->received = 0;
+        slot->expected_seq = hdr->sequence_number;
+    } else if (!slot->entry) {
+        return -1;
+    }
+
+    if (hdr->sequence_number != slot->expected_seq) {
+        LOG_WRN("Sequence gap (tid=%u): expected %u, got %u", slot->transaction_id,
+                slot->expected_seq, hdr->sequence_number);
+        return -1;
+    }
+    if (hdr->payload_len > slot->entry->len - slot->received) {
+        LOG_WRN("Container overruns request length (tid=%u)", slot->transaction_id);
+        return -1;
+    }
+
+    memcpy(slot->entry->data + slot->received, hdr->payload, hdr->payload_len);
+    slot->received += hdr->payload_len;
+    slot->expected_seq++;
+    return slot->received == slot->entry->len ? 1 : 0;
+}
+
+static void assembler_pool_reset(struct link_ctx *link)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(link->assembler_pool); i++) {
+        assembler_slot_release(&link->assembler_pool[i]);
+    }
+}
+
+/* Find link's assembler for hdr's transaction. A FIRST container claims a free
+ * slot, evicting the least recently used one if the pool is full;
+ * SUBSEQUENT containers only match an existing slot. Slots idle longer than
+ * CONFIG_BLERPC_ASSEMBLER_TIMEOUT_MS are reclaimed. */
+static struct assembler_slot *assembler_pool_get(struct link_ctx *link,
+                                                 const struct container_header *hdr)
+{
+    int64_t now = k_uptime_get();
+    struct assembler_slot *free_slot = NULL;
+    struct assembler_slot *lru = NULL;
+
+    for (size_t i = 0; i < ARRAY_SIZE(link->assembler_pool); i++) {
+        struct assembler_slot *slot = &link->assembler_pool[i];
+
+        if (slot->active && now - slot->last_activity > CONFIG_BLERPC_ASSEMBLER_TIMEOUT_MS) {
+            LOG_WRN("Reassembly timed out (tid=%u)", slot->transaction_id);
+            assembler_slot_release(slot);
+        }
+
+        if (!slot->active) {
+            if (!free_slot) {
+                free_slot = slot;
+            }
+            continue;
+        }
+
+        if (slot->transaction_id == hdr->transaction_id) {
+            slot->last_activity = now;
+            return slot;
+        }
+
+        if (!lru || slot->last_activity < lru->last_activity) {
+            lru = slot;
+        }
+    }
+
+    if (hdr->type != CONTAINER_TYPE_FIRST) {
+        LOG_DBG("No reassembly in progress for tid=%u", hdr->transaction_id);
+        return NULL;
+    }
+
+    if (!free_slot) {
+        LOG_WRN("Reassembly pool full, evicting tid=%u", lru->transaction_id);
+        assembler_slot_release(lru);
+        free_slot = lru;
+    }
+
+    free_slot->transaction_id = hdr->transaction_id;
+    free_slot->last_activity = now;
+    free_slot->active = true;
+    return free_slot;
+}
+
+#ifdef CONFIG_BLERPC_STATS
+/* Answer CONTROL_CMD_STATS with the requested page, cut to one container */
+static void send_stats_page(struct link_ctx *link, const struct container_header *hdr)
+{
+    uint8_t ctrl_buf[CONTAINER_CONTROL_HEADER_SIZE + UINT8_MAX];
+    uint8_t payload[UINT8_MAX];
+    size_t room = ble_service_get_mtu(link->conn) - CONTAINER_ATT_OVERHEAD -
+                  CONTAINER_CONTROL_HEADER_SIZE;
+    uint8_t page = hdr->payload_len >= 1 ? hdr->payload[0] : 0;
+    struct container_header ctrl = {
+        .transaction_id = hdr->transaction_id,
+        .sequence_number = 0,
+        .type = CONTAINER_TYPE_CONTROL,
+        .control_cmd = CONTROL_CMD_STATS,
+        .payload = payload,
+    };
+
+    ctrl.payload_len = blerpc_stats_page(page, payload, MIN(room, sizeof(payload)));
+    int n = container_serialize(&ctrl, ctrl_buf, sizeof(ctrl_buf));
+    if (n > 0) {
+        send_from_rx(link, ctrl_buf, (size_t)n);
+    }
+}
+#endif
+
+#ifdef CONFIG_BLERPC_RESUMPTION
+static void send_resume_reply(struct link_ctx *link, uint8_t transaction_id,
+                              const uint8_t *payload, size_t len)
+{
+    uint8_t ctrl_buf[CONTAINER_CONTROL_HEADER_SIZE + SESSION_RESUME_MAX_MSG_SIZE];
+    struct container_header ctrl = {
+        .transaction_id = transaction_id,
+        .sequence_number = 0,
+        .type = CONTAINER_TYPE_CONTROL,
+        .control_cmd = CONTROL_CMD_RESUME,
+        .payload_len = len,
+        .payload = payload,
+    };
+    int n = container_serialize(&ctrl, ctrl_buf, sizeof(ctrl_buf));
+    if (n > 0) {
+        send_from_rx(link, ctrl_buf, (size_t)n);
+    }
+}
+
+/* TICKET_REQUEST: the first ticket of a chain, for a fresh secret, sent
+ * encrypted under the session the full handshake just set up */
+static void resume_issue_ticket(struct link_ctx *link, uint8_t transaction_id)
+{
+    const uint8_t reject = SESSION_RESUME_OP_REJECT;
+
+    if (!link->encryption_active || !link->ticket_allowed) {
+        LOG_WRN("Ticket request rejected: not right after a key exchange");
+        send_resume_reply(link, transaction_id, &reject, 1);
+        return;
+    }
+    link->ticket_allowed = false;
+
+    uint32_t now = uptime_s();
+    uint8_t plain[SESSION_RESUME_SECRET_SIZE + SESSION_RESUME_TICKET_SIZE];
+    uint8_t msg[SESSION_RESUME_TICKET_MSG_SIZE];
+    size_t enc_len;
+    int rc = -1;
+
+    if (psa_generate_random(plain, SESSION_RESUME_SECRET_SIZE) == PSA_SUCCESS &&
+        session_resume_ticket_seal(&resume_tickets, now, plain, now,
+                                   CONFIG_BLERPC_RESUMPTION_MAX_COUNT,
+                                   plain + SESSION_RESUME_SECRET_SIZE) == 0) {
+        msg[0] = SESSION_RESUME_OP_TICKET;
+        rc = blerpc_crypto_session_encrypt(&link->crypto_session, msg + 1, sizeof(msg) - 1,
+                                           &enc_len, plain, sizeof(plain));
+    }
+    mbedtls_platform_zeroize(plain, sizeof(plain));
+    if (rc != 0) {
+        LOG_ERR("Failed to issue a resumption ticket");
+        send_resume_reply(link, transaction_id, &reject, 1);
+        return;
+    }
+    send_resume_reply(link, transaction_id, msg, 1 + enc_len);
+}
+
+/* HELLO: rekey from the central's ticket, or tell it to run a full key
+ * exchange */
+static void resume_accept(struct link_ctx *link, const struct container_header *hdr)
+{
+    uint8_t msg[SESSION_RESUME_ACCEPT_SIZE];
+    size_t msg_len = SESSION_RESUME_ACCEPT_MIN_SIZE;
+    uint8_t secret[SESSION_RESUME_SECRET_SIZE];
+    struct session_resume_keys keys;
+    uint32_t now = uptime_s();
+    uint32_t issued;
+    uint8_t uses_left;
+    int rc = -1;
+
+    /* Like a key exchange, resumption never replaces an active session */
+    if (!link->encryption_active && hdr->payload_len == SESSION_RESUME_HELLO_SIZE &&
+        session_resume_ticket_open(&resume_tickets, now, hdr->payload + 1, secret, &issued,
+                                   &uses_left) == 0) {
+        const uint8_t *nonce_c = hdr->payload + 1 + SESSION_RESUME_TICKET_SIZE;
+        uint8_t *nonce_p = msg + 1;
+
+        if (psa_generate_random(nonce_p, SESSION_RESUME_NONCE_SIZE) == PSA_SUCCESS &&
+            session_resume_derive(secret, nonce_c, nonce_p, &keys) == 0 &&
+            session_resume_start(&link->crypto_session, &keys, false) == 0) {
+            memcpy(nonce_p + SESSION_RESUME_NONCE_SIZE, keys.confirm,
+                   SESSION_RESUME_CONFIRM_SIZE);
+            /* The chain ends with its last resumption: no ticket follows */
+            if (uses_left > 1 &&
+                session_resume_ticket_seal(&resume_tickets, now, keys.next_secret, issued,
+                                           uses_left - 1, msg + msg_len) == 0) {
+                msg_len += SESSION_RESUME_TICKET_SIZE;
+            }
+            rc = 0;
+        }
+        mbedtls_platform_zeroize(secret, sizeof(secret));
+        mbedtls_platform_zeroize(&keys, sizeof(keys));
+    }
+
+    if (rc != 0) {
+        LOG_INF("Resumption refused");
+        msg[0] = SESSION_RESUME_OP_REJECT;
+        send_resume_reply(link, hdr->transaction_id, msg, 1);
+        return;
+    }
+    msg[0] = SESSION_RESUME_OP_ACCEPT;
+    link->encryption_active = true;
+    link->session_tentative = true;
+    send_resume_reply(link, hdr->transaction_id, msg, msg_len);
+    LOG_INF("E2E encryption resumed, %u resumptions left", (unsigned int)(uses_left - 1));
+}
+
+static void handle_resume(struct link_ctx *link, const struct container_header *hdr)
+{
+    uint8_t op = hdr->payload_len >= 1 ? hdr->payload[0] : 0;
+
+    if (op == SESSION_RESUME_OP_TICKET_REQUEST) {
+        resume_issue_ticket(link, hdr->transaction_id);
+    } else if (op == SESSION_RESUME_OP_HELLO) {
+        resume_accept(link, hdr);
+    } else {
+        LOG_WRN("Unknown resumption op 0x%02x", op);
+    }
+}
+#endif
+
+/* ── BLE service ─────────────────────────────────────────────────────── */
 
-    if (handler(cmd.data, cmd.data_len, &ostream) != 0) {
-        LOG_ERR("Handler encode pass failed");
+/* Queue a complete request payload, as received (still encrypted if the
+ * session is), for the work queue. Takes ownership of req. */
+static void request_enqueue(struct link_ctx *link, uint8_t transaction_id,
+                            struct request_entry *req)
+{
+#ifdef CONFIG_BLERPC_ENCRYPTION
+    if (!link->encryption_active) {
+        /* Reject unencrypted data when encryption is compiled in */
+        LOG_WRN("Rejecting unencrypted payload (encryption enabled but not active)");
+        request_queue_free(&request_queue, req);
+        return;
+    }
+    if (req->len < BLERPC_ENCRYPTED_OVERHEAD) {
+        LOG_ERR("Decryption failed");
+        BLERPC_STATS_INC(decrypt_failures);
+        request_queue_free(&request_queue, req);
         return;
     }
 
-    /* Flush last partial container */
-    streaming_flush_container(&sctx);
-
-    if (sctx.error) {
-        LOG_ERR("Streaming send failed: %d", sctx.error);
+    /* Decrypt straight into a second queue entry */
+    struct request_entry *plain =
+        request_queue_alloc(&request_queue, req->len - BLERPC_ENCRYPTED_OVERHEAD);
+    if (!plain) {
+        LOG_WRN("Request queue full, sending BUSY error");
+        send_busy_error(link, transaction_id, true);
+        request_queue_free(&request_queue, req);
+        return;
     }
-}
+    size_t decrypted_len;
+    uint32_t decrypt_start = blerpc_stats_now();
+    int drc = blerpc_crypto_session_decrypt(&link->crypto_session, plain->data, plain->len,
+                                            &decrypted_len, req->data, req->len);
+#ifdef CONFIG_BLERPC_STATS
+    plain->stats_first = req->stats_first;
+    plain->stats_decrypt_us = k_cyc_to_us_floor32(k_cycle_get_32() - decrypt_start);
+#else
+    (void)decrypt_start;
+#endif
+    request_queue_free(&request_queue, req);
+    if (drc != 0) {
+        LOG_ERR("Decryption failed");
+        BLERPC_STATS_INC(decrypt_failures);
+        request_queue_free(&request_queue, plain);
+        return;
+    }
+    plain->len = (uint16_t)decrypted_len;
+    req = plain;
+#ifdef CONFIG_BLERPC_RESUMPTION
+    /* The central derived the same keys: the resumption is settled */
+    link->session_tentative = false;
+#endif
+#endif
 
-static void request_work_handler(struct k_work *work)
-{
-    struct request_work *rw = CONTAINER_OF(work, struct request_work, work);
-    process_request(rw->data, rw->len, rw->transaction_id);
+    BLERPC_STATS_INC(requests);
+    BLERPC_STATS_STAMP(req->stats_queued);
+    req->transaction_id = transaction_id;
+    k_fifo_put(&link->request_fifo, req);
+    power_request_queued(link);
+    k_work_submit_to_queue(&blerpc_work_q, &request_work);
 }
 
-/* ── BLE service ─────────────────────────────────────────────────────── */
-
 static ssize_t on_write(struct bt_conn *conn, const struct bt_gatt_attr *attr, const void *buf,
                         uint16_t len, uint16_t offset, uint8_t flags)
 {
@@ -389,6 +2428,12 @@ static ssize_t on_write(struct bt_conn *conn, const struct bt_gatt_attr *attr, c
 
     LOG_DBG("Write: %u bytes", len);
 
+    struct link_ctx *link = link_get(conn);
+    if (!link) {
+        return len;
+    }
+    BLERPC_STATS_ADD(bytes_in, len);
+
     struct container_header hdr;
     if (container_parse_header(buf, len, &hdr) != 0) {
         LOG_ERR("Container parse failed");
@@ -413,27 +2458,64 @@ static ssize_t on_write(struct bt_conn *conn, const struct bt_gatt_attr *attr, c
             ctrl.payload = timeout_payload;
             int n = container_serialize(&ctrl, ctrl_buf, sizeof(ctrl_buf));
             if (n > 0) {
-                ble_service_notify(ctrl_buf, (size_t)n);
+                send_from_rx(link, ctrl_buf, (size_t)n);
             }
+        } else if (hdr.control_cmd == CONTROL_CMD_STREAM_CREDIT) {
+            stream_credit_grant(link, hdr.payload, hdr.payload_len);
+#ifdef CONFIG_BLERPC_STATS
+        } else if (hdr.control_cmd == CONTROL_CMD_STATS) {
+            send_stats_page(link, &hdr);
+#endif
+#ifdef CONFIG_BLERPC_RESUMPTION
+        } else if (hdr.control_cmd == CONTROL_CMD_RESUME) {
+            handle_resume(link, &hdr);
+#endif
         } else if (hdr.control_cmd == CONTROL_CMD_STREAM_END_C2P) {
             if (stream_end_cb) {
-                stream_end_cb(hdr.transaction_id);
+                stream_end_cb(conn, hdr.transaction_id);
             }
         } else if (hdr.control_cmd == CONTROL_CMD_CAPABILITIES) {
-            uint8_t ctrl_buf[12];
+            uint8_t ctrl_buf[CONTAINER_CONTROL_HEADER_SIZE + CAPS_PAYLOAD_SIZE];
             struct container_header ctrl = {
                 .transaction_id = hdr.transaction_id,
                 .sequence_number = 0,
                 .type = CONTAINER_TYPE_CONTROL,
                 .control_cmd = CONTROL_CMD_CAPABILITIES,
-                .payload_len = 6,
+                .payload_len = CAPS_PAYLOAD_SIZE,
             };
-            uint8_t caps_payload[6];
-            uint16_t max_req = CONFIG_BLERPC_PROTOCOL_ASSEMBLER_BUF_SIZE;
+            uint8_t caps_payload[CAPS_PAYLOAD_SIZE];
+            uint16_t max_req = max_request_payload_size();
             uint16_t max_resp = CONFIG_BLERPC_MAX_RESPONSE_PAYLOAD_SIZE;
-            uint16_t flags = 0;
+            uint16_t flags = CAPABILITY_FLAG_COMMAND_IDS | CAPABILITY_FLAG_STREAM_CREDITS |
+                             CAPABILITY_FLAG_STREAM_COALESCE;
+            uint16_t psm = 0;
+            uint16_t inflate_max = 0;
+#if CONFIG_BLERPC_BATCH_MAX_COMMANDS > 0
+            flags |= CAPABILITY_FLAG_BATCH;
+#endif
+#ifdef CONFIG_BLERPC_STATS
+            flags |= CAPABILITY_FLAG_STATS;
+#endif
+#ifdef CONFIG_BLERPC_COMPRESSION
+            flags |= CAPABILITY_FLAG_COMPRESSION;
+            inflate_max = CONFIG_BLERPC_COMPRESSION_BUF_SIZE;
+            /* The request carries the central's flags(2) and the largest
+             * response data it decompresses(2); older centrals send none */
+            link->inflate_limit = 0;
+            if (hdr.payload_len >= 4 &&
+                ((hdr.payload[0] | (hdr.payload[1] << 8)) & CAPABILITY_FLAG_COMPRESSION)) {
+                link->inflate_limit = (uint16_t)(hdr.payload[2] | (hdr.payload[3] << 8));
+            }
+#endif
 #ifdef CONFIG_BLERPC_ENCRYPTION
             flags |= CAPABILITY_FLAG_ENCRYPTION_SUPPORTED;
+#endif
+#ifdef CONFIG_BLERPC_RESUMPTION
+            flags |= CAPABILITY_FLAG_RESUMPTION;
+#endif
+#ifdef CONFIG_BLERPC_L2CAP
+            flags |= CAPABILITY_FLAG_L2CAP_SUPPORTED;
+            psm = CONFIG_BLERPC_L2CAP_PSM;
 #endif
             caps_payload[0] = (uint8_t)(max_req & 0xFF);
             caps_payload[1] = (uint8_t)(max_req >> 8);
@@ -441,15 +2523,30 @@ static ssize_t on_write(struct bt_conn *conn, const struct bt_gatt_attr *attr, c
             caps_payload[3] = (uint8_t)(max_resp >> 8);
             caps_payload[4] = (uint8_t)(flags & 0xFF);
             caps_payload[5] = (uint8_t)(flags >> 8);
+            caps_put_link_params(caps_payload + 6, &link->params);
+            put_le16(caps_payload + 18, psm);
+            put_le16(caps_payload + 20, BLERPC_SCHEMA_HASH);
+            put_le16(caps_payload + 22, inflate_max);
             ctrl.payload = caps_payload;
             int n = container_serialize(&ctrl, ctrl_buf, sizeof(ctrl_buf));
             if (n > 0) {
-                ble_service_notify(ctrl_buf, (size_t)n);
+                send_from_rx(link, ctrl_buf, (size_t)n);
             }
 #ifdef CONFIG_BLERPC_ENCRYPTION
         } else if (hdr.control_cmd == CONTROL_CMD_KEY_EXCHANGE) {
             /* Block KX re-initiation when encryption is already active */
-            if (encryption_active) {
+#ifdef CONFIG_BLERPC_RESUMPTION
+            if (link->session_tentative && hdr.payload_len >= 1 &&
+                hdr.payload[0] == KX_STEP1) {
+                /* The central refused the resumed session: start over */
+                LOG_INF("Key exchange replaces an unconfirmed resumption");
+                link->encryption_active = false;
+                link->session_tentative = false;
+                mbedtls_platform_zeroize(&link->crypto_session, sizeof(link->crypto_session));
+                blerpc_peripheral_kx_reset(&link->peripheral_kx);
+            } else
+#endif
+            if (link->encryption_active) {
                 LOG_WRN("Key exchange rejected: encryption already active");
                 return len;
             }
@@ -458,9 +2555,10 @@ static ssize_t on_write(struct bt_conn *conn, const struct bt_gatt_attr *attr, c
             size_t kx_out_len;
             bool session_established;
 
-            if (blerpc_peripheral_kx_handle_step(&peripheral_kx, hdr.payload, hdr.payload_len,
-                                                 kx_out, sizeof(kx_out), &kx_out_len,
-                                                 &crypto_session, &session_established) != 0) {
+            if (blerpc_peripheral_kx_handle_step(&link->peripheral_kx, hdr.payload,
+                                                 hdr.payload_len, kx_out, sizeof(kx_out),
+                                                 &kx_out_len, &link->crypto_session,
+                                                 &session_established) != 0) {
                 LOG_ERR("Key exchange step processing failed");
                 return len;
             }
@@ -476,11 +2574,14 @@ static ssize_t on_write(struct bt_conn *conn, const struct bt_gatt_attr *attr, c
             };
             int n = container_serialize(&kx_ctrl, resp_buf, sizeof(resp_buf));
             if (n > 0) {
-                send_with_retry(resp_buf, (size_t)n);
+                send_from_rx(link, resp_buf, (size_t)n);
             }
 
             if (session_established) {
-                encryption_active = true;
+                link->encryption_active = true;
+#ifdef CONFIG_BLERPC_RESUMPTION
+                link->ticket_allowed = true;
+#endif
                 LOG_INF("E2E encryption established");
             }
 #endif /* CONFIG_BLERPC_ENCRYPTION */
@@ -488,71 +2589,44 @@ static ssize_t on_write(struct bt_conn *conn, const struct bt_gatt_attr *attr, c
         return len;
     }
 
-    /* Feed into assembler */
-    int rc = container_assembler_feed(&assembler, &hdr);
-    if (rc == 1) {
-        /* Assembly complete — process via work queue to free BT RX thread */
-
-#ifdef CONFIG_BLERPC_DOUBLE_BUFFER
-        /* Pick a non-busy slot from the double-buffer pool */
-        int slot = -1;
-        for (int i = 0; i < 2; i++) {
-            int idx = (atomic_get(&req_work_index) + i) & 1;
-            if (!k_work_busy_get(&req_work_pool[idx].work)) {
-                slot = idx;
-                break;
-            }
-        }
-        if (slot < 0) {
-            LOG_WRN("Both request work slots busy, sending BUSY error");
-            send_busy_error(hdr.transaction_id);
-            container_assembler_init(&assembler);
-            return len;
-        }
-        atomic_set(&req_work_index, (slot + 1) & 1);
-        struct request_work *rw = &req_work_pool[slot];
-#else
-        /* Safe order: check busy FIRST, then write data */
-        if (k_work_busy_get(&req_work.work)) {
-            LOG_WRN("Request work busy, sending BUSY error");
-            send_busy_error(hdr.transaction_id);
-            container_assembler_init(&assembler);
-            return len;
-        }
-        struct request_work *rw = &req_work;
+#ifdef CONFIG_BLERPC_INCREMENTAL_DECODE
+    if (incremental_feed(link, &hdr)) {
+        return len;
+    }
 #endif
 
-        rw->transaction_id = hdr.transaction_id;
-#ifdef CONFIG_BLERPC_ENCRYPTION
-        if (encryption_active) {
-            /* Decrypt assembled payload (static to avoid stack overflow on BT RX thread) */
-            static uint8_t decrypted[CONFIG_BLERPC_PROTOCOL_ASSEMBLER_BUF_SIZE];
-            size_t decrypted_len;
-            if (blerpc_crypto_session_decrypt(&crypto_session, decrypted, sizeof(decrypted),
-                                              &decrypted_len, assembler.buf,
-                                              assembler.total_length) != 0) {
-                LOG_ERR("Decryption failed");
-                container_assembler_init(&assembler);
-                return len;
-            }
-            rw->len = decrypted_len;
-            memcpy(rw->data, decrypted, decrypted_len);
-        } else {
-            /* Reject unencrypted data when encryption is compiled in */
-            LOG_WRN("Rejecting unencrypted payload (encryption enabled but not active)");
-            container_assembler_init(&assembler);
-            return len;
-        }
-#else
-        rw->len = assembler.total_length;
-        memcpy(rw->data, assembler.buf, assembler.total_length);
+#ifdef CONFIG_BLERPC_RESUMPTION
+    /* Tickets are only handed out before the session carries traffic */
+    link->ticket_allowed = false;
 #endif
-        container_assembler_init(&assembler);
-        k_work_submit_to_queue(&blerpc_work_q, &rw->work);
-    } else if (rc < 0) {
-        container_assembler_init(&assembler);
+
+    /* Feed into this transaction's assembler */
+    struct assembler_slot *as = assembler_pool_get(link, &hdr);
+    if (!as) {
+        return len;
+    }
+
+    int rc = assembler_slot_feed(as, &hdr);
+    if (rc == -ENOMEM) {
+        LOG_WRN("Request queue full, sending BUSY error");
+        send_busy_error(link, hdr.transaction_id, true);
+        assembler_slot_release(as);
+        return len;
+    }
+    if (rc < 0) {
+        assembler_slot_release(as);
+        return len;
+    }
+    if (rc == 0) {
+        return len;
     }
 
+    /* Assembly complete — hand the entry to the work queue to free BT RX thread */
+    struct request_entry *req = as->entry;
+    as->entry = NULL;
+    assembler_slot_release(as);
+    request_enqueue(link, hdr.transaction_id, req);
+
     return len;
 }
 
@@ -563,27 +2637,313 @@ BT_GATT_SERVICE_DEFINE(blerpc_svc, BT_GATT_PRIMARY_SERVICE(&blerpc_svc_uuid),
                                               BT_GATT_PERM_WRITE, NULL, on_write, NULL),
                        BT_GATT_CCC(NULL, BT_GATT_PERM_READ | BT_GATT_PERM_WRITE), );
 
-uint16_t ble_service_get_mtu(void)
+uint16_t ble_service_get_mtu(struct bt_conn *conn)
 {
-    if (current_conn) {
-        return bt_gatt_get_mtu(current_conn);
+    if (conn) {
+        return bt_gatt_get_mtu(conn);
     }
     return 23; /* Default minimum */
 }
 
-int ble_service_notify(const uint8_t *data, size_t len)
+static void notify_sent(struct bt_conn *conn, void *user_data)
 {
-    if (!current_conn) {
+    ARG_UNUSED(conn);
+    struct link_ctx *link = user_data;
+    k_sem_give(&link->notify_credits);
+    k_sem_give(&link->notify_done);
+}
+
+static int notify_link(struct link_ctx *link, const uint8_t *data, size_t len,
+                       k_timeout_t timeout)
+{
+    struct bt_conn *conn = link->conn;
+
+    /* A NULL conn would notify every connection */
+    if (!conn) {
         return -ENOTCONN;
     }
+    /* Wait for a previously queued notification to leave the controller */
+    if (k_sem_take(&link->notify_credits, timeout) != 0) {
+        return -EAGAIN;
+    }
 
     struct bt_gatt_notify_params params = {
         .attr = &blerpc_svc.attrs[2],
         .data = data,
         .len = len,
+        .func = notify_sent,
+        .user_data = link,
+    };
+
+    int rc = bt_gatt_notify_cb(conn, &params);
+    if (rc < 0) {
+        k_sem_give(&link->notify_credits);
+    } else {
+        BLERPC_STATS_ADD(bytes_out, len);
+    }
+    return rc;
+}
+
+int ble_service_notify(struct bt_conn *conn, const uint8_t *data, size_t len)
+{
+    struct link_ctx *link = link_get(conn);
+    if (!link) {
+        return -ENOTCONN;
+    }
+    return notify_link(link, data, len, K_MSEC(CONFIG_BLERPC_NOTIFY_TIMEOUT_MS));
+}
+
+#ifdef CONFIG_BLERPC_L2CAP
+/* ── Bulk channel ────────────────────────────────────────────────────── */
+
+static struct link_ctx *bulk_link(struct bt_l2cap_chan *chan)
+{
+    return CONTAINER_OF(BT_L2CAP_LE_CHAN(chan), struct link_ctx, bulk_chan);
+}
+
+static void bulk_connected(struct bt_l2cap_chan *chan)
+{
+    struct link_ctx *link = bulk_link(chan);
+    link->bulk_connected = true;
+    LOG_INF("Bulk channel open (tx mtu %u, rx mtu %u)", link->bulk_chan.tx.mtu,
+            link->bulk_chan.rx.mtu);
+}
+
+static void bulk_disconnected(struct bt_l2cap_chan *chan)
+{
+    struct link_ctx *link = bulk_link(chan);
+    link->bulk_connected = false;
+    /* Wake a response waiting for its SDU to be sent */
+    k_sem_give(&link->bulk_sent);
+    LOG_INF("Bulk channel closed");
+}
+
+static void bulk_sent(struct bt_l2cap_chan *chan)
+{
+    k_sem_give(&bulk_link(chan)->bulk_sent);
+}
+
+static struct net_buf *bulk_alloc_buf(struct bt_l2cap_chan *chan)
+{
+    (void)chan;
+    return net_buf_alloc(&bulk_rx_pool, K_NO_WAIT);
+}
+
+/* One SDU is one whole request: copy it into the request queue, then treat
+ * it like a request reassembled from containers */
+static int bulk_recv(struct bt_l2cap_chan *chan, struct net_buf *buf)
+{
+    struct link_ctx *link = bulk_link(chan);
+
+    if (!link->conn || buf->len <= BULK_SDU_HEADER_SIZE) {
+        return 0;
+    }
+    uint8_t transaction_id = net_buf_pull_u8(buf);
+    if (buf->len > request_queue_max_len(&request_queue)) {
+        LOG_ERR("Request too large: %u", buf->len);
+        return 0;
+    }
+
+    struct request_entry *req = request_queue_alloc(&request_queue, buf->len);
+    if (!req) {
+        LOG_WRN("Request queue full, sending BUSY error");
+        send_busy_error(link, transaction_id, true);
+        return 0;
+    }
+    memcpy(req->data, buf->data, buf->len);
+    BLERPC_STATS_ADD(bytes_in, buf->len);
+    BLERPC_STATS_STAMP(req->stats_first);
+    request_enqueue(link, transaction_id, req);
+    return 0;
+}
+
+static const struct bt_l2cap_chan_ops bulk_ops = {
+    .connected = bulk_connected,
+    .disconnected = bulk_disconnected,
+    .sent = bulk_sent,
+    .alloc_buf = bulk_alloc_buf,
+    .recv = bulk_recv,
+};
+
+static int bulk_accept(struct bt_conn *conn, struct bt_l2cap_server *server,
+                       struct bt_l2cap_chan **chan)
+{
+    (void)server;
+    struct link_ctx *link = link_get(conn);
+
+    /* One bulk channel per link */
+    if (!link || link->bulk_connected) {
+        return -ENOMEM;
+    }
+    memset(&link->bulk_chan, 0, sizeof(link->bulk_chan));
+    link->bulk_chan.chan.ops = &bulk_ops;
+    link->bulk_chan.rx.mtu = CONFIG_BLERPC_L2CAP_MTU;
+    *chan = &link->bulk_chan.chan;
+    return 0;
+}
+
+/* Payloads are protected end to end by the session, if at all; the channel
+ * needs no link-layer security of its own */
+static struct bt_l2cap_server bulk_server = {
+    .psm = CONFIG_BLERPC_L2CAP_PSM,
+    .sec_level = BT_SECURITY_L1,
+    .accept = bulk_accept,
+};
+#endif /* CONFIG_BLERPC_L2CAP */
+
+/* Drop everything a link holds; its slot is then free for a new connection.
+ * Runs on blerpc_work_q, so no request of the link is being processed. */
+static void link_reset(struct link_ctx *link)
+{
+    struct request_entry *req;
+
+#ifdef CONFIG_BLERPC_LINK_TUNING
+    struct k_work_sync sync;
+
+    k_work_cancel_sync(&link->tune_work, &sync);
+#endif
+    assembler_pool_reset(link);
+    stream_link_reset(link);
+#ifdef CONFIG_BLERPC_INCREMENTAL_DECODE
+    incremental_link_reset(link);
+#endif
+    while ((req = k_fifo_get(&link->request_fifo, K_NO_WAIT)) != NULL) {
+#ifdef CONFIG_BLERPC_INCREMENTAL_DECODE
+        if (req->streamed) {
+            /* The work queue never saw it: end the decode here */
+            inc_rx.chunk = req;
+            incremental_finish();
+            continue;
+        }
+#endif
+        request_queue_free(&request_queue, req);
+    }
+    link->transaction_counter = 0;
+#ifdef CONFIG_BLERPC_COMPRESSION
+    link->inflate_limit = 0;
+#endif
+#ifdef CONFIG_BLERPC_ENCRYPTION
+    link->encryption_active = false;
+    mbedtls_platform_zeroize(&link->crypto_session, sizeof(link->crypto_session));
+    blerpc_peripheral_kx_reset(&link->peripheral_kx);
+#endif
+#ifdef CONFIG_BLERPC_RESUMPTION
+    link->ticket_allowed = false;
+    link->session_tentative = false;
+#endif
+#ifdef CONFIG_BLERPC_POWER_POLICY
+    power_link_reset(link);
+#endif
+}
+
+static void link_reset_work_handler(struct k_work *work)
+{
+    struct link_ctx *link = CONTAINER_OF(work, struct link_ctx, reset_work);
+    struct bt_conn *conn = link->closing;
+
+    link_reset(link);
+    link->closing = NULL;
+    /* Frees the connection object, and with it the slot (see recycled()) */
+    bt_conn_unref(conn);
+}
+
+/* Link-layer defaults until the controller reports otherwise */
+static void link_params_init(struct link_ctx *link)
+{
+    struct bt_conn_info info;
+
+    link->params = (struct ble_service_link_params){
+        .tx_phy = BT_GAP_LE_PHY_1M,
+        .rx_phy = BT_GAP_LE_PHY_1M,
+        .tx_max_len = 27,
+        .rx_max_len = 27,
     };
+    if (bt_conn_get_info(link->conn, &info) != 0) {
+        return;
+    }
+    link->params.interval = info.le.interval;
+    link->params.latency = info.le.latency;
+    link->params.timeout = info.le.timeout;
+#ifdef CONFIG_BT_USER_PHY_UPDATE
+    link->params.tx_phy = info.le.phy->tx_phy;
+    link->params.rx_phy = info.le.phy->rx_phy;
+#endif
+#ifdef CONFIG_BT_USER_DATA_LEN_UPDATE
+    link->params.tx_max_len = info.le.data_len->tx_max_len;
+    link->params.rx_max_len = info.le.data_len->rx_max_len;
+#endif
+}
+
+#ifdef CONFIG_BLERPC_LINK_TUNING
+static void tune_work_handler(struct k_work *work)
+{
+    struct link_ctx *link = CONTAINER_OF(work, struct link_ctx, tune_work);
+    struct bt_conn *conn = link->conn;
+    int err;
+
+    if (!conn) {
+        return;
+    }
+
+    err = bt_conn_le_phy_update(conn, BT_CONN_LE_PHY_PARAM_2M);
+    if (err) {
+        LOG_WRN("2M PHY request failed (err %d)", err);
+    }
+    err = bt_conn_le_data_len_update(conn, BT_LE_DATA_LEN_PARAM_MAX);
+    if (err) {
+        LOG_WRN("Data length update failed (err %d)", err);
+    }
+}
+#endif
+
+static void le_param_updated(struct bt_conn *conn, uint16_t interval, uint16_t latency,
+                             uint16_t timeout)
+{
+    struct link_ctx *link = link_get(conn);
+    if (!link) {
+        return;
+    }
+    link->params.interval = interval;
+    link->params.latency = latency;
+    link->params.timeout = timeout;
+    LOG_INF("Connection params: interval %u, latency %u, timeout %u", interval, latency,
+            timeout);
+}
+
+#ifdef CONFIG_BT_USER_PHY_UPDATE
+static void le_phy_updated(struct bt_conn *conn, struct bt_conn_le_phy_info *param)
+{
+    struct link_ctx *link = link_get(conn);
+    if (!link) {
+        return;
+    }
+    link->params.tx_phy = param->tx_phy;
+    link->params.rx_phy = param->rx_phy;
+    LOG_INF("PHY updated: tx %u, rx %u", param->tx_phy, param->rx_phy);
+}
+#endif
+
+#ifdef CONFIG_BT_USER_DATA_LEN_UPDATE
+static void le_data_len_updated(struct bt_conn *conn, struct bt_conn_le_data_len_info *info)
+{
+    struct link_ctx *link = link_get(conn);
+    if (!link) {
+        return;
+    }
+    link->params.tx_max_len = info->tx_max_len;
+    link->params.rx_max_len = info->rx_max_len;
+    LOG_INF("Data length updated: tx %u, rx %u", info->tx_max_len, info->rx_max_len);
+}
+#endif
 
-    return bt_gatt_notify_cb(current_conn, &params);
+static bool link_slot_free(void)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(links); i++) {
+        if (!links[i].conn && !links[i].closing) {
+            return true;
+        }
+    }
+    return false;
 }
 
 static void connected(struct bt_conn *conn, uint8_t err)
@@ -592,15 +2952,34 @@ static void connected(struct bt_conn *conn, uint8_t err)
         LOG_ERR("Connection failed (err %u)", err);
         return;
     }
-    LOG_INF("Connected");
-    current_conn = bt_conn_ref(conn);
-    container_assembler_init(&assembler);
-    transaction_counter = 0;
-#ifdef CONFIG_BLERPC_ENCRYPTION
-    encryption_active = false;
-    mbedtls_platform_zeroize(&crypto_session, sizeof(crypto_session));
-    blerpc_peripheral_kx_reset(&peripheral_kx);
+
+    /* A closing link still holds its connection object, so its index is
+     * not handed out again before the reset is done */
+    uint8_t index = bt_conn_index(conn);
+    if (index >= ARRAY_SIZE(links) || links[index].conn) {
+        LOG_ERR("No link context for connection %u", index);
+        bt_conn_disconnect(conn, BT_HCI_ERR_REMOTE_USER_TERM_CONN);
+        return;
+    }
+
+    struct link_ctx *link = &links[index];
+    k_sem_init(&link->notify_credits, CONFIG_BLERPC_NOTIFY_INFLIGHT_MAX,
+               CONFIG_BLERPC_NOTIFY_INFLIGHT_MAX);
+    k_sem_init(&link->notify_done, 0, 1);
+    link->conn = bt_conn_ref(conn);
+    link_params_init(link);
+    /* Connection setup is work too: the idle profile follows it */
+    power_settle(link);
+    LOG_INF("Connected (link %u)", index);
+#ifdef CONFIG_BLERPC_LINK_TUNING
+    /* PHY and data length updates block on HCI; not allowed here */
+    k_work_submit(&link->tune_work);
 #endif
+
+    /* Connectable advertising stops on connection; keep accepting centrals */
+    if (link_slot_free()) {
+        k_work_submit(&adv_work);
+    }
 }
 
 static const struct bt_data ad[] = {
@@ -615,46 +2994,162 @@ static const struct bt_data sd[] = {
 
 static void disconnected(struct bt_conn *conn, uint8_t reason)
 {
+    struct link_ctx *link = link_get(conn);
+
     LOG_INF("Disconnected (reason %u)", reason);
-    if (current_conn) {
-        bt_conn_unref(current_conn);
-        current_conn = NULL;
+    if (!link) {
+        return;
     }
-    container_assembler_init(&assembler);
-#ifdef CONFIG_BLERPC_ENCRYPTION
-    encryption_active = false;
-    mbedtls_platform_zeroize(&crypto_session, sizeof(crypto_session));
-    blerpc_peripheral_kx_reset(&peripheral_kx);
+    link->conn = NULL;
+    /* Wake senders blocked on this link's credits; they fail with -EAGAIN */
+    k_sem_reset(&link->notify_credits);
+    k_sem_reset(&link->notify_done);
+#ifdef CONFIG_BLERPC_INCREMENTAL_DECODE
+    /* A decode waiting for this link's chunks gives up now, not at the
+     * assembler timeout, so the reset below is not held up */
+    incremental_link_reset(link);
 #endif
+    /* The work queue may be in one of the link's requests right now: tear
+     * the link down after it, keeping the ref until then */
+    link->closing = conn;
+    k_work_submit_to_queue(&blerpc_work_q, &link->reset_work);
+}
 
-    int err = ble_service_start_advertising();
+/* The connection object is free again, so advertising can claim it */
+static void recycled(void)
+{
+    k_work_submit(&adv_work);
+}
+
+#ifdef CONFIG_BLERPC_POWER_POLICY
+/* Advertising starts at adv_interval_min and, while no central connects,
+ * doubles its interval every adv_backoff_s up to adv_interval_max. Both
+ * handlers run on the system workqueue. */
+static struct k_work_delayable adv_backoff_work;
+static uint16_t adv_interval; /* 0.625 ms units */
+
+static int adv_start(uint16_t interval)
+{
+    struct bt_le_adv_param param = *BT_LE_ADV_CONN;
+
+    param.interval_min = interval;
+    param.interval_max = interval;
+    return bt_le_adv_start(&param, ad, ARRAY_SIZE(ad), sd, ARRAY_SIZE(sd));
+}
+
+static void adv_backoff_handler(struct k_work *work)
+{
+    (void)work;
+    struct ble_service_power_policy p;
+
+    power_policy_get(&p);
+    if (!link_slot_free() || adv_interval >= p.adv_interval_max) {
+        return;
+    }
+    uint16_t next = (uint16_t)MIN((uint32_t)adv_interval * 2, p.adv_interval_max);
+    bt_le_adv_stop();
+    int err = adv_start(next);
     if (err) {
         LOG_ERR("Failed to restart advertising (err %d)", err);
+        return;
+    }
+    adv_interval = next;
+    LOG_DBG("Advertising interval %u", next);
+    if (next < p.adv_interval_max && p.adv_backoff_s > 0) {
+        k_work_schedule(&adv_backoff_work, K_SECONDS(p.adv_backoff_s));
+    }
+}
+#endif /* CONFIG_BLERPC_POWER_POLICY */
+
+static void adv_work_handler(struct k_work *work)
+{
+    (void)work;
+    if (!link_slot_free()) {
+        return;
+    }
+#ifdef CONFIG_BLERPC_POWER_POLICY
+    /* A central came or went: another may be about, so advertise fast
+     * again even if the backoff is under way */
+    bt_le_adv_stop();
+#endif
+    int err = ble_service_start_advertising();
+    if (err && err != -EALREADY) {
+        LOG_ERR("Failed to restart advertising (err %d)", err);
     }
 }
 
 int ble_service_start_advertising(void)
 {
+#ifdef CONFIG_BLERPC_POWER_POLICY
+    struct ble_service_power_policy p;
+
+    power_policy_get(&p);
+    int err = adv_start(p.adv_interval_min);
+    if (err == 0) {
+        adv_interval = p.adv_interval_min;
+        if (p.adv_backoff_s > 0) {
+            k_work_reschedule(&adv_backoff_work, K_SECONDS(p.adv_backoff_s));
+        }
+    }
+    return err;
+#else
     return bt_le_adv_start(BT_LE_ADV_CONN, ad, ARRAY_SIZE(ad), sd, ARRAY_SIZE(sd));
+#endif
 }
 
 BT_CONN_CB_DEFINE(conn_callbacks) = {
     .connected = connected,
     .disconnected = disconnected,
+    .recycled = recycled,
+    .le_param_updated = le_param_updated,
+#ifdef CONFIG_BT_USER_PHY_UPDATE
+    .le_phy_updated = le_phy_updated,
+#endif
+#ifdef CONFIG_BT_USER_DATA_LEN_UPDATE
+    .le_data_len_updated = le_data_len_updated,
+#endif
 };
 
 void ble_service_init(void)
 {
+    blerpc_stats_init();
     k_work_queue_init(&blerpc_work_q);
     k_work_queue_start(&blerpc_work_q, blerpc_work_stack, K_THREAD_STACK_SIZEOF(blerpc_work_stack),
                        K_PRIO_COOP(7), NULL);
-#ifdef CONFIG_BLERPC_DOUBLE_BUFFER
-    k_work_init(&req_work_pool[0].work, request_work_handler);
-    k_work_init(&req_work_pool[1].work, request_work_handler);
-#else
-    k_work_init(&req_work.work, request_work_handler);
+    request_queue_init(&request_queue, request_ring, sizeof(request_ring));
+    k_work_init(&request_work, request_work_handler);
+    k_work_init(&adv_work, adv_work_handler);
+#ifdef CONFIG_BLERPC_POWER_POLICY
+    k_work_init_delayable(&adv_backoff_work, adv_backoff_handler);
+#endif
+#ifdef CONFIG_BLERPC_INCREMENTAL_DECODE
+    k_fifo_init(&inc_rx.chunks);
+#endif
+    for (size_t i = 0; i < ARRAY_SIZE(links); i++) {
+        k_fifo_init(&links[i].request_fifo);
+        k_work_init(&links[i].reset_work, link_reset_work_handler);
+        k_work_init_delayable(&links[i].stream.work, stream_work_handler);
+        k_sem_init(&links[i].notify_credits, CONFIG_BLERPC_NOTIFY_INFLIGHT_MAX,
+                   CONFIG_BLERPC_NOTIFY_INFLIGHT_MAX);
+        k_sem_init(&links[i].notify_done, 0, 1);
+#ifdef CONFIG_BLERPC_LINK_TUNING
+        k_work_init(&links[i].tune_work, tune_work_handler);
+#endif
+#ifdef CONFIG_BLERPC_POWER_POLICY
+        k_work_init_delayable(&links[i].power_work, power_work_handler);
+        k_work_init_delayable(&links[i].batch_work, batch_work_handler);
+#endif
+#ifdef CONFIG_BLERPC_L2CAP
+        k_sem_init(&links[i].bulk_sent, 0, 1);
+#endif
+    }
+
+#ifdef CONFIG_BLERPC_L2CAP
+    int err = bt_l2cap_server_register(&bulk_server);
+    if (err) {
+        LOG_ERR("Bulk channel server registration failed (err %d)", err);
+    }
 #endif
-    container_assembler_init(&assembler);
 
 #ifdef CONFIG_BLERPC_ENCRYPTION
     if (load_keys() != 0) {
@@ -663,8 +3158,13 @@ void ble_service_init(void)
 #endif
 }
 
-int ble_service_send_stream_end_p2c(uint8_t transaction_id)
+int ble_service_send_stream_end_p2c(struct bt_conn *conn, uint8_t transaction_id)
 {
+    struct link_ctx *link = link_get(conn);
+    if (!link) {
+        return -ENOTCONN;
+    }
+
     uint8_t ctrl_buf[8];
     struct container_header ctrl = {
         .transaction_id = transaction_id,
@@ -678,7 +3178,8 @@ int ble_service_send_stream_end_p2c(uint8_t transaction_id)
     if (n < 0) {
         return -1;
     }
-    return send_with_retry(ctrl_buf, (size_t)n);
+    /* Behind any stream frames still held for the batch */
+    return send_container(link, ctrl_buf, (size_t)n, true);
 }
 
 void ble_service_set_stream_end_cb(ble_service_stream_end_cb_t cb)
@@ -686,9 +3187,15 @@ void ble_service_set_stream_end_cb(ble_service_stream_end_cb_t cb)
     stream_end_cb = cb;
 }
 
-uint8_t ble_service_next_transaction_id(void)
+uint8_t ble_service_next_transaction_id(struct bt_conn *conn)
 {
-    return transaction_counter++;
+    struct link_ctx *link = link_get(conn);
+    return link ? link->transaction_counter++ : 0;
+}
+
+struct bt_conn *ble_service_current_conn(void)
+{
+    return active_link ? active_link->conn : NULL;
 }
 
 void ble_service_submit_work(struct k_work *work)
@@ -696,26 +3203,71 @@ void ble_service_submit_work(struct k_work *work)
     k_work_submit_to_queue(&blerpc_work_q, work);
 }
 
-int ble_service_send_command_response(uint8_t transaction_id, const uint8_t *cmd_data,
-                                      size_t cmd_len)
+int ble_service_send_command_response(struct bt_conn *conn, uint8_t transaction_id,
+                                      const uint8_t *cmd_data, size_t cmd_len)
 {
-    uint16_t mtu = ble_service_get_mtu();
+    struct link_ctx *link = link_get(conn);
+    if (!link) {
+        return -ENOTCONN;
+    }
+    if (cmd_len + streaming_overhead(link) > UINT16_MAX) {
+        return -EMSGSIZE;
+    }
 
-#ifdef CONFIG_BLERPC_ENCRYPTION
-    if (encryption_active) {
-        static uint8_t
-            enc_buf[CONFIG_BLERPC_PROTOCOL_ASSEMBLER_BUF_SIZE + BLERPC_ENCRYPTED_OVERHEAD];
-        size_t enc_len;
-        if (blerpc_crypto_session_encrypt(&crypto_session, enc_buf, sizeof(enc_buf), &enc_len,
-                                          cmd_data, cmd_len) != 0) {
-            LOG_ERR("Stream response encryption failed");
-            return -1;
-        }
-        return container_split_and_send(transaction_id, enc_buf, enc_len, mtu, container_send_cb,
-                                        NULL);
+    struct streaming_ctx sctx;
+    int rc = streaming_begin(&sctx, link, transaction_id, cmd_len);
+    if (rc != 0) {
+        streaming_abort(&sctx);
+        return rc;
     }
-#endif
+    streaming_write(&sctx, cmd_data, cmd_len);
+    return streaming_end(&sctx);
+}
+
+int ble_service_get_link_params(struct bt_conn *conn, struct ble_service_link_params *out)
+{
+    struct link_ctx *link = link_get(conn);
+    if (!link) {
+        return -ENOTCONN;
+    }
+    *out = link->params;
+    return 0;
+}
+
+#ifdef CONFIG_BLERPC_POWER_POLICY
+static bool conn_profile_valid(const struct ble_service_conn_profile *c)
+{
+    return c->interval_min >= 6 && c->interval_min <= c->interval_max &&
+           c->interval_max <= 3200 && c->latency <= 499 && c->timeout >= 10 &&
+           c->timeout <= 3200 && POWER_TIMEOUT_OK(c->timeout, c->latency, c->interval_max);
+}
+
+void ble_service_get_power_policy(struct ble_service_power_policy *out)
+{
+    power_policy_get(out);
+}
 
-    return container_split_and_send(transaction_id, cmd_data, cmd_len, mtu, container_send_cb,
-                                    NULL);
+int ble_service_set_power_policy(const struct ble_service_power_policy *policy)
+{
+    if (!conn_profile_valid(&policy->bulk) || !conn_profile_valid(&policy->idle) ||
+        policy->bulk_queue_depth == 0 || policy->adv_interval_min < 0x20 ||
+        policy->adv_interval_min > policy->adv_interval_max ||
+        policy->adv_interval_max > 0x4000) {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&power_lock);
+    power_policy = *policy;
+    k_spin_unlock(&power_lock, key);
+
+    /* Held containers go out on their old window; links re-request their
+     * profile with the new parameters */
+    for (size_t i = 0; i < ARRAY_SIZE(links); i++) {
+        if (links[i].conn) {
+            links[i].profile = POWER_PROFILE_NONE;
+            k_work_reschedule(&links[i].power_work, K_NO_WAIT);
+        }
+    }
+    return 0;
 }
+#endif
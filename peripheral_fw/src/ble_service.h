@@ -3,6 +3,7 @@
 
 #include <zephyr/bluetooth/bluetooth.h>
 #include <zephyr/bluetooth/gatt.h>
+#include <pb_encode.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -14,8 +15,109 @@ extern "C" {
 /* blerpc Characteristic UUID: 12340002-0000-1000-8000-00805f9b34fb */
 #define BLERPC_CHAR_UUID BT_UUID_128_ENCODE(0x12340002, 0x0000, 0x1000, 0x8000, 0x00805f9b34fb)
 
+/* Capability flag: the bulk L2CAP channel is available; its PSM follows the
+ * link parameters in the capabilities payload */
+#ifndef CAPABILITY_FLAG_L2CAP_SUPPORTED
+#define CAPABILITY_FLAG_L2CAP_SUPPORTED 0x0002
+#endif
+
+/* Capability flag: requests may name their command by 1-byte ID; the schema
+ * hash the IDs belong to follows the PSM in the capabilities payload */
+#ifndef CAPABILITY_FLAG_COMMAND_IDS
+#define CAPABILITY_FLAG_COMMAND_IDS 0x0004
+#endif
+
+/* Capability flag: the peripheral accepts batch requests
+ * (CONFIG_BLERPC_BATCH_MAX_COMMANDS commands per batch) */
+#ifndef CAPABILITY_FLAG_BATCH
+#define CAPABILITY_FLAG_BATCH 0x0008
+#endif
+
+/* Capability flag: the central may pace P→C streams with
+ * CONTROL_CMD_STREAM_CREDIT grants */
+#ifndef CAPABILITY_FLAG_STREAM_CREDITS
+#define CAPABILITY_FLAG_STREAM_CREDITS 0x0010
+#endif
+
+/* Control command: the central grants P→C stream credits. Payload:
+ * credits(2, little-endian), then an optional flags(1). A grant sent before
+ * the stream request pre-loads credits for that stream; once a link has
+ * sent one, its streams never run ahead of the granted credits. */
+#ifndef CONTROL_CMD_STREAM_CREDIT
+#define CONTROL_CMD_STREAM_CREDIT 7
+#endif
+
+/* Stream credit flag: small stream messages may arrive coalesced into one
+ * batch response (see COMMAND_FLAG_BATCH), each counting as one credit */
+#ifndef STREAM_CREDIT_FLAG_COALESCE
+#define STREAM_CREDIT_FLAG_COALESCE 0x01
+#endif
+
+/* Capability flag: the peripheral accepts coalesced C→P stream frames */
+#ifndef CAPABILITY_FLAG_STREAM_COALESCE
+#define CAPABILITY_FLAG_STREAM_COALESCE 0x0020
+#endif
+
+/* Capability flag: the peripheral answers CONTROL_CMD_STATS
+ * (CONFIG_BLERPC_STATS) */
+#ifndef CAPABILITY_FLAG_STATS
+#define CAPABILITY_FLAG_STATS 0x0040
+#endif
+
+/* Capability flag: request and response data may be compressed
+ * (CONFIG_BLERPC_COMPRESSION). The largest data the peripheral decompresses
+ * follows the schema hash in the capabilities payload. A central that sends
+ * this flag in its CAPABILITIES request, followed by the largest response
+ * data it decompresses, gets compressed responses. */
+#ifndef CAPABILITY_FLAG_COMPRESSION
+#define CAPABILITY_FLAG_COMPRESSION 0x0080
+#endif
+
+/* Capability flag: the peripheral issues session resumption tickets and
+ * accepts them with CONTROL_CMD_RESUME (CONFIG_BLERPC_RESUMPTION) */
+#ifndef CAPABILITY_FLAG_RESUMPTION
+#define CAPABILITY_FLAG_RESUMPTION 0x0100
+#endif
+
+/* Control command: read instrumentation. Payload: page(1), 0 for the link
+ * counters or a command ID for its latency histograms. The peripheral
+ * answers with the same command; see blerpc_stats_page() for the layout. */
+#ifndef CONTROL_CMD_STATS
+#define CONTROL_CMD_STATS 8
+#endif
+
+/* Control command: session resumption, instead of or after
+ * CONTROL_CMD_KEY_EXCHANGE. Payload: op(1), then op-specific data; see
+ * session_resume.h. */
+#ifndef CONTROL_CMD_RESUME
+#define CONTROL_CMD_RESUME 9
+#endif
+
+/* Command byte 0 flag: a batch. The name field is empty and the data is a
+ * sequence of command packets, requests one way and responses in the same
+ * order the other. A request batch that names a stream command is a
+ * coalesced C→P stream frame instead: its data is a run of
+ * [len(2, little-endian)][message] entries, all for that command. */
+#ifndef COMMAND_FLAG_BATCH
+#define COMMAND_FLAG_BATCH 0x20
+#endif
+
+/* Command byte 0 flag: the data field is compressed, see blerpc_compress.h.
+ * data_len counts the compressed bytes. */
+#ifndef COMMAND_FLAG_COMPRESSED
+#define COMMAND_FLAG_COMPRESSED 0x10
+#endif
+
+/* Command byte 0 flag: the name field is a single command ID byte rather
+ * than the command name. Bit 7 stays the command type. */
+#ifndef COMMAND_FLAG_ID
+#define COMMAND_FLAG_ID 0x40
+#endif
+
 /**
- * Initialize the BLE service (work queue, assembler).
+ * Initialize the BLE service (work queue, per-link state).
+ * Up to CONFIG_BT_MAX_CONN centrals are served concurrently; advertising is
+ * restarted automatically while a link slot is free.
  * Call after bt_enable() but before starting advertising.
  */
 void ble_service_init(void);
@@ -27,30 +129,36 @@ void ble_service_init(void);
 int ble_service_start_advertising(void);
 
 /**
- * Get the current connection's MTU.
+ * Get a connection's MTU.
  */
-uint16_t ble_service_get_mtu(void);
+uint16_t ble_service_get_mtu(struct bt_conn *conn);
 
 /**
- * Send a notification to the connected Central.
+ * Send a notification to a connected Central.
+ * Blocks while CONFIG_BLERPC_NOTIFY_INFLIGHT_MAX notifications are still
+ * queued in the stack, until one is sent or the notify timeout expires.
+ * Not for the BT RX thread, which runs the callbacks that end the wait.
+ * @param conn  Connection to notify
  * @param data  Data to send
  * @param len   Length of data
- * @return 0 on success, negative on error
+ * @return 0 on success, -ENOTCONN if conn is not a blerpc link, -EAGAIN if
+ *         no TX credit came back in time, other negative on error
  */
-int ble_service_notify(const uint8_t *data, size_t len);
+int ble_service_notify(struct bt_conn *conn, const uint8_t *data, size_t len);
 
 /**
  * Send a STREAM_END_P2C control container.
+ * @param conn           Connection to send on
  * @param transaction_id Transaction ID
  * @return 0 on success, negative on error
  */
-int ble_service_send_stream_end_p2c(uint8_t transaction_id);
+int ble_service_send_stream_end_p2c(struct bt_conn *conn, uint8_t transaction_id);
 
 /**
  * Callback type for stream end notification (C->P).
  * Called when STREAM_END_C2P is received from Central.
  */
-typedef void (*ble_service_stream_end_cb_t)(uint8_t transaction_id);
+typedef void (*ble_service_stream_end_cb_t)(struct bt_conn *conn, uint8_t transaction_id);
 
 /**
  * Register a callback for STREAM_END_C2P reception.
@@ -58,25 +166,127 @@ typedef void (*ble_service_stream_end_cb_t)(uint8_t transaction_id);
 void ble_service_set_stream_end_cb(ble_service_stream_end_cb_t cb);
 
 /**
- * Get the next transaction ID (incrementing counter).
+ * Get the connection's next transaction ID (per-link incrementing counter).
  */
-uint8_t ble_service_next_transaction_id(void);
+uint8_t ble_service_next_transaction_id(struct bt_conn *conn);
+
+/**
+ * Connection whose request is being handled.
+ * Valid only inside a command handler running on the blerpc work queue;
+ * NULL elsewhere. Handlers that respond on their own (streams) use it to
+ * address the requesting central.
+ */
+struct bt_conn *ble_service_current_conn(void);
+
+/**
+ * Radio parameters of a link, as reported in the capabilities response.
+ */
+struct ble_service_link_params {
+    uint8_t tx_phy;      /* BT_GAP_LE_PHY_* */
+    uint8_t rx_phy;      /* BT_GAP_LE_PHY_* */
+    uint16_t tx_max_len; /* link-layer payload octets */
+    uint16_t rx_max_len; /* link-layer payload octets */
+    uint16_t interval;   /* connection interval, 1.25 ms units */
+    uint16_t latency;    /* peripheral latency, connection events */
+    uint16_t timeout;    /* supervision timeout, 10 ms units */
+};
+
+/**
+ * Get the current radio parameters of a connection.
+ * @return 0 on success, -ENOTCONN if conn is not a blerpc link
+ */
+int ble_service_get_link_params(struct bt_conn *conn, struct ble_service_link_params *out);
+
+#ifdef CONFIG_BLERPC_POWER_POLICY
+/**
+ * Connection parameters a link is asked to use in one power profile.
+ */
+struct ble_service_conn_profile {
+    uint16_t interval_min; /* 1.25 ms units */
+    uint16_t interval_max; /* 1.25 ms units */
+    uint16_t latency;      /* connection events the peripheral may skip */
+    uint16_t timeout;      /* supervision timeout, 10 ms units */
+};
+
+/**
+ * Power policy, initialized from the CONFIG_BLERPC_POWER_* options.
+ */
+struct ble_service_power_policy {
+    struct ble_service_conn_profile bulk;
+    struct ble_service_conn_profile idle;
+    uint16_t bulk_queue_depth;   /* queued requests that switch a link to bulk */
+    uint16_t bulk_response_size; /* response wire bytes that switch a link to bulk */
+    uint16_t idle_delay_ms;      /* time without work before a link drops to idle */
+    uint16_t batch_window_ms;    /* longest an idle link holds a small response, 0: never */
+    uint16_t adv_interval_min;   /* first advertising interval, 0.625 ms units */
+    uint16_t adv_interval_max;   /* slowest advertising interval, 0.625 ms units */
+    uint16_t adv_backoff_s;      /* advertising time per interval doubling, 0: never */
+};
+
+/**
+ * Get the power policy in force.
+ */
+void ble_service_get_power_policy(struct ble_service_power_policy *out);
+
+/**
+ * Replace the power policy. Connected links are asked for the new
+ * parameters of their profile at once; advertising picks up the new
+ * intervals the next time it starts or backs off.
+ * @return 0 on success, -EINVAL if a profile breaks the Core spec limits
+ *         (its timeout must exceed (1 + latency) * interval_max * 2.5 ms)
+ *         or an interval range is empty
+ */
+int ble_service_set_power_policy(const struct ble_service_power_policy *policy);
+#endif
 
 /**
  * Submit work to the blerpc work queue (has sufficient stack for BLE I/O).
  */
 void ble_service_submit_work(struct k_work *work);
 
+/**
+ * Encode message index of a P→C stream into ostream. Runs on the blerpc
+ * work queue. A message that does not fit the frame being filled is
+ * encoded again into the next one, so the same index may be asked for
+ * more than once and must produce the same message.
+ * @return 0 when encoded, -ENODATA once index is past the last message,
+ *         other negative to abort the stream
+ */
+typedef int (*ble_service_stream_next_t)(void *ctx, uint32_t index, pb_ostream_t *ostream);
+
+/* Frame bytes a P→C stream message takes besides its encoding: the batch
+ * header of a coalesced frame and the message's command header */
+#define BLE_SERVICE_STREAM_MSG_OVERHEAD(name_len) (4 + 2 + (name_len) + 2)
+
+struct ble_service_p2c_stream {
+    const char *cmd_name; /* name the stream responses carry */
+    uint8_t cmd_name_len;
+    ble_service_stream_next_t next;
+    void *ctx; /* passed to next; must stay valid until the stream ends */
+};
+
+/**
+ * Start a P→C stream on conn and return; the handler that starts it then
+ * returns -2. Messages are produced and sent in bursts from work items,
+ * within the credits the central has granted, and STREAM_END_P2C follows
+ * the last one. Requests from any link are served between bursts.
+ * @return 0 on success, -EBUSY if conn already has a stream running,
+ *         -ENOTCONN if conn is not a blerpc link
+ */
+int ble_service_stream_p2c_start(struct bt_conn *conn, const struct ble_service_p2c_stream *stream);
+
 /**
  * Send a command response payload, encrypting if encryption is active.
- * Splits the (possibly encrypted) payload into containers and sends via notify.
+ * The payload is encrypted incrementally while it is packed into containers
+ * and sent via notify, so no encrypted copy is buffered.
+ * @param conn           Connection to send on
  * @param transaction_id Transaction ID for the containers
  * @param cmd_data       Serialized command payload (unencrypted)
  * @param cmd_len        Length of command payload
  * @return 0 on success, negative on error
  */
-int ble_service_send_command_response(uint8_t transaction_id, const uint8_t *cmd_data,
-                                      size_t cmd_len);
+int ble_service_send_command_response(struct bt_conn *conn, uint8_t transaction_id,
+                                      const uint8_t *cmd_data, size_t cmd_len);
 
 #ifdef __cplusplus
 }
@@ -36,4 +36,10 @@ PB_BIND(blerpc_CounterUploadRequest, blerpc_CounterUploadRequest, AUTO)
 PB_BIND(blerpc_CounterUploadResponse, blerpc_CounterUploadResponse, AUTO)
 
 
+PB_BIND(blerpc_FlashDumpRequest, blerpc_FlashDumpRequest, AUTO)
+
+
+PB_BIND(blerpc_FlashDumpResponse, blerpc_FlashDumpResponse, AUTO)
+
+
 
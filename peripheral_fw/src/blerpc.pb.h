@@ -54,6 +54,17 @@ typedef struct _blerpc_CounterUploadResponse {
     uint32_t received_count;
 } blerpc_CounterUploadResponse;
 
+typedef struct _blerpc_FlashDumpRequest {
+    uint32_t address;
+    uint32_t length;
+} blerpc_FlashDumpRequest;
+
+typedef struct _blerpc_FlashDumpResponse {
+    uint32_t offset;
+    pb_callback_t data;
+    uint32_t crc32;
+} blerpc_FlashDumpResponse;
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -70,6 +81,8 @@ extern "C" {
 #define blerpc_CounterStreamResponse_init_default {0, 0}
 #define blerpc_CounterUploadRequest_init_default {0, 0}
 #define blerpc_CounterUploadResponse_init_default {0}
+#define blerpc_FlashDumpRequest_init_default     {0, 0}
+#define blerpc_FlashDumpResponse_init_default    {0, {{NULL}, NULL}, 0}
 #define blerpc_EchoRequest_init_zero             {""}
 #define blerpc_EchoResponse_init_zero            {""}
 #define blerpc_FlashReadRequest_init_zero        {0, 0}
@@ -80,6 +93,8 @@ extern "C" {
 #define blerpc_CounterStreamResponse_init_zero   {0, 0}
 #define blerpc_CounterUploadRequest_init_zero    {0, 0}
 #define blerpc_CounterUploadResponse_init_zero   {0}
+#define blerpc_FlashDumpRequest_init_zero        {0, 0}
+#define blerpc_FlashDumpResponse_init_zero       {0, {{NULL}, NULL}, 0}
 
 /* Field tags (for use in manual encoding/decoding) */
 #define blerpc_EchoRequest_message_tag           1
@@ -96,6 +111,11 @@ extern "C" {
 #define blerpc_CounterUploadRequest_seq_tag      1
 #define blerpc_CounterUploadRequest_value_tag    2
 #define blerpc_CounterUploadResponse_received_count_tag 1
+#define blerpc_FlashDumpRequest_address_tag      1
+#define blerpc_FlashDumpRequest_length_tag       2
+#define blerpc_FlashDumpResponse_offset_tag      1
+#define blerpc_FlashDumpResponse_data_tag        2
+#define blerpc_FlashDumpResponse_crc32_tag       3
 
 /* Struct field encoding specification for nanopb */
 #define blerpc_EchoRequest_FIELDLIST(X, a) \
@@ -152,6 +172,19 @@ X(a, STATIC,   SINGULAR, UINT32,   received_count,    1)
 #define blerpc_CounterUploadResponse_CALLBACK NULL
 #define blerpc_CounterUploadResponse_DEFAULT NULL
 
+#define blerpc_FlashDumpRequest_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   address,           1) \
+X(a, STATIC,   SINGULAR, UINT32,   length,            2)
+#define blerpc_FlashDumpRequest_CALLBACK NULL
+#define blerpc_FlashDumpRequest_DEFAULT NULL
+
+#define blerpc_FlashDumpResponse_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   offset,            1) \
+X(a, CALLBACK, SINGULAR, BYTES,    data,              2) \
+X(a, STATIC,   SINGULAR, UINT32,   crc32,             3)
+#define blerpc_FlashDumpResponse_CALLBACK pb_default_field_callback
+#define blerpc_FlashDumpResponse_DEFAULT NULL
+
 extern const pb_msgdesc_t blerpc_EchoRequest_msg;
 extern const pb_msgdesc_t blerpc_EchoResponse_msg;
 extern const pb_msgdesc_t blerpc_FlashReadRequest_msg;
@@ -162,6 +195,8 @@ extern const pb_msgdesc_t blerpc_CounterStreamRequest_msg;
 extern const pb_msgdesc_t blerpc_CounterStreamResponse_msg;
 extern const pb_msgdesc_t blerpc_CounterUploadRequest_msg;
 extern const pb_msgdesc_t blerpc_CounterUploadResponse_msg;
+extern const pb_msgdesc_t blerpc_FlashDumpRequest_msg;
+extern const pb_msgdesc_t blerpc_FlashDumpResponse_msg;
 
 /* Defines for backwards compatibility with code written before nanopb-0.4.0 */
 #define blerpc_EchoRequest_fields &blerpc_EchoRequest_msg
@@ -174,10 +209,13 @@ extern const pb_msgdesc_t blerpc_CounterUploadResponse_msg;
 #define blerpc_CounterStreamResponse_fields &blerpc_CounterStreamResponse_msg
 #define blerpc_CounterUploadRequest_fields &blerpc_CounterUploadRequest_msg
 #define blerpc_CounterUploadResponse_fields &blerpc_CounterUploadResponse_msg
+#define blerpc_FlashDumpRequest_fields &blerpc_FlashDumpRequest_msg
+#define blerpc_FlashDumpResponse_fields &blerpc_FlashDumpResponse_msg
 
 /* Maximum encoded size of messages (where known) */
 /* blerpc_FlashReadResponse_size depends on runtime parameters */
 /* blerpc_DataWriteRequest_size depends on runtime parameters */
+/* blerpc_FlashDumpResponse_size depends on runtime parameters */
 #define BLERPC_BLERPC_PB_H_MAX_SIZE              blerpc_EchoRequest_size
 #define blerpc_CounterStreamRequest_size         6
 #define blerpc_CounterStreamResponse_size        17
@@ -186,6 +224,7 @@ extern const pb_msgdesc_t blerpc_CounterUploadResponse_msg;
 #define blerpc_DataWriteResponse_size            6
 #define blerpc_EchoRequest_size                  259
 #define blerpc_EchoResponse_size                 259
+#define blerpc_FlashDumpRequest_size             12
 #define blerpc_FlashReadRequest_size             12
 
 #ifdef __cplusplus
@@ -0,0 +1,158 @@
+#include "blerpc_compress.h"
+
+#include <zephyr/sys/util.h>
+#include <string.h>
+
+static int group_flush(struct blerpc_compress *c)
+{
+    if (c->group_items == 0 || c->error) {
+        return c->error;
+    }
+    c->error = c->emit(c->group, c->group_len, c->emit_ctx);
+    c->out_len += c->group_len;
+    c->group[0] = 0;
+    c->group_len = 1;
+    c->group_items = 0;
+    return c->error;
+}
+
+/* Longest match for the bytes at pos, nearest first on ties */
+static size_t find_match(const struct blerpc_compress *c, size_t *distance)
+{
+    size_t max_len = MIN((size_t)(c->end - c->pos), BLERPC_COMPRESS_MAX_MATCH);
+    size_t lowest = c->pos > BLERPC_COMPRESS_WINDOW ? c->pos - BLERPC_COMPRESS_WINDOW : 0;
+    const uint8_t *cur = c->buf + c->pos;
+    size_t best = 0;
+
+    if (max_len < BLERPC_COMPRESS_MIN_MATCH) {
+        return 0;
+    }
+    for (size_t p = c->pos; p-- > lowest;) {
+        const uint8_t *cand = c->buf + p;
+        if (cand[0] != cur[0] || cand[best] != cur[best]) {
+            continue;
+        }
+        size_t n = 1;
+        while (n < max_len && cand[n] == cur[n]) {
+            n++;
+        }
+        if (n > best) {
+            best = n;
+            *distance = c->pos - p;
+            if (best == max_len) {
+                break;
+            }
+        }
+    }
+    return best;
+}
+
+/* Encode one item at pos */
+static int encode_item(struct blerpc_compress *c)
+{
+    size_t distance = 0;
+    size_t len = find_match(c, &distance);
+
+    if (len >= BLERPC_COMPRESS_MIN_MATCH) {
+        uint16_t v = (uint16_t)((distance - 1) | ((len - BLERPC_COMPRESS_MIN_MATCH) << 12));
+        c->group[0] |= BIT(c->group_items);
+        c->group[c->group_len++] = (uint8_t)(v & 0xFF);
+        c->group[c->group_len++] = (uint8_t)(v >> 8);
+        c->pos += len;
+    } else {
+        c->group[c->group_len++] = c->buf[c->pos++];
+    }
+    if (++c->group_items == 8) {
+        return group_flush(c);
+    }
+    return 0;
+}
+
+void blerpc_compress_begin(struct blerpc_compress *c, blerpc_compress_emit_t emit, void *ctx)
+{
+    c->emit = emit;
+    c->emit_ctx = ctx;
+    c->out_len = 0;
+    c->error = 0;
+    c->pos = 0;
+    c->end = 0;
+    c->group[0] = 0;
+    c->group_len = 1;
+    c->group_items = 0;
+}
+
+int blerpc_compress_write(struct blerpc_compress *c, const uint8_t *data, size_t len)
+{
+    while (len > 0 && !c->error) {
+        if (c->end == sizeof(c->buf)) {
+            /* Keep one window of history; less than a match is pending */
+            size_t shift = c->pos - BLERPC_COMPRESS_WINDOW;
+            memmove(c->buf, c->buf + shift, c->end - shift);
+            c->pos -= shift;
+            c->end -= shift;
+        }
+        size_t n = MIN(len, sizeof(c->buf) - c->end);
+        memcpy(c->buf + c->end, data, n);
+        c->end += n;
+        data += n;
+        len -= n;
+
+        while (c->end - c->pos >= BLERPC_COMPRESS_MAX_MATCH && !c->error) {
+            encode_item(c);
+        }
+    }
+    return c->error;
+}
+
+int blerpc_compress_finish(struct blerpc_compress *c)
+{
+    while (c->pos < c->end && !c->error) {
+        encode_item(c);
+    }
+    return group_flush(c);
+}
+
+int blerpc_decompress(const uint8_t *in, size_t in_len, uint8_t *out, size_t out_size,
+                      size_t *out_len)
+{
+    if (in_len < BLERPC_COMPRESS_HEADER_SIZE) {
+        return -1;
+    }
+    size_t raw_len = in[0] | (in[1] << 8);
+    if (raw_len > out_size) {
+        return -1;
+    }
+
+    size_t i = BLERPC_COMPRESS_HEADER_SIZE;
+    size_t o = 0;
+    while (i < in_len) {
+        uint8_t ctrl = in[i++];
+        for (int bit = 0; bit < 8 && i < in_len; bit++) {
+            if (!(ctrl & BIT(bit))) {
+                if (o == raw_len) {
+                    return -1;
+                }
+                out[o++] = in[i++];
+                continue;
+            }
+            if (in_len - i < 2) {
+                return -1;
+            }
+            uint16_t v = in[i] | (in[i + 1] << 8);
+            size_t distance = (v & 0x0FFF) + 1;
+            size_t len = (v >> 12) + BLERPC_COMPRESS_MIN_MATCH;
+            i += 2;
+            if (distance > o || len > raw_len - o) {
+                return -1;
+            }
+            for (size_t k = 0; k < len; k++, o++) {
+                out[o] = out[o - distance];
+            }
+        }
+    }
+    if (o != raw_len) {
+        return -1;
+    }
+    *out_len = o;
+    return 0;
+}
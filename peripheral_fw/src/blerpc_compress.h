@@ -0,0 +1,88 @@
+#ifndef BLERPC_COMPRESS_H
+#define BLERPC_COMPRESS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * LZSS codec for the data field of a command with COMMAND_FLAG_COMPRESSED.
+ *
+ * Compressed data is raw_len(2, little-endian), then groups of up to 8
+ * items, each group led by a control byte whose bit i (LSB first) marks
+ * item i as a match. A literal item is one byte. A match item is 2 bytes,
+ * little-endian: distance - 1 in the low 12 bits and length - 3 in the high
+ * 4, and copies length bytes starting distance bytes back in the output
+ * (the copy may overlap the bytes it produces). The data ends with its last
+ * item.
+ *
+ * The encoder is incremental, so a response can be compressed while it is
+ * encoded and sent; it only keeps the last 2^CONFIG_BLERPC_COMPRESSION_
+ * WINDOW_BITS bytes to match against. Output is deterministic: the same
+ * input always compresses to the same bytes, so a sizing pass gives the
+ * exact length of the real one.
+ */
+
+#define BLERPC_COMPRESS_HEADER_SIZE 2
+#define BLERPC_COMPRESS_MIN_MATCH 3
+#define BLERPC_COMPRESS_MAX_MATCH 18
+#define BLERPC_COMPRESS_WINDOW (1U << CONFIG_BLERPC_COMPRESSION_WINDOW_BITS)
+
+/**
+ * Sink for compressed bytes. Returns 0 on success; anything else stops the
+ * encoder and is returned by every later call.
+ */
+typedef int (*blerpc_compress_emit_t)(const uint8_t *data, size_t len, void *ctx);
+
+/**
+ * Incremental encoder state. buf holds up to BLERPC_COMPRESS_WINDOW bytes of
+ * history followed by bytes not yet encoded, and slides once it fills.
+ */
+struct blerpc_compress {
+    blerpc_compress_emit_t emit;
+    void *emit_ctx;
+    size_t out_len; /* compressed bytes emitted, without the header */
+    int error;
+    uint16_t pos; /* first byte of buf not yet encoded */
+    uint16_t end; /* bytes of buf in use */
+    uint8_t group_len;
+    uint8_t group_items;
+    uint8_t group[1 + 8 * 2];
+    uint8_t buf[2 * BLERPC_COMPRESS_WINDOW + BLERPC_COMPRESS_MAX_MATCH];
+};
+
+/**
+ * Start compressing. The caller sends the raw_len header itself; the
+ * encoder only emits items.
+ */
+void blerpc_compress_begin(struct blerpc_compress *c, blerpc_compress_emit_t emit, void *ctx);
+
+/**
+ * Compress the next len bytes. Items are emitted once enough input follows
+ * them to find the longest match.
+ * @return 0 on success, else the error the sink returned
+ */
+int blerpc_compress_write(struct blerpc_compress *c, const uint8_t *data, size_t len);
+
+/**
+ * Encode the remaining input and emit the last group. c->out_len is then
+ * the compressed length without the header.
+ * @return 0 on success, else the error the sink returned
+ */
+int blerpc_compress_finish(struct blerpc_compress *c);
+
+/**
+ * Decompress a whole data field, header included, into out.
+ * @return 0 on success, -1 if it is malformed or raw_len exceeds out_size
+ */
+int blerpc_decompress(const uint8_t *in, size_t in_len, uint8_t *out, size_t out_size,
+                      size_t *out_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLERPC_COMPRESS_H */
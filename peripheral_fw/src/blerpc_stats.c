@@ -0,0 +1,218 @@
+#include "blerpc_stats.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(blerpc_stats, LOG_LEVEL_INF);
+
+#ifdef CONFIG_STATS
+STATS_SECT_DECL(blerpc_stats) blerpc_stats;
+
+#define BLERPC_STATS_NAME(name) STATS_NAME(blerpc_stats, name)
+STATS_NAME_START(blerpc_stats)
+BLERPC_STATS_COUNTERS(BLERPC_STATS_NAME)
+STATS_NAME_END(blerpc_stats);
+#else
+struct stats_blerpc_stats blerpc_stats;
+#endif
+
+struct stats_hist {
+    uint32_t count;
+    uint32_t total_us; /* wraps after ~71 minutes of samples */
+    uint32_t max_us;
+    uint16_t buckets[BLERPC_STATS_BUCKETS];
+};
+
+struct command_stats {
+    uint32_t calls;
+    uint32_t errors;
+    struct stats_hist phases[BLERPC_STATS_PHASE_COUNT];
+};
+
+/* Indexed by command ID - 1 */
+static struct command_stats command_stats[BLERPC_CMD_COUNT];
+
+/* The request the work queue is processing; only that thread touches it */
+static struct {
+    struct command_stats *cmd;
+    uint32_t us[BLERPC_STATS_PHASE_COUNT];
+    uint8_t recorded; /* bit per phase in us[] */
+    bool failed;
+} cur;
+
+static uint32_t cycles_to_us(uint32_t cycles)
+{
+    return k_cyc_to_us_floor32(cycles);
+}
+
+static void hist_add(struct stats_hist *h, uint32_t us)
+{
+    size_t b = 0;
+    for (uint32_t v = us >> 7; v != 0 && b < BLERPC_STATS_BUCKETS - 1; v >>= 1) {
+        b++;
+    }
+    h->count++;
+    h->total_us += us;
+    h->max_us = MAX(h->max_us, us);
+    if (h->buckets[b] < UINT16_MAX) {
+        h->buckets[b]++;
+    }
+}
+
+void blerpc_stats_request_begin(const struct request_entry *req)
+{
+    uint32_t now = k_cycle_get_32();
+
+    memset(&cur, 0, sizeof(cur));
+    cur.us[BLERPC_STATS_PHASE_ASSEMBLE] = cycles_to_us(req->stats_queued - req->stats_first);
+    cur.us[BLERPC_STATS_PHASE_QUEUE] = cycles_to_us(now - req->stats_queued);
+    cur.recorded = BIT(BLERPC_STATS_PHASE_ASSEMBLE) | BIT(BLERPC_STATS_PHASE_QUEUE);
+#ifdef CONFIG_BLERPC_ENCRYPTION
+    cur.us[BLERPC_STATS_PHASE_DECRYPT] = req->stats_decrypt_us;
+    cur.recorded |= BIT(BLERPC_STATS_PHASE_DECRYPT);
+#endif
+}
+
+void blerpc_stats_request_command(const struct handler_entry *entry)
+{
+    cur.cmd = &command_stats[entry->id - 1];
+}
+
+void blerpc_stats_request_phase(enum blerpc_stats_phase phase, uint32_t start)
+{
+    cur.us[phase] = cycles_to_us(k_cycle_get_32() - start);
+    cur.recorded |= BIT(phase);
+}
+
+void blerpc_stats_request_fail(void)
+{
+    cur.failed = true;
+}
+
+void blerpc_stats_request_end(void)
+{
+    struct command_stats *cs = cur.cmd;
+
+    if (!cs) {
+        return;
+    }
+    cs->calls++;
+    if (cur.failed) {
+        cs->errors++;
+    }
+    for (size_t i = 0; i < BLERPC_STATS_PHASE_COUNT; i++) {
+        if (cur.recorded & BIT(i)) {
+            hist_add(&cs->phases[i], cur.us[i]);
+        }
+    }
+    cur.cmd = NULL;
+}
+
+static uint8_t *put_le32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v & 0xFF);
+    p[1] = (uint8_t)((v >> 8) & 0xFF);
+    p[2] = (uint8_t)((v >> 16) & 0xFF);
+    p[3] = (uint8_t)(v >> 24);
+    return p + 4;
+}
+
+/* Size of one phase in a command page */
+#define PAGE_PHASE_SIZE (12 + 2 * BLERPC_STATS_BUCKETS)
+
+size_t blerpc_stats_page(uint8_t page, uint8_t *buf, size_t size)
+{
+    uint8_t *p = buf;
+
+    if (size < 1) {
+        return 0;
+    }
+    *p++ = page;
+
+    if (page == 0) {
+#define BLERPC_STATS_PUT(name)                                                                   \
+    if ((size_t)(p - buf) + 4 <= size) {                                                         \
+        p = put_le32(p, blerpc_stats.name);                                                      \
+    }
+        BLERPC_STATS_COUNTERS(BLERPC_STATS_PUT)
+#undef BLERPC_STATS_PUT
+        return p - buf;
+    }
+
+    if (page > BLERPC_CMD_COUNT || size < 9) {
+        return p - buf;
+    }
+    const struct command_stats *cs = &command_stats[page - 1];
+    p = put_le32(p, cs->calls);
+    p = put_le32(p, cs->errors);
+    for (size_t i = 0; i < BLERPC_STATS_PHASE_COUNT; i++) {
+        const struct stats_hist *h = &cs->phases[i];
+        if ((size_t)(p - buf) + PAGE_PHASE_SIZE > size) {
+            break;
+        }
+        p = put_le32(p, h->count);
+        p = put_le32(p, h->total_us);
+        p = put_le32(p, h->max_us);
+        for (size_t b = 0; b < BLERPC_STATS_BUCKETS; b++) {
+            *p++ = (uint8_t)(h->buckets[b] & 0xFF);
+            *p++ = (uint8_t)(h->buckets[b] >> 8);
+        }
+    }
+    return p - buf;
+}
+
+#if CONFIG_BLERPC_STATS_LOG_INTERVAL_S > 0
+/* ── Periodic dump, e.g. over RTT ────────────────────────────────────── */
+
+static const char *const phase_names[BLERPC_STATS_PHASE_COUNT] = {
+    "assemble", "decrypt", "queue", "handler", "send",
+};
+
+static void stats_log(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(log_work, stats_log);
+
+static void stats_log(struct k_work *work)
+{
+    (void)work;
+
+    LOG_INF("req %u resp %u busy %u notify retry %u fail %u asm reset %u dec fail %u "
+            "in %u out %u",
+            blerpc_stats.requests, blerpc_stats.responses, blerpc_stats.busy_errors,
+            blerpc_stats.notify_retries, blerpc_stats.notify_failures,
+            blerpc_stats.assembler_resets, blerpc_stats.decrypt_failures, blerpc_stats.bytes_in,
+            blerpc_stats.bytes_out);
+
+    for (uint8_t id = 1; id <= BLERPC_CMD_COUNT; id++) {
+        const struct command_stats *cs = &command_stats[id - 1];
+        const struct handler_entry *entry = handlers_find_id(id);
+        if (cs->calls == 0 || !entry) {
+            continue;
+        }
+        LOG_INF("%s: calls %u errors %u", entry->name, cs->calls, cs->errors);
+        for (size_t i = 0; i < BLERPC_STATS_PHASE_COUNT; i++) {
+            const struct stats_hist *h = &cs->phases[i];
+            if (h->count == 0) {
+                continue;
+            }
+            LOG_INF("  %-8s avg %u us max %u us", phase_names[i], h->total_us / h->count,
+                    h->max_us);
+        }
+    }
+
+    k_work_schedule(&log_work, K_SECONDS(CONFIG_BLERPC_STATS_LOG_INTERVAL_S));
+}
+#endif
+
+void blerpc_stats_init(void)
+{
+#ifdef CONFIG_STATS
+    int rc = STATS_INIT_AND_REG(blerpc_stats, STATS_SIZE_32, "blerpc");
+    if (rc) {
+        LOG_WRN("Stats group registration failed: %d", rc);
+    }
+#endif
+#if CONFIG_BLERPC_STATS_LOG_INTERVAL_S > 0
+    k_work_schedule(&log_work, K_SECONDS(CONFIG_BLERPC_STATS_LOG_INTERVAL_S));
+#endif
+}
@@ -0,0 +1,149 @@
+#ifndef BLERPC_STATS_H
+#define BLERPC_STATS_H
+
+#include <zephyr/kernel.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "generated_handlers.h"
+#include "request_queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Hot-path instrumentation (CONFIG_BLERPC_STATS). Everything here compiles
+ * to nothing when it is disabled. Counters are updated from the BT RX thread
+ * and the work queue without locking, like Zephyr's own stats.
+ */
+
+/* Link counters, in the order CONTROL_CMD_STATS page 0 carries them. Append
+ * new counters at the end so older readers keep working. */
+#define BLERPC_STATS_COUNTERS(X)                                                                 \
+    X(requests)         /* complete requests handed to the work queue */                        \
+    X(responses)        /* responses sent */                                                    \
+    X(busy_errors)      /* ERROR(BUSY) sent */                                                  \
+    X(notify_retries)   /* notifications retried after -ENOMEM */                               \
+    X(notify_failures)  /* notifications given up on */                                         \
+    X(assembler_resets) /* reassemblies dropped before completing */                            \
+    X(decrypt_failures) /* requests that failed decryption */                                   \
+    X(bytes_in)         /* container bytes written by centrals */                               \
+    X(bytes_out)        /* container and bulk bytes sent to centrals */                         \
+    X(cache_hits)       /* responses served from the response cache */
+
+/* Latency phases of a request, each with its own histogram per command */
+enum blerpc_stats_phase {
+    BLERPC_STATS_PHASE_ASSEMBLE, /* FIRST container to the last one */
+    BLERPC_STATS_PHASE_DECRYPT,  /* request decryption, encrypted links only */
+    BLERPC_STATS_PHASE_QUEUE,    /* waiting in blerpc_work_q */
+    BLERPC_STATS_PHASE_HANDLER,  /* sizing or single-pass encode */
+    BLERPC_STATS_PHASE_SEND,     /* response to the stack, incl. streamed encode */
+    BLERPC_STATS_PHASE_COUNT,
+};
+
+/* Bucket 0 counts samples under 128 us, bucket k samples in
+ * [64 << k, 128 << k) us; the last bucket is open-ended */
+#define BLERPC_STATS_BUCKETS 12
+
+#ifdef CONFIG_BLERPC_STATS
+
+#ifdef CONFIG_STATS
+#include <zephyr/stats/stats.h>
+
+/* Registered as Zephyr stats group "blerpc" */
+#define BLERPC_STATS_SECT_ENTRY(name) STATS_SECT_ENTRY32(name)
+STATS_SECT_START(blerpc_stats)
+BLERPC_STATS_COUNTERS(BLERPC_STATS_SECT_ENTRY)
+STATS_SECT_END;
+extern STATS_SECT_DECL(blerpc_stats) blerpc_stats;
+#else
+#define BLERPC_STATS_FIELD(name) uint32_t name;
+struct stats_blerpc_stats {
+    BLERPC_STATS_COUNTERS(BLERPC_STATS_FIELD)
+};
+extern struct stats_blerpc_stats blerpc_stats;
+#endif
+
+#define BLERPC_STATS_ADD(name, n) ((void)(blerpc_stats.name += (uint32_t)(n)))
+#define BLERPC_STATS_INC(name)    BLERPC_STATS_ADD(name, 1)
+/* Store the current cycle count in a request entry's stats_* field */
+#define BLERPC_STATS_STAMP(lvalue) ((void)((lvalue) = k_cycle_get_32()))
+
+static inline uint32_t blerpc_stats_now(void)
+{
+    return k_cycle_get_32();
+}
+
+void blerpc_stats_init(void);
+
+/* Timings of the request the work queue is about to process */
+void blerpc_stats_request_begin(const struct request_entry *req);
+
+/* The handler the request resolved to; no histogram is kept without one */
+void blerpc_stats_request_command(const struct handler_entry *entry);
+
+/* Close a phase that started at start (a blerpc_stats_now() value) */
+void blerpc_stats_request_phase(enum blerpc_stats_phase phase, uint32_t start);
+
+void blerpc_stats_request_fail(void);
+
+/* Fold the request's timings into its command's histograms */
+void blerpc_stats_request_end(void);
+
+/**
+ * Serialize a CONTROL_CMD_STATS page: page(1), then for page 0 every counter
+ * as u32, or for a command ID calls(4) errors(4) and per phase count(4)
+ * total_us(4) max_us(4) buckets(2 each), all little-endian. Phases that do
+ * not fit size are left off; an unknown page is just the page byte.
+ * @return bytes written
+ */
+size_t blerpc_stats_page(uint8_t page, uint8_t *buf, size_t size);
+
+#else /* !CONFIG_BLERPC_STATS */
+
+#define BLERPC_STATS_ADD(name, n)  ((void)0)
+#define BLERPC_STATS_INC(name)     ((void)0)
+#define BLERPC_STATS_STAMP(lvalue) ((void)0)
+
+static inline uint32_t blerpc_stats_now(void)
+{
+    return 0;
+}
+
+static inline void blerpc_stats_init(void)
+{
+}
+
+static inline void blerpc_stats_request_begin(const struct request_entry *req)
+{
+    (void)req;
+}
+
+static inline void blerpc_stats_request_command(const struct handler_entry *entry)
+{
+    (void)entry;
+}
+
+static inline void blerpc_stats_request_phase(enum blerpc_stats_phase phase, uint32_t start)
+{
+    (void)phase;
+    (void)start;
+}
+
+static inline void blerpc_stats_request_fail(void)
+{
+}
+
+static inline void blerpc_stats_request_end(void)
+{
+}
+
+#endif /* CONFIG_BLERPC_STATS */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLERPC_STATS_H */
@@ -87,22 +87,310 @@ int handle_counter_upload(const uint8_t *req_data, size_t req_len,
     return 0;
 }
 
-static const struct handler_entry handler_table[] = {
-    {"echo", 4, handle_echo},
-    {"flash_read", 10, handle_flash_read},
-    {"data_write", 10, handle_data_write},
-    {"counter_stream", 14, handle_counter_stream},
-    {"counter_upload", 14, handle_counter_upload},
-};
+__attribute__((weak))
+int handle_flash_dump(const uint8_t *req_data, size_t req_len,
+                          pb_ostream_t *ostream)
+{
+    blerpc_FlashDumpRequest req = blerpc_FlashDumpRequest_init_zero;
+    pb_istream_t stream = pb_istream_from_buffer(req_data, req_len);
+    if (!pb_decode(&stream, blerpc_FlashDumpRequest_fields, &req)) return -1;
 
-command_handler_fn handlers_lookup(const char *name, uint8_t name_len)
+    blerpc_FlashDumpResponse resp = blerpc_FlashDumpResponse_init_zero;
+    if (!pb_encode(ostream, blerpc_FlashDumpResponse_fields, &resp)) return -1;
+    return 0;
+}
+
+static uint8_t *put_varint32(uint8_t *p, uint32_t v)
+{
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+static uint8_t *put_varint(uint8_t *p, uint64_t v)
 {
-    size_t i;
-    for (i = 0; i < sizeof(handler_table) / sizeof(handler_table[0]); i++) {
-        if (handler_table[i].name_len == name_len &&
-            memcmp(handler_table[i].name, name, name_len) == 0) {
-            return handler_table[i].handler;
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+/* NULL if the varint is truncated, longer than ten bytes or over 64 bits */
+static const uint8_t *get_varint(const uint8_t *p, const uint8_t *end,
+                                 uint64_t *out)
+{
+    uint64_t v = 0;
+    for (unsigned int shift = 0; shift < 70 && p < end; shift += 7) {
+        uint8_t byte = *p++;
+        if (shift == 63 && (byte & 0x7E)) {
+            return NULL; /* bits past 64, nanopb's "varint overflow" */
+        }
+        v |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *out = v;
+            return p;
         }
     }
     return NULL;
 }
+
+size_t blerpc_DataWriteResponse_encode_direct(const blerpc_DataWriteResponse *msg, uint8_t *buf)
+{
+    uint8_t *p = buf;
+    if (msg->length) {
+        *p++ = 0x08;
+        p = put_varint32(p, msg->length);
+    }
+    return (size_t)(p - buf);
+}
+
+size_t blerpc_CounterStreamResponse_encode_direct(const blerpc_CounterStreamResponse *msg, uint8_t *buf)
+{
+    uint8_t *p = buf;
+    if (msg->seq) {
+        *p++ = 0x08;
+        p = put_varint32(p, msg->seq);
+    }
+    if (msg->value) {
+        *p++ = 0x10;
+        p = put_varint(p, (uint64_t)(int64_t)msg->value);
+    }
+    return (size_t)(p - buf);
+}
+
+size_t blerpc_CounterUploadResponse_encode_direct(const blerpc_CounterUploadResponse *msg, uint8_t *buf)
+{
+    uint8_t *p = buf;
+    if (msg->received_count) {
+        *p++ = 0x08;
+        p = put_varint32(p, msg->received_count);
+    }
+    return (size_t)(p - buf);
+}
+
+bool blerpc_FlashReadRequest_decode_direct(const uint8_t *data, size_t len, blerpc_FlashReadRequest *msg)
+{
+    const uint8_t *p = data;
+    const uint8_t *end = data + len;
+    uint64_t tag;
+    uint64_t v;
+
+    *msg = (blerpc_FlashReadRequest)blerpc_FlashReadRequest_init_zero;
+    while (p < end) {
+        p = get_varint(p, end, &tag);
+        p = p ? get_varint(p, end, &v) : NULL;
+        if (!p) goto fallback;
+        switch (tag) {
+        case 0x08:
+            if (v > UINT32_MAX) goto fallback;
+            msg->address = (uint32_t)v;
+            break;
+        case 0x10:
+            if (v > UINT32_MAX) goto fallback;
+            msg->length = (uint32_t)v;
+            break;
+        default:
+            goto fallback;
+        }
+    }
+    return true;
+
+fallback:;
+    /* Not the layout this codec knows: nanopb decides */
+    pb_istream_t stream = pb_istream_from_buffer(data, len);
+    *msg = (blerpc_FlashReadRequest)blerpc_FlashReadRequest_init_zero;
+    return pb_decode(&stream, blerpc_FlashReadRequest_fields, msg);
+}
+
+bool blerpc_CounterStreamRequest_decode_direct(const uint8_t *data, size_t len, blerpc_CounterStreamRequest *msg)
+{
+    const uint8_t *p = data;
+    const uint8_t *end = data + len;
+    uint64_t tag;
+    uint64_t v;
+
+    *msg = (blerpc_CounterStreamRequest)blerpc_CounterStreamRequest_init_zero;
+    while (p < end) {
+        p = get_varint(p, end, &tag);
+        p = p ? get_varint(p, end, &v) : NULL;
+        if (!p) goto fallback;
+        switch (tag) {
+        case 0x08:
+            if (v > UINT32_MAX) goto fallback;
+            msg->count = (uint32_t)v;
+            break;
+        default:
+            goto fallback;
+        }
+    }
+    return true;
+
+fallback:;
+    /* Not the layout this codec knows: nanopb decides */
+    pb_istream_t stream = pb_istream_from_buffer(data, len);
+    *msg = (blerpc_CounterStreamRequest)blerpc_CounterStreamRequest_init_zero;
+    return pb_decode(&stream, blerpc_CounterStreamRequest_fields, msg);
+}
+
+bool blerpc_CounterUploadRequest_decode_direct(const uint8_t *data, size_t len, blerpc_CounterUploadRequest *msg)
+{
+    const uint8_t *p = data;
+    const uint8_t *end = data + len;
+    uint64_t tag;
+    uint64_t v;
+
+    *msg = (blerpc_CounterUploadRequest)blerpc_CounterUploadRequest_init_zero;
+    while (p < end) {
+        p = get_varint(p, end, &tag);
+        p = p ? get_varint(p, end, &v) : NULL;
+        if (!p) goto fallback;
+        switch (tag) {
+        case 0x08:
+            if (v > UINT32_MAX) goto fallback;
+            msg->seq = (uint32_t)v;
+            break;
+        case 0x10:
+            if ((int64_t)v < INT32_MIN || (int64_t)v > INT32_MAX) goto fallback;
+            msg->value = (int32_t)v;
+            break;
+        default:
+            goto fallback;
+        }
+    }
+    return true;
+
+fallback:;
+    /* Not the layout this codec knows: nanopb decides */
+    pb_istream_t stream = pb_istream_from_buffer(data, len);
+    *msg = (blerpc_CounterUploadRequest)blerpc_CounterUploadRequest_init_zero;
+    return pb_decode(&stream, blerpc_CounterUploadRequest_fields, msg);
+}
+
+bool blerpc_FlashDumpRequest_decode_direct(const uint8_t *data, size_t len, blerpc_FlashDumpRequest *msg)
+{
+    const uint8_t *p = data;
+    const uint8_t *end = data + len;
+    uint64_t tag;
+    uint64_t v;
+
+    *msg = (blerpc_FlashDumpRequest)blerpc_FlashDumpRequest_init_zero;
+    while (p < end) {
+        p = get_varint(p, end, &tag);
+        p = p ? get_varint(p, end, &v) : NULL;
+        if (!p) goto fallback;
+        switch (tag) {
+        case 0x08:
+            if (v > UINT32_MAX) goto fallback;
+            msg->address = (uint32_t)v;
+            break;
+        case 0x10:
+            if (v > UINT32_MAX) goto fallback;
+            msg->length = (uint32_t)v;
+            break;
+        default:
+            goto fallback;
+        }
+    }
+    return true;
+
+fallback:;
+    /* Not the layout this codec knows: nanopb decides */
+    pb_istream_t stream = pb_istream_from_buffer(data, len);
+    *msg = (blerpc_FlashDumpRequest)blerpc_FlashDumpRequest_init_zero;
+    return pb_decode(&stream, blerpc_FlashDumpRequest_fields, msg);
+}
+
+/* Encoded response size bounds, 0 when nanopb cannot bound the message */
+#ifdef blerpc_EchoResponse_size
+#define ECHO_RESP_MAX_SIZE blerpc_EchoResponse_size
+#else
+#define ECHO_RESP_MAX_SIZE 0
+#endif
+#ifdef blerpc_FlashReadResponse_size
+#define FLASH_READ_RESP_MAX_SIZE blerpc_FlashReadResponse_size
+#else
+#define FLASH_READ_RESP_MAX_SIZE 0
+#endif
+#ifdef blerpc_DataWriteResponse_size
+#define DATA_WRITE_RESP_MAX_SIZE blerpc_DataWriteResponse_size
+#else
+#define DATA_WRITE_RESP_MAX_SIZE 0
+#endif
+#ifdef blerpc_CounterStreamResponse_size
+#define COUNTER_STREAM_RESP_MAX_SIZE blerpc_CounterStreamResponse_size
+#else
+#define COUNTER_STREAM_RESP_MAX_SIZE 0
+#endif
+#ifdef blerpc_CounterUploadResponse_size
+#define COUNTER_UPLOAD_RESP_MAX_SIZE blerpc_CounterUploadResponse_size
+#else
+#define COUNTER_UPLOAD_RESP_MAX_SIZE 0
+#endif
+#ifdef blerpc_FlashDumpResponse_size
+#define FLASH_DUMP_RESP_MAX_SIZE blerpc_FlashDumpResponse_size
+#else
+#define FLASH_DUMP_RESP_MAX_SIZE 0
+#endif
+
+/* Incremental-decode handlers, NULL unless the application defines them */
+__attribute__((weak)) int handle_data_write_istream(pb_istream_t *istream,
+                                                    pb_ostream_t *ostream);
+
+static const struct handler_entry handler_table[] = {
+    {"echo", 4, handle_echo, ECHO_RESP_MAX_SIZE, NULL, 0, HANDLER_STREAM_NONE, 1},
+    {"flash_read", 10, handle_flash_read, FLASH_READ_RESP_MAX_SIZE, NULL, 5000, HANDLER_STREAM_NONE, 2},
+    {"data_write", 10, handle_data_write, DATA_WRITE_RESP_MAX_SIZE, handle_data_write_istream, 0, HANDLER_STREAM_NONE, 3},
+    {"counter_stream", 14, handle_counter_stream, COUNTER_STREAM_RESP_MAX_SIZE, NULL, 0, HANDLER_STREAM_P2C, 4},
+    {"counter_upload", 14, handle_counter_upload, COUNTER_UPLOAD_RESP_MAX_SIZE, NULL, 0, HANDLER_STREAM_C2P, 5},
+    {"flash_dump", 10, handle_flash_dump, FLASH_DUMP_RESP_MAX_SIZE, NULL, 0, HANDLER_STREAM_P2C, 6},
+};
+
+/* Perfect hash of the command names: slot holds table index + 1, 0 if empty */
+#define HANDLER_HASH_SEED 0x811c9dc5u
+#define HANDLER_SLOT_MASK 0xfu
+static const uint8_t handler_slots[] = {
+    0, 0, 0, 0, 1, 5, 0, 0, 6, 3, 2, 0, 4, 0, 0, 0,
+};
+
+static uint32_t name_hash(const char *name, uint8_t name_len)
+{
+    uint32_t h = HANDLER_HASH_SEED;
+    for (uint8_t i = 0; i < name_len; i++) {
+        h ^= (uint8_t)name[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+const struct handler_entry *handlers_find(const char *name, uint8_t name_len)
+{
+    uint8_t slot = handler_slots[name_hash(name, name_len) & HANDLER_SLOT_MASK];
+    if (slot == 0) {
+        return NULL;
+    }
+    const struct handler_entry *entry = &handler_table[slot - 1];
+    if (entry->name_len != name_len || memcmp(entry->name, name, name_len) != 0) {
+        return NULL;
+    }
+    return entry;
+}
+
+const struct handler_entry *handlers_find_id(uint8_t id)
+{
+    /* IDs are table positions + 1 */
+    if (id == 0 || id > sizeof(handler_table) / sizeof(handler_table[0])) {
+        return NULL;
+    }
+    return &handler_table[id - 1];
+}
+
+command_handler_fn handlers_lookup(const char *name, uint8_t name_len)
+{
+    const struct handler_entry *entry = handlers_find(name, name_len);
+    return entry ? entry->handler : NULL;
+}
@@ -5,6 +5,8 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <pb_encode.h>
+#include <pb_decode.h>
+#include "blerpc.pb.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -13,13 +15,45 @@ extern "C" {
 typedef int (*command_handler_fn)(const uint8_t *req_data, size_t req_len,
                                   pb_ostream_t *ostream);
 
+/* Decodes the request straight from a stream fed as containers arrive */
+typedef int (*command_istream_handler_fn)(pb_istream_t *istream, pb_ostream_t *ostream);
+
+/* Stream direction of a command, from streaming.txt */
+enum handler_stream {
+    HANDLER_STREAM_NONE,
+    HANDLER_STREAM_P2C, /* handler starts a peripheral-to-central stream */
+    HANDLER_STREAM_C2P, /* handler consumes one central-to-peripheral message */
+};
+
 struct handler_entry {
     const char *name;
     uint8_t name_len;
     command_handler_fn handler;
+    size_t max_resp_size; /* encoded response bound, 0 if unbounded */
+    command_istream_handler_fn istream_handler; /* NULL if not implemented */
+    uint32_t cache_ttl_ms; /* response cache lifetime (cache.txt), 0 if not cached */
+    enum handler_stream stream;
+    uint8_t id; /* wire ID, the *_CMD_ID_* value */
 };
 
 command_handler_fn handlers_lookup(const char *name, uint8_t name_len);
+const struct handler_entry *handlers_find(const char *name, uint8_t name_len);
+
+/* Look up a handler by its wire ID (see the *_CMD_ID_* macros) */
+const struct handler_entry *handlers_find_id(uint8_t id);
+
+/* Command IDs for the 1-byte wire form, dense in schema order: append new
+ * commands to keep existing IDs stable. 0 means the command has no ID. */
+#define BLERPC_CMD_ID_ECHO 1
+#define BLERPC_CMD_ID_FLASH_READ 2
+#define BLERPC_CMD_ID_DATA_WRITE 3
+#define BLERPC_CMD_ID_COUNTER_STREAM 4
+#define BLERPC_CMD_ID_COUNTER_UPLOAD 5
+#define BLERPC_CMD_ID_FLASH_DUMP 6
+#define BLERPC_CMD_COUNT 6
+
+/* Identifies the ID assignment; peers only use IDs when theirs match */
+#define BLERPC_SCHEMA_HASH 0x59de
 
 int handle_echo(const uint8_t *req_data, size_t req_len,
                     pb_ostream_t *ostream);
@@ -29,6 +63,8 @@ int handle_flash_read(const uint8_t *req_data, size_t req_len,
 
 int handle_data_write(const uint8_t *req_data, size_t req_len,
                           pb_ostream_t *ostream);
+/* Optional: define to decode large requests as they arrive */
+int handle_data_write_istream(pb_istream_t *istream, pb_ostream_t *ostream);
 
 int handle_counter_stream(const uint8_t *req_data, size_t req_len,
                               pb_ostream_t *ostream);
@@ -36,6 +72,21 @@ int handle_counter_stream(const uint8_t *req_data, size_t req_len,
 int handle_counter_upload(const uint8_t *req_data, size_t req_len,
                               pb_ostream_t *ostream);
 
+int handle_flash_dump(const uint8_t *req_data, size_t req_len,
+                          pb_ostream_t *ostream);
+
+/* Direct codecs for fixed-layout messages (varint scalars only): the bytes
+ * pb_encode() writes, without walking nanopb's field tables. An encode
+ * buffer holds <message>_size bytes; decode leaves anything unexpected to
+ * pb_decode(). */
+size_t blerpc_DataWriteResponse_encode_direct(const blerpc_DataWriteResponse *msg, uint8_t *buf);
+size_t blerpc_CounterStreamResponse_encode_direct(const blerpc_CounterStreamResponse *msg, uint8_t *buf);
+size_t blerpc_CounterUploadResponse_encode_direct(const blerpc_CounterUploadResponse *msg, uint8_t *buf);
+bool blerpc_FlashReadRequest_decode_direct(const uint8_t *data, size_t len, blerpc_FlashReadRequest *msg);
+bool blerpc_CounterStreamRequest_decode_direct(const uint8_t *data, size_t len, blerpc_CounterStreamRequest *msg);
+bool blerpc_CounterUploadRequest_decode_direct(const uint8_t *data, size_t len, blerpc_CounterUploadRequest *msg);
+bool blerpc_FlashDumpRequest_decode_direct(const uint8_t *data, size_t len, blerpc_FlashDumpRequest *msg);
+
 #ifdef __cplusplus
 }
 #endif
@@ -11,11 +11,11 @@
 #include <zephyr/logging/log.h>
 #if IS_ENABLED(CONFIG_FLASH)
 #include <zephyr/drivers/flash.h>
+#include <zephyr/sys/crc.h>
 #endif
 
 LOG_MODULE_REGISTER(handlers, LOG_LEVEL_INF);
 
-#define MAX_FLASH_READ_SIZE 8192
 #define MAX_COUNTER_STREAM_COUNT 10000
 
 int handle_echo(const uint8_t *req_data, size_t req_len, pb_ostream_t *ostream)
@@ -49,6 +49,102 @@ struct flash_encode_ctx {
     uint32_t length;
 };
 
+#ifdef CONFIG_BLERPC_FLASH_READ_XIP
+
+BUILD_ASSERT(DT_SAME_NODE(DT_PARENT(DT_CHOSEN(zephyr_flash)), DT_CHOSEN(zephyr_flash_controller)),
+             "XIP flash_read needs zephyr,flash to belong to zephyr,flash-controller");
+
+static inline const uint8_t *flash_xip_ptr(uint32_t address)
+{
+    return (const uint8_t *)(uintptr_t)(DT_REG_ADDR(DT_CHOSEN(zephyr_flash)) + address);
+}
+
+/* Internal flash is memory-mapped: hand the encoder a pointer, no copy */
+static bool flash_stream(pb_ostream_t *stream, const struct flash_encode_ctx *ctx)
+{
+    return pb_write(stream, flash_xip_ptr(ctx->address), ctx->length);
+}
+
+#else
+
+/* Double-buffered reader: the system work queue fills one buffer while the
+ * blerpc work queue drains the other into the container stream, which
+ * mostly means waiting for TX credits. Each read stops at a page boundary,
+ * so after the first one reads are page-aligned. */
+struct flash_pipe {
+    const struct device *flash_dev;
+    struct k_work read_work;
+    struct k_sem filled;
+    uint32_t addr;      /* next address to read */
+    uint32_t remaining; /* bytes not yet read */
+    uint8_t fill;       /* buffer read_work writes into */
+    uint32_t len[2];
+    int rc;
+    uint8_t buf[2][CONFIG_BLERPC_FLASH_READ_BUF_SIZE] __aligned(4);
+};
+
+static struct flash_pipe flash_pipe;
+
+static void flash_pipe_read(struct k_work *work)
+{
+    struct flash_pipe *pipe = CONTAINER_OF(work, struct flash_pipe, read_work);
+    uint32_t n = MIN(pipe->remaining, sizeof(pipe->buf[0]));
+    struct flash_pages_info page;
+
+    if (flash_get_page_info_by_offs(pipe->flash_dev, pipe->addr, &page) == 0) {
+        n = MIN(n, page.start_offset + page.size - pipe->addr);
+    }
+    pipe->rc = flash_read(pipe->flash_dev, pipe->addr, pipe->buf[pipe->fill], n);
+    pipe->len[pipe->fill] = n;
+    pipe->addr += n;
+    pipe->remaining -= n;
+    k_sem_give(&pipe->filled);
+}
+
+static bool flash_stream(pb_ostream_t *stream, const struct flash_encode_ctx *ctx)
+{
+    struct flash_pipe *pipe = &flash_pipe;
+
+    if (ctx->length == 0) {
+        return true;
+    }
+    pipe->flash_dev = ctx->flash_dev;
+    pipe->addr = ctx->address;
+    pipe->remaining = ctx->length;
+    pipe->fill = 0;
+    k_work_submit(&pipe->read_work);
+
+    uint8_t cur = 0;
+    bool ok = true;
+    bool pending = true;
+    while (pending) {
+        k_sem_take(&pipe->filled, K_FOREVER);
+        pending = false;
+        if (pipe->rc != 0) {
+            LOG_ERR("FlashRead: flash_read failed: %d", pipe->rc);
+            return false;
+        }
+        /* Start the next read before draining this one */
+        if (pipe->remaining > 0) {
+            pipe->fill = cur ^ 1;
+            k_work_submit(&pipe->read_work);
+            pending = true;
+        }
+        if (!pb_write(stream, pipe->buf[cur], pipe->len[cur])) {
+            ok = false;
+            break;
+        }
+        cur ^= 1;
+    }
+    if (pending) {
+        /* The buffers are reused by the next request */
+        k_sem_take(&pipe->filled, K_FOREVER);
+    }
+    return ok;
+}
+
+#endif /* CONFIG_BLERPC_FLASH_READ_XIP */
+
 static bool flash_data_encode_cb(pb_ostream_t *stream, const pb_field_t *field, void *const *arg)
 {
     struct flash_encode_ctx *ctx = *(struct flash_encode_ctx **)arg;
@@ -58,18 +154,36 @@ static bool flash_data_encode_cb(pb_ostream_t *stream, const pb_field_t *field,
     if (!pb_encode_varint(stream, ctx->length))
         return false;
 
-    /* Read flash in chunks and stream directly to protobuf encoder */
-    uint8_t chunk[256];
-    uint32_t addr = ctx->address;
-    uint32_t remaining = ctx->length;
-    while (remaining > 0) {
-        uint32_t n = MIN(remaining, sizeof(chunk));
-        if (flash_read(ctx->flash_dev, addr, chunk, n) != 0)
-            return false;
-        if (!pb_write(stream, chunk, n))
+    /* Sizing pass only counts bytes; skip the flash reads */
+    if (stream->callback == NULL) {
+        return pb_write(stream, NULL, ctx->length);
+    }
+
+    return flash_stream(stream, ctx);
+}
+
+/* Validate flash read address bounds */
+static bool flash_range_valid(const struct device *flash_dev, uint32_t address, uint32_t length)
+{
+#if defined(CONFIG_BLERPC_MAX_FLASH_READ_ADDRESS) && CONFIG_BLERPC_MAX_FLASH_READ_ADDRESS > 0
+    if (length > 0 && ((uint64_t)address + length > CONFIG_BLERPC_MAX_FLASH_READ_ADDRESS ||
+                       address + length < address)) {
+        LOG_ERR("Flash: address 0x%08x + length %u exceeds max allowed address 0x%x", address,
+                length, CONFIG_BLERPC_MAX_FLASH_READ_ADDRESS);
+        return false;
+    }
+#endif
+    struct flash_pages_info page_info;
+    size_t page_count = flash_get_page_count(flash_dev);
+    if (page_count > 0 && flash_get_page_info_by_idx(flash_dev, page_count - 1, &page_info) == 0) {
+        size_t flash_size = page_info.start_offset + page_info.size;
+        /* Check for integer overflow and out-of-bounds */
+        if (length > 0 &&
+            ((uint64_t)address + length > flash_size || address + length < address)) {
+            LOG_ERR("Flash: address 0x%08x + length %u out of bounds (flash_size=%zu)", address,
+                    length, flash_size);
             return false;
-        addr += n;
-        remaining -= n;
+        }
     }
     return true;
 }
@@ -86,8 +200,9 @@ int handle_flash_read(const uint8_t *req_data, size_t req_len, pb_ostream_t *ost
 
     LOG_INF("FlashRead: addr=0x%08x len=%u", req.address, req.length);
 
-    if (req.length > MAX_FLASH_READ_SIZE) {
-        LOG_ERR("FlashRead: requested length %u exceeds max %d", req.length, MAX_FLASH_READ_SIZE);
+    if (req.length > CONFIG_BLERPC_MAX_FLASH_READ_SIZE) {
+        LOG_ERR("FlashRead: requested length %u exceeds max %d", req.length,
+                CONFIG_BLERPC_MAX_FLASH_READ_SIZE);
         return -1;
     }
 
@@ -97,28 +212,9 @@ int handle_flash_read(const uint8_t *req_data, size_t req_len, pb_ostream_t *ost
         return -1;
     }
 
-    /* Validate flash read address bounds */
-#if defined(CONFIG_BLERPC_MAX_FLASH_READ_ADDRESS) && CONFIG_BLERPC_MAX_FLASH_READ_ADDRESS > 0
-    if (req.length > 0 &&
-        ((uint64_t)req.address + req.length > CONFIG_BLERPC_MAX_FLASH_READ_ADDRESS ||
-         req.address + req.length < req.address)) {
-        LOG_ERR("FlashRead: address 0x%08x + length %u exceeds max allowed address 0x%x",
-                req.address, req.length, CONFIG_BLERPC_MAX_FLASH_READ_ADDRESS);
+    if (!flash_range_valid(flash_dev, req.address, req.length)) {
         return -1;
     }
-#endif
-    struct flash_pages_info page_info;
-    size_t page_count = flash_get_page_count(flash_dev);
-    if (page_count > 0 && flash_get_page_info_by_idx(flash_dev, page_count - 1, &page_info) == 0) {
-        size_t flash_size = page_info.start_offset + page_info.size;
-        /* Check for integer overflow and out-of-bounds */
-        if (req.length > 0 && ((uint64_t)req.address + req.length > flash_size ||
-                               req.address + req.length < req.address)) {
-            LOG_ERR("FlashRead: address 0x%08x + length %u out of bounds (flash_size=%zu)",
-                    req.address, req.length, flash_size);
-            return -1;
-        }
-    }
 
     struct flash_encode_ctx ctx = {
         .flash_dev = flash_dev,
@@ -139,6 +235,134 @@ int handle_flash_read(const uint8_t *req_data, size_t req_len, pb_ostream_t *ost
     return 0;
 }
 
+/* ── flash_dump: P→C stream ───────────────────────────────────────── */
+
+#define FLASH_DUMP_CHUNK CONFIG_BLERPC_FLASH_DUMP_CHUNK_SIZE
+/* offset and crc32 varints plus the data tag and length */
+#define FLASH_DUMP_PB_MAX (FLASH_DUMP_CHUNK + 16)
+
+struct bytes_encode_ctx {
+    const uint8_t *data;
+    size_t len;
+};
+
+static bool bytes_encode_cb(pb_ostream_t *stream, const pb_field_t *field, void *const *arg)
+{
+    const struct bytes_encode_ctx *ctx = *(const struct bytes_encode_ctx **)arg;
+
+    if (!pb_encode_tag_for_field(stream, field))
+        return false;
+    return pb_encode_string(stream, ctx->data, ctx->len);
+}
+
+/* Returns the chunk's bytes, or NULL if the flash read fails */
+static const uint8_t *flash_dump_chunk(const struct device *flash_dev, uint32_t address,
+                                       uint32_t len)
+{
+#ifdef CONFIG_BLERPC_FLASH_READ_XIP
+    (void)flash_dev;
+    (void)len;
+    return flash_xip_ptr(address);
+#else
+    static uint8_t chunk_buf[FLASH_DUMP_CHUNK] __aligned(4);
+    int rc = flash_read(flash_dev, address, chunk_buf, len);
+    if (rc != 0) {
+        LOG_ERR("FlashDump: flash_read failed: %d", rc);
+        return NULL;
+    }
+    return chunk_buf;
+#endif
+}
+
+/* Per link; the stream engine reads the range after the handler returns */
+struct flash_dump_state {
+    const struct device *flash_dev;
+    uint32_t address;
+    uint32_t length;
+};
+static struct flash_dump_state flash_dump_states[CONFIG_BT_MAX_CONN];
+
+BUILD_ASSERT(BLE_SERVICE_STREAM_MSG_OVERHEAD(10) + FLASH_DUMP_PB_MAX <=
+                 CONFIG_BLERPC_STREAM_BUF_SIZE,
+             "a flash_dump chunk must fit CONFIG_BLERPC_STREAM_BUF_SIZE");
+
+/* Message index covers the chunk index * FLASH_DUMP_CHUNK bytes into the
+ * range; asked again, it reads and encodes the same chunk */
+static int flash_dump_next(void *ctx, uint32_t index, pb_ostream_t *ostream)
+{
+    const struct flash_dump_state *st = ctx;
+    uint64_t pos = (uint64_t)index * FLASH_DUMP_CHUNK;
+    if (pos >= st->length) {
+        return -ENODATA;
+    }
+
+    uint32_t offset = st->address + (uint32_t)pos;
+    uint32_t n = MIN(st->length - (uint32_t)pos, FLASH_DUMP_CHUNK);
+    const uint8_t *data = flash_dump_chunk(st->flash_dev, offset, n);
+    if (!data) {
+        return -EIO;
+    }
+    struct bytes_encode_ctx data_ctx = {.data = data, .len = n};
+
+    blerpc_FlashDumpResponse resp = blerpc_FlashDumpResponse_init_zero;
+    resp.offset = offset;
+    resp.data.funcs.encode = bytes_encode_cb;
+    resp.data.arg = &data_ctx;
+    resp.crc32 = crc32_ieee(data, n);
+    return pb_encode(ostream, blerpc_FlashDumpResponse_fields, &resp) ? 0 : -EIO;
+}
+
+/* Every chunk is self-describing (absolute offset plus CRC), so a central
+ * that loses the link resumes by requesting the range it has not verified. */
+int handle_flash_dump(const uint8_t *req_data, size_t req_len, pb_ostream_t *ostream)
+{
+    (void)ostream; /* Not used — the stream engine sends the responses */
+
+    blerpc_FlashDumpRequest req = blerpc_FlashDumpRequest_init_zero;
+    pb_istream_t stream = pb_istream_from_buffer(req_data, req_len);
+
+    if (!pb_decode(&stream, blerpc_FlashDumpRequest_fields, &req)) {
+        LOG_ERR("FlashDump decode failed: %s", PB_GET_ERROR(&stream));
+        return -1;
+    }
+
+    LOG_INF("FlashDump: addr=0x%08x len=%u", req.address, req.length);
+
+    const struct device *flash_dev = DEVICE_DT_GET(DT_CHOSEN(zephyr_flash_controller));
+    if (!device_is_ready(flash_dev)) {
+        LOG_ERR("Flash device not ready");
+        return -1;
+    }
+    if (!flash_range_valid(flash_dev, req.address, req.length)) {
+        return -1;
+    }
+
+    struct bt_conn *conn = ble_service_current_conn();
+    uint8_t index = bt_conn_index(conn);
+    if (index >= ARRAY_SIZE(flash_dump_states)) {
+        return -1;
+    }
+    struct flash_dump_state *st = &flash_dump_states[index];
+    const struct ble_service_p2c_stream desc = {
+        .cmd_name = "flash_dump",
+        .cmd_name_len = 10,
+        .next = flash_dump_next,
+        .ctx = st,
+    };
+    int rc = ble_service_stream_p2c_start(conn, &desc);
+    if (rc != 0) {
+        LOG_ERR("FlashDump start failed: %d", rc);
+        return -1;
+    }
+    /* The engine runs on this work queue, so it has not read the range yet */
+    st->flash_dev = flash_dev;
+    st->address = req.address;
+    st->length = req.length;
+
+    /* Return -2: process_request will skip normal response */
+    return -2;
+}
+
 #endif /* CONFIG_FLASH */
 
 /* Callback for decoding DataWriteRequest.data — count bytes, discard data */
@@ -168,42 +392,32 @@ static bool data_write_decode_cb(pb_istream_t *stream, const pb_field_t *field,
 
 /* ── counter_stream: P→C stream ───────────────────────────────────── */
 
-static int send_one_counter_stream_response(uint32_t seq, int32_t value)
-{
-    blerpc_CounterStreamResponse resp = blerpc_CounterStreamResponse_init_zero;
-    resp.seq = seq;
-    resp.value = value;
+/* Messages per link; the stream engine produces them after the handler
+ * returns */
+static uint32_t counter_stream_counts[CONFIG_BT_MAX_CONN];
 
-    /* Encode protobuf to buffer */
-    uint8_t pb_buf[blerpc_CounterStreamResponse_size];
-    pb_ostream_t ostream = pb_ostream_from_buffer(pb_buf, sizeof(pb_buf));
-    if (!pb_encode(&ostream, blerpc_CounterStreamResponse_fields, &resp)) {
-        LOG_ERR("CounterStream encode failed");
-        return -1;
-    }
-
-    /* Build command response */
-    static uint8_t cmd_buf[64];
-    int cmd_len = command_serialize(COMMAND_TYPE_RESPONSE, "counter_stream", 14, pb_buf,
-                                    (uint16_t)ostream.bytes_written, cmd_buf, sizeof(cmd_buf));
-    if (cmd_len < 0) {
-        return -1;
+static int counter_stream_next(void *ctx, uint32_t index, pb_ostream_t *ostream)
+{
+    const uint32_t *count = ctx;
+    if (index >= *count) {
+        return -ENODATA;
     }
 
-    /* Send via ble_service helper (handles encryption if active) */
-    uint8_t tid = ble_service_next_transaction_id();
-    return ble_service_send_command_response(tid, cmd_buf, (size_t)cmd_len);
+    blerpc_CounterStreamResponse resp = blerpc_CounterStreamResponse_init_zero;
+    resp.seq = index;
+    resp.value = (int32_t)(index * 10);
+    uint8_t buf[blerpc_CounterStreamResponse_size];
+    size_t len = blerpc_CounterStreamResponse_encode_direct(&resp, buf);
+    return pb_write(ostream, buf, len) ? 0 : -EIO;
 }
 
 int handle_counter_stream(const uint8_t *req_data, size_t req_len, pb_ostream_t *ostream)
 {
-    (void)ostream; /* Not used — we send responses directly */
+    (void)ostream; /* Not used — the stream engine sends the responses */
 
-    blerpc_CounterStreamRequest req = blerpc_CounterStreamRequest_init_zero;
-    pb_istream_t stream = pb_istream_from_buffer(req_data, req_len);
-
-    if (!pb_decode(&stream, blerpc_CounterStreamRequest_fields, &req)) {
-        LOG_ERR("CounterStream decode failed: %s", PB_GET_ERROR(&stream));
+    blerpc_CounterStreamRequest req;
+    if (!blerpc_CounterStreamRequest_decode_direct(req_data, req_len, &req)) {
+        LOG_ERR("CounterStream decode failed");
         return -1;
     }
 
@@ -214,18 +428,24 @@ int handle_counter_stream(const uint8_t *req_data, size_t req_len, pb_ostream_t
         return -1;
     }
 
-    /* Send N responses, each with its own transaction_id */
-    for (uint32_t i = 0; i < req.count; i++) {
-        int rc = send_one_counter_stream_response(i, (int32_t)(i * 10));
-        if (rc != 0) {
-            LOG_ERR("CounterStream send %u failed: %d", i, rc);
-            return -1;
-        }
+    struct bt_conn *conn = ble_service_current_conn();
+    uint8_t index = bt_conn_index(conn);
+    if (index >= ARRAY_SIZE(counter_stream_counts)) {
+        return -1;
     }
-
-    /* Send STREAM_END_P2C */
-    uint8_t tid = ble_service_next_transaction_id();
-    ble_service_send_stream_end_p2c(tid);
+    const struct ble_service_p2c_stream desc = {
+        .cmd_name = "counter_stream",
+        .cmd_name_len = 14,
+        .next = counter_stream_next,
+        .ctx = &counter_stream_counts[index],
+    };
+    int rc = ble_service_stream_p2c_start(conn, &desc);
+    if (rc != 0) {
+        LOG_ERR("CounterStream start failed: %d", rc);
+        return -1;
+    }
+    /* The engine runs on this work queue, so it has not read the count yet */
+    counter_stream_counts[index] = req.count;
 
     /* Return -2: process_request will skip normal response */
     return -2;
@@ -233,33 +453,54 @@ int handle_counter_stream(const uint8_t *req_data, size_t req_len, pb_ostream_t
 
 /* ── counter_upload: C→P stream (accumulation) ────────────────────── */
 
-static atomic_t upload_count;
+/* Upload progress per link, indexed by bt_conn_index() */
+struct upload_state {
+    atomic_t count;
+    struct k_work response_work;
+    struct bt_conn *conn; /* referenced while a response is pending */
+};
 
-static void send_upload_response(struct k_work *work);
-static K_WORK_DEFINE(upload_response_work, send_upload_response);
+static struct upload_state upload_states[CONFIG_BT_MAX_CONN];
 
-static void on_stream_end_c2p(uint8_t transaction_id)
+static struct upload_state *upload_state_get(struct bt_conn *conn)
+{
+    uint8_t index = bt_conn_index(conn);
+    return index < ARRAY_SIZE(upload_states) ? &upload_states[index] : NULL;
+}
+
+static void on_stream_end_c2p(struct bt_conn *conn, uint8_t transaction_id)
 {
     (void)transaction_id;
-    LOG_INF("STREAM_END_C2P received, upload_count=%ld", atomic_get(&upload_count));
-    ble_service_submit_work(&upload_response_work);
+    struct upload_state *up = upload_state_get(conn);
+    if (!up) {
+        return;
+    }
+    LOG_INF("STREAM_END_C2P received, upload_count=%ld", atomic_get(&up->count));
+    if (up->conn) {
+        /* Previous response still pending; it will report this upload too */
+        return;
+    }
+    up->conn = bt_conn_ref(conn);
+    ble_service_submit_work(&up->response_work);
 }
 
 int handle_counter_upload(const uint8_t *req_data, size_t req_len, pb_ostream_t *ostream)
 {
     (void)ostream;
 
-    blerpc_CounterUploadRequest req = blerpc_CounterUploadRequest_init_zero;
-    pb_istream_t stream = pb_istream_from_buffer(req_data, req_len);
-
-    if (!pb_decode(&stream, blerpc_CounterUploadRequest_fields, &req)) {
-        LOG_ERR("CounterUpload decode failed: %s", PB_GET_ERROR(&stream));
+    blerpc_CounterUploadRequest req;
+    if (!blerpc_CounterUploadRequest_decode_direct(req_data, req_len, &req)) {
+        LOG_ERR("CounterUpload decode failed");
         return -1;
     }
 
-    atomic_inc(&upload_count);
+    struct upload_state *up = upload_state_get(ble_service_current_conn());
+    if (!up) {
+        return -1;
+    }
+    atomic_inc(&up->count);
     LOG_DBG("CounterUpload: seq=%u value=%d (total=%ld)", req.seq, req.value,
-            atomic_get(&upload_count));
+            atomic_get(&up->count));
 
     /* Return -2: no response for individual stream messages */
     return -2;
@@ -267,9 +508,13 @@ int handle_counter_upload(const uint8_t *req_data, size_t req_len, pb_ostream_t
 
 static void send_upload_response(struct k_work *work)
 {
-    (void)work;
+    struct upload_state *up = CONTAINER_OF(work, struct upload_state, response_work);
 
-    atomic_val_t count = atomic_set(&upload_count, 0);
+    /* Release the slot before reading the count, so a STREAM_END_C2P that
+     * arrives meanwhile schedules a fresh response instead of being lost */
+    struct bt_conn *conn = up->conn;
+    up->conn = NULL;
+    atomic_val_t count = atomic_set(&up->count, 0);
 
     LOG_INF("CounterUpload: sending response, received_count=%ld", count);
 
@@ -279,31 +524,43 @@ static void send_upload_response(struct k_work *work)
 
     uint8_t pb_buf[blerpc_CounterUploadResponse_size];
     pb_ostream_t ostream = pb_ostream_from_buffer(pb_buf, sizeof(pb_buf));
+    static uint8_t cmd_buf[64];
+    int cmd_len = -1;
     if (!pb_encode(&ostream, blerpc_CounterUploadResponse_fields, &resp)) {
         LOG_ERR("CounterUploadResponse encode failed");
-        return;
+    } else {
+        /* Build command response */
+        cmd_len = command_serialize(COMMAND_TYPE_RESPONSE, "counter_upload", 14, pb_buf,
+                                    (uint16_t)ostream.bytes_written, cmd_buf, sizeof(cmd_buf));
+        if (cmd_len < 0) {
+            LOG_ERR("Command serialize failed");
+        }
     }
 
-    /* Build command response */
-    static uint8_t cmd_buf[64];
-    int cmd_len = command_serialize(COMMAND_TYPE_RESPONSE, "counter_upload", 14, pb_buf,
-                                    (uint16_t)ostream.bytes_written, cmd_buf, sizeof(cmd_buf));
-    if (cmd_len < 0) {
-        LOG_ERR("Command serialize failed");
-        return;
+    if (cmd_len >= 0) {
+        /* Send via ble_service helper (handles encryption if active) */
+        uint8_t tid = ble_service_next_transaction_id(conn);
+        ble_service_send_command_response(conn, tid, cmd_buf, (size_t)cmd_len);
     }
 
-    /* Send via ble_service helper (handles encryption if active) */
-    uint8_t tid = ble_service_next_transaction_id();
-    ble_service_send_command_response(tid, cmd_buf, (size_t)cmd_len);
+    bt_conn_unref(conn);
 }
 
-void handlers_stream_init(void)
+void handlers_init(void)
 {
+#if IS_ENABLED(CONFIG_FLASH) && !defined(CONFIG_BLERPC_FLASH_READ_XIP)
+    k_work_init(&flash_pipe.read_work, flash_pipe_read);
+    k_sem_init(&flash_pipe.filled, 0, 1);
+#endif
+    for (size_t i = 0; i < ARRAY_SIZE(upload_states); i++) {
+        k_work_init(&upload_states[i].response_work, send_upload_response);
+    }
     ble_service_set_stream_end_cb(on_stream_end_c2p);
 }
 
-int handle_data_write(const uint8_t *req_data, size_t req_len, pb_ostream_t *ostream)
+/* Also registered for incremental decode: the data field is consumed in
+ * 256-byte reads, so a large write never needs a full-size request buffer. */
+int handle_data_write_istream(pb_istream_t *istream, pb_ostream_t *ostream)
 {
     struct data_write_decode_ctx decode_ctx = {.total_bytes = 0};
 
@@ -311,9 +568,8 @@ int handle_data_write(const uint8_t *req_data, size_t req_len, pb_ostream_t *ost
     req.data.funcs.decode = data_write_decode_cb;
     req.data.arg = &decode_ctx;
 
-    pb_istream_t stream = pb_istream_from_buffer(req_data, req_len);
-    if (!pb_decode(&stream, blerpc_DataWriteRequest_fields, &req)) {
-        LOG_ERR("DataWrite decode failed: %s", PB_GET_ERROR(&stream));
+    if (!pb_decode(istream, blerpc_DataWriteRequest_fields, &req)) {
+        LOG_ERR("DataWrite decode failed: %s", PB_GET_ERROR(istream));
         return -1;
     }
 
@@ -329,3 +585,9 @@ int handle_data_write(const uint8_t *req_data, size_t req_len, pb_ostream_t *ost
 
     return 0;
 }
+
+int handle_data_write(const uint8_t *req_data, size_t req_len, pb_ostream_t *ostream)
+{
+    pb_istream_t stream = pb_istream_from_buffer(req_data, req_len);
+    return handle_data_write_istream(&stream, ostream);
+}
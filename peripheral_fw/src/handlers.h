@@ -4,9 +4,9 @@
 #include "generated_handlers.h"
 
 /**
- * Initialize stream handlers (register STREAM_END_C2P callback).
- * Call after ble_service_init().
+ * Initialize handler state: stream handlers (register STREAM_END_C2P
+ * callback) and the flash_read pipeline. Call after ble_service_init().
  */
-void handlers_stream_init(void);
+void handlers_init(void);
 
 #endif /* BLERPC_HANDLERS_H */
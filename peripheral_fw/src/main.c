@@ -28,7 +28,7 @@ int main(void)
     LOG_INF("Bluetooth initialized");
 
     ble_service_init();
-    handlers_stream_init();
+    handlers_init();
 
     err = ble_service_start_advertising();
     if (err) {
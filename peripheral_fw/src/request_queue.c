@@ -0,0 +1,108 @@
+#include "request_queue.h"
+
+#include <zephyr/sys/util.h>
+
+/* Entries start with a pointer (k_fifo link) */
+#define ENTRY_ALIGN sizeof(void *)
+
+static struct request_entry *entry_at(struct request_queue *q, uint32_t offset)
+{
+    return (struct request_entry *)(q->buf + offset);
+}
+
+/* Called with q->lock held when nothing is allocated */
+static void reset_locked(struct request_queue *q)
+{
+    q->head = 0;
+    q->tail = 0;
+    q->wrap_end = q->capacity;
+    q->wrapped = false;
+}
+
+void request_queue_init(struct request_queue *q, uint8_t *buf, size_t capacity)
+{
+    q->buf = buf;
+    q->capacity = (uint32_t)ROUND_DOWN(capacity, ENTRY_ALIGN);
+    q->allocated = 0;
+    reset_locked(q);
+}
+
+struct request_entry *request_queue_alloc(struct request_queue *q, size_t len)
+{
+    if (len > request_queue_max_len(q)) {
+        return NULL;
+    }
+
+    uint32_t need = ROUND_UP(sizeof(struct request_entry) + len, ENTRY_ALIGN);
+    struct request_entry *entry = NULL;
+    k_spinlock_key_t key = k_spin_lock(&q->lock);
+
+    if (q->allocated == 0) {
+        reset_locked(q);
+    }
+
+    if (!q->wrapped) {
+        /* Live region is [tail, head): free space at the end, then before tail */
+        if (q->capacity - q->head >= need) {
+            entry = entry_at(q, q->head);
+            q->head += need;
+        } else if (q->tail >= need) {
+            q->wrap_end = q->head;
+            q->wrapped = true;
+            entry = entry_at(q, 0);
+            q->head = need;
+        }
+    } else if (q->tail - q->head >= need) {
+        /* Live region is [tail, wrap_end) + [0, head): free space is [head, tail) */
+        entry = entry_at(q, q->head);
+        q->head += need;
+    }
+
+    if (entry) {
+        entry->size = need;
+        entry->len = (uint16_t)len;
+        entry->in_use = true;
+        entry->streamed = false;
+        q->allocated++;
+    }
+
+    k_spin_unlock(&q->lock, key);
+    return entry;
+}
+
+void request_queue_free(struct request_queue *q, struct request_entry *entry)
+{
+    k_spinlock_key_t key = k_spin_lock(&q->lock);
+
+    entry->in_use = false;
+    q->allocated--;
+
+    if (q->allocated == 0) {
+        reset_locked(q);
+        k_spin_unlock(&q->lock, key);
+        return;
+    }
+
+    /* Reclaim every freed entry at the tail */
+    while (true) {
+        if (q->wrapped && q->tail == q->wrap_end) {
+            q->tail = 0;
+            q->wrap_end = q->capacity;
+            q->wrapped = false;
+            continue;
+        }
+        struct request_entry *oldest = entry_at(q, q->tail);
+        if (oldest->in_use) {
+            break;
+        }
+        q->tail += oldest->size;
+    }
+
+    k_spin_unlock(&q->lock, key);
+}
+
+size_t request_queue_max_len(const struct request_queue *q)
+{
+    size_t max = q->capacity - sizeof(struct request_entry);
+    return MIN(max, UINT16_MAX);
+}
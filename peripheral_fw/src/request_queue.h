@@ -0,0 +1,74 @@
+#ifndef BLERPC_REQUEST_QUEUE_H
+#define BLERPC_REQUEST_QUEUE_H
+
+#include <zephyr/kernel.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * One request in the ring. Entries are sized by their actual payload length
+ * and may be freed in any order; space is reclaimed once every older entry
+ * has been freed too.
+ */
+struct request_entry {
+    void *fifo_reserved; /* first word reserved for k_fifo */
+    uint32_t size;       /* bytes occupied in the ring, including this header */
+    uint16_t len;        /* payload length */
+    uint8_t transaction_id;
+    bool in_use;
+    bool streamed;       /* first container only; the rest arrives incrementally */
+#ifdef CONFIG_BLERPC_STATS
+    uint32_t stats_first;      /* cycle count when the FIRST container arrived */
+    uint32_t stats_queued;     /* cycle count when handed to the work queue */
+    uint32_t stats_decrypt_us; /* time spent decrypting it */
+#endif
+    uint8_t data[];
+};
+
+/**
+ * Byte ring of variable-sized request entries.
+ * Alloc and free are safe to call from different threads.
+ */
+struct request_queue {
+    uint8_t *buf;
+    uint32_t capacity;
+    uint32_t head;     /* next allocation offset */
+    uint32_t tail;     /* oldest entry not yet reclaimed */
+    uint32_t wrap_end; /* end of the live region before head wrapped to 0 */
+    uint32_t allocated;
+    bool wrapped;
+    struct k_spinlock lock;
+};
+
+/**
+ * Initialize a queue over caller-provided storage (aligned to sizeof(void *)).
+ */
+void request_queue_init(struct request_queue *q, uint8_t *buf, size_t capacity);
+
+/**
+ * Reserve a contiguous entry for a payload of len bytes.
+ * @return entry with in_use set and len filled in, or NULL if the ring has
+ *         no room right now
+ */
+struct request_entry *request_queue_alloc(struct request_queue *q, size_t len);
+
+/**
+ * Release an entry returned by request_queue_alloc().
+ */
+void request_queue_free(struct request_queue *q, struct request_entry *entry);
+
+/**
+ * Largest payload a single entry can ever hold in this queue.
+ */
+size_t request_queue_max_len(const struct request_queue *q);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLERPC_REQUEST_QUEUE_H */
@@ -0,0 +1,135 @@
+#include "response_cache.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <string.h>
+
+#include "blerpc_stats.h"
+
+struct cache_entry {
+    const struct handler_entry *cmd; /* NULL if free */
+    uint32_t hash;                   /* of the request data */
+    uint32_t epoch;                  /* response_cache_epoch() when it was computed */
+    uint32_t seq;                    /* store order, to find the oldest */
+    int64_t expires;                 /* k_uptime_get() deadline */
+    uint16_t offset;                 /* request data in arena, the response right after */
+    uint16_t req_len;
+    uint16_t resp_len;
+};
+
+static uint8_t arena[CONFIG_BLERPC_RESPONSE_CACHE_SIZE];
+static size_t arena_head; /* where the next entry goes, unless it must wrap */
+static struct cache_entry entries[CONFIG_BLERPC_RESPONSE_CACHE_ENTRIES];
+static uint32_t store_seq;
+
+/* The reservation response_cache_commit() completes */
+static struct cache_entry *pending;
+static const struct handler_entry *pending_cmd;
+
+/* Bumped by response_cache_invalidate(); an entry is only served while the
+ * sum for its command is unchanged. Both only grow, so any bump changes it. */
+static atomic_t epoch_all;
+static atomic_t epoch_cmd[BLERPC_CMD_COUNT];
+
+BUILD_ASSERT(CONFIG_BLERPC_RESPONSE_CACHE_SIZE <= UINT16_MAX, "arena offsets are 16-bit");
+
+static uint32_t request_hash(const uint8_t *req, size_t req_len)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < req_len; i++) {
+        h ^= req[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+uint32_t response_cache_epoch(const struct handler_entry *entry)
+{
+    return (uint32_t)atomic_get(&epoch_all) + (uint32_t)atomic_get(&epoch_cmd[entry->id - 1]);
+}
+
+const uint8_t *response_cache_get(const struct handler_entry *entry, const uint8_t *req,
+                                  size_t req_len, size_t *resp_len)
+{
+    if (entry->cache_ttl_ms == 0) {
+        return NULL;
+    }
+    uint32_t hash = request_hash(req, req_len);
+    uint32_t epoch = response_cache_epoch(entry);
+    int64_t now = k_uptime_get();
+
+    for (size_t i = 0; i < ARRAY_SIZE(entries); i++) {
+        struct cache_entry *e = &entries[i];
+        if (e->cmd != entry || e->hash != hash || e->req_len != req_len) {
+            continue;
+        }
+        if (e->epoch != epoch || now >= e->expires) {
+            e->cmd = NULL;
+            continue;
+        }
+        if (memcmp(&arena[e->offset], req, req_len) != 0) {
+            continue;
+        }
+        BLERPC_STATS_INC(cache_hits);
+        *resp_len = e->resp_len;
+        return &arena[e->offset + e->req_len];
+    }
+    return NULL;
+}
+
+uint8_t *response_cache_reserve(const struct handler_entry *entry, const uint8_t *req,
+                                size_t req_len, size_t resp_len, uint32_t epoch)
+{
+    size_t need = req_len + resp_len;
+
+    pending = NULL;
+    if (entry->cache_ttl_ms == 0 || need > sizeof(arena)) {
+        return NULL;
+    }
+    size_t start = arena_head + need > sizeof(arena) ? 0 : arena_head;
+
+    /* Drop the entries the new one overwrites, then take a free slot, or
+     * the oldest one if all are in use */
+    struct cache_entry *slot = NULL;
+    for (size_t i = 0; i < ARRAY_SIZE(entries); i++) {
+        struct cache_entry *e = &entries[i];
+        if (e->cmd && e->offset < start + need && start < e->offset + e->req_len + e->resp_len) {
+            e->cmd = NULL;
+        }
+        if (!slot || (slot->cmd && (!e->cmd || e->seq < slot->seq))) {
+            slot = e;
+        }
+    }
+
+    slot->cmd = NULL;
+    slot->hash = request_hash(req, req_len);
+    slot->epoch = epoch;
+    slot->seq = store_seq++;
+    slot->expires = k_uptime_get() + entry->cache_ttl_ms;
+    slot->offset = (uint16_t)start;
+    slot->req_len = (uint16_t)req_len;
+    slot->resp_len = (uint16_t)resp_len;
+    memcpy(&arena[start], req, req_len);
+    arena_head = start + need;
+
+    pending = slot;
+    pending_cmd = entry;
+    return &arena[start + req_len];
+}
+
+void response_cache_commit(void)
+{
+    if (pending && response_cache_epoch(pending_cmd) == pending->epoch) {
+        pending->cmd = pending_cmd;
+    }
+    pending = NULL;
+}
+
+void response_cache_invalidate(uint8_t cmd_id)
+{
+    if (cmd_id == 0) {
+        atomic_inc(&epoch_all);
+    } else if (cmd_id <= BLERPC_CMD_COUNT) {
+        atomic_inc(&epoch_cmd[cmd_id - 1]);
+    }
+}
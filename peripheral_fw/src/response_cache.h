@@ -0,0 +1,113 @@
+#ifndef BLERPC_RESPONSE_CACHE_H
+#define BLERPC_RESPONSE_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "generated_handlers.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Encoded responses of the commands listed in proto/cache.txt
+ * (CONFIG_BLERPC_RESPONSE_CACHE). A response is keyed by its command and the
+ * exact request data, and served again for cache_ttl_ms without running the
+ * handler. Entries live in a ring arena of CONFIG_BLERPC_RESPONSE_CACHE_SIZE
+ * bytes holding each request next to its response; storing one drops the
+ * oldest entries in its way.
+ *
+ * Only the blerpc work queue looks up and stores responses, so the arena
+ * needs no lock. response_cache_invalidate() may be called from any thread.
+ */
+
+#ifdef CONFIG_BLERPC_RESPONSE_CACHE
+
+/**
+ * Invalidation epoch of a command. Take it before running the handler and
+ * hand it to response_cache_reserve(), so a response computed across an
+ * invalidation is not stored.
+ */
+uint32_t response_cache_epoch(const struct handler_entry *entry);
+
+/**
+ * Find the cached response to a request.
+ * @return the encoded response, valid until the next response_cache_reserve()
+ *         call, or NULL if there is none or it expired
+ */
+const uint8_t *response_cache_get(const struct handler_entry *entry, const uint8_t *req,
+                                  size_t req_len, size_t *resp_len);
+
+/**
+ * Make room for the response to a request, dropping the oldest entries in
+ * the way. The response is encoded or copied into the returned buffer and
+ * joins the cache with response_cache_commit(); a reservation that is not
+ * committed is dropped.
+ * @return resp_len bytes to fill, or NULL if the command is not cached or
+ *         the request and response together do not fit the arena
+ */
+uint8_t *response_cache_reserve(const struct handler_entry *entry, const uint8_t *req,
+                                size_t req_len, size_t resp_len, uint32_t epoch);
+
+/**
+ * Add the reserved response to the cache, unless its command was
+ * invalidated since the epoch was taken.
+ */
+void response_cache_commit(void);
+
+/**
+ * Drop cached responses: those of one command (a *_CMD_ID_* value), or of
+ * every command for 0. Call it whenever what a cached command reads
+ * changes, e.g. after writing flash that flash_read may have cached.
+ */
+void response_cache_invalidate(uint8_t cmd_id);
+
+#else /* !CONFIG_BLERPC_RESPONSE_CACHE */
+
+static inline uint32_t response_cache_epoch(const struct handler_entry *entry)
+{
+    (void)entry;
+    return 0;
+}
+
+static inline const uint8_t *response_cache_get(const struct handler_entry *entry,
+                                                const uint8_t *req, size_t req_len,
+                                                size_t *resp_len)
+{
+    (void)entry;
+    (void)req;
+    (void)req_len;
+    (void)resp_len;
+    return NULL;
+}
+
+static inline uint8_t *response_cache_reserve(const struct handler_entry *entry,
+                                              const uint8_t *req, size_t req_len,
+                                              size_t resp_len, uint32_t epoch)
+{
+    (void)entry;
+    (void)req;
+    (void)req_len;
+    (void)resp_len;
+    (void)epoch;
+    return NULL;
+}
+
+static inline void response_cache_commit(void)
+{
+}
+
+static inline void response_cache_invalidate(uint8_t cmd_id)
+{
+    (void)cmd_id;
+}
+
+#endif /* CONFIG_BLERPC_RESPONSE_CACHE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLERPC_RESPONSE_CACHE_H */
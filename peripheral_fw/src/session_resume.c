@@ -0,0 +1,183 @@
+#include "session_resume.h"
+
+#include <mbedtls/platform_util.h>
+#include <psa/crypto.h>
+#include <zephyr/sys/byteorder.h>
+#include <string.h>
+
+#define TICKET_NONCE_SIZE 12
+#define TICKET_TAG_SIZE 16
+/* secret(32) || issued(4, LE) || uses_left(1) */
+#define TICKET_PLAIN_SIZE (SESSION_RESUME_SECRET_SIZE + 4 + 1)
+
+static const char resume_info[] = "blerpc-resume";
+
+int session_resume_derive(const uint8_t secret[SESSION_RESUME_SECRET_SIZE],
+                          const uint8_t nonce_c[SESSION_RESUME_NONCE_SIZE],
+                          const uint8_t nonce_p[SESSION_RESUME_NONCE_SIZE],
+                          struct session_resume_keys *keys)
+{
+    uint8_t salt[2 * SESSION_RESUME_NONCE_SIZE];
+    uint8_t okm[sizeof(*keys)];
+
+    memcpy(salt, nonce_c, SESSION_RESUME_NONCE_SIZE);
+    memcpy(salt + SESSION_RESUME_NONCE_SIZE, nonce_p, SESSION_RESUME_NONCE_SIZE);
+
+    psa_key_derivation_operation_t op = PSA_KEY_DERIVATION_OPERATION_INIT;
+    psa_status_t rc = psa_key_derivation_setup(&op, PSA_ALG_HKDF(PSA_ALG_SHA_256));
+    if (rc == PSA_SUCCESS) {
+        rc = psa_key_derivation_input_bytes(&op, PSA_KEY_DERIVATION_INPUT_SALT, salt,
+                                            sizeof(salt));
+    }
+    if (rc == PSA_SUCCESS) {
+        rc = psa_key_derivation_input_bytes(&op, PSA_KEY_DERIVATION_INPUT_SECRET, secret,
+                                            SESSION_RESUME_SECRET_SIZE);
+    }
+    if (rc == PSA_SUCCESS) {
+        rc = psa_key_derivation_input_bytes(&op, PSA_KEY_DERIVATION_INPUT_INFO,
+                                            (const uint8_t *)resume_info,
+                                            sizeof(resume_info) - 1);
+    }
+    if (rc == PSA_SUCCESS) {
+        rc = psa_key_derivation_output_bytes(&op, okm, sizeof(okm));
+    }
+    psa_key_derivation_abort(&op);
+
+    if (rc == PSA_SUCCESS) {
+        memcpy(keys->session_key, okm, SESSION_RESUME_KEY_SIZE);
+        memcpy(keys->next_secret, okm + SESSION_RESUME_KEY_SIZE, SESSION_RESUME_SECRET_SIZE);
+        memcpy(keys->confirm, okm + SESSION_RESUME_KEY_SIZE + SESSION_RESUME_SECRET_SIZE,
+               SESSION_RESUME_CONFIRM_SIZE);
+    }
+    mbedtls_platform_zeroize(okm, sizeof(okm));
+    return rc == PSA_SUCCESS ? 0 : -1;
+}
+
+bool session_resume_confirm_ok(const struct session_resume_keys *keys,
+                               const uint8_t confirm[SESSION_RESUME_CONFIRM_SIZE])
+{
+    uint8_t diff = 0;
+    for (size_t i = 0; i < SESSION_RESUME_CONFIRM_SIZE; i++) {
+        diff |= keys->confirm[i] ^ confirm[i];
+    }
+    return diff == 0;
+}
+
+int session_resume_start(struct blerpc_crypto_session *session,
+                         const struct session_resume_keys *keys, bool is_central)
+{
+    return blerpc_crypto_session_init(session, keys->session_key, is_central) == 0 ? 0 : -1;
+}
+
+/* One-shot AES-128-GCM with the key ID byte as associated data */
+static int ticket_aead(bool seal, const uint8_t key[SESSION_RESUME_KEY_SIZE], uint8_t key_id,
+                       const uint8_t nonce[TICKET_NONCE_SIZE], const uint8_t *in, size_t in_len,
+                       uint8_t *out, size_t out_len)
+{
+    psa_key_attributes_t attr = PSA_KEY_ATTRIBUTES_INIT;
+    psa_set_key_type(&attr, PSA_KEY_TYPE_AES);
+    psa_set_key_bits(&attr, SESSION_RESUME_KEY_SIZE * 8);
+    psa_set_key_usage_flags(&attr, seal ? PSA_KEY_USAGE_ENCRYPT : PSA_KEY_USAGE_DECRYPT);
+    psa_set_key_algorithm(&attr, PSA_ALG_GCM);
+
+    psa_key_id_t id;
+    if (psa_import_key(&attr, key, SESSION_RESUME_KEY_SIZE, &id) != PSA_SUCCESS) {
+        return -1;
+    }
+
+    size_t written = 0;
+    psa_status_t rc;
+    if (seal) {
+        rc = psa_aead_encrypt(id, PSA_ALG_GCM, nonce, TICKET_NONCE_SIZE, &key_id, 1, in, in_len,
+                              out, out_len, &written);
+    } else {
+        rc = psa_aead_decrypt(id, PSA_ALG_GCM, nonce, TICKET_NONCE_SIZE, &key_id, 1, in, in_len,
+                              out, out_len, &written);
+    }
+    psa_destroy_key(id);
+    return rc == PSA_SUCCESS && written == out_len ? 0 : -1;
+}
+
+int session_resume_tickets_init(struct session_resume_tickets *t, uint32_t lifetime_s,
+                                uint32_t now_s)
+{
+    memset(t, 0, sizeof(*t));
+    t->lifetime_s = lifetime_s;
+    t->rotated_s = now_s;
+    return psa_generate_random(t->key[0], SESSION_RESUME_KEY_SIZE) == PSA_SUCCESS ? 0 : -1;
+}
+
+static int tickets_rotate(struct session_resume_tickets *t, uint32_t now_s)
+{
+    uint8_t key[SESSION_RESUME_KEY_SIZE];
+    if (psa_generate_random(key, sizeof(key)) != PSA_SUCCESS) {
+        return -1;
+    }
+    memcpy(t->key[1], t->key[0], SESSION_RESUME_KEY_SIZE);
+    t->key_id[1] = t->key_id[0];
+    t->have_previous = true;
+    memcpy(t->key[0], key, SESSION_RESUME_KEY_SIZE);
+    t->key_id[0]++;
+    t->rotated_s = now_s;
+    mbedtls_platform_zeroize(key, sizeof(key));
+    return 0;
+}
+
+int session_resume_ticket_seal(struct session_resume_tickets *t, uint32_t now_s,
+                               const uint8_t secret[SESSION_RESUME_SECRET_SIZE],
+                               uint32_t issued_s, uint8_t uses_left,
+                               uint8_t ticket[SESSION_RESUME_TICKET_SIZE])
+{
+    if (now_s - t->rotated_s >= t->lifetime_s && tickets_rotate(t, now_s) != 0) {
+        return -1;
+    }
+
+    uint8_t plain[TICKET_PLAIN_SIZE];
+    memcpy(plain, secret, SESSION_RESUME_SECRET_SIZE);
+    sys_put_le32(issued_s, plain + SESSION_RESUME_SECRET_SIZE);
+    plain[SESSION_RESUME_SECRET_SIZE + 4] = uses_left;
+
+    ticket[0] = t->key_id[0];
+    uint8_t *nonce = ticket + 1;
+    int rc = -1;
+    if (psa_generate_random(nonce, TICKET_NONCE_SIZE) == PSA_SUCCESS) {
+        rc = ticket_aead(true, t->key[0], t->key_id[0], nonce, plain, sizeof(plain),
+                         nonce + TICKET_NONCE_SIZE, TICKET_PLAIN_SIZE + TICKET_TAG_SIZE);
+    }
+    mbedtls_platform_zeroize(plain, sizeof(plain));
+    return rc;
+}
+
+int session_resume_ticket_open(struct session_resume_tickets *t, uint32_t now_s,
+                               const uint8_t ticket[SESSION_RESUME_TICKET_SIZE],
+                               uint8_t secret[SESSION_RESUME_SECRET_SIZE], uint32_t *issued_s,
+                               uint8_t *uses_left)
+{
+    const uint8_t *key;
+    if (ticket[0] == t->key_id[0]) {
+        key = t->key[0];
+    } else if (t->have_previous && ticket[0] == t->key_id[1]) {
+        key = t->key[1];
+    } else {
+        return -1;
+    }
+
+    uint8_t plain[TICKET_PLAIN_SIZE];
+    const uint8_t *nonce = ticket + 1;
+    if (ticket_aead(false, key, ticket[0], nonce, nonce + TICKET_NONCE_SIZE,
+                    TICKET_PLAIN_SIZE + TICKET_TAG_SIZE, plain, sizeof(plain)) != 0) {
+        return -1;
+    }
+
+    uint32_t issued = sys_get_le32(plain + SESSION_RESUME_SECRET_SIZE);
+    uint8_t left = plain[SESSION_RESUME_SECRET_SIZE + 4];
+    int rc = -1;
+    if (left > 0 && now_s - issued < t->lifetime_s) {
+        memcpy(secret, plain, SESSION_RESUME_SECRET_SIZE);
+        *issued_s = issued;
+        *uses_left = left;
+        rc = 0;
+    }
+    mbedtls_platform_zeroize(plain, sizeof(plain));
+    return rc;
+}
@@ -0,0 +1,137 @@
+#ifndef BLERPC_SESSION_RESUME_H
+#define BLERPC_SESSION_RESUME_H
+
+#include <blerpc_protocol/crypto.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Session resumption, carried by CONTROL_CMD_RESUME. The first payload byte
+ * is one of the SESSION_RESUME_OP_* below.
+ *
+ * After a full key exchange, before its first request, the central sends
+ * TICKET_REQUEST. The peripheral answers TICKET with secret(32) ||
+ * ticket, encrypted under the new session. The ticket is that secret, the
+ * time of the full handshake and the resumptions left, sealed with a key
+ * only the peripheral holds.
+ *
+ * A reconnecting central sends HELLO: ticket || nonce_c(16). The peripheral
+ * opens the ticket, picks nonce_p(16), and both sides derive
+ *
+ *   HKDF-SHA256(secret, salt = nonce_c || nonce_p, info = "blerpc-resume")
+ *     = session_key(16) || next_secret(32) || confirm(16)
+ *
+ * The peripheral answers ACCEPT: nonce_p || confirm, followed by a ticket
+ * for next_secret unless none are left, so each secret is used once; or
+ * REJECT, and the central falls back to a full key exchange.
+ *
+ * Tickets stop opening one lifetime (CONFIG_BLERPC_RESUMPTION_LIFETIME_S on
+ * the peripheral) after the full handshake they descend from, and the
+ * sealing key rotates every lifetime, so no ticket stays usable, or
+ * recoverable, beyond two lifetimes: a full handshake restores forward
+ * secrecy at least that often.
+ */
+
+#define SESSION_RESUME_OP_TICKET_REQUEST 0x01
+#define SESSION_RESUME_OP_TICKET 0x02
+#define SESSION_RESUME_OP_HELLO 0x03
+#define SESSION_RESUME_OP_ACCEPT 0x04
+#define SESSION_RESUME_OP_REJECT 0x05
+
+#define SESSION_RESUME_SECRET_SIZE 32
+#define SESSION_RESUME_NONCE_SIZE 16
+#define SESSION_RESUME_CONFIRM_SIZE 16
+#define SESSION_RESUME_KEY_SIZE 16
+
+/* key_id(1) || gcm_nonce(12) || sealed{secret(32) issued(4) uses_left(1)} || tag(16) */
+#define SESSION_RESUME_TICKET_SIZE 66
+
+/* Control payload sizes, op byte included */
+#define SESSION_RESUME_TICKET_MSG_SIZE \
+    (1 + BLERPC_ENCRYPTED_OVERHEAD + SESSION_RESUME_SECRET_SIZE + SESSION_RESUME_TICKET_SIZE)
+#define SESSION_RESUME_HELLO_SIZE (1 + SESSION_RESUME_TICKET_SIZE + SESSION_RESUME_NONCE_SIZE)
+#define SESSION_RESUME_ACCEPT_MIN_SIZE \
+    (1 + SESSION_RESUME_NONCE_SIZE + SESSION_RESUME_CONFIRM_SIZE)
+#define SESSION_RESUME_ACCEPT_SIZE (SESSION_RESUME_ACCEPT_MIN_SIZE + SESSION_RESUME_TICKET_SIZE)
+#define SESSION_RESUME_MAX_MSG_SIZE SESSION_RESUME_TICKET_MSG_SIZE
+
+/** Keys derived from a resumption secret and both nonces. */
+struct session_resume_keys {
+    uint8_t session_key[SESSION_RESUME_KEY_SIZE];
+    uint8_t next_secret[SESSION_RESUME_SECRET_SIZE];
+    uint8_t confirm[SESSION_RESUME_CONFIRM_SIZE];
+};
+
+/**
+ * Derive the resumed session's keys.
+ * @return 0 on success, -1 on failure
+ */
+int session_resume_derive(const uint8_t secret[SESSION_RESUME_SECRET_SIZE],
+                          const uint8_t nonce_c[SESSION_RESUME_NONCE_SIZE],
+                          const uint8_t nonce_p[SESSION_RESUME_NONCE_SIZE],
+                          struct session_resume_keys *keys);
+
+/**
+ * Compare the peer's confirm value with ours in constant time.
+ */
+bool session_resume_confirm_ok(const struct session_resume_keys *keys,
+                               const uint8_t confirm[SESSION_RESUME_CONFIRM_SIZE]);
+
+/**
+ * Start the resumed session: fresh counters under keys->session_key.
+ * @return 0 on success, -1 on failure
+ */
+int session_resume_start(struct blerpc_crypto_session *session,
+                         const struct session_resume_keys *keys, bool is_central);
+
+/**
+ * Ticket sealing keys of a peripheral: the current one and the one it
+ * replaced, which still opens the tickets sealed during its lifetime.
+ */
+struct session_resume_tickets {
+    uint8_t key[2][SESSION_RESUME_KEY_SIZE]; /* [0] current, [1] previous */
+    uint8_t key_id[2];
+    bool have_previous;
+    uint32_t rotated_s; /* when key[0] was generated */
+    uint32_t lifetime_s;
+};
+
+/**
+ * Generate the first sealing key.
+ * @return 0 on success, -1 on failure
+ */
+int session_resume_tickets_init(struct session_resume_tickets *t, uint32_t lifetime_s,
+                                uint32_t now_s);
+
+/**
+ * Seal a ticket for secret, rotating the sealing key once it is a lifetime
+ * old.
+ * @param issued_s  Time of the full handshake the secret descends from
+ * @param uses_left Resumptions the ticket still allows, at least 1
+ * @return 0 on success, -1 on failure
+ */
+int session_resume_ticket_seal(struct session_resume_tickets *t, uint32_t now_s,
+                               const uint8_t secret[SESSION_RESUME_SECRET_SIZE],
+                               uint32_t issued_s, uint8_t uses_left,
+                               uint8_t ticket[SESSION_RESUME_TICKET_SIZE]);
+
+/**
+ * Open a ticket.
+ * @return 0 on success, -1 if it is forged, expired, spent or sealed with
+ *         a key that has been rotated out
+ */
+int session_resume_ticket_open(struct session_resume_tickets *t, uint32_t now_s,
+                               const uint8_t ticket[SESSION_RESUME_TICKET_SIZE],
+                               uint8_t secret[SESSION_RESUME_SECRET_SIZE], uint32_t *issued_s,
+                               uint8_t *uses_left);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLERPC_SESSION_RESUME_H */
@@ -0,0 +1,86 @@
+#include "stream_crypto.h"
+
+#include <zephyr/sys/byteorder.h>
+#include <string.h>
+
+#define NONCE_SIZE 12
+#define SESSION_KEY_BITS 128
+
+/* nonce = counter(4, LE) || direction(1) || zeros(7), as in the protocol library */
+static void build_nonce(uint8_t nonce[NONCE_SIZE], uint32_t counter, uint8_t direction)
+{
+    memset(nonce, 0, NONCE_SIZE);
+    sys_put_le32(counter, nonce);
+    nonce[4] = direction;
+}
+
+int stream_crypto_tx_begin(struct stream_crypto_tx *tx, struct blerpc_crypto_session *session,
+                           uint8_t direction, size_t plain_len,
+                           uint8_t counter_out[STREAM_CRYPTO_COUNTER_SIZE])
+{
+    /* Never reuse a nonce: refuse once the counter space is exhausted */
+    if (session->tx_counter == UINT32_MAX) {
+        return -1;
+    }
+
+    psa_key_attributes_t attr = PSA_KEY_ATTRIBUTES_INIT;
+    psa_set_key_type(&attr, PSA_KEY_TYPE_AES);
+    psa_set_key_bits(&attr, SESSION_KEY_BITS);
+    psa_set_key_usage_flags(&attr, PSA_KEY_USAGE_ENCRYPT);
+    psa_set_key_algorithm(&attr, PSA_ALG_GCM);
+
+    tx->op = psa_aead_operation_init();
+    if (psa_import_key(&attr, session->session_key, sizeof(session->session_key), &tx->key) !=
+        PSA_SUCCESS) {
+        return -1;
+    }
+
+    uint32_t counter = session->tx_counter;
+    uint8_t nonce[NONCE_SIZE];
+    build_nonce(nonce, counter, direction);
+
+    if (psa_aead_encrypt_setup(&tx->op, tx->key, PSA_ALG_GCM) != PSA_SUCCESS ||
+        psa_aead_set_lengths(&tx->op, 0, plain_len) != PSA_SUCCESS ||
+        psa_aead_set_nonce(&tx->op, nonce, sizeof(nonce)) != PSA_SUCCESS) {
+        stream_crypto_tx_abort(tx);
+        return -1;
+    }
+
+    session->tx_counter = counter + 1;
+    sys_put_le32(counter, counter_out);
+    return 0;
+}
+
+int stream_crypto_tx_update(struct stream_crypto_tx *tx, const uint8_t *in, size_t len,
+                            uint8_t *out, size_t out_size, size_t *out_len)
+{
+    if (psa_aead_update(&tx->op, in, len, out, out_size, out_len) != PSA_SUCCESS) {
+        stream_crypto_tx_abort(tx);
+        return -1;
+    }
+    return 0;
+}
+
+int stream_crypto_tx_finish(struct stream_crypto_tx *tx, uint8_t *out, size_t out_size,
+                            size_t *out_len, uint8_t tag[STREAM_CRYPTO_TAG_SIZE])
+{
+    size_t tag_len;
+    if (psa_aead_finish(&tx->op, out, out_size, out_len, tag, STREAM_CRYPTO_TAG_SIZE,
+                        &tag_len) != PSA_SUCCESS ||
+        tag_len != STREAM_CRYPTO_TAG_SIZE) {
+        stream_crypto_tx_abort(tx);
+        return -1;
+    }
+    psa_destroy_key(tx->key);
+    tx->key = PSA_KEY_ID_NULL;
+    return 0;
+}
+
+void stream_crypto_tx_abort(struct stream_crypto_tx *tx)
+{
+    psa_aead_abort(&tx->op);
+    if (tx->key != PSA_KEY_ID_NULL) {
+        psa_destroy_key(tx->key);
+        tx->key = PSA_KEY_ID_NULL;
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef BLERPC_STREAM_CRYPTO_H
+#define BLERPC_STREAM_CRYPTO_H
+
+#include <blerpc_protocol/crypto.h>
+#include <psa/crypto.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Counter prefix of an encrypted payload */
+#define STREAM_CRYPTO_COUNTER_SIZE 4
+#define STREAM_CRYPTO_TAG_SIZE 16
+
+/* Direction byte of the GCM nonce */
+#define STREAM_CRYPTO_DIRECTION_C2P 0x00
+#define STREAM_CRYPTO_DIRECTION_P2C 0x01
+
+/**
+ * Incremental AES-128-GCM encryption producing the same wire format as
+ * blerpc_crypto_session_encrypt(): counter(4, LE) || ciphertext || tag(16).
+ * Lets a payload be encrypted while it is being encoded and sent, so no
+ * plaintext or ciphertext copy of the whole payload is needed.
+ */
+struct stream_crypto_tx {
+    psa_aead_operation_t op;
+    psa_key_id_t key;
+};
+
+/**
+ * Start encrypting a payload of exactly plain_len bytes with the session's
+ * next TX counter, and consume that counter.
+ * @param direction   STREAM_CRYPTO_DIRECTION_* of the side that sends it
+ * @param counter_out Receives the 4-byte counter prefix to send first
+ * @return 0 on success, -1 on failure (nothing to clean up)
+ */
+int stream_crypto_tx_begin(struct stream_crypto_tx *tx, struct blerpc_crypto_session *session,
+                           uint8_t direction, size_t plain_len,
+                           uint8_t counter_out[STREAM_CRYPTO_COUNTER_SIZE]);
+
+/**
+ * Encrypt the next len bytes of plaintext.
+ * The cipher may hold back a partial block, so out_len can differ from len;
+ * out_size must be at least PSA_AEAD_UPDATE_OUTPUT_MAX_SIZE(len).
+ * @return 0 on success, -1 on failure (operation aborted)
+ */
+int stream_crypto_tx_update(struct stream_crypto_tx *tx, const uint8_t *in, size_t len,
+                            uint8_t *out, size_t out_size, size_t *out_len);
+
+/**
+ * Finish the payload: flush held-back ciphertext into out and write the tag.
+ * out_size must be at least PSA_AEAD_FINISH_OUTPUT_MAX_SIZE.
+ * @return 0 on success, -1 on failure (operation aborted)
+ */
+int stream_crypto_tx_finish(struct stream_crypto_tx *tx, uint8_t *out, size_t out_size,
+                            size_t *out_len, uint8_t tag[STREAM_CRYPTO_TAG_SIZE]);
+
+/**
+ * Abandon an operation started with stream_crypto_tx_begin().
+ */
+void stream_crypto_tx_abort(struct stream_crypto_tx *tx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLERPC_STREAM_CRYPTO_H */
@@ -0,0 +1,79 @@
+#include <zephyr/ztest.h>
+#include <string.h>
+#include "request_queue.h"
+
+ZTEST_SUITE(request_queue_tests, NULL, NULL, NULL, NULL, NULL);
+
+static uint8_t ring[256] __aligned(sizeof(void *));
+
+ZTEST(request_queue_tests, test_alloc_sized_by_length)
+{
+    struct request_queue q;
+    request_queue_init(&q, ring, sizeof(ring));
+
+    struct request_entry *a = request_queue_alloc(&q, 5);
+    struct request_entry *b = request_queue_alloc(&q, 5);
+    zassert_not_null(a, "");
+    zassert_not_null(b, "");
+    zassert_equal(a->len, 5, "");
+    zassert_true((uint8_t *)b >= a->data + 5, "entries must not overlap");
+    zassert_true((uint8_t *)b - (uint8_t *)a < 64, "small requests take little space");
+
+    request_queue_free(&q, a);
+    request_queue_free(&q, b);
+}
+
+ZTEST(request_queue_tests, test_too_large_rejected)
+{
+    struct request_queue q;
+    request_queue_init(&q, ring, sizeof(ring));
+
+    zassert_is_null(request_queue_alloc(&q, sizeof(ring)), "");
+    zassert_not_null(request_queue_alloc(&q, request_queue_max_len(&q)), "max_len must fit");
+}
+
+ZTEST(request_queue_tests, test_full_then_out_of_order_free)
+{
+    struct request_queue q;
+    request_queue_init(&q, ring, sizeof(ring));
+
+    struct request_entry *a = request_queue_alloc(&q, 80);
+    struct request_entry *b = request_queue_alloc(&q, 80);
+    zassert_not_null(a, "");
+    zassert_not_null(b, "");
+    zassert_is_null(request_queue_alloc(&q, 120), "ring should be full");
+
+    /* Freeing a newer entry first does not reclaim space behind an older one */
+    request_queue_free(&q, b);
+    zassert_is_null(request_queue_alloc(&q, 120), "");
+
+    /* Once the oldest is freed the whole ring is reusable */
+    request_queue_free(&q, a);
+    zassert_not_null(request_queue_alloc(&q, 120), "");
+}
+
+ZTEST(request_queue_tests, test_wraparound)
+{
+    struct request_queue q;
+    request_queue_init(&q, ring, sizeof(ring));
+
+    struct request_entry *a = request_queue_alloc(&q, 80);
+    struct request_entry *b = request_queue_alloc(&q, 80);
+    zassert_not_null(a, "");
+    zassert_not_null(b, "");
+    memset(b->data, 0xAB, 80);
+
+    /* Free the head of the ring; the next entry wraps to offset 0 */
+    request_queue_free(&q, a);
+    struct request_entry *c = request_queue_alloc(&q, 80);
+    zassert_not_null(c, "");
+    zassert_equal_ptr(c, (struct request_entry *)ring, "should wrap to start of ring");
+
+    for (int i = 0; i < 80; i++) {
+        zassert_equal(b->data[i], 0xAB, "live entry must stay intact");
+    }
+
+    request_queue_free(&q, b);
+    request_queue_free(&q, c);
+    zassert_not_null(request_queue_alloc(&q, request_queue_max_len(&q)), "empty ring resets");
+}
@@ -37,10 +37,17 @@ def handle_counter_upload(req_data):
     return blerpc_pb2.CounterUploadResponse().SerializeToString()
 
 
+def handle_flash_dump(req_data):
+    req = blerpc_pb2.FlashDumpRequest()
+    req.ParseFromString(req_data)
+    return blerpc_pb2.FlashDumpResponse().SerializeToString()
+
+
 HANDLERS = {
     "echo": handle_echo,
     "flash_read": handle_flash_read,
     "data_write": handle_data_write,
     "counter_stream": handle_counter_stream,
     "counter_upload": handle_counter_upload,
+    "flash_dump": handle_flash_dump,
 }
@@ -9,8 +9,11 @@ import logging
 import os
 import struct
 import sys
-import threading
-import time
+import zlib
+from collections import OrderedDict
+from collections.abc import AsyncIterator
+from concurrent.futures import ThreadPoolExecutor
+from dataclasses import dataclass
 
 from blerpc_protocol.command import CommandPacket, CommandType
 from blerpc_protocol.container import (
@@ -32,13 +35,9 @@ from blerpc_protocol.crypto import (
 
 # Import protobuf definitions from central_py/blerpc/
 sys.path.insert(0, os.path.join(os.path.dirname(__file__), "..", "central_py"))
+from blerpc import resume
+from blerpc.compress import DecompressError, compress, decompress
 from blerpc.generated import blerpc_pb2
-from bless import (
-    BlessGATTCharacteristic,
-    BlessServer,
-    GATTAttributePermissions,
-    GATTCharacteristicProperties,
-)
 from generated_handlers import HANDLERS as _GENERATED_HANDLERS
 
 logging.basicConfig(level=logging.INFO)
@@ -49,8 +48,36 @@ CHAR_UUID = "12340002-0000-1000-8000-00805f9b34fb"
 TIMEOUT_MS = 100
 MTU = 247
 MAX_RESPONSE_PAYLOAD_SIZE = 65535
-NOTIFY_MAX_RETRIES = 50
-NOTIFY_RETRY_DELAY_S = 0.005
+# A full notify queue drains one connection event at a time, so back off
+# from sub-millisecond up to this cap while waiting for room.
+NOTIFY_TIMEOUT_S = 1.0
+NOTIFY_BACKOFF_MIN_S = 0.0005
+NOTIFY_BACKOFF_MAX_S = 0.008
+FLASH_DUMP_CHUNK_SIZE = 512
+# Handlers run on WORKER_COUNT workers; requests beyond REQUEST_QUEUE_DEPTH
+# waiting for one are refused with BUSY
+WORKER_COUNT = 4
+REQUEST_QUEUE_DEPTH = 8
+# Commands whose requests are C->P stream messages, without responses
+C2P_STREAM_COMMANDS = {"counter_upload"}
+# Containers queued for notification before senders wait for room
+TX_QUEUE_DEPTH = 32
+# Transactions reassembled at once, like CONFIG_BLERPC_ASSEMBLER_POOL_SIZE
+ASSEMBLER_POOL_SIZE = 4
+# Coalesced C->P stream frames: a batch request naming one stream command,
+# whose data is a run of [len LE16][message] entries
+CAPABILITY_FLAG_STREAM_COALESCE = 0x0020
+COMMAND_FLAG_BATCH = 0x20
+# Command data compression. The capabilities response carries the largest
+# request we inflate at offset 22, after a zero link, PSM and schema tail;
+# the central's CAPABILITIES request carries its flags and its own limit
+CAPABILITY_FLAG_COMPRESSION = 0x0080
+COMMAND_FLAG_COMPRESSED = 0x10
+COMPRESS_MIN_SIZE = 64
+# Resumptions a full key exchange allows, like CONFIG_BLERPC_RESUMPTION_MAX_COUNT
+RESUMPTION_MAX_COUNT = 16
+# First payload byte of the central's opening KEY_EXCHANGE message
+KX_STEP1 = b"\x01"
 
 
 HANDLERS = dict(_GENERATED_HANDLERS)
@@ -95,19 +122,60 @@ HANDLERS["data_write"] = handle_data_write
 HANDLERS["counter_upload"] = handle_counter_upload
 
 
+@dataclass
+class _Request:
+    """A decoded request waiting for a worker."""
+
+    transaction_id: int
+    cmd: CommandPacket
+
+
 class BlerpcPeripheral:
+    """blerpc peripheral; all protocol state lives on one asyncio event loop.
+
+    Writes are handed to the loop from whatever thread the BLE stack calls
+    back on and are processed in arrival order: reassembly per transaction
+    ID, then decryption. Requests go to a bounded queue served by
+    WORKER_COUNT workers, which run handlers on a thread pool, so a slow
+    handler or a long stream does not hold up other requests. A full queue
+    answers BUSY. C->P stream messages have no response and are counted in
+    arrival order instead. Outgoing containers pass through a bounded TX
+    queue that one sender drains into notifications, so producers wait for
+    room.
+    """
+
     def __init__(
         self,
         ed25519_private_key_hex: str | None = None,
+        mtu: int = MTU,
+        timeout_ms: int = TIMEOUT_MS,
+        workers: int = WORKER_COUNT,
+        queue_depth: int = REQUEST_QUEUE_DEPTH,
     ):
-        self.server: BlessServer | None = None
-        self.assembler = ContainerAssembler()
-        self.splitter = ContainerSplitter(mtu=MTU)
+        self.server = None  # BlessServer once started
+        self._link = None  # LoopbackLink once attached
+        self._timeout_ms = timeout_ms
+        self._workers = workers
+        self._queue_depth = queue_depth
+        self.splitter = ContainerSplitter(mtu=mtu)
+        self._assemblers: OrderedDict[int, ContainerAssembler] = OrderedDict()
         self._loop: asyncio.AbstractEventLoop | None = None
-        self._send_queue: list[tuple[bytes, int]] = []
-        self._send_lock = threading.Lock()
-        self._state_lock = threading.Lock()
+        self._tasks: list[asyncio.Task] = []
+        self._executor: ThreadPoolExecutor | None = None
+        self._rx_queue: asyncio.Queue[bytes] | None = None
+        self._requests: asyncio.Queue[_Request] | None = None
+        self._tx_queue: asyncio.Queue[bytes] | None = None
+        self._tx_ready = asyncio.Event()
+        # Held from encryption until a response's last container is queued,
+        # so the central decrypts responses in counter order
+        self._response_lock = asyncio.Lock()
         self._upload_count = 0
+        # Largest response data the central inflates; 0 if it can't
+        self._inflate_limit = 0
+        self._stream_handlers = {
+            "counter_stream": self._counter_stream,
+            "flash_dump": self._flash_dump,
+        }
 
         # Encryption state
         self._encryption_supported = False
@@ -115,6 +183,13 @@ class BlerpcPeripheral:
         self._kx: PeripheralKeyExchange | None = None
         self._ed25519_privkey = None  # Store for KX recreation on disconnect
         self._connected = False
+        self._tickets: resume.TicketSealer | None = None
+        # Set by a full key exchange until the first request, while the
+        # central may ask for a resumption ticket
+        self._ticket_allowed = False
+        # Set by a resumption until a request decrypts under it: the central
+        # may not accept the session and fall back to a key exchange
+        self._session_tentative = False
 
         if ed25519_private_key_hex:
             ed25519_priv_bytes = bytes.fromhex(ed25519_private_key_hex)
@@ -124,10 +199,18 @@ class BlerpcPeripheral:
             self._ed25519_privkey = ed25519_privkey
             self._kx = PeripheralKeyExchange(ed25519_privkey)
             self._encryption_supported = True
+            self._tickets = resume.TicketSealer()
             logger.info("Encryption key loaded (X25519 generated per session)")
 
     async def start(self):
-        self._loop = asyncio.get_event_loop()
+        # Imported here so a loopback peripheral runs without bless
+        from bless import (
+            BlessServer,
+            GATTAttributePermissions,
+            GATTCharacteristicProperties,
+        )
+
+        self._start_tasks()
         self.server = BlessServer(name="blerpc", loop=self._loop)
         self.server.write_request_func = self._on_write
 
@@ -151,20 +234,62 @@ class BlerpcPeripheral:
         await self.server.start()
         logger.info("Advertising as 'blerpc' — waiting for connections...")
 
+    def attach(self, link) -> None:
+        """Serve a blerpc.loopback.LoopbackLink instead of a GATT server.
+
+        Call from the event loop the peripheral should run on.
+        """
+        self._link = link
+        self._start_tasks()
+        link.attach(
+            lambda data: self._on_write(None, bytearray(data)),
+            on_ready=self._tx_ready.set,
+        )
+
+    def _start_tasks(self):
+        self._loop = asyncio.get_running_loop()
+        self._executor = ThreadPoolExecutor(
+            max_workers=self._workers, thread_name_prefix="blerpc-handler"
+        )
+        self._rx_queue = asyncio.Queue()
+        self._requests = asyncio.Queue(maxsize=self._queue_depth)
+        self._tx_queue = asyncio.Queue(maxsize=TX_QUEUE_DEPTH)
+        self._tasks = [
+            self._loop.create_task(self._receiver()),
+            self._loop.create_task(self._sender()),
+            *(self._loop.create_task(self._worker()) for _ in range(self._workers)),
+        ]
+
     def _reset_connection_state(self):
         """Reset session state for new connection."""
         logger.info("Resetting connection state")
-        with self._state_lock:
-            self._session = None
-            self._upload_count = 0
-            self.assembler = ContainerAssembler()
-            if self._ed25519_privkey is not None:
-                self._kx = PeripheralKeyExchange(self._ed25519_privkey)
+        self._session = None
+        self._ticket_allowed = False
+        self._session_tentative = False
+        self._upload_count = 0
+        self._inflate_limit = 0
+        self._assemblers.clear()
+        while not self._requests.empty():
+            self._requests.get_nowait()
+        if self._ed25519_privkey is not None:
+            self._kx = PeripheralKeyExchange(self._ed25519_privkey)
+
+    def _on_write(self, characteristic, value: bytearray, **kwargs):
+        # Called on the BLE stack's thread: hand the write to the event loop
+        try:
+            self._loop.call_soon_threadsafe(self._rx_queue.put_nowait, bytes(value))
+        except RuntimeError:
+            logger.debug("Write after the event loop closed, dropped")
 
-    def _on_write(
-        self, characteristic: BlessGATTCharacteristic, value: bytearray, **kwargs
-    ):
-        data = bytes(value)
+    async def _receiver(self):
+        while True:
+            data = await self._rx_queue.get()
+            try:
+                await self._handle_write(data)
+            except Exception:
+                logger.exception("Error handling write")
+
+    async def _handle_write(self, data: bytes):
         logger.debug("Write received: %d bytes", len(data))
 
         # Detect new connection by tracking connection state.
@@ -189,19 +314,23 @@ class BlerpcPeripheral:
                     sequence_number=0,
                     container_type=ContainerType.CONTROL,
                     control_cmd=ControlCmd.TIMEOUT,
-                    payload=struct.pack("<H", TIMEOUT_MS),
+                    payload=struct.pack("<H", self._timeout_ms),
                 )
-                self._send_container_sync(resp)
+                await self._send_container(resp)
             elif container.control_cmd == ControlCmd.STREAM_END_C2P:
-                threading.Thread(
-                    target=self._handle_stream_end_c2p,
-                    args=(container.transaction_id,),
-                    daemon=True,
-                ).start()
+                await self._handle_stream_end_c2p()
             elif container.control_cmd == ControlCmd.CAPABILITIES:
-                flags = 0
+                self._inflate_limit = 0
+                if len(container.payload) >= 4:
+                    central_flags, limit = struct.unpack_from("<HH", container.payload)
+                    if central_flags & CAPABILITY_FLAG_COMPRESSION:
+                        self._inflate_limit = limit
+                flags = CAPABILITY_FLAG_STREAM_COALESCE | CAPABILITY_FLAG_COMPRESSION
                 if self._encryption_supported:
-                    flags |= CAPABILITY_FLAG_ENCRYPTION_SUPPORTED
+                    flags |= (
+                        CAPABILITY_FLAG_ENCRYPTION_SUPPORTED
+                        | resume.CAPABILITY_FLAG_RESUMPTION
+                    )
                 logger.info(
                     "Capabilities request, max_req=65535 max_resp=%d flags=0x%04x",
                     MAX_RESPONSE_PAYLOAD_SIZE,
@@ -213,31 +342,88 @@ class BlerpcPeripheral:
                     container_type=ContainerType.CONTROL,
                     control_cmd=ControlCmd.CAPABILITIES,
                     payload=struct.pack(
-                        "<HHH", 65535, MAX_RESPONSE_PAYLOAD_SIZE, flags
+                        "<HHH12xHHH",
+                        65535,
+                        MAX_RESPONSE_PAYLOAD_SIZE,
+                        flags,
+                        0,  # no L2CAP channel
+                        0,  # schema hash unknown
+                        65535,
                     ),
                 )
-                self._send_container_sync(resp)
+                await self._send_container(resp)
             elif container.control_cmd == ControlCmd.KEY_EXCHANGE:
-                self._handle_key_exchange(container)
+                await self._handle_key_exchange(container)
+            elif container.control_cmd == resume.CONTROL_CMD_RESUME:
+                await self._handle_resume(container)
             return
 
-        # Feed into assembler
-        result = self.assembler.feed(container)
+        self._ticket_allowed = False
+        result = self._reassemble(container)
+        if result is None:
+            return
+        tid = container.transaction_id
+        # Decrypt in arrival order: the central may pipeline requests, and
+        # workers can finish in any order
+        payload = self._decrypt_request(result)
+        if payload is None:
+            if self._session is not None:
+                await self._send_error(tid, BLERPC_ERROR_BUSY)
+            return
+
+        if payload and payload[0] & COMMAND_FLAG_COMPRESSED:
+            payload = self._inflate_request(payload)
+            if payload is None:
+                return
+        if payload and payload[0] & COMMAND_FLAG_BATCH:
+            self._process_stream_frame(payload)
+            return
+        cmd = CommandPacket.deserialize(payload)
+        if cmd.cmd_type != CommandType.REQUEST:
+            logger.error("Expected request, got type=%d", cmd.cmd_type)
+            return
+        # Counted here, so STREAM_END_C2P sees every message before it
+        if cmd.cmd_name in C2P_STREAM_COMMANDS:
+            self._process_stream_message(cmd.cmd_name, cmd.data)
+            return
+
+        try:
+            self._requests.put_nowait(_Request(tid, cmd))
+        except asyncio.QueueFull:
+            logger.warning("Request queue full, rejecting tid=%d", tid)
+            await self._send_error(tid, BLERPC_ERROR_BUSY)
+
+    def _reassemble(self, container: Container) -> bytes | None:
+        """Feed a container to its transaction's assembler."""
+        tid = container.transaction_id
+        if container.container_type == ContainerType.FIRST:
+            self._assemblers[tid] = ContainerAssembler()
+            self._assemblers.move_to_end(tid)
+            if len(self._assemblers) > ASSEMBLER_POOL_SIZE:
+                evicted, _ = self._assemblers.popitem(last=False)
+                logger.warning("Reassembly pool full, evicting tid=%d", evicted)
+        assembler = self._assemblers.get(tid)
+        if assembler is None:
+            logger.debug("No reassembly in progress for tid=%d", tid)
+            return None
+        result = assembler.feed(container)
         if result is not None:
-            # Process in a separate thread to avoid blocking CoreBluetooth callback
-            tid = container.transaction_id
-            threading.Thread(
-                target=self._process_request_thread,
-                args=(result, tid),
-                daemon=True,
-            ).start()
-
-    def _handle_key_exchange(self, container: Container):
+            del self._assemblers[tid]
+        return result
+
+    async def _handle_key_exchange(self, container: Container):
         """Handle KEY_EXCHANGE control containers."""
         if not self._encryption_supported or self._kx is None:
             logger.warning("KEY_EXCHANGE received but encryption not supported")
             return
 
+        if self._session_tentative and container.payload[:1] == KX_STEP1:
+            # The central refused the resumed session: start over
+            logger.info("KEY_EXCHANGE replaces an unconfirmed resumption")
+            self._session = None
+            self._session_tentative = False
+            self._kx = PeripheralKeyExchange(self._ed25519_privkey)
+
         # Block KX re-initiation when session already exists
         if self._session is not None:
             logger.warning("KEY_EXCHANGE rejected: encryption already active")
@@ -256,58 +442,157 @@ class BlerpcPeripheral:
             control_cmd=ControlCmd.KEY_EXCHANGE,
             payload=response,
         )
-        self._send_container_sync(resp)
+        await self._send_container(resp)
 
         if session is not None:
-            with self._state_lock:
-                self._session = session
+            self._session = session
+            self._ticket_allowed = True
             logger.info("E2E encryption established")
 
-    def _process_request_thread(self, payload: bytes, transaction_id: int):
-        try:
-            self._process_request(payload, transaction_id)
-        except Exception:
-            logger.exception("Error processing request")
+    def _resume_accept(self, hello: bytes) -> bytes | None:
+        """ACCEPT payload for a HELLO, starting the resumed session; None to
+        refuse it."""
+        if len(hello) != resume.HELLO_SIZE - 1:
+            return None
+        ticket = self._tickets.open(hello[: resume.TICKET_SIZE])
+        if ticket is None:
+            return None
+        nonce_c = hello[resume.TICKET_SIZE :]
+        nonce_p = os.urandom(resume.NONCE_SIZE)
+        keys = resume.derive(ticket.secret, nonce_c, nonce_p)
+        reply = bytes([resume.OP_ACCEPT]) + nonce_p + keys.confirm
+        if ticket.uses_left > 1:
+            reply += self._tickets.seal(
+                keys.next_secret, ticket.issued, ticket.uses_left - 1
+            )
+        self._session = BlerpcCryptoSession(keys.session_key, is_central=False)
+        self._session_tentative = True
+        return reply
+
+    async def _handle_resume(self, container: Container):
+        """Handle RESUME control containers."""
+        if self._tickets is None or not container.payload:
+            logger.warning("RESUME received but encryption not supported")
+            return
 
-    def _send_error(self, transaction_id: int, error_code: int):
-        """Send an ERROR control container to the central."""
-        err = Container(
-            transaction_id=transaction_id,
+        op = container.payload[0]
+        if op == resume.OP_TICKET_REQUEST and self._ticket_allowed:
+            # One ticket per full key exchange
+            self._ticket_allowed = False
+            secret = os.urandom(resume.SECRET_SIZE)
+            ticket = self._tickets.seal(
+                secret, self._tickets.now(), RESUMPTION_MAX_COUNT
+            )
+            reply = bytes([resume.OP_TICKET]) + self._session.encrypt(secret + ticket)
+        elif op == resume.OP_HELLO and self._session is None:
+            reply = self._resume_accept(container.payload[1:])
+            if reply is None:
+                logger.info("Resumption refused, central falls back to KX")
+                reply = bytes([resume.OP_REJECT])
+            else:
+                logger.info("E2E encryption resumed")
+        else:
+            logger.warning("RESUME op 0x%02x rejected", op)
+            reply = bytes([resume.OP_REJECT])
+
+        resp = Container(
+            transaction_id=container.transaction_id,
             sequence_number=0,
             container_type=ContainerType.CONTROL,
-            control_cmd=ControlCmd.ERROR,
-            payload=bytes([error_code]),
+            control_cmd=resume.CONTROL_CMD_RESUME,
+            payload=reply,
         )
-        self._send_container_sync(err)
+        await self._send_container(resp)
 
-    def _process_request(self, payload: bytes, transaction_id: int):
-        # Snapshot session under lock for thread safety
-        with self._state_lock:
-            session = self._session
-
-        # Decrypt if encryption is active
-        if session is not None:
+    def _decrypt_request(self, payload: bytes) -> bytes | None:
+        """Decrypt a reassembled request; None if it must be dropped."""
+        if self._session is not None:
             try:
-                payload = session.decrypt(payload)
+                plain = self._session.decrypt(payload)
             except RuntimeError as e:
                 logger.error("Decryption/replay error: %s", e)
-                self._send_error(transaction_id, BLERPC_ERROR_BUSY)
-                return
-        elif self._encryption_supported:
+                return None
+            self._session_tentative = False
+            return plain
+        if self._encryption_supported:
             # Reject unencrypted data when encryption is supported
             logger.warning(
                 "Rejecting unencrypted payload (encryption supported but not active)"
             )
-            return
+            return None
+        return payload
 
-        cmd = CommandPacket.deserialize(payload)
-        if cmd.cmd_type != CommandType.REQUEST:
-            logger.error("Expected request, got type=%d", cmd.cmd_type)
+    async def _worker(self):
+        while True:
+            request = await self._requests.get()
+            try:
+                await self._process_request(request.cmd, request.transaction_id)
+            except Exception:
+                logger.exception("Error processing request")
+
+    async def _send_error(self, transaction_id: int, error_code: int):
+        """Send an ERROR control container to the central."""
+        err = Container(
+            transaction_id=transaction_id,
+            sequence_number=0,
+            container_type=ContainerType.CONTROL,
+            control_cmd=ControlCmd.ERROR,
+            payload=bytes([error_code]),
+        )
+        await self._send_container(err)
+
+    def _process_stream_frame(self, payload: bytes):
+        """Run every message of a coalesced C->P stream frame in order."""
+        name_len = payload[1] if len(payload) > 1 else 0
+        body_start = 4 + name_len
+        if name_len == 0 or len(payload) < body_start:
+            logger.error("Malformed coalesced stream frame")
             return
+        cmd_name = payload[2 : 2 + name_len].decode()
+        if cmd_name not in C2P_STREAM_COMMANDS:
+            logger.error(
+                "Coalesced frame names '%s', not a C->P stream command", cmd_name
+            )
+            return
+        (body_len,) = struct.unpack_from("<H", payload, body_start - 2)
+        body = payload[body_start : body_start + body_len]
+
+        # Split the whole frame before running any message
+        messages = []
+        off = 0
+        while off < len(body):
+            if len(body) - off < 2:
+                logger.error("Malformed coalesced stream frame")
+                return
+            (msg_len,) = struct.unpack_from("<H", body, off)
+            msg = body[off + 2 : off + 2 + msg_len]
+            off += 2 + msg_len
+            if len(msg) != msg_len:
+                logger.error("Malformed coalesced stream frame")
+                return
+            messages.append(msg)
 
-        # Handle counter_stream specially (P→C stream)
-        if cmd.cmd_name == "counter_stream":
-            self._handle_counter_stream(cmd.data)
+        for msg in messages:
+            if not self._process_stream_message(cmd_name, msg):
+                logger.error("Bad coalesced '%s' message", cmd_name)
+                return
+
+    def _process_stream_message(self, cmd_name: str, data: bytes) -> bool:
+        """Run one C->P stream message's handler; False if it was rejected."""
+        handler = HANDLERS.get(cmd_name)
+        if not handler:
+            logger.error("Unknown command: '%s'", cmd_name)
+            return False
+        if handler(data) is not None:
+            return False
+        self._upload_count += 1
+        return True
+
+    async def _process_request(self, cmd: CommandPacket, transaction_id: int):
+        # P→C streams: one response per message the handler yields
+        stream_handler = self._stream_handlers.get(cmd.cmd_name)
+        if stream_handler is not None:
+            await self._run_stream(cmd.cmd_name, stream_handler(cmd.data))
             return
 
         handler = HANDLERS.get(cmd.cmd_name)
@@ -315,12 +600,8 @@ class BlerpcPeripheral:
             logger.error("Unknown command: '%s'", cmd.cmd_name)
             return
 
-        resp_data = handler(cmd.data)
-
-        # counter_upload returns None (no individual response)
+        resp_data = await self._loop.run_in_executor(self._executor, handler, cmd.data)
         if resp_data is None:
-            with self._state_lock:
-                self._upload_count += 1
             return
 
         resp_cmd = CommandPacket(
@@ -328,17 +609,10 @@ class BlerpcPeripheral:
             cmd_name=cmd.cmd_name,
             data=resp_data,
         )
-        resp_payload = resp_cmd.serialize()
+        resp_payload = self._compress_response(resp_cmd) or resp_cmd.serialize()
 
         if len(resp_payload) > MAX_RESPONSE_PAYLOAD_SIZE:
-            err = Container(
-                transaction_id=transaction_id,
-                sequence_number=0,
-                container_type=ContainerType.CONTROL,
-                control_cmd=ControlCmd.ERROR,
-                payload=bytes([BLERPC_ERROR_RESPONSE_TOO_LARGE]),
-            )
-            self._send_container_sync(err)
+            await self._send_error(transaction_id, BLERPC_ERROR_RESPONSE_TOO_LARGE)
             logger.warning(
                 "Response too large: %d > %d",
                 len(resp_payload),
@@ -346,18 +620,58 @@ class BlerpcPeripheral:
             )
             return
 
-        send_payload = self._maybe_encrypt(resp_payload)
-        with self._state_lock:
+        await self._send_response(resp_payload, transaction_id)
+
+    @staticmethod
+    def _inflate_request(payload: bytes) -> bytes | None:
+        """Replace a compressed request's data with its expansion."""
+        name_len = payload[1]
+        header = bytes([payload[0] & ~COMMAND_FLAG_COMPRESSED]) + payload[
+            1 : 2 + name_len
+        ]
+        try:
+            data = decompress(CommandPacket.deserialize(payload).data)
+        except DecompressError as e:
+            logger.error("Compressed request malformed: %s", e)
+            return None
+        return header + struct.pack("<H", len(data)) + data
+
+    def _compress_response(self, resp_cmd: CommandPacket) -> bytes | None:
+        """Serialize resp_cmd with compressed data, or None if not worth it."""
+        size = len(resp_cmd.data)
+        if not COMPRESS_MIN_SIZE <= size <= self._inflate_limit:
+            return None
+        data = compress(resp_cmd.data)
+        if len(data) >= size:
+            return None
+        payload = bytearray(
+            CommandPacket(
+                cmd_type=resp_cmd.cmd_type, cmd_name=resp_cmd.cmd_name, data=data
+            ).serialize()
+        )
+        payload[0] |= COMMAND_FLAG_COMPRESSED
+        return bytes(payload)
+
+    async def _send_response(self, payload: bytes, transaction_id: int | None = None):
+        """Encrypt a response and queue all of its containers.
+
+        Without a transaction ID, the next one of our own is used, as for
+        stream messages.
+        """
+        async with self._response_lock:
+            send_payload = self._maybe_encrypt(payload)
+            if transaction_id is None:
+                transaction_id = self.splitter.next_transaction_id()
             containers = self.splitter.split(
                 send_payload, transaction_id=transaction_id
             )
-        logger.info(
-            "Sending %d containers (%d bytes payload)",
-            len(containers),
-            len(send_payload),
-        )
-        for c in containers:
-            self._send_container_sync(c)
+            logger.debug(
+                "Sending %d containers (%d bytes payload)",
+                len(containers),
+                len(send_payload),
+            )
+            for c in containers:
+                await self._send_container(c)
 
     def _maybe_encrypt(self, payload: bytes) -> bytes:
         """Encrypt payload if encryption is active, otherwise return as-is."""
@@ -365,49 +679,62 @@ class BlerpcPeripheral:
             return payload
         return self._session.encrypt(payload)
 
+    async def _run_stream(self, cmd_name: str, messages: AsyncIterator[bytes]):
+        """Send each message of a P→C stream, then STREAM_END_P2C."""
+        count = 0
+        async for data in messages:
+            resp_cmd = CommandPacket(
+                cmd_type=CommandType.RESPONSE,
+                cmd_name=cmd_name,
+                data=data,
+            )
+            await self._send_response(resp_cmd.serialize())
+            count += 1
+        tid = self.splitter.next_transaction_id()
+        await self._send_container(make_stream_end_p2c(transaction_id=tid))
+        logger.info("%s: sent %d responses + STREAM_END_P2C", cmd_name, count)
+
     _MAX_COUNTER_STREAM_COUNT = 10000
 
-    def _handle_counter_stream(self, req_data: bytes):
-        """Handle counter_stream: send N responses + STREAM_END_P2C."""
+    async def _counter_stream(self, req_data: bytes) -> AsyncIterator[bytes]:
+        """counter_stream: N CounterStreamResponse messages."""
         req = blerpc_pb2.CounterStreamRequest()
         req.ParseFromString(req_data)
         logger.info("CounterStream: count=%d", req.count)
 
         if req.count > self._MAX_COUNTER_STREAM_COUNT:
-            logger.error(
-                "CounterStream: count %d exceeds max %d",
-                req.count,
-                self._MAX_COUNTER_STREAM_COUNT,
+            raise ValueError(
+                f"CounterStream: count {req.count} exceeds max "
+                f"{self._MAX_COUNTER_STREAM_COUNT}"
             )
-            return
 
         for i in range(req.count):
             resp = blerpc_pb2.CounterStreamResponse(seq=i, value=i * 10)
-            resp_cmd = CommandPacket(
-                cmd_type=CommandType.RESPONSE,
-                cmd_name="counter_stream",
-                data=resp.SerializeToString(),
-            )
-            resp_payload = resp_cmd.serialize()
-            send_payload = self._maybe_encrypt(resp_payload)
-            with self._state_lock:
-                tid = self.splitter.next_transaction_id()
-                containers = self.splitter.split(send_payload, transaction_id=tid)
-            for c in containers:
-                self._send_container_sync(c)
+            yield resp.SerializeToString()
 
-        # Send STREAM_END_P2C
-        with self._state_lock:
-            tid = self.splitter.next_transaction_id()
-        stream_end = make_stream_end_p2c(transaction_id=tid)
-        self._send_container_sync(stream_end)
-        logger.info("CounterStream: sent %d responses + STREAM_END_P2C", req.count)
+    async def _flash_dump(self, req_data: bytes) -> AsyncIterator[bytes]:
+        """flash_dump: CRC-tagged chunks of the requested range.
 
-    def _handle_stream_end_c2p(self, transaction_id: int):
+        Flash is simulated with a pattern derived from the address, so a
+        dump resumed from any offset returns the same bytes.
+        """
+        req = blerpc_pb2.FlashDumpRequest()
+        req.ParseFromString(req_data)
+        logger.info("FlashDump: addr=0x%08x len=%d", req.address, req.length)
+
+        end = req.address + req.length
+        for offset in range(req.address, end, FLASH_DUMP_CHUNK_SIZE):
+            n = min(FLASH_DUMP_CHUNK_SIZE, end - offset)
+            data = bytes((a ^ (a >> 8)) & 0xFF for a in range(offset, offset + n))
+            resp = blerpc_pb2.FlashDumpResponse(
+                offset=offset, data=data, crc32=zlib.crc32(data)
+            )
+            yield resp.SerializeToString()
+
+    async def _handle_stream_end_c2p(self):
         """Handle STREAM_END_C2P: send final counter_upload response."""
-        with self._state_lock:
-            count = self._upload_count
-            self._upload_count = 0
+        count = self._upload_count
+        self._upload_count = 0
         logger.info(
             "STREAM_END_C2P: sending counter_upload response, received_count=%d",
             count,
@@ -419,27 +746,59 @@ class BlerpcPeripheral:
             cmd_name="counter_upload",
             data=resp.SerializeToString(),
         )
-        resp_payload = resp_cmd.serialize()
-        send_payload = self._maybe_encrypt(resp_payload)
-        with self._state_lock:
-            tid = self.splitter.next_transaction_id()
-            containers = self.splitter.split(send_payload, transaction_id=tid)
-        for c in containers:
-            self._send_container_sync(c)
-
-    def _send_container_sync(self, container: Container):
-        data = container.serialize()
-        char = self.server.get_characteristic(CHAR_UUID)
-        char.value = data
-        for attempt in range(NOTIFY_MAX_RETRIES):
-            result = self.server.update_value(SERVICE_UUID, CHAR_UUID)
-            if result:
-                break
-            time.sleep(NOTIFY_RETRY_DELAY_S)
-        else:
-            logger.error("update_value failed after %d retries", NOTIFY_MAX_RETRIES)
+        await self._send_response(resp_cmd.serialize())
+
+    async def _send_container(self, container: Container):
+        """Queue a container for the sender, waiting while the queue is full."""
+        await self._tx_queue.put(container.serialize())
+
+    def _notify(self, data: bytes) -> bool:
+        """Hand one notification to the link; False while its queue is full."""
+        if self._link is not None:
+            return self._link.notify(data)
+        self.server.get_characteristic(CHAR_UUID).value = data
+        return self.server.update_value(SERVICE_UUID, CHAR_UUID)
+
+    async def _sender(self):
+        while True:
+            data = await self._tx_queue.get()
+            try:
+                await self._notify_async(data)
+            except Exception:
+                logger.exception("Error sending notification")
+
+    async def _notify_async(self, data: bytes):
+        """Send one notification, waiting for room in the TX buffer.
+
+        A loopback link signals when a notification leaves its buffer. bless
+        has no such callback, so a full GATT queue is polled with backoff
+        from sub-millisecond up to NOTIFY_BACKOFF_MAX_S.
+        """
+        deadline = self._loop.time() + NOTIFY_TIMEOUT_S
+        delay = NOTIFY_BACKOFF_MIN_S
+        while True:
+            self._tx_ready.clear()
+            if self._notify(data):
+                return
+            remaining = deadline - self._loop.time()
+            if remaining <= 0:
+                logger.error("update_value timed out after %.1fs", NOTIFY_TIMEOUT_S)
+                return
+            if self._link is not None:
+                try:
+                    await asyncio.wait_for(self._tx_ready.wait(), remaining)
+                except asyncio.TimeoutError:
+                    pass
+            else:
+                await asyncio.sleep(min(delay, remaining))
+                delay = min(delay * 2, NOTIFY_BACKOFF_MAX_S)
 
     async def stop(self):
+        for task in self._tasks:
+            task.cancel()
+        self._tasks = []
+        if self._executor is not None:
+            self._executor.shutdown(wait=False)
         if self.server:
             await self.server.stop()
 
@@ -29,36 +29,92 @@ func generateCClientHeader(commands []Command, streaming map[string]string, call
 		"/* Callback for P2C streaming response payloads */",
 		"typedef int (*" + pkg + "_on_stream_resp_t)(const uint8_t *data, size_t len, void *ctx);",
 		"",
+		"/* Callback for a unary response payload. data is loaned from the transport's",
+		" * receive buffer and only valid until the callback returns. */",
+		"typedef int (*" + pkg + "_on_resp_t)(const uint8_t *data, size_t len, void *ctx);",
+		"",
+		"/* Producer for a streamed bytes field: fill buf with up to size bytes of the",
+		" * field starting at offset. Returns the number of bytes written (> 0), or",
+		" * negative on error. */",
+		"typedef int (*" + pkg + "_produce_t)(size_t offset, uint8_t *buf, size_t size, void *ctx);",
+		"",
+		"/* Writer for a request payload of exactly the announced length */",
+		"typedef bool (*" + pkg + "_encode_req_t)(pb_ostream_t *stream, void *ctx);",
+		"",
 		"/* Callback for C2P streaming message serialization */",
 		"typedef int (*" + pkg + "_next_msg_t)(size_t index, uint8_t *buf, size_t buf_size,",
 		"                                 size_t *len, void *ctx);",
 		"",
-		"/* User-provided RPC transport functions */",
-		"extern int " + pkg + "_rpc_call(const char *cmd_name,",
-		"                           const uint8_t *req_data, size_t req_len,",
+		"/* Connection handle, defined by the transport */",
+		"struct " + pkg + "_conn;",
+		"",
+		"/* User-provided RPC transport functions. cmd_id is the command's wire ID,",
+		" * which the transport may send instead of cmd_name when the peer's schema",
+		" * hash matches " + strings.ToUpper(pkg) + "_SCHEMA_HASH. */",
+		"extern int " + pkg + "_rpc_call(struct " + pkg + "_conn *conn, uint8_t cmd_id,",
+		"                           const char *cmd_name, const uint8_t *req_data, size_t req_len,",
 		"                           uint8_t *resp_data, size_t resp_size, size_t *resp_len);",
 		"",
-		"extern int " + pkg + "_stream_receive(const char *cmd_name,",
-		"                                 const uint8_t *req_data, size_t req_len,",
-		"                                 " + pkg + "_on_stream_resp_t on_resp, void *ctx);",
+		"/* Like " + pkg + "_rpc_call(), but hands the response payload to on_resp in place",
+		" * instead of copying it out; on_resp runs before this returns. */",
+		"extern int " + pkg + "_rpc_call_loan(struct " + pkg + "_conn *conn, uint8_t cmd_id,",
+		"                                const char *cmd_name, const uint8_t *req_data,",
+		"                                size_t req_len, " + pkg + "_on_resp_t on_resp, void *ctx);",
+		"",
+		"/* Like " + pkg + "_rpc_call_loan(), but encode writes the req_len byte request",
+		" * into a stream that sends it as it is produced, so it is never staged. */",
+		"extern int " + pkg + "_rpc_call_encode(struct " + pkg + "_conn *conn, uint8_t cmd_id,",
+		"                                  const char *cmd_name, size_t req_len,",
+		"                                  " + pkg + "_encode_req_t encode, void *encode_ctx,",
+		"                                  " + pkg + "_on_resp_t on_resp, void *ctx);",
+		"",
+		"extern int " + pkg + "_stream_receive(struct " + pkg + "_conn *conn, uint8_t cmd_id,",
+		"                                 const char *cmd_name, const uint8_t *req_data,",
+		"                                 size_t req_len, " + pkg + "_on_stream_resp_t on_resp,",
+		"                                 void *ctx);",
 		"",
-		"extern int " + pkg + "_stream_send(const char *cmd_name, size_t msg_count,",
+		"extern int " + pkg + "_stream_send(struct " + pkg + "_conn *conn, uint8_t cmd_id,",
+		"                              const char *cmd_name, size_t msg_count,",
 		"                              " + pkg + "_next_msg_t next_msg, void *msg_ctx,",
 		"                              const char *final_cmd_name,",
 		"                              uint8_t *resp_data, size_t resp_size, size_t *resp_len);",
 		"",
-		"/* Generated typed RPC functions */",
 	}
 	for _, l := range lines {
 		b.WriteString(l)
 		b.WriteByte('\n')
 	}
+	b.WriteString(cCommandIDDefines(commands, pkg))
+	batchCmds := cBatchCommands(commands, streaming, callbacks)
+	if len(batchCmds) > 0 {
+		b.WriteString(generateCBatchTypes(pkg))
+	}
+	b.WriteString("/* Generated typed RPC functions */\n")
 
 	for _, cmd := range commands {
 		params := cClientParams(cmd, streaming, callbacks, pkg)
 		b.WriteString(fmt.Sprintf("int %s_%s(%s);\n", pkg, cmd.Snake, strings.Join(params, ", ")))
 	}
 
+	if streamedCmds := cStreamedCommands(commands, streaming, callbacks); len(streamedCmds) > 0 {
+		b.WriteString("\n/* Generated streamed-request functions: bytes fields are pulled from a\n")
+		b.WriteString(" * producer while the request is sent instead of passed in a buffer */\n")
+		for _, cmd := range streamedCmds {
+			params := cStreamedParams(cmd, streaming, callbacks, pkg)
+			b.WriteString(fmt.Sprintf("int %s_%s_streamed(%s);\n", pkg, cmd.Snake, strings.Join(params, ", ")))
+		}
+	}
+
+	if len(batchCmds) > 0 {
+		b.WriteString("\n/* Generated batch functions */\n")
+		b.WriteString("void " + pkg + "_batch_init(struct " + pkg + "_batch *batch);\n")
+		b.WriteString("int " + pkg + "_batch_send(struct " + pkg + "_conn *conn, struct " + pkg + "_batch *batch);\n")
+		for _, cmd := range batchCmds {
+			params := cBatchParams(cmd, streaming, callbacks, pkg)
+			b.WriteString(fmt.Sprintf("int %s_batch_%s(%s);\n", pkg, cmd.Snake, strings.Join(params, ", ")))
+		}
+	}
+
 	tail := []string{
 		"",
 		"#ifdef __cplusplus",
@@ -84,15 +140,15 @@ func generateCClientSource(commands []Command, streaming map[string]string, call
 	// Check if we need helpers
 	needDecode := false
 	needEncode := false
-	needRespBuf := false
+	needMsgDecode := false
 	for _, cmd := range commands {
 		if _, ok := streaming[cmd.Snake]; ok {
 			continue
 		}
+		needMsgDecode = true
 		for _, f := range cmd.ResponseFields {
 			if callbacks[cmd.ResponseMsg+"."+f.Name] {
 				needDecode = true
-				needRespBuf = true
 			}
 		}
 		for _, f := range cmd.RequestFields {
@@ -102,15 +158,20 @@ func generateCClientSource(commands []Command, streaming map[string]string, call
 		}
 	}
 
-	up := strings.ToUpper(pkg)
-	bufMacro := up + "_GENERATED_RESP_BUF_SIZE"
-
-	// Internal response buffer for FT_CALLBACK response commands
-	if needRespBuf {
-		b.WriteString("#ifndef " + bufMacro + "\n")
-		b.WriteString("#define " + bufMacro + " 4096\n")
-		b.WriteString("#endif\n")
-		b.WriteString("static uint8_t _" + pkg + "_resp_buf[" + bufMacro + "];\n\n")
+	// Unary responses are decoded straight from the transport's loaned
+	// receive buffer, so no response copy is needed
+	if needMsgDecode {
+		b.WriteString("/* Decode context for a loaned unary response */\n")
+		b.WriteString("struct _" + pkg + "_msg_decode_ctx {\n")
+		b.WriteString("    const pb_msgdesc_t *fields;\n")
+		b.WriteString("    void *msg;\n")
+		b.WriteString("};\n\n")
+		b.WriteString("static int _" + pkg + "_decode_msg(const uint8_t *data, size_t len, void *ctx)\n")
+		b.WriteString("{\n")
+		b.WriteString("    const struct _" + pkg + "_msg_decode_ctx *c = ctx;\n")
+		b.WriteString("    pb_istream_t istream = pb_istream_from_buffer(data, len);\n")
+		b.WriteString("    return pb_decode(&istream, c->fields, c->msg) ? 0 : -1;\n")
+		b.WriteString("}\n\n")
 	}
 
 	if needDecode {
@@ -135,6 +196,7 @@ func generateCClientSource(commands []Command, streaming map[string]string, call
 	}
 
 	if needEncode {
+		b.WriteString(generateCProduceHelpers(pkg))
 		b.WriteString("/* Encode context for FT_CALLBACK bytes fields */\n")
 		b.WriteString("struct _" + pkg + "_bytes_encode_ctx {\n")
 		b.WriteString("    const uint8_t *data;\n")
@@ -152,14 +214,42 @@ func generateCClientSource(commands []Command, streaming map[string]string, call
 		b.WriteString("}\n\n")
 	}
 
+	// Stream messages are coded once per message, so fixed-layout ones skip
+	// nanopb's table-driven codec
+	var directEnc, directDec []cDirectMsg
+	for _, cmd := range commands {
+		switch dir, isStreaming := streaming[cmd.Snake]; {
+		case isStreaming && dir == "c2p":
+			directEnc = appendDirectMsg(directEnc, pkg+"_"+cmd.RequestMsg, cmd.RequestFields)
+		case isStreaming && dir == "p2c" && !cRespHasCallbacks(cmd, callbacks):
+			directDec = appendDirectMsg(directDec, pkg+"_"+cmd.ResponseMsg, cmd.ResponseFields)
+		}
+	}
+	if len(directEnc)+len(directDec) > 0 {
+		b.WriteString("/* Direct codecs for fixed-layout stream messages: the bytes pb_encode()\n")
+		b.WriteString(" * writes, without walking nanopb's field tables */\n")
+		b.WriteString(cDirectCodecs("static ", "_", "_"+pkg+"_", directEnc, directDec))
+	}
+
 	// Per-command generation
 	for _, cmd := range commands {
 		dir, isStreaming := streaming[cmd.Snake]
 		reqMsg := pkg + "_" + cmd.RequestMsg
 		respMsg := pkg + "_" + cmd.ResponseMsg
 		params := cClientParams(cmd, streaming, callbacks, pkg)
+		idMacro := cCommandIDMacro(cmd, pkg)
 
-		if isStreaming && dir == "p2c" {
+		if isStreaming && dir == "p2c" && cRespHasCallbacks(cmd, callbacks) {
+			// P2C streaming with FT_CALLBACK response fields: each response
+			// payload goes to the caller's callback, to be decoded in place
+			b.WriteString(fmt.Sprintf("int %s_%s(%s)\n", pkg, cmd.Snake, strings.Join(params, ", ")))
+			b.WriteString("{\n")
+			b.WriteString(cP2CRequestEncode(cmd, reqMsg))
+			b.WriteString(fmt.Sprintf("    return "+pkg+"_stream_receive(conn, %s, \"%s\", req_buf,\n", idMacro, cmd.Snake))
+			b.WriteString("                                 ostream.bytes_written, on_resp, ctx);\n")
+			b.WriteString("}\n\n")
+
+		} else if isStreaming && dir == "p2c" {
 			// P2C streaming: callback struct + on_resp function + main function
 			b.WriteString(fmt.Sprintf("struct _"+pkg+"_%s_ctx {\n", cmd.Snake))
 			b.WriteString(fmt.Sprintf("    %s *results;\n", respMsg))
@@ -172,33 +262,27 @@ func generateCClientSource(commands []Command, streaming map[string]string, call
 			b.WriteString("{\n")
 			b.WriteString(fmt.Sprintf("    struct _"+pkg+"_%s_ctx *c = (struct _"+pkg+"_%s_ctx *)ctx;\n", cmd.Snake, cmd.Snake))
 			b.WriteString("    if (c->count >= c->max_results) return -1;\n")
-			b.WriteString(fmt.Sprintf("    c->results[c->count] = (%s)%s_init_zero;\n", respMsg, respMsg))
-			b.WriteString("    pb_istream_t istream = pb_istream_from_buffer(data, len);\n")
-			b.WriteString(fmt.Sprintf("    if (!pb_decode(&istream, %s_fields, &c->results[c->count])) return -1;\n", respMsg))
+			if cFixedLayout(cmd.ResponseFields) {
+				b.WriteString(fmt.Sprintf("    if (!%s(data, len, &c->results[c->count])) return -1;\n",
+					cDirectDecodeName("_", respMsg)))
+			} else {
+				b.WriteString(fmt.Sprintf("    c->results[c->count] = (%s)%s_init_zero;\n", respMsg, respMsg))
+				b.WriteString("    pb_istream_t istream = pb_istream_from_buffer(data, len);\n")
+				b.WriteString(fmt.Sprintf("    if (!pb_decode(&istream, %s_fields, &c->results[c->count])) return -1;\n", respMsg))
+			}
 			b.WriteString("    c->count++;\n")
 			b.WriteString("    return 0;\n")
 			b.WriteString("}\n\n")
 
 			b.WriteString(fmt.Sprintf("int %s_%s(%s)\n", pkg, cmd.Snake, strings.Join(params, ", ")))
 			b.WriteString("{\n")
-			b.WriteString(fmt.Sprintf("    %s req = %s_init_zero;\n", reqMsg, reqMsg))
-			for _, f := range cmd.RequestFields {
-				if f.Type == "string" {
-					b.WriteString(fmt.Sprintf("    strncpy(req.%s, %s, sizeof(req.%s) - 1);\n", f.Name, f.Name, f.Name))
-				} else {
-					b.WriteString(fmt.Sprintf("    req.%s = %s;\n", f.Name, f.Name))
-				}
-			}
-			b.WriteByte('\n')
-			b.WriteString(fmt.Sprintf("    uint8_t req_buf[%s_size];\n", reqMsg))
-			b.WriteString("    pb_ostream_t ostream = pb_ostream_from_buffer(req_buf, sizeof(req_buf));\n")
-			b.WriteString(fmt.Sprintf("    if (!pb_encode(&ostream, %s_fields, &req)) return -1;\n", reqMsg))
-			b.WriteByte('\n')
+			b.WriteString(cP2CRequestEncode(cmd, reqMsg))
 			b.WriteString(fmt.Sprintf("    struct _"+pkg+"_%s_ctx ctx = {\n", cmd.Snake))
 			b.WriteString("        .results = results, .max_results = max_results, .count = 0\n")
 			b.WriteString("    };\n")
-			b.WriteString(fmt.Sprintf("    if ("+pkg+"_stream_receive(\"%s\", req_buf, ostream.bytes_written,\n", cmd.Snake))
-			b.WriteString(fmt.Sprintf("                              _"+pkg+"_%s_on_resp, &ctx) != 0) return -1;\n", cmd.Snake))
+			b.WriteString(fmt.Sprintf("    if ("+pkg+"_stream_receive(conn, %s, \"%s\", req_buf,\n", idMacro, cmd.Snake))
+			b.WriteString(fmt.Sprintf("                              ostream.bytes_written, _"+pkg+"_%s_on_resp,\n", cmd.Snake))
+			b.WriteString("                              &ctx) != 0) return -1;\n")
 			b.WriteByte('\n')
 			b.WriteString("    *result_count = ctx.count;\n")
 			b.WriteString("    return 0;\n")
@@ -214,9 +298,20 @@ func generateCClientSource(commands []Command, streaming map[string]string, call
 			b.WriteString(fmt.Sprintf("                           %ssize_t buf_size, size_t *len, void *ctx)\n", strings.Repeat(" ", len(cmd.Snake))))
 			b.WriteString("{\n")
 			b.WriteString(fmt.Sprintf("    struct _"+pkg+"_%s_ctx *c = (struct _"+pkg+"_%s_ctx *)ctx;\n", cmd.Snake, cmd.Snake))
-			b.WriteString("    pb_ostream_t ostream = pb_ostream_from_buffer(buf, buf_size);\n")
-			b.WriteString(fmt.Sprintf("    if (!pb_encode(&ostream, %s_fields, &c->messages[index])) return -1;\n", reqMsg))
-			b.WriteString("    *len = ostream.bytes_written;\n")
+			if cFixedLayout(cmd.RequestFields) {
+				// Encoded whole first: buf may be shorter than the bound
+				// while still holding the message
+				b.WriteString(fmt.Sprintf("    uint8_t msg_buf[%s_size];\n", reqMsg))
+				b.WriteString(fmt.Sprintf("    size_t msg_len = %s(&c->messages[index], msg_buf);\n",
+					cDirectEncodeName("_", reqMsg)))
+				b.WriteString("    if (msg_len > buf_size) return -1;\n")
+				b.WriteString("    memcpy(buf, msg_buf, msg_len);\n")
+				b.WriteString("    *len = msg_len;\n")
+			} else {
+				b.WriteString("    pb_ostream_t ostream = pb_ostream_from_buffer(buf, buf_size);\n")
+				b.WriteString(fmt.Sprintf("    if (!pb_encode(&ostream, %s_fields, &c->messages[index])) return -1;\n", reqMsg))
+				b.WriteString("    *len = ostream.bytes_written;\n")
+			}
 			b.WriteString("    return 0;\n")
 			b.WriteString("}\n\n")
 
@@ -226,7 +321,7 @@ func generateCClientSource(commands []Command, streaming map[string]string, call
 			b.WriteByte('\n')
 			b.WriteString(fmt.Sprintf("    uint8_t resp_buf[%s_size];\n", respMsg))
 			b.WriteString("    size_t resp_len;\n")
-			b.WriteString(fmt.Sprintf("    if ("+pkg+"_stream_send(\"%s\", msg_count,\n", cmd.Snake))
+			b.WriteString(fmt.Sprintf("    if ("+pkg+"_stream_send(conn, %s, \"%s\", msg_count,\n", idMacro, cmd.Snake))
 			b.WriteString(fmt.Sprintf("                           _"+pkg+"_%s_next, &ctx,\n", cmd.Snake))
 			b.WriteString(fmt.Sprintf("                           \"%s\", resp_buf, sizeof(resp_buf),\n", cmd.Snake))
 			b.WriteString("                           &resp_len) != 0) return -1;\n")
@@ -241,17 +336,11 @@ func generateCClientSource(commands []Command, streaming map[string]string, call
 		} else {
 			// Unary command
 			hasCbReq := false
-			hasCbResp := false
 			for _, f := range cmd.RequestFields {
 				if callbacks[cmd.RequestMsg+"."+f.Name] {
 					hasCbReq = true
 				}
 			}
-			for _, f := range cmd.ResponseFields {
-				if callbacks[cmd.ResponseMsg+"."+f.Name] {
-					hasCbResp = true
-				}
-			}
 
 			b.WriteString(fmt.Sprintf("int %s_%s(%s)\n", pkg, cmd.Snake, strings.Join(params, ", ")))
 			b.WriteString("{\n")
@@ -299,68 +388,381 @@ func generateCClientSource(commands []Command, streaming map[string]string, call
 			}
 			b.WriteByte('\n')
 
+			// Response is decoded by the transport's callback
+			b.WriteString(cRespDecodeSetup(cmd, callbacks, pkg))
+			b.WriteString("    struct _" + pkg + "_msg_decode_ctx dctx = {\n")
+			b.WriteString(fmt.Sprintf("        .fields = %s_fields, .msg = resp\n", respMsg))
+			b.WriteString("    };\n")
+
 			// RPC call
 			reqBufName := "req_buf"
 			if hasCbReq {
 				reqBufName = "work_buf"
 			}
-			if hasCbResp {
-				b.WriteString("    size_t resp_len;\n")
-				b.WriteString(fmt.Sprintf("    if ("+pkg+"_rpc_call(\"%s\", %s, ostream.bytes_written,\n", cmd.Snake, reqBufName))
-				b.WriteString("                        _" + pkg + "_resp_buf, sizeof(_" + pkg + "_resp_buf),\n")
-				b.WriteString("                        &resp_len) != 0) return -1;\n")
-			} else {
-				b.WriteString(fmt.Sprintf("    uint8_t resp_buf[%s_size];\n", respMsg))
-				b.WriteString("    size_t resp_len;\n")
-				b.WriteString(fmt.Sprintf("    if ("+pkg+"_rpc_call(\"%s\", %s, ostream.bytes_written,\n", cmd.Snake, reqBufName))
-				b.WriteString("                        resp_buf, sizeof(resp_buf), &resp_len) != 0) return -1;\n")
-			}
+			callPad := strings.Repeat(" ", len("    if ("+pkg+"_rpc_call_loan("))
+			b.WriteString(fmt.Sprintf("    if ("+pkg+"_rpc_call_loan(conn, %s, \"%s\", %s,\n", idMacro, cmd.Snake, reqBufName))
+			b.WriteString(callPad + "ostream.bytes_written, _" + pkg + "_decode_msg, &dctx) != 0) return -1;\n")
+
+			// Set output lengths for FT_CALLBACK response fields
+			b.WriteString(cRespLengths(cmd, callbacks))
+
 			b.WriteByte('\n')
+			b.WriteString("    return 0;\n")
+			b.WriteString("}\n\n")
+		}
+	}
 
-			// Decode context for FT_CALLBACK response fields
-			if hasCbResp {
-				for _, f := range cmd.ResponseFields {
-					if callbacks[cmd.ResponseMsg+"."+f.Name] {
-						b.WriteString(fmt.Sprintf("    struct _"+pkg+"_bytes_decode_ctx _%s_ctx = {\n", f.Name))
-						b.WriteString(fmt.Sprintf("        .buf = %s_buf, .buf_size = %s_buf_size, .decoded_len = 0\n", f.Name, f.Name))
-						b.WriteString("    };\n")
-					}
-				}
-			}
+	if streamedCmds := cStreamedCommands(commands, streaming, callbacks); len(streamedCmds) > 0 {
+		b.WriteString(generateCStreamedSource(streamedCmds, streaming, callbacks, pkg))
+	}
 
-			// Decode response
-			b.WriteString(fmt.Sprintf("    *resp = (%s)%s_init_zero;\n", respMsg, respMsg))
-			if hasCbResp {
-				for _, f := range cmd.ResponseFields {
-					if callbacks[cmd.ResponseMsg+"."+f.Name] {
-						b.WriteString(fmt.Sprintf("    resp->%s.funcs.decode = _"+pkg+"_decode_bytes_cb;\n", f.Name))
-						b.WriteString(fmt.Sprintf("    resp->%s.arg = &_%s_ctx;\n", f.Name, f.Name))
-					}
-				}
+	if batchCmds := cBatchCommands(commands, streaming, callbacks); len(batchCmds) > 0 {
+		b.WriteString(generateCBatchSource(batchCmds, streaming, callbacks, pkg))
+	}
+
+	return b.String()
+}
+
+// cP2CRequestEncode emits the request encode of a P2C stream function into
+// req_buf / ostream.
+func cP2CRequestEncode(cmd Command, reqMsg string) string {
+	var b strings.Builder
+	b.WriteString(fmt.Sprintf("    %s req = %s_init_zero;\n", reqMsg, reqMsg))
+	for _, f := range cmd.RequestFields {
+		if f.Type == "string" {
+			b.WriteString(fmt.Sprintf("    strncpy(req.%s, %s, sizeof(req.%s) - 1);\n", f.Name, f.Name, f.Name))
+		} else {
+			b.WriteString(fmt.Sprintf("    req.%s = %s;\n", f.Name, f.Name))
+		}
+	}
+	b.WriteByte('\n')
+	b.WriteString(fmt.Sprintf("    uint8_t req_buf[%s_size];\n", reqMsg))
+	b.WriteString("    pb_ostream_t ostream = pb_ostream_from_buffer(req_buf, sizeof(req_buf));\n")
+	b.WriteString(fmt.Sprintf("    if (!pb_encode(&ostream, %s_fields, &req)) return -1;\n", reqMsg))
+	b.WriteByte('\n')
+	return b.String()
+}
+
+// cStreamedCommands returns the unary commands with FT_CALLBACK request
+// fields, which get a *_streamed function taking a producer per field.
+func cStreamedCommands(commands []Command, streaming map[string]string, callbacks map[string]bool) []Command {
+	var out []Command
+	for _, cmd := range commands {
+		if _, ok := streaming[cmd.Snake]; ok {
+			continue
+		}
+		for _, f := range cmd.RequestFields {
+			if callbacks[cmd.RequestMsg+"."+f.Name] {
+				out = append(out, cmd)
+				break
 			}
+		}
+	}
+	return out
+}
 
-			isBuf := "_" + pkg + "_resp_buf"
-			if !hasCbResp {
-				isBuf = "resp_buf"
+// cStreamedParams is the unary parameter list with a length, producer and
+// producer context in place of each FT_CALLBACK request field's buffer, and
+// no work buffer.
+func cStreamedParams(cmd Command, streaming map[string]string, callbacks map[string]bool, pkg string) []string {
+	params := []string{"struct " + pkg + "_conn *conn"}
+	for _, f := range cmd.RequestFields {
+		if callbacks[cmd.RequestMsg+"."+f.Name] {
+			params = append(params,
+				fmt.Sprintf("size_t %s_len", f.Name),
+				fmt.Sprintf("%s_produce_t %s_produce", pkg, f.Name),
+				fmt.Sprintf("void *%s_ctx", f.Name),
+			)
+		} else {
+			params = append(params, cParamStr(resolveCType(f), f.Name))
+		}
+	}
+	unary := cClientParams(cmd, streaming, callbacks, pkg)
+	for i, p := range unary {
+		if p == "size_t work_buf_size" {
+			return append(params, unary[i+1:]...)
+		}
+	}
+	return params
+}
+
+// generateCProduceHelpers emits the encode callback that pulls a bytes
+// field from a producer, and the whole-message writer handed to the
+// transport.
+func generateCProduceHelpers(pkg string) string {
+	up := strings.ToUpper(pkg)
+	lines := []string{
+		"/* Bytes pulled from a producer per call */",
+		"#ifndef " + up + "_PRODUCE_CHUNK_SIZE",
+		"#define " + up + "_PRODUCE_CHUNK_SIZE 64",
+		"#endif",
+		"",
+		"/* Encode context for FT_CALLBACK bytes fields read from a producer */",
+		"struct _" + pkg + "_bytes_produce_ctx {",
+		"    size_t len;",
+		"    " + pkg + "_produce_t produce;",
+		"    void *ctx;",
+		"};",
+		"",
+		"static bool _" + pkg + "_encode_produced_cb(pb_ostream_t *stream,",
+		"                                        const pb_field_t *field,",
+		"                                        void *const *arg)",
+		"{",
+		"    const struct _" + pkg + "_bytes_produce_ctx *ctx =",
+		"        *(const struct _" + pkg + "_bytes_produce_ctx **)arg;",
+		"    if (!pb_encode_tag_for_field(stream, field)) return false;",
+		"    if (!pb_encode_varint(stream, ctx->len)) return false;",
+		"    /* Sizing pass: count the bytes without producing them */",
+		"    if (stream->callback == NULL) return pb_write(stream, NULL, ctx->len);",
+		"",
+		"    uint8_t chunk[" + up + "_PRODUCE_CHUNK_SIZE];",
+		"    size_t off = 0;",
+		"    while (off < ctx->len) {",
+		"        size_t want = ctx->len - off;",
+		"        if (want > sizeof(chunk)) want = sizeof(chunk);",
+		"        int n = ctx->produce(off, chunk, want, ctx->ctx);",
+		"        if (n <= 0 || (size_t)n > want) return false;",
+		"        if (!pb_write(stream, chunk, (size_t)n)) return false;",
+		"        off += (size_t)n;",
+		"    }",
+		"    return true;",
+		"}",
+		"",
+		"/* Whole-message writer for " + pkg + "_rpc_call_encode() */",
+		"struct _" + pkg + "_msg_encode_ctx {",
+		"    const pb_msgdesc_t *fields;",
+		"    const void *msg;",
+		"};",
+		"",
+		"static bool _" + pkg + "_encode_msg(pb_ostream_t *stream, void *ctx)",
+		"{",
+		"    const struct _" + pkg + "_msg_encode_ctx *c = ctx;",
+		"    return pb_encode(stream, c->fields, c->msg);",
+		"}",
+		"",
+	}
+	return strings.Join(lines, "\n") + "\n"
+}
+
+// generateCStreamedSource emits the *_streamed functions: the request is
+// sized once with the producers skipped, then encoded straight into the
+// transport, which sends each container as it fills.
+func generateCStreamedSource(streamedCmds []Command, streaming map[string]string, callbacks map[string]bool, pkg string) string {
+	var b strings.Builder
+	for _, cmd := range streamedCmds {
+		reqMsg := pkg + "_" + cmd.RequestMsg
+		respMsg := pkg + "_" + cmd.ResponseMsg
+		params := cStreamedParams(cmd, streaming, callbacks, pkg)
+
+		b.WriteString(fmt.Sprintf("int %s_%s_streamed(%s)\n", pkg, cmd.Snake, strings.Join(params, ", ")))
+		b.WriteString("{\n")
+		for _, f := range cmd.RequestFields {
+			if callbacks[cmd.RequestMsg+"."+f.Name] {
+				b.WriteString(fmt.Sprintf("    struct _"+pkg+"_bytes_produce_ctx _%s_ctx = {\n", f.Name))
+				b.WriteString(fmt.Sprintf("        .len = %s_len, .produce = %s_produce, .ctx = %s_ctx\n", f.Name, f.Name, f.Name))
+				b.WriteString("    };\n")
 			}
-			b.WriteString(fmt.Sprintf("    pb_istream_t istream = pb_istream_from_buffer(%s, resp_len);\n", isBuf))
-			b.WriteString(fmt.Sprintf("    if (!pb_decode(&istream, %s_fields, resp)) return -1;\n", respMsg))
+		}
+		b.WriteString(fmt.Sprintf("    %s req = %s_init_zero;\n", reqMsg, reqMsg))
+		for _, f := range cmd.RequestFields {
+			if callbacks[cmd.RequestMsg+"."+f.Name] {
+				b.WriteString(fmt.Sprintf("    req.%s.funcs.encode = _"+pkg+"_encode_produced_cb;\n", f.Name))
+				b.WriteString(fmt.Sprintf("    req.%s.arg = &_%s_ctx;\n", f.Name, f.Name))
+			} else if f.Type == "string" {
+				b.WriteString(fmt.Sprintf("    strncpy(req.%s, %s, sizeof(req.%s) - 1);\n", f.Name, f.Name, f.Name))
+			} else {
+				b.WriteString(fmt.Sprintf("    req.%s = %s;\n", f.Name, f.Name))
+			}
+		}
+		b.WriteByte('\n')
+		b.WriteString("    pb_ostream_t sizing = PB_OSTREAM_SIZING;\n")
+		b.WriteString(fmt.Sprintf("    if (!pb_encode(&sizing, %s_fields, &req)) return -1;\n", reqMsg))
+		b.WriteByte('\n')
+		b.WriteString(cRespDecodeSetup(cmd, callbacks, pkg))
+		b.WriteString("    struct _" + pkg + "_msg_encode_ctx ectx = {\n")
+		b.WriteString(fmt.Sprintf("        .fields = %s_fields, .msg = &req\n", reqMsg))
+		b.WriteString("    };\n")
+		b.WriteString("    struct _" + pkg + "_msg_decode_ctx dctx = {\n")
+		b.WriteString(fmt.Sprintf("        .fields = %s_fields, .msg = resp\n", respMsg))
+		b.WriteString("    };\n")
+		callPad := strings.Repeat(" ", len("    if ("+pkg+"_rpc_call_encode("))
+		b.WriteString(fmt.Sprintf("    if ("+pkg+"_rpc_call_encode(conn, %s, \"%s\", sizing.bytes_written,\n", cCommandIDMacro(cmd, pkg), cmd.Snake))
+		b.WriteString(callPad + "_" + pkg + "_encode_msg, &ectx, _" + pkg + "_decode_msg,\n")
+		b.WriteString(callPad + "&dctx) != 0) return -1;\n")
+		b.WriteString(cRespLengths(cmd, callbacks))
+		b.WriteByte('\n')
+		b.WriteString("    return 0;\n")
+		b.WriteString("}\n\n")
+	}
+	return b.String()
+}
 
-			// Set output lengths for FT_CALLBACK response fields
-			if hasCbResp {
+// cRespDecodeSetup emits the zeroed response and the decode contexts of its
+// FT_CALLBACK fields.
+func cRespDecodeSetup(cmd Command, callbacks map[string]bool, pkg string) string {
+	var b strings.Builder
+	respMsg := pkg + "_" + cmd.ResponseMsg
+	for _, f := range cmd.ResponseFields {
+		if callbacks[cmd.ResponseMsg+"."+f.Name] {
+			b.WriteString(fmt.Sprintf("    struct _"+pkg+"_bytes_decode_ctx _%s_ctx = {\n", f.Name))
+			b.WriteString(fmt.Sprintf("        .buf = %s_buf, .buf_size = %s_buf_size, .decoded_len = 0\n", f.Name, f.Name))
+			b.WriteString("    };\n")
+		}
+	}
+	b.WriteString(fmt.Sprintf("    *resp = (%s)%s_init_zero;\n", respMsg, respMsg))
+	for _, f := range cmd.ResponseFields {
+		if callbacks[cmd.ResponseMsg+"."+f.Name] {
+			b.WriteString(fmt.Sprintf("    resp->%s.funcs.decode = _"+pkg+"_decode_bytes_cb;\n", f.Name))
+			b.WriteString(fmt.Sprintf("    resp->%s.arg = &_%s_ctx;\n", f.Name, f.Name))
+		}
+	}
+	return b.String()
+}
+
+// cRespLengths emits the output lengths of FT_CALLBACK response fields.
+func cRespLengths(cmd Command, callbacks map[string]bool) string {
+	var b strings.Builder
+	for _, f := range cmd.ResponseFields {
+		if callbacks[cmd.ResponseMsg+"."+f.Name] {
+			if b.Len() == 0 {
 				b.WriteByte('\n')
-				for _, f := range cmd.ResponseFields {
-					if callbacks[cmd.ResponseMsg+"."+f.Name] {
-						b.WriteString(fmt.Sprintf("    *%s_len = _%s_ctx.decoded_len;\n", f.Name, f.Name))
-					}
-				}
 			}
+			b.WriteString(fmt.Sprintf("    *%s_len = _%s_ctx.decoded_len;\n", f.Name, f.Name))
+		}
+	}
+	return b.String()
+}
 
-			b.WriteByte('\n')
-			b.WriteString("    return 0;\n")
-			b.WriteString("}\n\n")
+// cBatchCommands returns the commands that get a batch_* function.
+func cBatchCommands(commands []Command, streaming map[string]string, callbacks map[string]bool) []Command {
+	var out []Command
+	for _, cmd := range commands {
+		if cBatchable(cmd, streaming, callbacks) {
+			out = append(out, cmd)
 		}
 	}
+	return out
+}
+
+// cBatchParams is the unary parameter list with the batch in place of the
+// connection.
+func cBatchParams(cmd Command, streaming map[string]string, callbacks map[string]bool, pkg string) []string {
+	params := cClientParams(cmd, streaming, callbacks, pkg)
+	params[0] = "struct " + pkg + "_batch *batch"
+	return params
+}
+
+// generateCBatchTypes emits the batch structs and transport extern.
+func generateCBatchTypes(pkg string) string {
+	up := strings.ToUpper(pkg)
+	lines := []string{
+		"/* Batched calls: " + pkg + "_batch_<command>() queues a request and " + pkg + "_batch_send()",
+		" * sends the queue as one command frame, then decodes every response */",
+		"#ifndef " + up + "_BATCH_MAX_CALLS",
+		"#define " + up + "_BATCH_MAX_CALLS 32",
+		"#endif",
+		"#ifndef " + up + "_BATCH_BUF_SIZE",
+		"#define " + up + "_BATCH_BUF_SIZE 1024",
+		"#endif",
+		"",
+		"struct " + pkg + "_batch_call {",
+		"    uint8_t cmd_id;",
+		"    const char *cmd_name;",
+		"    const uint8_t *req_data;",
+		"    size_t req_len;",
+		"    uint8_t *resp_data;",
+		"    size_t resp_size;",
+		"    size_t resp_len; /* set by the transport */",
+		"};",
+		"",
+		"struct " + pkg + "_batch {",
+		"    struct " + pkg + "_batch_call calls[" + up + "_BATCH_MAX_CALLS];",
+		"    const pb_msgdesc_t *resp_fields[" + up + "_BATCH_MAX_CALLS];",
+		"    void *resp[" + up + "_BATCH_MAX_CALLS];",
+		"    size_t count;",
+		"    size_t used; /* bytes of buf taken by encoded requests and response space */",
+		"    uint8_t buf[" + up + "_BATCH_BUF_SIZE];",
+		"};",
+		"",
+		"extern int " + pkg + "_rpc_call_batch(struct " + pkg + "_conn *conn,",
+		strings.Repeat(" ", len("extern int "+pkg+"_rpc_call_batch(")) + "struct " + pkg + "_batch_call *calls, size_t count);",
+		"",
+	}
+	return strings.Join(lines, "\n") + "\n"
+}
 
+// generateCBatchSource emits the batch queueing, send and per-command
+// functions.
+func generateCBatchSource(batchCmds []Command, streaming map[string]string, callbacks map[string]bool, pkg string) string {
+	var b strings.Builder
+	up := strings.ToUpper(pkg)
+	batch := "struct " + pkg + "_batch"
+
+	b.WriteString("void " + pkg + "_batch_init(" + batch + " *batch)\n")
+	b.WriteString("{\n")
+	b.WriteString("    batch->count = 0;\n")
+	b.WriteString("    batch->used = 0;\n")
+	b.WriteString("}\n\n")
+
+	b.WriteString("/* Encode a request into the batch buffer and reserve its response space */\n")
+	addPad := strings.Repeat(" ", len("static int _"+pkg+"_batch_add("))
+	b.WriteString("static int _" + pkg + "_batch_add(" + batch + " *batch, uint8_t cmd_id,\n")
+	b.WriteString(addPad + "const char *cmd_name, const pb_msgdesc_t *req_fields,\n")
+	b.WriteString(addPad + "const void *req, const pb_msgdesc_t *resp_fields,\n")
+	b.WriteString(addPad + "size_t resp_size, void *resp)\n")
+	b.WriteString("{\n")
+	b.WriteString("    if (batch->count >= " + up + "_BATCH_MAX_CALLS) return -1;\n")
+	b.WriteString("    uint8_t *req_buf = batch->buf + batch->used;\n")
+	b.WriteString("    size_t left = sizeof(batch->buf) - batch->used;\n")
+	b.WriteString("    pb_ostream_t ostream = pb_ostream_from_buffer(req_buf, left);\n")
+	b.WriteString("    if (!pb_encode(&ostream, req_fields, req)) return -1;\n")
+	b.WriteString("    if (resp_size > left - ostream.bytes_written) return -1;\n")
+	b.WriteByte('\n')
+	b.WriteString("    struct " + pkg + "_batch_call *call = &batch->calls[batch->count];\n")
+	b.WriteString("    call->cmd_id = cmd_id;\n")
+	b.WriteString("    call->cmd_name = cmd_name;\n")
+	b.WriteString("    call->req_data = req_buf;\n")
+	b.WriteString("    call->req_len = ostream.bytes_written;\n")
+	b.WriteString("    call->resp_data = req_buf + ostream.bytes_written;\n")
+	b.WriteString("    call->resp_size = resp_size;\n")
+	b.WriteString("    call->resp_len = 0;\n")
+	b.WriteString("    batch->resp_fields[batch->count] = resp_fields;\n")
+	b.WriteString("    batch->resp[batch->count] = resp;\n")
+	b.WriteString("    batch->count++;\n")
+	b.WriteString("    batch->used += ostream.bytes_written + resp_size;\n")
+	b.WriteString("    return 0;\n")
+	b.WriteString("}\n\n")
+
+	b.WriteString("int " + pkg + "_batch_send(struct " + pkg + "_conn *conn, " + batch + " *batch)\n")
+	b.WriteString("{\n")
+	b.WriteString("    if (" + pkg + "_rpc_call_batch(conn, batch->calls, batch->count) != 0) return -1;\n")
+	b.WriteString("    for (size_t i = 0; i < batch->count; i++) {\n")
+	b.WriteString("        pb_istream_t istream =\n")
+	b.WriteString("            pb_istream_from_buffer(batch->calls[i].resp_data, batch->calls[i].resp_len);\n")
+	b.WriteString("        if (!pb_decode(&istream, batch->resp_fields[i], batch->resp[i])) return -1;\n")
+	b.WriteString("    }\n")
+	b.WriteString("    return 0;\n")
+	b.WriteString("}\n\n")
+
+	for _, cmd := range batchCmds {
+		reqMsg := pkg + "_" + cmd.RequestMsg
+		respMsg := pkg + "_" + cmd.ResponseMsg
+		params := cBatchParams(cmd, streaming, callbacks, pkg)
+		b.WriteString(fmt.Sprintf("int %s_batch_%s(%s)\n", pkg, cmd.Snake, strings.Join(params, ", ")))
+		b.WriteString("{\n")
+		b.WriteString(fmt.Sprintf("    %s req = %s_init_zero;\n", reqMsg, reqMsg))
+		for _, f := range cmd.RequestFields {
+			if f.Type == "string" {
+				b.WriteString(fmt.Sprintf("    strncpy(req.%s, %s, sizeof(req.%s) - 1);\n", f.Name, f.Name, f.Name))
+			} else {
+				b.WriteString(fmt.Sprintf("    req.%s = %s;\n", f.Name, f.Name))
+			}
+		}
+		b.WriteString(fmt.Sprintf("    return _%s_batch_add(batch, %s, \"%s\", %s_fields, &req,\n",
+			pkg, cCommandIDMacro(cmd, pkg), cmd.Snake, reqMsg))
+		b.WriteString(fmt.Sprintf("%s%s_fields, %s_size, resp);\n",
+			strings.Repeat(" ", len("    return _"+pkg+"_batch_add(")), respMsg, respMsg))
+		b.WriteString("}\n\n")
+	}
 	return b.String()
 }
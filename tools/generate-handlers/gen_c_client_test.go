@@ -12,9 +12,10 @@ func TestGenerateCClientHeader_Echo(t *testing.T) {
 	mustContain := []string{
 		"#ifndef BLERPC_GENERATED_CLIENT_H",
 		"blerpc_rpc_call",
-		"int blerpc_echo(",
-		"const char *message",
+		"struct blerpc_conn;",
+		"int blerpc_echo(struct blerpc_conn *conn, const char *message",
 		"blerpc_EchoResponse *resp",
+		"extern int blerpc_rpc_call(struct blerpc_conn *conn,",
 	}
 	for _, s := range mustContain {
 		if !strings.Contains(out, s) {
@@ -32,7 +33,7 @@ func TestGenerateCClientSource_Echo(t *testing.T) {
 		"int blerpc_echo(",
 		"blerpc_EchoRequest req = blerpc_EchoRequest_init_zero",
 		"strncpy(req.message, message",
-		`blerpc_rpc_call("echo"`,
+		`blerpc_rpc_call_loan(conn, BLERPC_CMD_ID_ECHO, "echo"`,
 		"blerpc_EchoResponse_fields",
 	}
 	for _, s := range mustContain {
@@ -60,6 +61,46 @@ func TestGenerateCClientHeader_StreamP2C(t *testing.T) {
 	}
 }
 
+func TestGenerateCClient_StreamP2CCallbackResponse(t *testing.T) {
+	cmd := Command{
+		Camel:       "FlashDump",
+		Snake:       "flash_dump",
+		RequestMsg:  "FlashDumpRequest",
+		ResponseMsg: "FlashDumpResponse",
+		RequestFields: []Field{
+			{Type: "uint32", Name: "address", Number: 1},
+			{Type: "uint32", Name: "length", Number: 2},
+		},
+		ResponseFields: []Field{
+			{Type: "uint32", Name: "offset", Number: 1},
+			{Type: "bytes", Name: "data", Number: 2},
+			{Type: "uint32", Name: "crc32", Number: 3},
+		},
+	}
+	streaming := map[string]string{"flash_dump": "p2c"}
+	callbacks := map[string]bool{"FlashDumpResponse.data": true}
+	hdr := generateCClientHeader([]Command{cmd}, streaming, callbacks, "blerpc")
+	src := generateCClientSource([]Command{cmd}, streaming, callbacks, "blerpc")
+
+	want := "int blerpc_flash_dump(struct blerpc_conn *conn, uint32_t address, uint32_t length, " +
+		"blerpc_on_stream_resp_t on_resp, void *ctx);"
+	if !strings.Contains(hdr, want) {
+		t.Errorf("C client header missing %q\nGot:\n%s", want, hdr)
+	}
+	for _, s := range []string{
+		"req.address = address;",
+		`return blerpc_stream_receive(conn, BLERPC_CMD_ID_FLASH_DUMP, "flash_dump", req_buf,`,
+		"ostream.bytes_written, on_resp, ctx);",
+	} {
+		if !strings.Contains(src, s) {
+			t.Errorf("C client source missing %q\nGot:\n%s", s, src)
+		}
+	}
+	if strings.Contains(src, "_blerpc_flash_dump_ctx") {
+		t.Error("callback-response stream should not collect results")
+	}
+}
+
 func TestGenerateCClientSource_StreamP2C(t *testing.T) {
 	cmds := []Command{streamP2CCommand()}
 	streaming := map[string]string{"counter_stream": "p2c"}
@@ -68,7 +109,7 @@ func TestGenerateCClientSource_StreamP2C(t *testing.T) {
 	mustContain := []string{
 		"struct _blerpc_counter_stream_ctx",
 		"_blerpc_counter_stream_on_resp",
-		"blerpc_stream_receive(",
+		`blerpc_stream_receive(conn, BLERPC_CMD_ID_COUNTER_STREAM, "counter_stream"`,
 		"blerpc_CounterStreamRequest req = blerpc_CounterStreamRequest_init_zero",
 		"req.start = start",
 		"*result_count = ctx.count",
@@ -86,7 +127,7 @@ func TestGenerateCClientHeader_StreamC2P(t *testing.T) {
 	out := generateCClientHeader(cmds, streaming, nil, "blerpc")
 
 	mustContain := []string{
-		"int blerpc_counter_upload(",
+		"int blerpc_counter_upload(struct blerpc_conn *conn,",
 		"const blerpc_CounterUploadRequest *messages",
 		"size_t msg_count",
 		"blerpc_CounterUploadResponse *resp",
@@ -106,7 +147,7 @@ func TestGenerateCClientSource_StreamC2P(t *testing.T) {
 	mustContain := []string{
 		"struct _blerpc_counter_upload_ctx",
 		"_blerpc_counter_upload_next(",
-		"blerpc_stream_send(",
+		`blerpc_stream_send(conn, BLERPC_CMD_ID_COUNTER_UPLOAD, "counter_upload"`,
 		"blerpc_CounterUploadResponse_fields",
 	}
 	for _, s := range mustContain {
@@ -116,6 +157,23 @@ func TestGenerateCClientSource_StreamC2P(t *testing.T) {
 	}
 }
 
+func TestGenerateCClientSource_LoanedResponse(t *testing.T) {
+	cmds := []Command{echoCommand(), callbackCommand()}
+	out := generateCClientSource(cmds, nil, nil, "blerpc")
+
+	if strings.Contains(out, "_blerpc_resp_buf") {
+		t.Error("unary responses should be decoded from the loaned buffer, not copied")
+	}
+	for _, s := range []string{
+		"static int _blerpc_decode_msg(const uint8_t *data, size_t len, void *ctx)",
+		"_blerpc_decode_msg, &dctx",
+	} {
+		if !strings.Contains(out, s) {
+			t.Errorf("C client source missing %q\nGot:\n%s", s, out)
+		}
+	}
+}
+
 func TestGenerateCClientSource_Callback(t *testing.T) {
 	cmds := []Command{callbackCommand()}
 	callbacks := map[string]bool{
@@ -143,6 +201,7 @@ func TestGenerateCClientHeader_CustomPkg(t *testing.T) {
 	mustContain := []string{
 		"#ifndef MYAPP_GENERATED_CLIENT_H",
 		"myapp_rpc_call",
+		"struct myapp_conn *conn",
 		"int myapp_echo(",
 		"myapp_EchoResponse *resp",
 	}
@@ -170,3 +229,80 @@ func TestGenerateCClientSource_MultiField(t *testing.T) {
 		}
 	}
 }
+
+func TestGenerateCClient_Batch(t *testing.T) {
+	cmds := []Command{echoCommand(), callbackCommand(), streamP2CCommand()}
+	streaming := map[string]string{"counter_stream": "p2c"}
+	callbacks := map[string]bool{"DataWriteRequest.data": true}
+	hdr := generateCClientHeader(cmds, streaming, callbacks, "blerpc")
+	src := generateCClientSource(cmds, streaming, callbacks, "blerpc")
+
+	hdrContain := []string{
+		"struct blerpc_batch_call {",
+		"struct blerpc_batch {",
+		"extern int blerpc_rpc_call_batch(struct blerpc_conn *conn,",
+		"int blerpc_batch_send(struct blerpc_conn *conn, struct blerpc_batch *batch);",
+		"int blerpc_batch_echo(struct blerpc_batch *batch, const char *message, blerpc_EchoResponse *resp);",
+	}
+	for _, s := range hdrContain {
+		if !strings.Contains(hdr, s) {
+			t.Errorf("C client header missing %q\nGot:\n%s", s, hdr)
+		}
+	}
+	srcContain := []string{
+		"static int _blerpc_batch_add(",
+		`return _blerpc_batch_add(batch, BLERPC_CMD_ID_ECHO, "echo", blerpc_EchoRequest_fields, &req,`,
+		"blerpc_rpc_call_batch(conn, batch->calls, batch->count)",
+	}
+	for _, s := range srcContain {
+		if !strings.Contains(src, s) {
+			t.Errorf("C client source missing %q\nGot:\n%s", s, src)
+		}
+	}
+	for _, s := range []string{"blerpc_batch_data_write", "blerpc_batch_counter_stream"} {
+		if strings.Contains(hdr, s) {
+			t.Errorf("C client header should not batch %q", s)
+		}
+	}
+}
+
+func TestGenerateCClient_NoBatchableCommands(t *testing.T) {
+	cmds := []Command{streamP2CCommand()}
+	streaming := map[string]string{"counter_stream": "p2c"}
+	src := generateCClientSource(cmds, streaming, nil, "blerpc")
+	if strings.Contains(src, "_blerpc_batch_add") {
+		t.Error("batch helpers should be omitted when no command is batchable")
+	}
+}
+
+func TestGenerateCClient_StreamedRequest(t *testing.T) {
+	cmds := []Command{echoCommand(), callbackCommand()}
+	callbacks := map[string]bool{
+		"DataWriteRequest.data": true,
+	}
+	hdr := generateCClientHeader(cmds, nil, callbacks, "blerpc")
+	src := generateCClientSource(cmds, nil, callbacks, "blerpc")
+
+	for _, s := range []string{
+		"typedef int (*blerpc_produce_t)(size_t offset, uint8_t *buf, size_t size, void *ctx);",
+		"extern int blerpc_rpc_call_encode(",
+		"int blerpc_data_write_streamed(struct blerpc_conn *conn, uint32_t address, size_t data_len, blerpc_produce_t data_produce, void *data_ctx, blerpc_DataWriteResponse *resp);",
+	} {
+		if !strings.Contains(hdr, s) {
+			t.Errorf("C client header missing %q", s)
+		}
+	}
+	for _, s := range []string{
+		"_blerpc_encode_produced_cb",
+		"if (stream->callback == NULL) return pb_write(stream, NULL, ctx->len);",
+		"req.data.funcs.encode = _blerpc_encode_produced_cb;",
+		`blerpc_rpc_call_encode(conn, BLERPC_CMD_ID_DATA_WRITE, "data_write", sizing.bytes_written,`,
+	} {
+		if !strings.Contains(src, s) {
+			t.Errorf("C client source missing %q", s)
+		}
+	}
+	if strings.Contains(src, "blerpc_echo_streamed") || strings.Contains(hdr, "blerpc_echo_streamed") {
+		t.Error("commands without FT_CALLBACK request fields should not get a streamed variant")
+	}
+}
@@ -0,0 +1,253 @@
+package main
+
+import (
+	"fmt"
+	"sort"
+	"strings"
+)
+
+// Direct C codecs for fixed-layout messages: every field is a singular
+// varint scalar, so a message encodes to its tags and varints in field
+// number order, exactly as pb_encode() writes it, with no field tables to
+// walk. Decoding hands anything it does not expect (other fields or wire
+// types, out-of-range values) to pb_decode(), so the result never differs
+// from nanopb's.
+
+// cFixedLayout reports whether a message can use the direct codec.
+func cFixedLayout(fields []Field) bool {
+	if len(fields) == 0 {
+		return false
+	}
+	for _, f := range fields {
+		if f.IsRepeated || f.IsMessage || f.IsMap || f.InOneof || f.IsOptional {
+			return false
+		}
+		if f.IsEnum {
+			continue
+		}
+		switch f.Type {
+		case "uint32", "int32", "uint64", "int64", "bool":
+		default:
+			return false
+		}
+	}
+	return true
+}
+
+// cDirectEncodeName and cDirectDecodeName name the codec functions of a
+// message; prefix is "" for public functions and "_" for file-local ones.
+func cDirectEncodeName(prefix, msg string) string {
+	return prefix + msg + "_encode_direct"
+}
+
+func cDirectDecodeName(prefix, msg string) string {
+	return prefix + msg + "_decode_direct"
+}
+
+// cDirectEncodeSignature is the encoder prototype, without a trailing ';'.
+func cDirectEncodeSignature(prefix, msg string) string {
+	return fmt.Sprintf("size_t %s(const %s *msg, uint8_t *buf)", cDirectEncodeName(prefix, msg), msg)
+}
+
+// cDirectDecodeSignature is the decoder prototype, without a trailing ';'.
+func cDirectDecodeSignature(prefix, msg string) string {
+	return fmt.Sprintf("bool %s(const uint8_t *data, size_t len, %s *msg)", cDirectDecodeName(prefix, msg), msg)
+}
+
+// protoVarint returns the varint encoding of v.
+func protoVarint(v uint64) []byte {
+	var out []byte
+	for v >= 0x80 {
+		out = append(out, byte(v)|0x80)
+		v >>= 7
+	}
+	return append(out, byte(v))
+}
+
+func sortedByNumber(fields []Field) []Field {
+	sorted := append([]Field(nil), fields...)
+	sort.SliceStable(sorted, func(i, j int) bool { return sorted[i].Number < sorted[j].Number })
+	return sorted
+}
+
+// cVarint32 reports whether a field's varint fits 32 bits; negative int32
+// and enum values are sign-extended to ten bytes on the wire.
+func cVarint32(f Field) bool {
+	return !f.IsEnum && (f.Type == "uint32" || f.Type == "bool")
+}
+
+// cDirectHelpers emits the varint helpers, <helperPrefix>put_varint32,
+// put_varint and get_varint, that the encoders of encFields and any
+// decoder need.
+func cDirectHelpers(helperPrefix string, encode, decode bool, encFields [][]Field) string {
+	need32, need64 := false, false
+	for _, fields := range encFields {
+		for _, f := range fields {
+			if cVarint32(f) {
+				need32 = true
+			} else {
+				need64 = true
+			}
+		}
+	}
+	var b strings.Builder
+	if encode && need32 {
+		b.WriteString("static uint8_t *" + helperPrefix + "put_varint32(uint8_t *p, uint32_t v)\n")
+		b.WriteString("{\n")
+		b.WriteString("    while (v >= 0x80) {\n")
+		b.WriteString("        *p++ = (uint8_t)(v | 0x80);\n")
+		b.WriteString("        v >>= 7;\n")
+		b.WriteString("    }\n")
+		b.WriteString("    *p++ = (uint8_t)v;\n")
+		b.WriteString("    return p;\n")
+		b.WriteString("}\n\n")
+	}
+	if encode && need64 {
+		b.WriteString("static uint8_t *" + helperPrefix + "put_varint(uint8_t *p, uint64_t v)\n")
+		b.WriteString("{\n")
+		b.WriteString("    while (v >= 0x80) {\n")
+		b.WriteString("        *p++ = (uint8_t)(v | 0x80);\n")
+		b.WriteString("        v >>= 7;\n")
+		b.WriteString("    }\n")
+		b.WriteString("    *p++ = (uint8_t)v;\n")
+		b.WriteString("    return p;\n")
+		b.WriteString("}\n\n")
+	}
+	if decode {
+		b.WriteString("/* NULL if the varint is truncated, longer than ten bytes or over 64 bits */\n")
+		b.WriteString("static const uint8_t *" + helperPrefix + "get_varint(const uint8_t *p, const uint8_t *end,\n")
+		b.WriteString(strings.Repeat(" ", len("static const uint8_t *"+helperPrefix+"get_varint(")) + "uint64_t *out)\n")
+		b.WriteString("{\n")
+		b.WriteString("    uint64_t v = 0;\n")
+		b.WriteString("    for (unsigned int shift = 0; shift < 70 && p < end; shift += 7) {\n")
+		b.WriteString("        uint8_t byte = *p++;\n")
+		b.WriteString("        if (shift == 63 && (byte & 0x7E)) {\n")
+		b.WriteString("            return NULL; /* bits past 64, nanopb's \"varint overflow\" */\n")
+		b.WriteString("        }\n")
+		b.WriteString("        v |= (uint64_t)(byte & 0x7F) << shift;\n")
+		b.WriteString("        if (!(byte & 0x80)) {\n")
+		b.WriteString("            *out = v;\n")
+		b.WriteString("            return p;\n")
+		b.WriteString("        }\n")
+		b.WriteString("    }\n")
+		b.WriteString("    return NULL;\n")
+		b.WriteString("}\n\n")
+	}
+	return b.String()
+}
+
+// cDirectEncode emits the encoder of a fixed-layout message. buf must
+// hold <msg>_size bytes. storage is "" or "static ".
+func cDirectEncode(storage, prefix, helperPrefix, msg string, fields []Field) string {
+	var b strings.Builder
+	b.WriteString(storage + cDirectEncodeSignature(prefix, msg) + "\n")
+	b.WriteString("{\n")
+	b.WriteString("    uint8_t *p = buf;\n")
+	for _, f := range sortedByNumber(fields) {
+		b.WriteString(fmt.Sprintf("    if (msg->%s) {\n", f.Name))
+		for _, t := range protoVarint(uint64(f.Number) << 3) {
+			b.WriteString(fmt.Sprintf("        *p++ = 0x%02x;\n", t))
+		}
+		switch {
+		case !f.IsEnum && f.Type == "bool":
+			b.WriteString("        *p++ = 1;\n")
+		case cVarint32(f):
+			b.WriteString(fmt.Sprintf("        p = %sput_varint32(p, msg->%s);\n", helperPrefix, f.Name))
+		case !f.IsEnum && f.Type == "uint64":
+			b.WriteString(fmt.Sprintf("        p = %sput_varint(p, msg->%s);\n", helperPrefix, f.Name))
+		default:
+			b.WriteString(fmt.Sprintf("        p = %sput_varint(p, (uint64_t)(int64_t)msg->%s);\n", helperPrefix, f.Name))
+		}
+		b.WriteString("    }\n")
+	}
+	b.WriteString("    return (size_t)(p - buf);\n")
+	b.WriteString("}\n\n")
+	return b.String()
+}
+
+// cDirectDecode emits the decoder of a fixed-layout message.
+func cDirectDecode(storage, prefix, helperPrefix, msg string, fields []Field) string {
+	var b strings.Builder
+	b.WriteString(storage + cDirectDecodeSignature(prefix, msg) + "\n")
+	b.WriteString("{\n")
+	b.WriteString("    const uint8_t *p = data;\n")
+	b.WriteString("    const uint8_t *end = data + len;\n")
+	b.WriteString("    uint64_t tag;\n")
+	b.WriteString("    uint64_t v;\n")
+	b.WriteByte('\n')
+	b.WriteString(fmt.Sprintf("    *msg = (%s)%s_init_zero;\n", msg, msg))
+	b.WriteString("    while (p < end) {\n")
+	b.WriteString(fmt.Sprintf("        p = %sget_varint(p, end, &tag);\n", helperPrefix))
+	b.WriteString(fmt.Sprintf("        p = p ? %sget_varint(p, end, &v) : NULL;\n", helperPrefix))
+	b.WriteString("        if (!p) goto fallback;\n")
+	b.WriteString("        switch (tag) {\n")
+	for _, f := range sortedByNumber(fields) {
+		b.WriteString(fmt.Sprintf("        case 0x%02x:\n", f.Number<<3))
+		switch {
+		case !f.IsEnum && f.Type == "bool":
+			b.WriteString("            if (v > UINT32_MAX) goto fallback;\n")
+			b.WriteString(fmt.Sprintf("            msg->%s = v != 0;\n", f.Name))
+		case !f.IsEnum && f.Type == "uint32":
+			b.WriteString("            if (v > UINT32_MAX) goto fallback;\n")
+			b.WriteString(fmt.Sprintf("            msg->%s = (uint32_t)v;\n", f.Name))
+		case !f.IsEnum && f.Type == "uint64":
+			b.WriteString(fmt.Sprintf("            msg->%s = v;\n", f.Name))
+		case !f.IsEnum && f.Type == "int64":
+			b.WriteString(fmt.Sprintf("            msg->%s = (int64_t)v;\n", f.Name))
+		default:
+			b.WriteString("            if ((int64_t)v < INT32_MIN || (int64_t)v > INT32_MAX) goto fallback;\n")
+			b.WriteString(fmt.Sprintf("            msg->%s = (int32_t)v;\n", f.Name))
+		}
+		b.WriteString("            break;\n")
+	}
+	b.WriteString("        default:\n")
+	b.WriteString("            goto fallback;\n")
+	b.WriteString("        }\n")
+	b.WriteString("    }\n")
+	b.WriteString("    return true;\n")
+	b.WriteByte('\n')
+	b.WriteString("fallback:;\n")
+	b.WriteString("    /* Not the layout this codec knows: nanopb decides */\n")
+	b.WriteString("    pb_istream_t stream = pb_istream_from_buffer(data, len);\n")
+	b.WriteString(fmt.Sprintf("    *msg = (%s)%s_init_zero;\n", msg, msg))
+	b.WriteString(fmt.Sprintf("    return pb_decode(&stream, %s_fields, msg);\n", msg))
+	b.WriteString("}\n\n")
+	return b.String()
+}
+
+// cDirectMsg is a fixed-layout message that gets a direct codec.
+type cDirectMsg struct {
+	Name   string // C type, <pkg>_<Message>
+	Fields []Field
+}
+
+// appendDirectMsg adds a message to list if it is fixed-layout and not
+// listed yet.
+func appendDirectMsg(list []cDirectMsg, name string, fields []Field) []cDirectMsg {
+	if !cFixedLayout(fields) {
+		return list
+	}
+	for _, m := range list {
+		if m.Name == name {
+			return list
+		}
+	}
+	return append(list, cDirectMsg{Name: name, Fields: fields})
+}
+
+// cDirectCodecs emits the helpers and codecs for encoders and decoders.
+func cDirectCodecs(storage, prefix, helperPrefix string, encoders, decoders []cDirectMsg) string {
+	var encFields [][]Field
+	for _, m := range encoders {
+		encFields = append(encFields, m.Fields)
+	}
+	var b strings.Builder
+	b.WriteString(cDirectHelpers(helperPrefix, len(encoders) > 0, len(decoders) > 0, encFields))
+	for _, m := range encoders {
+		b.WriteString(cDirectEncode(storage, prefix, helperPrefix, m.Name, m.Fields))
+	}
+	for _, m := range decoders {
+		b.WriteString(cDirectDecode(storage, prefix, helperPrefix, m.Name, m.Fields))
+	}
+	return b.String()
+}
@@ -0,0 +1,125 @@
+package main
+
+import (
+	"strings"
+	"testing"
+)
+
+func TestCFixedLayout(t *testing.T) {
+	tests := []struct {
+		name   string
+		fields []Field
+		want   bool
+	}{
+		{"scalars", []Field{{Type: "uint32", Number: 1}, {Type: "int32", Number: 2}, {Type: "bool", Number: 3}}, true},
+		{"enum", []Field{{Type: "Status", Number: 1, IsEnum: true}}, true},
+		{"empty", nil, false},
+		{"string", []Field{{Type: "string", Number: 1}}, false},
+		{"bytes", []Field{{Type: "bytes", Number: 1}}, false},
+		{"repeated", []Field{{Type: "uint32", Number: 1, IsRepeated: true}}, false},
+		{"message", []Field{{Type: "Address", Number: 1, IsMessage: true}}, false},
+		{"oneof", []Field{{Type: "uint32", Number: 1, InOneof: true}}, false},
+		{"optional", []Field{{Type: "uint32", Number: 1, IsOptional: true}}, false},
+	}
+	for _, tt := range tests {
+		if got := cFixedLayout(tt.fields); got != tt.want {
+			t.Errorf("cFixedLayout(%s) = %v, want %v", tt.name, got, tt.want)
+		}
+	}
+}
+
+func TestCDirectEncode(t *testing.T) {
+	fields := []Field{
+		{Type: "int32", Name: "value", Number: 2},
+		{Type: "uint32", Name: "seq", Number: 1},
+		{Type: "bool", Name: "last", Number: 16},
+	}
+	out := cDirectEncode("", "", "", "blerpc_Sample", fields)
+
+	mustContain := []string{
+		"size_t blerpc_Sample_encode_direct(const blerpc_Sample *msg, uint8_t *buf)",
+		"        *p++ = 0x08;\n        p = put_varint32(p, msg->seq);",
+		"        *p++ = 0x10;\n        p = put_varint(p, (uint64_t)(int64_t)msg->value);",
+		"        *p++ = 0x80;\n        *p++ = 0x01;\n        *p++ = 1;",
+	}
+	for _, s := range mustContain {
+		if !strings.Contains(out, s) {
+			t.Errorf("direct encoder missing %q\nGot:\n%s", s, out)
+		}
+	}
+	if strings.Index(out, "msg->seq") > strings.Index(out, "msg->value") {
+		t.Error("direct encoder should write fields in field number order")
+	}
+}
+
+func TestCDirectDecode(t *testing.T) {
+	fields := []Field{
+		{Type: "uint32", Name: "seq", Number: 1},
+		{Type: "int32", Name: "value", Number: 2},
+	}
+	out := cDirectDecode("static ", "_", "_blerpc_", "blerpc_Sample", fields)
+
+	mustContain := []string{
+		"static bool _blerpc_Sample_decode_direct(const uint8_t *data, size_t len, blerpc_Sample *msg)",
+		"p = _blerpc_get_varint(p, end, &tag);",
+		"case 0x08:",
+		"msg->seq = (uint32_t)v;",
+		"case 0x10:",
+		"if ((int64_t)v < INT32_MIN || (int64_t)v > INT32_MAX) goto fallback;",
+		"return pb_decode(&stream, blerpc_Sample_fields, msg);",
+	}
+	for _, s := range mustContain {
+		if !strings.Contains(out, s) {
+			t.Errorf("direct decoder missing %q\nGot:\n%s", s, out)
+		}
+	}
+}
+
+func TestGenerateCHeader_DirectCodecs(t *testing.T) {
+	cmds := []Command{streamP2CCommand(), echoCommand()}
+	out := generateCHeader(cmds, nil, "blerpc")
+
+	mustContain := []string{
+		`#include "blerpc.pb.h"`,
+		"size_t blerpc_CounterStreamResponse_encode_direct(const blerpc_CounterStreamResponse *msg, uint8_t *buf);",
+		"bool blerpc_CounterStreamRequest_decode_direct(const uint8_t *data, size_t len, blerpc_CounterStreamRequest *msg);",
+	}
+	for _, s := range mustContain {
+		if !strings.Contains(out, s) {
+			t.Errorf("C header missing %q\nGot:\n%s", s, out)
+		}
+	}
+	if strings.Contains(out, "blerpc_EchoResponse_encode_direct") {
+		t.Error("string message should not get a direct codec")
+	}
+}
+
+func TestGenerateCClientSource_DirectCodecs(t *testing.T) {
+	cmds := []Command{streamP2CCommand(), streamC2PCommand()}
+	streaming := map[string]string{"counter_stream": "p2c", "counter_upload": "c2p"}
+	out := generateCClientSource(cmds, streaming, nil, "blerpc")
+
+	mustContain := []string{
+		"static bool _blerpc_CounterStreamResponse_decode_direct(",
+		"static size_t _blerpc_CounterUploadRequest_encode_direct(",
+		"_blerpc_CounterStreamResponse_decode_direct(data, len, &c->results[c->count])",
+	}
+	for _, s := range mustContain {
+		if !strings.Contains(out, s) {
+			t.Errorf("C client source missing %q\nGot:\n%s", s, out)
+		}
+	}
+}
+
+func TestCDirectHelpers_VarintOverflow(t *testing.T) {
+	out := cDirectHelpers("", false, true, nil)
+
+	// A tenth byte may only carry bit 63, as pb_decode_varint() enforces
+	want := "        if (shift == 63 && (byte & 0x7E)) {\n            return NULL;"
+	if !strings.Contains(out, want) {
+		t.Errorf("get_varint should reject bits past 64\nGot:\n%s", out)
+	}
+	if strings.Contains(out, "put_varint") {
+		t.Error("decode-only helpers should not emit put_varint")
+	}
+}
@@ -5,8 +5,19 @@ import (
 	"strings"
 )
 
-func generateCHeader(commands []Command, pkg string) string {
+// cHandlerDirectMsgs lists the messages the peripheral gets direct codecs
+// for: fixed-layout responses to encode and requests to decode.
+func cHandlerDirectMsgs(commands []Command, pkg string) (encoders, decoders []cDirectMsg) {
+	for _, cmd := range commands {
+		encoders = appendDirectMsg(encoders, pkg+"_"+cmd.ResponseMsg, cmd.ResponseFields)
+		decoders = appendDirectMsg(decoders, pkg+"_"+cmd.RequestMsg, cmd.RequestFields)
+	}
+	return encoders, decoders
+}
+
+func generateCHeader(commands []Command, callbacks map[string]bool, pkg string) string {
 	guard := strings.ToUpper(pkg) + "_GENERATED_HANDLERS_H"
+	encoders, decoders := cHandlerDirectMsgs(commands, pkg)
 	var b strings.Builder
 	lines := []string{
 		"/* Auto-generated by generate-handlers — DO NOT EDIT */",
@@ -16,6 +27,12 @@ func generateCHeader(commands []Command, pkg string) string {
 		"#include <stdint.h>",
 		"#include <stddef.h>",
 		"#include <pb_encode.h>",
+		"#include <pb_decode.h>",
+	}
+	if len(encoders)+len(decoders) > 0 {
+		lines = append(lines, `#include "`+pkg+`.pb.h"`)
+	}
+	lines = append(lines,
 		"",
 		"#ifdef __cplusplus",
 		`extern "C" {`,
@@ -24,24 +41,63 @@ func generateCHeader(commands []Command, pkg string) string {
 		"typedef int (*command_handler_fn)(const uint8_t *req_data, size_t req_len,",
 		"                                  pb_ostream_t *ostream);",
 		"",
+		"/* Decodes the request straight from a stream fed as containers arrive */",
+		"typedef int (*command_istream_handler_fn)(pb_istream_t *istream, pb_ostream_t *ostream);",
+		"",
+		"/* Stream direction of a command, from streaming.txt */",
+		"enum handler_stream {",
+		"    HANDLER_STREAM_NONE,",
+		"    HANDLER_STREAM_P2C, /* handler starts a peripheral-to-central stream */",
+		"    HANDLER_STREAM_C2P, /* handler consumes one central-to-peripheral message */",
+		"};",
+		"",
 		"struct handler_entry {",
 		"    const char *name;",
 		"    uint8_t name_len;",
 		"    command_handler_fn handler;",
+		"    size_t max_resp_size; /* encoded response bound, 0 if unbounded */",
+		"    command_istream_handler_fn istream_handler; /* NULL if not implemented */",
+		"    uint32_t cache_ttl_ms; /* response cache lifetime (cache.txt), 0 if not cached */",
+		"    enum handler_stream stream;",
+		"    uint8_t id; /* wire ID, the *_CMD_ID_* value */",
 		"};",
 		"",
 		"command_handler_fn handlers_lookup(const char *name, uint8_t name_len);",
+		"const struct handler_entry *handlers_find(const char *name, uint8_t name_len);",
 		"",
-	}
+		"/* Look up a handler by its wire ID (see the *_CMD_ID_* macros) */",
+		"const struct handler_entry *handlers_find_id(uint8_t id);",
+		"",
+	)
 	for _, l := range lines {
 		b.WriteString(l)
 		b.WriteByte('\n')
 	}
+	b.WriteString(cCommandIDDefines(commands, pkg))
 
 	for _, cmd := range commands {
 		pad := strings.Repeat(" ", len(cmd.Snake))
 		b.WriteString(fmt.Sprintf("int handle_%s(const uint8_t *req_data, size_t req_len,\n", cmd.Snake))
 		b.WriteString(fmt.Sprintf("                %spb_ostream_t *ostream);\n", pad))
+		if cIncremental(cmd, callbacks) {
+			b.WriteString("/* Optional: define to decode large requests as they arrive */\n")
+			b.WriteString(fmt.Sprintf("int handle_%s_istream(pb_istream_t *istream, pb_ostream_t *ostream);\n",
+				cmd.Snake))
+		}
+		b.WriteByte('\n')
+	}
+
+	if len(encoders)+len(decoders) > 0 {
+		b.WriteString("/* Direct codecs for fixed-layout messages (varint scalars only): the bytes\n")
+		b.WriteString(" * pb_encode() writes, without walking nanopb's field tables. An encode\n")
+		b.WriteString(" * buffer holds <message>_size bytes; decode leaves anything unexpected to\n")
+		b.WriteString(" * pb_decode(). */\n")
+		for _, m := range encoders {
+			b.WriteString(cDirectEncodeSignature("", m.Name) + ";\n")
+		}
+		for _, m := range decoders {
+			b.WriteString(cDirectDecodeSignature("", m.Name) + ";\n")
+		}
 		b.WriteByte('\n')
 	}
 
@@ -59,7 +115,7 @@ func generateCHeader(commands []Command, pkg string) string {
 	return b.String()
 }
 
-func generateCSource(commands []Command, callbacks map[string]bool, pkg string) string {
+func generateCSource(commands []Command, streaming map[string]string, callbacks map[string]bool, pkg string) string {
 	var b strings.Builder
 
 	header := []string{
@@ -126,26 +182,132 @@ func generateCSource(commands []Command, callbacks map[string]bool, pkg string)
 		b.WriteByte('\n')
 	}
 
+	encoders, decoders := cHandlerDirectMsgs(commands, pkg)
+	b.WriteString(cDirectCodecs("", "", "", encoders, decoders))
+
+	// Response size bounds: nanopb only emits <Msg>_size for messages
+	// without FT_CALLBACK or unbounded fields.
+	b.WriteString("/* Encoded response size bounds, 0 when nanopb cannot bound the message */\n")
+	for _, cmd := range commands {
+		sizeMacro := pkg + "_" + cmd.ResponseMsg + "_size"
+		maxMacro := respMaxSizeMacro(cmd)
+		b.WriteString(fmt.Sprintf("#ifdef %s\n", sizeMacro))
+		b.WriteString(fmt.Sprintf("#define %s %s\n", maxMacro, sizeMacro))
+		b.WriteString("#else\n")
+		b.WriteString(fmt.Sprintf("#define %s 0\n", maxMacro))
+		b.WriteString("#endif\n")
+	}
+	b.WriteByte('\n')
+
+	// Incremental handlers have no default: an undefined weak reference
+	// resolves to NULL, so requests fall back to full assembly unless the
+	// application opts in.
+	var incremental []Command
+	for _, cmd := range commands {
+		if cIncremental(cmd, callbacks) {
+			incremental = append(incremental, cmd)
+		}
+	}
+	if len(incremental) > 0 {
+		b.WriteString("/* Incremental-decode handlers, NULL unless the application defines them */\n")
+		for _, cmd := range incremental {
+			b.WriteString(fmt.Sprintf("__attribute__((weak)) int handle_%s_istream(pb_istream_t *istream,\n",
+				cmd.Snake))
+			pad := strings.Repeat(" ", len("__attribute__((weak)) int handle__istream(")+len(cmd.Snake))
+			b.WriteString(pad + "pb_ostream_t *ostream);\n")
+		}
+		b.WriteByte('\n')
+	}
+
 	// Handler table
 	b.WriteString("static const struct handler_entry handler_table[] = {\n")
-	for _, cmd := range commands {
-		b.WriteString(fmt.Sprintf("    {\"%s\", %d, handle_%s},\n", cmd.Snake, len(cmd.Snake), cmd.Snake))
+	for i, cmd := range commands {
+		istream := "NULL"
+		if cIncremental(cmd, callbacks) {
+			istream = "handle_" + cmd.Snake + "_istream"
+		}
+		b.WriteString(fmt.Sprintf("    {\"%s\", %d, handle_%s, %s, %s, %d, %s, %d},\n", cmd.Snake,
+			len(cmd.Snake), cmd.Snake, respMaxSizeMacro(cmd), istream, cmd.CacheTTL,
+			cStreamDirection(streaming[cmd.Snake]), i+1))
 	}
 	b.WriteString("};\n")
 	b.WriteByte('\n')
 
-	// Lookup function
-	b.WriteString("command_handler_fn handlers_lookup(const char *name, uint8_t name_len)\n")
+	// Perfect hash over the command names: every name owns one slot, so a
+	// lookup is one hash and at most one memcmp
+	seed, slots := perfectHash(commands)
+	b.WriteString("/* Perfect hash of the command names: slot holds table index + 1, 0 if empty */\n")
+	b.WriteString(fmt.Sprintf("#define HANDLER_HASH_SEED 0x%08xu\n", seed))
+	b.WriteString(fmt.Sprintf("#define HANDLER_SLOT_MASK 0x%xu\n", len(slots)-1))
+	slotType := "uint8_t"
+	if len(commands) > 255 {
+		slotType = "uint16_t"
+	}
+	b.WriteString("static const " + slotType + " handler_slots[] = {")
+	for i, s := range slots {
+		if i%16 == 0 {
+			b.WriteString("\n   ")
+		}
+		b.WriteString(fmt.Sprintf(" %d,", s))
+	}
+	b.WriteString("\n};\n")
+	b.WriteByte('\n')
+
+	b.WriteString("static uint32_t name_hash(const char *name, uint8_t name_len)\n")
+	b.WriteString("{\n")
+	b.WriteString("    uint32_t h = HANDLER_HASH_SEED;\n")
+	b.WriteString("    for (uint8_t i = 0; i < name_len; i++) {\n")
+	b.WriteString("        h ^= (uint8_t)name[i];\n")
+	b.WriteString("        h *= 16777619u;\n")
+	b.WriteString("    }\n")
+	b.WriteString("    return h;\n")
+	b.WriteString("}\n")
+	b.WriteByte('\n')
+
+	// Lookup functions
+	b.WriteString("const struct handler_entry *handlers_find(const char *name, uint8_t name_len)\n")
 	b.WriteString("{\n")
-	b.WriteString("    size_t i;\n")
-	b.WriteString("    for (i = 0; i < sizeof(handler_table) / sizeof(handler_table[0]); i++) {\n")
-	b.WriteString("        if (handler_table[i].name_len == name_len &&\n")
-	b.WriteString("            memcmp(handler_table[i].name, name, name_len) == 0) {\n")
-	b.WriteString("            return handler_table[i].handler;\n")
-	b.WriteString("        }\n")
+	b.WriteString("    " + slotType + " slot = handler_slots[name_hash(name, name_len) & HANDLER_SLOT_MASK];\n")
+	b.WriteString("    if (slot == 0) {\n")
+	b.WriteString("        return NULL;\n")
 	b.WriteString("    }\n")
-	b.WriteString("    return NULL;\n")
+	b.WriteString("    const struct handler_entry *entry = &handler_table[slot - 1];\n")
+	b.WriteString("    if (entry->name_len != name_len || memcmp(entry->name, name, name_len) != 0) {\n")
+	b.WriteString("        return NULL;\n")
+	b.WriteString("    }\n")
+	b.WriteString("    return entry;\n")
+	b.WriteString("}\n")
+	b.WriteByte('\n')
+	b.WriteString("const struct handler_entry *handlers_find_id(uint8_t id)\n")
+	b.WriteString("{\n")
+	b.WriteString("    /* IDs are table positions + 1 */\n")
+	b.WriteString("    if (id == 0 || id > sizeof(handler_table) / sizeof(handler_table[0])) {\n")
+	b.WriteString("        return NULL;\n")
+	b.WriteString("    }\n")
+	b.WriteString("    return &handler_table[id - 1];\n")
+	b.WriteString("}\n")
+	b.WriteByte('\n')
+	b.WriteString("command_handler_fn handlers_lookup(const char *name, uint8_t name_len)\n")
+	b.WriteString("{\n")
+	b.WriteString("    const struct handler_entry *entry = handlers_find(name, name_len);\n")
+	b.WriteString("    return entry ? entry->handler : NULL;\n")
 	b.WriteString("}\n")
 
 	return b.String()
 }
+
+// cStreamDirection maps a streaming.txt direction to its handler_stream
+// value.
+func cStreamDirection(dir string) string {
+	switch dir {
+	case "p2c":
+		return "HANDLER_STREAM_P2C"
+	case "c2p":
+		return "HANDLER_STREAM_C2P"
+	}
+	return "HANDLER_STREAM_NONE"
+}
+
+func respMaxSizeMacro(cmd Command) string {
+	return strings.ToUpper(cmd.Snake) + "_RESP_MAX_SIZE"
+}
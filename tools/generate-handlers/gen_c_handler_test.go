@@ -131,13 +131,15 @@ func callbackCommand() Command {
 
 func TestGenerateCHeader_Echo(t *testing.T) {
 	cmds := []Command{echoCommand()}
-	out := generateCHeader(cmds, "blerpc")
+	out := generateCHeader(cmds, nil, "blerpc")
 
 	mustContain := []string{
 		"#ifndef BLERPC_GENERATED_HANDLERS_H",
 		"int handle_echo(const uint8_t *req_data, size_t req_len,",
 		"pb_ostream_t *ostream);",
+		"size_t max_resp_size;",
 		"handlers_lookup",
+		"handlers_find",
 	}
 	for _, s := range mustContain {
 		if !strings.Contains(out, s) {
@@ -148,7 +150,7 @@ func TestGenerateCHeader_Echo(t *testing.T) {
 
 func TestGenerateCHeader_CustomPkg(t *testing.T) {
 	cmds := []Command{echoCommand()}
-	out := generateCHeader(cmds, "myapp")
+	out := generateCHeader(cmds, nil, "myapp")
 
 	mustContain := []string{
 		"#ifndef MYAPP_GENERATED_HANDLERS_H",
@@ -173,7 +175,7 @@ func TestGenerateCHeader_CustomPkg(t *testing.T) {
 
 func TestGenerateCHeader_MultipleCommands(t *testing.T) {
 	cmds := []Command{echoCommand(), enumCommand()}
-	out := generateCHeader(cmds, "blerpc")
+	out := generateCHeader(cmds, nil, "blerpc")
 
 	mustContain := []string{
 		"int handle_echo(",
@@ -188,14 +190,18 @@ func TestGenerateCHeader_MultipleCommands(t *testing.T) {
 
 func TestGenerateCSource_Echo(t *testing.T) {
 	cmds := []Command{echoCommand()}
-	out := generateCSource(cmds, nil, "blerpc")
+	out := generateCSource(cmds, nil, nil, "blerpc")
 
 	mustContain := []string{
 		"__attribute__((weak))",
 		"int handle_echo(",
 		"blerpc_EchoRequest req = blerpc_EchoRequest_init_zero;",
 		"blerpc_EchoResponse resp = blerpc_EchoResponse_init_zero;",
-		`{"echo", 4, handle_echo}`,
+		`{"echo", 4, handle_echo, ECHO_RESP_MAX_SIZE, NULL, 0, HANDLER_STREAM_NONE, 1}`,
+		"#ifdef blerpc_EchoResponse_size",
+		"#define ECHO_RESP_MAX_SIZE blerpc_EchoResponse_size",
+		"#define ECHO_RESP_MAX_SIZE 0",
+		"handlers_find",
 		"handlers_lookup",
 	}
 	for _, s := range mustContain {
@@ -210,7 +216,7 @@ func TestGenerateCSource_Callback(t *testing.T) {
 	callbacks := map[string]bool{
 		"DataWriteRequest.data": true,
 	}
-	out := generateCSource(cmds, callbacks, "blerpc")
+	out := generateCSource(cmds, nil, callbacks, "blerpc")
 
 	mustContain := []string{
 		"req.data.funcs.decode = discard_bytes_cb;",
@@ -223,9 +229,46 @@ func TestGenerateCSource_Callback(t *testing.T) {
 	}
 }
 
+func TestGenerateC_IncrementalHandler(t *testing.T) {
+	cmds := []Command{echoCommand(), callbackCommand()}
+	callbacks := map[string]bool{
+		"DataWriteRequest.data": true,
+	}
+	hdr := generateCHeader(cmds, callbacks, "blerpc")
+	src := generateCSource(cmds, nil, callbacks, "blerpc")
+
+	for _, s := range []string{
+		"#include <pb_decode.h>",
+		"typedef int (*command_istream_handler_fn)(pb_istream_t *istream, pb_ostream_t *ostream);",
+		"command_istream_handler_fn istream_handler;",
+		"int handle_data_write_istream(pb_istream_t *istream, pb_ostream_t *ostream);",
+	} {
+		if !strings.Contains(hdr, s) {
+			t.Errorf("C header missing %q\nGot:\n%s", s, hdr)
+		}
+	}
+	if strings.Contains(hdr, "handle_echo_istream") {
+		t.Error("C header declares an istream handler for a message without callbacks")
+	}
+	for _, s := range []string{
+		"__attribute__((weak)) int handle_data_write_istream(pb_istream_t *istream,",
+		"{\"echo\", 4, handle_echo, ECHO_RESP_MAX_SIZE, NULL, 0, HANDLER_STREAM_NONE, 1},",
+		"{\"data_write\", 10, handle_data_write, DATA_WRITE_RESP_MAX_SIZE, handle_data_write_istream, 0, HANDLER_STREAM_NONE, 2},",
+	} {
+		if !strings.Contains(src, s) {
+			t.Errorf("C source missing %q\nGot:\n%s", s, src)
+		}
+	}
+	// No default body: the weak reference must stay undefined
+	if strings.Contains(src, "handle_data_write_istream(pb_istream_t *istream,\n"+
+		strings.Repeat(" ", 48)+"pb_ostream_t *ostream)\n{") {
+		t.Error("C source defines a default istream handler")
+	}
+}
+
 func TestGenerateCSource_CustomPkg(t *testing.T) {
 	cmds := []Command{echoCommand()}
-	out := generateCSource(cmds, nil, "myapp")
+	out := generateCSource(cmds, nil, nil, "myapp")
 
 	mustContain := []string{
 		"myapp.pb.h",
@@ -241,3 +284,101 @@ func TestGenerateCSource_CustomPkg(t *testing.T) {
 		t.Error("C source custom pkg should not contain 'blerpc_'")
 	}
 }
+
+func TestGenerateCSource_RespMaxSizePerCommand(t *testing.T) {
+	cmds := []Command{echoCommand(), callbackCommand()}
+	out := generateCSource(cmds, nil, nil, "myapp")
+
+	mustContain := []string{
+		"#ifdef myapp_EchoResponse_size",
+		"#define ECHO_RESP_MAX_SIZE myapp_EchoResponse_size",
+		"#ifdef myapp_DataWriteResponse_size",
+		"#define DATA_WRITE_RESP_MAX_SIZE myapp_DataWriteResponse_size",
+		`{"data_write", 10, handle_data_write, DATA_WRITE_RESP_MAX_SIZE, NULL, 0, HANDLER_STREAM_NONE, 2}`,
+	}
+	for _, s := range mustContain {
+		if !strings.Contains(out, s) {
+			t.Errorf("C source missing %q\nGot:\n%s", s, out)
+		}
+	}
+}
+
+func TestGenerateCSource_CacheTTL(t *testing.T) {
+	cached := echoCommand()
+	cached.CacheTTL = 5000
+	cmds := []Command{cached, callbackCommand()}
+	out := generateCSource(cmds, nil, nil, "blerpc")
+
+	mustContain := []string{
+		`{"echo", 4, handle_echo, ECHO_RESP_MAX_SIZE, NULL, 5000, HANDLER_STREAM_NONE, 1}`,
+		`{"data_write", 10, handle_data_write, DATA_WRITE_RESP_MAX_SIZE, NULL, 0, HANDLER_STREAM_NONE, 2}`,
+	}
+	for _, s := range mustContain {
+		if !strings.Contains(out, s) {
+			t.Errorf("C source missing %q\nGot:\n%s", s, out)
+		}
+	}
+	if hdr := generateCHeader(cmds, nil, "blerpc"); !strings.Contains(hdr, "uint32_t cache_ttl_ms;") {
+		t.Errorf("C header missing cache_ttl_ms\nGot:\n%s", hdr)
+	}
+}
+
+func TestGenerateCSource_StreamDirection(t *testing.T) {
+	cmds := []Command{echoCommand(), streamP2CCommand(), streamC2PCommand()}
+	streaming := map[string]string{"counter_stream": "p2c", "counter_upload": "c2p"}
+	out := generateCSource(cmds, streaming, nil, "blerpc")
+
+	mustContain := []string{
+		`{"echo", 4, handle_echo, ECHO_RESP_MAX_SIZE, NULL, 0, HANDLER_STREAM_NONE, 1}`,
+		`handle_counter_stream, COUNTER_STREAM_RESP_MAX_SIZE, NULL, 0, HANDLER_STREAM_P2C, 2}`,
+		`handle_counter_upload, COUNTER_UPLOAD_RESP_MAX_SIZE, NULL, 0, HANDLER_STREAM_C2P, 3}`,
+	}
+	for _, s := range mustContain {
+		if !strings.Contains(out, s) {
+			t.Errorf("C source missing %q\nGot:\n%s", s, out)
+		}
+	}
+	if hdr := generateCHeader(cmds, nil, "blerpc"); !strings.Contains(hdr, "enum handler_stream stream;") {
+		t.Errorf("C header missing the stream column\nGot:\n%s", hdr)
+	}
+}
+
+func TestGenerateCHeader_CommandIDs(t *testing.T) {
+	cmds := []Command{echoCommand(), enumCommand()}
+	out := generateCHeader(cmds, nil, "myapp")
+
+	mustContain := []string{
+		"#define MYAPP_CMD_ID_ECHO 1",
+		"#define MYAPP_CMD_ID_GET_STATUS 2",
+		"#define MYAPP_CMD_COUNT 2",
+		"#define MYAPP_SCHEMA_HASH 0x",
+		"const struct handler_entry *handlers_find_id(uint8_t id);",
+		"uint8_t id; /* wire ID, the *_CMD_ID_* value */",
+	}
+	for _, s := range mustContain {
+		if !strings.Contains(out, s) {
+			t.Errorf("C header missing %q\nGot:\n%s", s, out)
+		}
+	}
+}
+
+func TestGenerateCSource_PerfectHashLookup(t *testing.T) {
+	cmds := []Command{echoCommand(), enumCommand(), callbackCommand()}
+	out := generateCSource(cmds, nil, nil, "blerpc")
+
+	mustContain := []string{
+		"#define HANDLER_HASH_SEED 0x",
+		"#define HANDLER_SLOT_MASK 0x7u",
+		"static const uint8_t handler_slots[] = {",
+		"handler_slots[name_hash(name, name_len) & HANDLER_SLOT_MASK]",
+		"const struct handler_entry *handlers_find_id(uint8_t id)",
+	}
+	for _, s := range mustContain {
+		if !strings.Contains(out, s) {
+			t.Errorf("C source missing %q\nGot:\n%s", s, out)
+		}
+	}
+	if strings.Contains(out, "for (i = 0; i < sizeof(handler_table)") {
+		t.Error("C source should not scan the handler table linearly")
+	}
+}
@@ -75,20 +75,23 @@ func cParamStr(cType, name string) string {
 }
 
 // cClientParams builds the parameter list for a C client function.
+// Every function takes the connection handle it targets first.
 func cClientParams(cmd Command, streaming map[string]string, callbacks map[string]bool, pkg string) []string {
 	dir, isStreaming := streaming[cmd.Snake]
 	reqMsg := pkg + "_" + cmd.RequestMsg
 	respMsg := pkg + "_" + cmd.ResponseMsg
+	connParam := "struct " + pkg + "_conn *conn"
 
 	if isStreaming && dir == "c2p" {
 		return []string{
+			connParam,
 			fmt.Sprintf("const %s *messages", reqMsg),
 			"size_t msg_count",
 			fmt.Sprintf("%s *resp", respMsg),
 		}
 	}
 
-	var params []string
+	params := []string{connParam}
 
 	for _, f := range cmd.RequestFields {
 		key := cmd.RequestMsg + "." + f.Name
@@ -112,7 +115,9 @@ func cClientParams(cmd Command, streaming map[string]string, callbacks map[strin
 		params = append(params, "uint8_t *work_buf", "size_t work_buf_size")
 	}
 
-	if isStreaming && dir == "p2c" {
+	if isStreaming && dir == "p2c" && cRespHasCallbacks(cmd, callbacks) {
+		params = append(params, pkg+"_on_stream_resp_t on_resp", "void *ctx")
+	} else if isStreaming && dir == "p2c" {
 		params = append(params,
 			fmt.Sprintf("%s *results", respMsg),
 			"size_t max_results",
@@ -132,3 +137,144 @@ func cClientParams(cmd Command, streaming map[string]string, callbacks map[strin
 
 	return params
 }
+
+// cBatchable reports whether a command can be queued in a C client batch:
+// unary, with no FT_CALLBACK fields, so requests and responses are plain
+// fixed-size structs.
+func cBatchable(cmd Command, streaming map[string]string, callbacks map[string]bool) bool {
+	if _, ok := streaming[cmd.Snake]; ok {
+		return false
+	}
+	for _, f := range cmd.RequestFields {
+		if callbacks[cmd.RequestMsg+"."+f.Name] {
+			return false
+		}
+	}
+	for _, f := range cmd.ResponseFields {
+		if callbacks[cmd.ResponseMsg+"."+f.Name] {
+			return false
+		}
+	}
+	return true
+}
+
+// cIncremental reports whether a command's request has FT_CALLBACK fields,
+// which is what makes decoding it straight off the link worthwhile: the
+// handler consumes the bulk bytes as they arrive instead of from one buffer.
+func cIncremental(cmd Command, callbacks map[string]bool) bool {
+	for _, f := range cmd.RequestFields {
+		if callbacks[cmd.RequestMsg+"."+f.Name] {
+			return true
+		}
+	}
+	return false
+}
+
+// cRespHasCallbacks reports whether a command's response has FT_CALLBACK
+// fields. P2C streams of such responses cannot be collected into a results
+// array, so their C client hands each raw response payload to a callback.
+func cRespHasCallbacks(cmd Command, callbacks map[string]bool) bool {
+	for _, f := range cmd.ResponseFields {
+		if callbacks[cmd.ResponseMsg+"."+f.Name] {
+			return true
+		}
+	}
+	return false
+}
+
+// maxCommandID is the largest ID that fits the 1-byte wire form. Commands
+// past it get ID 0 and are only ever sent by name.
+const maxCommandID = 255
+
+// commandID returns the wire ID of the i-th command in schema order. IDs are
+// dense from 1, so appending a command keeps every existing ID stable.
+func commandID(i int) int {
+	if i+1 > maxCommandID {
+		return 0
+	}
+	return i + 1
+}
+
+// cCommandIDMacro names the C macro holding a command's wire ID.
+func cCommandIDMacro(cmd Command, pkg string) string {
+	return strings.ToUpper(pkg) + "_CMD_ID_" + strings.ToUpper(cmd.Snake)
+}
+
+const (
+	fnvOffset = 2166136261
+	fnvPrime  = 16777619
+)
+
+// fnv1a is 32-bit FNV-1a starting from seed; the generated C name_hash()
+// computes the same value.
+func fnv1a(seed uint32, s string) uint32 {
+	h := seed
+	for i := 0; i < len(s); i++ {
+		h ^= uint32(s[i])
+		h *= fnvPrime
+	}
+	return h
+}
+
+// schemaHash identifies the command ID assignment: FNV-1a over the command
+// names in order, folded to 16 bits. Peers only exchange IDs when their
+// hashes match.
+func schemaHash(commands []Command) uint16 {
+	h := uint32(fnvOffset)
+	for _, cmd := range commands {
+		h = fnv1a(h, cmd.Snake)
+		h = fnv1a(h, "\n")
+	}
+	return uint16(h>>16) ^ uint16(h)
+}
+
+// perfectHash finds a seed for which fnv1a(seed, name) masked to the table
+// size maps every name to its own slot. The table is a power of two at least
+// twice the command count, grown if no seed is found. slots[i] holds the
+// command index plus one, 0 for an empty slot.
+func perfectHash(commands []Command) (seed uint32, slots []int) {
+	size := 1
+	for size < 2*len(commands) {
+		size <<= 1
+	}
+	for {
+		slots = make([]int, size)
+		for attempt := uint32(0); attempt < 1<<16; attempt++ {
+			seed = fnvOffset + attempt
+			for i := range slots {
+				slots[i] = 0
+			}
+			ok := true
+			for i, cmd := range commands {
+				s := fnv1a(seed, cmd.Snake) & uint32(size-1)
+				if slots[s] != 0 {
+					ok = false
+					break
+				}
+				slots[s] = i + 1
+			}
+			if ok {
+				return seed, slots
+			}
+		}
+		size <<= 1
+	}
+}
+
+// cCommandIDDefines emits the command ID and schema hash macros shared by
+// the generated peripheral and central headers.
+func cCommandIDDefines(commands []Command, pkg string) string {
+	var b strings.Builder
+	up := strings.ToUpper(pkg)
+	b.WriteString("/* Command IDs for the 1-byte wire form, dense in schema order: append new\n")
+	b.WriteString(" * commands to keep existing IDs stable. 0 means the command has no ID. */\n")
+	for i, cmd := range commands {
+		b.WriteString(fmt.Sprintf("#define %s %d\n", cCommandIDMacro(cmd, pkg), commandID(i)))
+	}
+	b.WriteString(fmt.Sprintf("#define %s_CMD_COUNT %d\n", up, len(commands)))
+	b.WriteByte('\n')
+	b.WriteString("/* Identifies the ID assignment; peers only use IDs when theirs match */\n")
+	b.WriteString(fmt.Sprintf("#define %s_SCHEMA_HASH 0x%04x\n", up, schemaHash(commands)))
+	b.WriteByte('\n')
+	return b.String()
+}
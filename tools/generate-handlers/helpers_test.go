@@ -1,6 +1,9 @@
 package main
 
-import "testing"
+import (
+	"fmt"
+	"testing"
+)
 
 func TestCamelToSnake(t *testing.T) {
 	tests := []struct {
@@ -106,3 +109,40 @@ func TestCParamStr(t *testing.T) {
 		})
 	}
 }
+
+func TestPerfectHash(t *testing.T) {
+	var cmds []Command
+	for i := 0; i < 40; i++ {
+		cmds = append(cmds, Command{Snake: fmt.Sprintf("command_%d", i)})
+	}
+	seed, slots := perfectHash(cmds)
+	if len(slots) < 2*len(cmds) || len(slots)&(len(slots)-1) != 0 {
+		t.Fatalf("table size %d is not a power of two >= %d", len(slots), 2*len(cmds))
+	}
+	for i, cmd := range cmds {
+		s := fnv1a(seed, cmd.Snake) & uint32(len(slots)-1)
+		if slots[s] != i+1 {
+			t.Errorf("%s hashes to slot %d holding %d, want %d", cmd.Snake, s, slots[s], i+1)
+		}
+	}
+}
+
+func TestSchemaHash(t *testing.T) {
+	a := []Command{{Snake: "echo"}, {Snake: "flash_read"}}
+	b := []Command{{Snake: "flash_read"}, {Snake: "echo"}}
+	if schemaHash(a) != schemaHash([]Command{{Snake: "echo"}, {Snake: "flash_read"}}) {
+		t.Error("schema hash is not deterministic")
+	}
+	if schemaHash(a) == schemaHash(b) {
+		t.Error("reordering commands should change the schema hash")
+	}
+}
+
+func TestCommandID(t *testing.T) {
+	if commandID(0) != 1 || commandID(254) != 255 {
+		t.Error("IDs should be dense from 1")
+	}
+	if commandID(255) != 0 {
+		t.Error("commands past the 1-byte range should have no ID")
+	}
+}
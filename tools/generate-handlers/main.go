@@ -36,6 +36,7 @@ func main() {
 	protoFlag := flag.String("proto", "", "path to .proto file (default: <root>/proto/blerpc.proto)")
 	optionsFlag := flag.String("options", "", "path to .options file (default: <root>/proto/blerpc.options)")
 	streamingFlag := flag.String("streaming", "", "path to streaming.txt (default: <root>/proto/streaming.txt)")
+	cacheFlag := flag.String("cache", "", "path to cache.txt (default: <root>/proto/cache.txt)")
 
 	// Import path flags
 	protoPathDirs := flag.String("proto-path", "", "comma-separated proto import search paths")
@@ -57,6 +58,7 @@ func main() {
 	protoPath := flagOrDefault(*protoFlag, filepath.Join(*root, "proto", "blerpc.proto"))
 	optionsFile := flagOrDefault(*optionsFlag, filepath.Join(*root, "proto", "blerpc.options"))
 	streamingFile := flagOrDefault(*streamingFlag, filepath.Join(*root, "proto", "streaming.txt"))
+	cacheFile := flagOrDefault(*cacheFlag, filepath.Join(*root, "proto", "cache.txt"))
 
 	outCHeader := flagOrDefault(*outCHeaderFlag, filepath.Join(*root, "peripheral_fw", "src", "generated_handlers.h"))
 	outCSource := flagOrDefault(*outCSourceFlag, filepath.Join(*root, "peripheral_fw", "src", "generated_handlers.c"))
@@ -89,6 +91,11 @@ func main() {
 		log.Fatalf("Failed to parse streaming commands: %v", err)
 	}
 
+	cache, err := parseCacheCommands(cacheFile)
+	if err != nil {
+		log.Fatalf("Failed to parse cache commands: %v", err)
+	}
+
 	pkg := protoFile.Package
 	if pkg == "" {
 		pkg = "blerpc"
@@ -117,6 +124,13 @@ func main() {
 		os.Exit(1)
 	}
 
+	if err := checkStreamingCommands(commands, streaming); err != nil {
+		log.Fatalf("Failed to apply streaming commands: %v", err)
+	}
+	if err := applyCacheTTLs(commands, cache); err != nil {
+		log.Fatalf("Failed to apply cache commands: %v", err)
+	}
+
 	names := make([]string, len(commands))
 	for i, c := range commands {
 		names[i] = c.Snake
@@ -127,8 +141,8 @@ func main() {
 		path    string
 		content string
 	}{
-		{outCHeader, generateCHeader(commands, pkg)},
-		{outCSource, generateCSource(commands, callbacks, pkg)},
+		{outCHeader, generateCHeader(commands, callbacks, pkg)},
+		{outCSource, generateCSource(commands, streaming, callbacks, pkg)},
 		{outPyHandlers, generatePyHandlers(commands, pkg)},
 		{outPyClient, generatePyClient(commands, streaming, pkg)},
 		{outKtClient, generateKotlinClient(commands, streaming, pkg)},
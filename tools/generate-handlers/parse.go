@@ -6,6 +6,8 @@ import (
 	"io"
 	"os"
 	"path/filepath"
+	"sort"
+	"strconv"
 	"strings"
 
 	"github.com/yoheimuta/go-protoparser/v4"
@@ -108,6 +110,7 @@ func parseProtoReader(r io.Reader) (*ProtoFile, error) {
 					Number:     num,
 					IsEnum:     enumSet[f.Type],
 					IsRepeated: f.IsRepeated,
+					IsOptional: f.IsOptional,
 					IsMessage:  msgSet[f.Type],
 				})
 			case *parser.MapField:
@@ -131,6 +134,7 @@ func parseProtoReader(r io.Reader) (*ProtoFile, error) {
 						Number:    num,
 						IsEnum:    enumSet[of.Type],
 						IsMessage: msgSet[of.Type],
+						InOneof:   true,
 					}
 					og.Fields = append(og.Fields, field)
 					// Also add oneof fields to the message's flat field list
@@ -260,6 +264,81 @@ func parseStreamingCommands(path string) (map[string]string, error) {
 	return streaming, scanner.Err()
 }
 
+// parseCacheCommands reads cache.txt: the commands whose encoded responses
+// the peripheral may cache, each with its time to live in milliseconds.
+func parseCacheCommands(path string) (map[string]int, error) {
+	cache := make(map[string]int)
+	f, err := os.Open(path)
+	if err != nil {
+		if os.IsNotExist(err) {
+			return cache, nil
+		}
+		return nil, err
+	}
+	defer f.Close()
+
+	scanner := bufio.NewScanner(f)
+	for scanner.Scan() {
+		line := strings.TrimSpace(scanner.Text())
+		if line == "" || strings.HasPrefix(line, "#") {
+			continue
+		}
+		parts := strings.Fields(line)
+		if len(parts) != 2 {
+			return nil, fmt.Errorf("invalid cache line (expected 'name ttl_ms'): %q", line)
+		}
+		ttl, err := strconv.ParseUint(parts[1], 10, 32)
+		if err != nil || ttl == 0 {
+			return nil, fmt.Errorf("invalid cache TTL %q (must be a positive number of milliseconds)", parts[1])
+		}
+		cache[parts[0]] = int(ttl)
+	}
+	return cache, scanner.Err()
+}
+
+// checkStreamingCommands fails on streaming.txt names that match no command:
+// the peripheral dispatches by the direction it generates for each command,
+// so a typo must not leave a stream command looking unary.
+func checkStreamingCommands(commands []Command, streaming map[string]string) error {
+	known := make(map[string]bool, len(commands))
+	for _, c := range commands {
+		known[c.Snake] = true
+	}
+	var unknown []string
+	for name := range streaming {
+		if !known[name] {
+			unknown = append(unknown, name)
+		}
+	}
+	if len(unknown) > 0 {
+		sort.Strings(unknown)
+		return fmt.Errorf("streaming.txt names unknown commands: %s", strings.Join(unknown, ", "))
+	}
+	return nil
+}
+
+// applyCacheTTLs sets CacheTTL on the commands cache.txt lists. A name that
+// matches no command is an error, so a typo does not silently disable
+// caching.
+func applyCacheTTLs(commands []Command, cache map[string]int) error {
+	known := make(map[string]bool, len(commands))
+	for i := range commands {
+		known[commands[i].Snake] = true
+		commands[i].CacheTTL = cache[commands[i].Snake]
+	}
+	var unknown []string
+	for name := range cache {
+		if !known[name] {
+			unknown = append(unknown, name)
+		}
+	}
+	if len(unknown) > 0 {
+		sort.Strings(unknown)
+		return fmt.Errorf("cache.txt names unknown commands: %s", strings.Join(unknown, ", "))
+	}
+	return nil
+}
+
 func parseOptions(path string) (map[string]bool, error) {
 	callbacks := make(map[string]bool)
 	f, err := os.Open(path)
@@ -821,3 +821,57 @@ func TestDiscoverCommands_Oneof(t *testing.T) {
 		t.Fatalf("expected 2 request fields, got %d", len(cmd.RequestFields))
 	}
 }
+
+func TestParseCacheCommands(t *testing.T) {
+	dir := t.TempDir()
+	path := filepath.Join(dir, "cache.txt")
+	content := "# name ttl_ms\nflash_read 5000\n\necho 250\n"
+	if err := os.WriteFile(path, []byte(content), 0o644); err != nil {
+		t.Fatal(err)
+	}
+	cache, err := parseCacheCommands(path)
+	if err != nil {
+		t.Fatalf("parseCacheCommands: %v", err)
+	}
+	if len(cache) != 2 || cache["flash_read"] != 5000 || cache["echo"] != 250 {
+		t.Errorf("unexpected cache map %v", cache)
+	}
+
+	if err := os.WriteFile(path, []byte("echo 0\n"), 0o644); err != nil {
+		t.Fatal(err)
+	}
+	if _, err := parseCacheCommands(path); err == nil {
+		t.Error("expected an error for a zero TTL")
+	}
+
+	cache, err = parseCacheCommands(filepath.Join(dir, "missing.txt"))
+	if err != nil || len(cache) != 0 {
+		t.Errorf("missing file: expected empty map, got %v, %v", cache, err)
+	}
+}
+
+func TestApplyCacheTTLs(t *testing.T) {
+	commands := []Command{{Snake: "echo"}, {Snake: "flash_read"}}
+	if err := applyCacheTTLs(commands, map[string]int{"flash_read": 5000}); err != nil {
+		t.Fatalf("applyCacheTTLs: %v", err)
+	}
+	if commands[0].CacheTTL != 0 || commands[1].CacheTTL != 5000 {
+		t.Errorf("unexpected TTLs %d, %d", commands[0].CacheTTL, commands[1].CacheTTL)
+	}
+
+	err := applyCacheTTLs(commands, map[string]int{"flash_raed": 5000})
+	if err == nil || !strings.Contains(err.Error(), "flash_raed") {
+		t.Errorf("expected an error naming the unknown command, got %v", err)
+	}
+}
+
+func TestCheckStreamingCommands(t *testing.T) {
+	commands := []Command{{Snake: "echo"}, {Snake: "counter_stream"}}
+	if err := checkStreamingCommands(commands, map[string]string{"counter_stream": "p2c"}); err != nil {
+		t.Fatalf("checkStreamingCommands: %v", err)
+	}
+	err := checkStreamingCommands(commands, map[string]string{"counter_straem": "p2c"})
+	if err == nil || !strings.Contains(err.Error(), "counter_straem") {
+		t.Errorf("expected an error naming the unknown command, got %v", err)
+	}
+}
@@ -27,6 +27,8 @@ type Field struct {
 	IsRepeated bool
 	IsMessage  bool
 	IsMap      bool
+	IsOptional bool // proto3 optional: has explicit presence
+	InOneof    bool // also listed in one of the message's Oneofs
 	KeyType    string
 	ValueType  string
 }
@@ -46,6 +48,7 @@ type Command struct {
 	ResponseMsg    string
 	RequestFields  []Field
 	ResponseFields []Field
+	CacheTTL       int // ms the peripheral may serve a cached response, 0: never (cache.txt)
 }
 
 // ServiceRPC represents a single RPC method within a service.
@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+"""Drive the Python central and peripheral against each other over loopback.
+
+Usage:
+    python3 tools/loadgen.py [--sessions 8] [--calls 200] [--latency-ms 7.5]
+                             [--loss 0.01] [--mix echo,flash_read] [--encrypt]
+                             [--depth 4]
+
+Each session is one BlerpcClient and one BlerpcPeripheral joined by a
+blerpc.loopback.LoopbackLink, so no radio or BLE stack is needed. Sessions run
+concurrently; each keeps --depth calls in flight, cycling through --mix.
+Prints calls/s, latency percentiles, failures by kind and link counters.
+Exits non-zero when a call fails on a lossless link.
+"""
+
+import argparse
+import asyncio
+import logging
+import os
+import sys
+import time
+from collections import Counter
+from dataclasses import fields
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+sys.path.insert(0, os.path.join(ROOT, "central_py"))
+sys.path.insert(0, os.path.join(ROOT, "peripheral_py"))
+
+from blerpc.client import BlerpcClient  # noqa: E402
+from blerpc.loopback import LinkStats, LoopbackLink  # noqa: E402
+from blerpc_protocol.container import BLERPC_ERROR_BUSY  # noqa: E402
+from server import BlerpcPeripheral  # noqa: E402
+
+MIX = ("echo", "flash_read", "data_write", "counter_stream")
+
+
+async def call(client: BlerpcClient, op: str, payload: int) -> None:
+    if op == "echo":
+        await client.echo(message="x" * payload)
+    elif op == "flash_read":
+        await client.flash_read(address=0, length=payload)
+    elif op == "data_write":
+        await client.data_write(data=bytes(payload))
+    elif op == "counter_stream":
+        await client.counter_stream(count=max(1, payload // 16))
+
+
+def classify(e: Exception) -> str:
+    if isinstance(e, asyncio.TimeoutError):
+        return "timeout"
+    if f"error: 0x{BLERPC_ERROR_BUSY:02x}" in str(e):
+        return "busy"
+    return type(e).__name__
+
+
+async def run_session(args, index: int, latencies: list, failures: Counter):
+    link = LoopbackLink(
+        mtu=args.mtu,
+        latency_s=args.latency_ms / 1000,
+        loss=args.loss,
+        tx_depth=args.tx_depth,
+        seed=None if args.seed is None else args.seed + index,
+    )
+    key = None
+    if args.encrypt:
+        from cryptography.hazmat.primitives.asymmetric.ed25519 import (
+            Ed25519PrivateKey,
+        )
+
+        key = Ed25519PrivateKey.generate().private_bytes_raw().hex()
+    peripheral = BlerpcPeripheral(
+        ed25519_private_key_hex=key, mtu=args.mtu, timeout_ms=args.timeout_ms
+    )
+    peripheral.attach(link)
+    client = BlerpcClient(require_encryption=args.encrypt, transport=link.transport)
+
+    try:
+        devices = await client.scan()
+        await client.connect(devices[0])
+    except Exception as e:
+        failures[f"connect: {classify(e)}"] += 1
+        await client.disconnect()
+        return link.stats
+
+    async def issue(calls):
+        for i in calls:
+            op = args.mix[(index + i) % len(args.mix)]
+            start = time.perf_counter()
+            try:
+                await call(client, op, args.payload)
+            except Exception as e:
+                failures[classify(e)] += 1
+                continue
+            latencies.append(time.perf_counter() - start)
+
+    try:
+        # Workers share one iterator, so each call is issued once
+        calls = iter(range(args.calls))
+        await asyncio.gather(*(issue(calls) for _ in range(args.depth)))
+    finally:
+        await client.disconnect()
+    return link.stats
+
+
+def percentile(sorted_values: list, q: float) -> float:
+    if not sorted_values:
+        return 0.0
+    return sorted_values[min(len(sorted_values) - 1, int(len(sorted_values) * q))]
+
+
+async def run(args) -> int:
+    latencies: list[float] = []
+    failures: Counter = Counter()
+    start = time.perf_counter()
+    all_stats = await asyncio.gather(
+        *(run_session(args, i, latencies, failures) for i in range(args.sessions))
+    )
+    elapsed = time.perf_counter() - start
+
+    latencies.sort()
+    total = LinkStats()
+    for stats in all_stats:
+        for f in fields(LinkStats):
+            setattr(total, f.name, getattr(total, f.name) + getattr(stats, f.name))
+
+    print(
+        f"{args.sessions} sessions x {args.calls} calls, depth {args.depth} "
+        f"({','.join(args.mix)}, {args.payload} B) in {elapsed:.2f}s: "
+        f"{len(latencies) / elapsed:.1f} calls/s"
+    )
+    print(
+        f"latency p50={percentile(latencies, 0.50) * 1000:.2f}ms "
+        f"p99={percentile(latencies, 0.99) * 1000:.2f}ms "
+        f"max={percentile(latencies, 1.0) * 1000:.2f}ms"
+    )
+    print(
+        f"link writes={total.writes} notifications={total.notifications} "
+        f"c2p={total.bytes_c2p}B p2c={total.bytes_p2c}B lost={total.lost} "
+        f"notify_full={total.notify_full}"
+    )
+    if failures:
+        print(
+            "failures: " + " ".join(f"{k}={v}" for k, v in sorted(failures.items()))
+        )
+    return 1 if failures and args.loss == 0 else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="blerpc loopback load generator")
+    parser.add_argument("--sessions", type=int, default=4)
+    parser.add_argument("--calls", type=int, default=100, help="calls per session")
+    parser.add_argument(
+        "--depth", type=int, default=1, help="calls in flight per session"
+    )
+    parser.add_argument(
+        "--mix",
+        type=lambda s: s.split(","),
+        default=list(MIX),
+        help=f"comma-separated commands to cycle through (default: {','.join(MIX)})",
+    )
+    parser.add_argument("--payload", type=int, default=64, help="payload bytes")
+    parser.add_argument("--mtu", type=int, default=247)
+    parser.add_argument(
+        "--latency-ms", type=float, default=0.0, help="one-way packet latency"
+    )
+    parser.add_argument(
+        "--loss", type=float, default=0.0, help="packet loss probability"
+    )
+    parser.add_argument(
+        "--tx-depth", type=int, default=20, help="packets in flight per direction"
+    )
+    parser.add_argument("--encrypt", action="store_true", help="use E2E encryption")
+    parser.add_argument(
+        "--timeout-ms", type=int, default=1000, help="peripheral-reported timeout"
+    )
+    parser.add_argument("--seed", type=int, help="seed for packet loss")
+    parser.add_argument("--verbose", action="store_true")
+    args = parser.parse_args()
+
+    unknown = set(args.mix) - set(MIX)
+    if unknown:
+        parser.error(f"unknown commands in --mix: {','.join(sorted(unknown))}")
+    if not args.verbose:
+        logging.getLogger().setLevel(logging.WARNING)
+        logging.getLogger("blerpc-peripheral").setLevel(logging.WARNING)
+
+    sys.exit(asyncio.run(run(args)))
+
+
+if __name__ == "__main__":
+    main()